@@ -0,0 +1,97 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+N = 2_000_000
+N_LOOP = 200_000       # per-element Python loops are timed on a prefix and scaled up
+ROWS, COLS = 4_000, 500
+
+random.seed(0)
+logits = array.array('d', [random.gauss(0.0, 20.0) for _ in range(N)])
+logits32 = array.array('f', logits)
+probs = array.array('d', [random.uniform(1e-6, 1.0 - 1e-6) for _ in range(N)])
+scores = array.array('d', [random.gauss(0.0, 50.0) for _ in range(ROWS * COLS)])
+scores32 = array.array('f', scores)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<18}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def loop_scaled(func, data):
+    t, _ = timed(lambda: [func(v) for v in data[:N_LOOP]], repeat=1)
+    return t * (N / N_LOOP)
+
+def sigmoid_composed(x):
+    # What a scoring model writes on the scalar primitives; overflows for x < -709.
+    return 1.0 / (1.0 + calco.exponential(-x))
+
+def softplus_composed(x):
+    return calco.natural_log(1.0 + calco.exponential(x)) if x < 700.0 else x
+
+def logsumexp_two_pass(buf):
+    # Max pass, then an exp pass over a shifted copy per row, as apply() allows today.
+    out = array.array('d', bytes(8 * ROWS))
+    for r in range(ROWS):
+        rw = buf[r * COLS:(r + 1) * COLS]
+        m = max(rw)
+        shifted = array.array('d', [v - m for v in rw])
+        out[r] = m + math.log(math.fsum(calco.apply(calco.exponential, shifted)))
+    return out
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Operation (' + format(N, ',') + ' values)':<34}{'Reference':<18}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 82)
+    t_ref = loop_scaled(sigmoid_composed, logits)
+    t_c, _ = timed(lambda: calco.sigmoid(logits))
+    row("sigmoid, float64", t_ref, t_c, "composed loop*")
+    t_c, _ = timed(lambda: calco.sigmoid(logits32))
+    row("sigmoid, float32", t_ref, t_c, "composed loop*")
+    t_c, _ = timed(lambda: calco.softplus(logits))
+    row("softplus", loop_scaled(softplus_composed, logits), t_c, "composed loop*")
+    t_c, _ = timed(lambda: calco.logit(probs))
+    row("logit", loop_scaled(lambda p: math.log(p / (1.0 - p)), probs), t_c, "math loop*")
+    t_c, _ = timed(lambda: calco.gelu(logits))
+    row("gelu", loop_scaled(lambda v: 0.5 * v * math.erfc(-v / math.sqrt(2.0)), logits), t_c, "math loop*")
+    t_c, _ = timed(lambda: calco.logaddexp(logits, 0.0))
+    row("logaddexp(x, 0)", loop_scaled(lambda v: max(v, 0.0) + math.log1p(math.exp(-abs(v))), logits), t_c,
+        "math loop*")
+
+    print("-" * 82)
+    print(f"{f'Rows ({ROWS:,} x {COLS})':<34}")
+    t_ref, ref = timed(lambda: logsumexp_two_pass(scores), repeat=1)
+    t_c, lse = timed(lambda: calco.logsumexp(scores, COLS))
+    assert max(abs(lse[r] - ref[r]) for r in range(ROWS)) < 1e-12
+    row("logsumexp, float64", t_ref, t_c, "max + apply(exp)")
+    t_c, _ = timed(lambda: calco.logsumexp(scores32, COLS))
+    row("logsumexp, float32", t_ref, t_c, "max + apply(exp)")
+    t_c, sm = timed(lambda: calco.softmax(scores, COLS))
+    row("softmax, float64", t_ref, t_c, "max + apply(exp)")
+    t_c, _ = timed(lambda: calco.softmax(scores32, COLS))
+    row("softmax, float32", t_ref, t_c, "max + apply(exp)")
+    print("-" * 82)
+    print(f"overflow-safe: sigmoid(-1000) = {calco.sigmoid(-1000.0)}, softplus(1000) = {calco.softplus(1000.0)}, "
+          f"logsumexp([1000, 1000]) = {calco.logsumexp(array.array('d', [1000.0, 1000.0])):.6f}")
+    print(f"* one value at a time, timed on {N_LOOP:,} values and scaled to {N:,}")
+    print(f"worker threads: {calco.get_num_threads()}")
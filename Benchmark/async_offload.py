@@ -0,0 +1,70 @@
+import asyncio
+import array
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+TOTAL_BYTES = 1 << 30          # 1 GB of float64 input in total
+BLOCK_ELEMENTS = 8_000_000     # 64 MB per job
+TICK = 0.001                   # Event-loop heartbeat interval (s)
+
+# -----------------------------
+# Event-loop Latency Probe
+# -----------------------------
+
+async def heartbeat(stop, lateness):
+    """Sleeps TICK repeatedly and records how late each wakeup was."""
+    loop = asyncio.get_running_loop()
+    while not stop.is_set():
+        start = loop.time()
+        await asyncio.sleep(TICK)
+        lateness.append(loop.time() - start - TICK)
+
+async def run(label, work):
+    stop = asyncio.Event()
+    lateness = []
+    probe = asyncio.create_task(heartbeat(stop, lateness))
+    await asyncio.sleep(0.05)
+    start = time.perf_counter()
+    await work()
+    elapsed = time.perf_counter() - start
+    stop.set()
+    await probe
+    lateness.sort()
+    p99 = lateness[int(len(lateness) * 0.99) - 1] if lateness else 0.0
+    worst = lateness[-1] if lateness else 0.0
+    print(f"{label:<12}{elapsed:>10.3f}{p99 * 1e3:>14.3f}{worst * 1e3:>14.3f}")
+
+# -----------------------------
+# Workloads
+# -----------------------------
+
+def main():
+    data = array.array('d', [i * 1e-7 for i in range(BLOCK_ELEMENTS)])
+    out = array.array('d', bytes(len(data) * 8))
+    blocks = TOTAL_BYTES // (BLOCK_ELEMENTS * 8)
+
+    async def blocking():
+        for _ in range(blocks):
+            calco.apply(calco.error_function, data, out=out)
+            await asyncio.sleep(0)
+
+    async def offloaded():
+        for _ in range(blocks):
+            await calco.submit(calco.error_function, data, out=out)
+
+    print(f"Processing {blocks * BLOCK_ELEMENTS * 8 / 2**30:.2f} GB with calco.error_function "
+          f"on {calco.get_num_threads()} threads")
+    print("-" * 50)
+    print(f"{'Mode':<12}{'Time (s)':>10}{'p99 late(ms)':>14}{'max late(ms)':>14}")
+    print("-" * 50)
+    asyncio.run(run("apply", blocking))
+    asyncio.run(run("submit", offloaded))
+    print("-" * 50)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,109 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+M = 1_000_000          # matrices per batch
+N_SCALAR = 20_000      # per-matrix Python loops are timed on a prefix and scaled up
+
+random.seed(0)
+
+def random_batch(n, m):
+    return array.array('d', [random.uniform(-1.0, 1.0) for _ in range(n * n * m)])
+
+def symmetric_batch(m):
+    a = random_batch(3, m)
+    for r in range(3):
+        for c in range(r):
+            a[(r * 3 + c) * m:(r * 3 + c + 1) * m] = a[(c * 3 + r) * m:(c * 3 + r + 1) * m]
+    return a
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    ref_ms = f"{t_ref * 1e3:>10.1f}" if t_ref else f"{'-':>10}"
+    speedup = f"{t_ref / t_calco:>9.1f}x" if t_ref else f"{'':>10}"
+    print(f"{label:<30}{ref_name:<14}{ref_ms}{t_calco * 1e3:>10.2f}{speedup}")
+
+def matrix(a, n, m, i):
+    return [[a[(r * n + c) * m + i] for c in range(n)] for r in range(n)]
+
+def solve_per_call(A, b):
+    # Gaussian elimination with partial pivoting through scalar calco calls, one system at a time.
+    n = len(b)
+    A = [row[:] + [b[r]] for r, row in enumerate(A)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(A[r][c]))
+        A[c], A[p] = A[p], A[c]
+        for r in range(c + 1, n):
+            f = calco.divide(A[r][c], A[c][c])
+            for j in range(c, n + 1):
+                A[r][j] = calco.subtract(A[r][j], calco.multiply(f, A[c][j]))
+    x = [0.0] * n
+    for r in range(n - 1, -1, -1):
+        s = A[r][n] - sum(A[r][j] * x[j] for j in range(r + 1, n))
+        x[r] = calco.divide(s, A[r][r])
+    return x
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    scale = M / N_SCALAR
+    print(f"{'Operation':<30}{'Reference':<14}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 74)
+    for n in (2, 3, 4):
+        a = random_batch(n, M)
+        b = array.array('d', [random.uniform(-1.0, 1.0) for _ in range(n * M)])
+        t_ref, ref = timed(lambda: [solve_per_call(matrix(a, n, M, i), [b[r * M + i] for r in range(n)])
+                                    for i in range(N_SCALAR)], repeat=1)
+        t_c, (x, flags) = timed(lambda: calco.batch_solve(a, b, n))
+        assert max(abs(x[r * M + i] - ref[i][r]) for i in range(0, N_SCALAR, 97) for r in range(n)) < 1e-6
+        row(f"batch_solve {n}x{n}, {M:,}", t_ref * scale, t_c, "per-call*")
+        if numpy is not None:
+            na = numpy.frombuffer(a).reshape(n, n, M).transpose(2, 0, 1).copy()
+            nb = numpy.frombuffer(b).reshape(n, M).T.copy()[..., None]
+            t_ref, _ = timed(lambda: numpy.linalg.solve(na, nb))
+            row("", t_ref, t_c, "numpy solve")
+        t_c, _ = timed(lambda: calco.batch_det(a, n))
+        row(f"batch_det {n}x{n}", 0.0, t_c, "")
+        t_c, _ = timed(lambda: calco.batch_inv(a, n))
+        row(f"batch_inv {n}x{n}", 0.0, t_c, "")
+        t_c, _ = timed(lambda: calco.batch_matmul(a, a, n))
+        row(f"batch_matmul {n}x{n}", 0.0, t_c, "")
+
+    s = symmetric_batch(M)
+    for method in ('jacobi', 'analytic'):
+        t_c, _ = timed(lambda: calco.batch_eigh3(s, method=method))
+        row(f"batch_eigh3 {method}", 0.0, t_c, "")
+    if numpy is not None:
+        ns = numpy.frombuffer(s).reshape(3, 3, M).transpose(2, 0, 1).copy()
+        t_ref, _ = timed(lambda: numpy.linalg.eigh(ns))
+        row("", t_ref, t_c, "numpy eigh")
+    print("-" * 74)
+    print(f"* per-matrix Python loop timed on {N_SCALAR:,} systems and scaled to {M:,}")
+    if numpy is None:
+        print("NumPy is not installed; its rows are skipped")
+    print(f"worker threads: {calco.get_num_threads()}")
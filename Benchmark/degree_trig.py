@@ -0,0 +1,75 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+N = 2_000_000
+N_LOOP = 200_000       # per-element Python loops are timed on a prefix and scaled up
+
+random.seed(0)
+degrees = array.array('d', [random.uniform(-720.0, 720.0) for _ in range(N)])
+radians = array.array('d', [random.uniform(-1e5, 1e5) for _ in range(N)])
+huge = array.array('d', [random.uniform(1e6, 1e22) for _ in range(N)])   # Payne-Hanek range
+unit = array.array('d', [random.uniform(-1.0, 1.0) for _ in range(N)])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<18}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def loop_scaled(func, data):
+    t, _ = timed(lambda: [func(v) for v in data[:N_LOOP]], repeat=1)
+    return t * (N / N_LOOP)
+
+def two_pass_sine(buf):
+    tmp = calco.apply(calco.degrees_to_radians, buf)
+    return calco.apply(calco.sine, tmp, out=tmp)
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Operation (' + format(N, ',') + ' values)':<34}{'Reference':<18}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 82)
+
+    t_ref, _ = timed(lambda: two_pass_sine(degrees))
+    t_c, _ = timed(lambda: calco.sind(degrees))
+    row("sin of degrees", t_ref, t_c, "radians+apply")
+    row("", loop_scaled(lambda v: math.sin(math.radians(v)), degrees), t_c, "math loop*")
+    t_c, _ = timed(lambda: calco.tand(degrees))
+    row("tan of degrees", loop_scaled(lambda v: math.tan(math.radians(v)), degrees), t_c, "math loop*")
+    t_c, _ = timed(lambda: calco.asind(unit))
+    row("asin in degrees", loop_scaled(lambda v: math.degrees(math.asin(v)), unit), t_c, "math loop*")
+
+    t_c, _ = timed(lambda: calco.apply(calco.sine, radians))
+    row("apply(sine), |x| < 1e5", loop_scaled(math.sin, radians), t_c, "math loop*")
+    t_c, out = timed(lambda: calco.apply(calco.sine, huge))
+    row("apply(sine), 1e6 < x < 1e22", loop_scaled(math.sin, huge), t_c, "math loop*")
+    err = max(abs(out[i] - math.sin(huge[i])) for i in range(0, N, 97))
+    print(f"{'':<4}max |error| vs libm on huge arguments: {err:.1e}")
+    t_c, _ = timed(lambda: calco.apply(calco.tangent, radians))
+    row("apply(tangent)", loop_scaled(math.tan, radians), t_c, "math loop*")
+    print("-" * 82)
+    print(f"exact values: sind(180) = {calco.sind(180.0)}, cosd(90) = {calco.cosd(90.0)}, "
+          f"tand(45) = {calco.tand(45.0)}, asind(0.5) = {calco.asind(0.5)}")
+    print(f"  vs math:    {math.sin(math.radians(180.0))}, {math.cos(math.radians(90.0))}, "
+          f"{math.tan(math.radians(45.0))}, {math.degrees(math.asin(0.5))}")
+    print(f"* one value at a time, timed on {N_LOOP:,} values and scaled to {N:,}")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,88 @@
+import array
+import math
+import random
+import time
+from decimal import Decimal, getcontext
+
+import calco
+
+try:
+    import mpmath
+    mpmath.mp.dps = 30
+except ImportError:
+    mpmath = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+SCALAR_REPEAT = 20_000
+COUNT = 1_000_000
+
+random.seed(0)
+x = 1.2345678901234567
+values = array.array('d', [random.uniform(0.1, 10.0) for _ in range(COUNT)])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=1):
+    start = time.perf_counter()
+    for _ in range(repeat):
+        result = func()
+    return (time.perf_counter() - start) / repeat, result
+
+def scalar_expr_dd():
+    a = calco.dd(x)
+    return (a.exp() * a.log() + a.sin() / a.cos()).sqrt()
+
+def scalar_expr_mpmath():
+    a = mpmath.mpf(x)
+    return mpmath.sqrt(mpmath.exp(a) * mpmath.log(a) + mpmath.sin(a) / mpmath.cos(a))
+
+def scalar_expr_double():
+    return math.sqrt(math.exp(x) * math.log(x) + math.sin(x) / math.cos(x))
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"Scalar expression sqrt(exp(x) log(x) + sin(x) / cos(x)), {SCALAR_REPEAT:,} evaluations")
+    print("-" * 60)
+    print(f"{'Library':<28}{'Time (us)':>12}   Digits")
+    print("-" * 60)
+    t, r = timed(scalar_expr_double, SCALAR_REPEAT)
+    print(f"{'math (double)':<28}{t * 1e6:>12.3f}   {r!r}")
+    t, r = timed(scalar_expr_dd, SCALAR_REPEAT)
+    print(f"{'calco.dd':<28}{t * 1e6:>12.3f}   {r}")
+    if mpmath:
+        t, r = timed(scalar_expr_mpmath, SCALAR_REPEAT)
+        print(f"{'mpmath (dps=30)':<28}{t * 1e6:>12.3f}   {r}")
+    print("-" * 60)
+
+    print(f"\n{COUNT:,}-element buffers")
+    print("-" * 60)
+    print(f"{'Kernel':<28}{'Time (s)':>12}{'vs double':>12}")
+    print("-" * 60)
+    pairs = [
+        ("mul", None, lambda: calco.dd_mul(values, values)),
+        ("div", None, lambda: calco.dd_div(values, (values, values))),
+        ("sqrt", lambda: calco.apply('square_root', values), lambda: calco.dd_sqrt(values)),
+        ("exp", lambda: calco.apply('exponential', values), lambda: calco.dd_exp(values)),
+        ("log", lambda: calco.apply('natural_log', values), lambda: calco.dd_log(values)),
+        ("sin", lambda: calco.apply('sine', values), lambda: calco.dd_sin(values)),
+    ]
+    for label, double_fn, dd_fn in pairs:
+        t_dd, _ = timed(dd_fn)
+        if double_fn is not None:
+            t_d, _ = timed(double_fn)
+            print(f"{'dd_' + label:<28}{t_dd:>12.4f}{t_dd / t_d:>11.1f}x")
+        else:
+            print(f"{'dd_' + label:<28}{t_dd:>12.4f}{'':>12}")
+    t, s = timed(lambda: calco.dd_sum(values))
+    getcontext().prec = 40
+    exact = sum(Decimal(v) for v in values)
+    print(f"{'dd_sum':<28}{t:>12.4f}   error {float(abs(Decimal(s.hi) + Decimal(s.lo) - exact)):.1e}")
+    print("-" * 60)
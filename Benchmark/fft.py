@@ -0,0 +1,97 @@
+import array
+import cmath
+import math
+import random
+import time
+
+import calco
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+SIZES = [(1 << 10, 512), (1 << 16, 8), (1 << 20, 1), (1000, 512), (100_003, 2)]  # (points, rows)
+PY_LIMIT = 1 << 12     # the pure-Python reference is only timed up to this many points per row
+
+random.seed(0)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<14}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def fft_python(z):
+    # Recursive radix-2 with twiddles from calco.sine/calco.cosine per element, as done before
+    # handing data to another library; other sizes fall back to a direct DFT.
+    n = len(z)
+    if n == 1:
+        return z
+    if n % 2:
+        return [sum(z[j] * cmath.exp(-2j * math.pi * j * k / n) for j in range(n)) for k in range(n)]
+    even, odd = fft_python(z[0::2]), fft_python(z[1::2])
+    out = [0j] * n
+    for k in range(n // 2):
+        a = -2.0 * math.pi * k / n
+        t = complex(calco.cosine(a), calco.sine(a)) * odd[k]
+        out[k], out[k + n // 2] = even[k] + t, even[k] - t
+    return out
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    ref_name = "numpy.fft" if np is not None else "Python*"
+    print(f"{'Transform':<34}{'Reference':<14}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 78)
+    for n, rows in SIZES:
+        data = array.array('d', [random.gauss(0.0, 1.0) for _ in range(2 * n * rows)])
+        real = array.array('d', data[:n * rows])
+        data32 = array.array('f', data)
+        calco.fft(data, n)  # build and cache the plan
+        t_c, spec = timed(lambda: calco.fft(data, n))
+        t_r, _ = timed(lambda: calco.rfft(real, n))
+        t_32, _ = timed(lambda: calco.fft(data32, n))
+        if np is not None:
+            z = np.frombuffer(data, dtype=np.complex128).reshape(rows, n)
+            x = np.frombuffer(real, dtype=np.float64).reshape(rows, n)
+            t_ref, ref = timed(lambda: np.fft.fft(z, axis=1))
+            t_rref, _ = timed(lambda: np.fft.rfft(x, axis=1))
+            err = np.max(np.abs(np.frombuffer(spec, dtype=np.complex128).reshape(rows, n) - ref))
+        elif n <= PY_LIMIT:
+            z = [complex(data[2 * i], data[2 * i + 1]) for i in range(n)]
+            t_ref, ref = timed(lambda: fft_python(z), repeat=1)
+            t_ref *= rows
+            t_rref = t_ref
+            err = max(abs(complex(spec[2 * k], spec[2 * k + 1]) - ref[k]) for k in range(n))
+        else:
+            t_ref = t_rref = err = None
+        kind = "pow2" if n & (n - 1) == 0 else "Bluestein"
+        label = f"fft {n:,} x {rows} ({kind})"
+        if t_ref is None:
+            print(f"{label:<34}{'-':<14}{'-':>10}{t_c * 1e3:>10.1f}")
+            print(f"{'rfft':<34}{'-':<14}{'-':>10}{t_r * 1e3:>10.1f}")
+        else:
+            row(label, t_ref, t_c, ref_name)
+            row("rfft", t_rref, t_r, ref_name)
+            print(f"{'':<4}max |error| vs reference: {err:.1e}")
+        print(f"{'fft, float32 in/out':<34}{'':<14}{'':>10}{t_32 * 1e3:>10.1f}")
+    print("-" * 78)
+    if np is None:
+        print("* numpy not installed: recursive Python FFT with calco.sine/cosine twiddles, per row")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,118 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+try:
+    from scipy.optimize import brentq
+except ImportError:
+    brentq = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+N = 200_000
+N_LOOP = 5_000         # one-equation-at-a-time loops are timed on a prefix and scaled up
+ECC = 0.7              # Kepler eccentricity
+
+random.seed(0)
+levels = array.array('d', [random.uniform(-0.999, 0.999) for _ in range(N)])
+mean_anomaly = array.array('d', [random.uniform(0.0, 2.0 * math.pi) for _ in range(N)])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<14}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def brent_python(f, a, b, xtol=2e-12, rtol=8.9e-16, maxiter=100):
+    # The Python-level Brent loop (SciPy's brentq step rules) run one equation at a time.
+    fa, fb = f(a), f(b)
+    if fa == 0.0:
+        return a
+    if fb == 0.0:
+        return b
+    xpre, xcur, fpre, fcur = a, b, fa, fb
+    xblk = fblk = spre = scur = 0.0
+    for _ in range(maxiter):
+        if fpre * fcur < 0.0:
+            xblk, fblk = xpre, fpre
+            spre = scur = xcur - xpre
+        if abs(fblk) < abs(fcur):
+            xpre, xcur, xblk = xcur, xblk, xcur
+            fpre, fcur, fblk = fcur, fblk, fcur
+        delta = (xtol + rtol * abs(xcur)) / 2
+        sbis = (xblk - xcur) / 2
+        if fcur == 0.0 or abs(sbis) < delta:
+            return xcur
+        if abs(spre) > delta and abs(fcur) < abs(fpre):
+            if xpre == xblk:
+                stry = -fcur * (xcur - xpre) / (fcur - fpre)
+            else:
+                dpre = (fpre - fcur) / (xpre - xcur)
+                dblk = (fblk - fcur) / (xblk - xcur)
+                stry = -fcur * (fblk * dblk - fpre * dpre) / (dblk * dpre * (fblk - fpre))
+            if 2 * abs(stry) < min(abs(spre), 3 * abs(sbis) - delta):
+                spre, scur = scur, stry
+            else:
+                spre = scur = sbis
+        else:
+            spre = scur = sbis
+        xpre, fpre = xcur, fcur
+        xcur += scur if abs(scur) > delta else (delta if sbis > 0 else -delta)
+        fcur = f(xcur)
+    return xcur
+
+solve_one = brentq if brentq is not None else brent_python
+REF_NAME = "brentq loop*" if brentq is not None else "Py Brent loop*"
+
+def kepler_vectorized(x):
+    return [v - ECC * math.sin(v) for v in x]
+
+def kepler_derivative(x):
+    return [1.0 - ECC * math.cos(v) for v in x]
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    scale = N / N_LOOP
+    print(f"{'Operation (' + format(N, ',') + ' equations)':<34}{'Reference':<14}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 78)
+
+    t_ref, ref = timed(lambda: [solve_one(lambda x, y=levels[i]: calco.error_function(x) - y, -10.0, 10.0)
+                                for i in range(N_LOOP)], repeat=1)
+    t_ref *= scale
+    for method in ('brent', 'newton', 'bisect'):
+        t_c, (roots, iters, status) = timed(lambda: calco.find_roots('error_function', -10.0, 10.0, target=levels,
+                                                                     method=method))
+        assert max(abs(roots[i] - ref[i]) for i in range(0, N_LOOP, 7)) < 1e-9 and not any(status)
+        row(f"inverse erf, {method}", t_ref, t_c, REF_NAME)
+
+    t_ref, ref = timed(lambda: [solve_one(lambda x, m=mean_anomaly[i]: calco.subtract(
+                                    x, calco.multiply(ECC, calco.sine(x))) - m, 0.0, 2.0 * math.pi)
+                                for i in range(N_LOOP)], repeat=1)
+    t_ref *= scale
+    for method in ('brent', 'newton'):
+        t_c, ((roots, iters, status), info) = timed(lambda: calco.find_roots(
+            kepler_vectorized, 0.0, 2.0 * math.pi, target=mean_anomaly, method=method, fprime=kepler_derivative,
+            full_output=True), repeat=1)
+        assert max(abs(roots[i] - ref[i]) for i in range(0, N_LOOP, 7)) < 1e-9 and not any(status)
+        row(f"Kepler (Python f), {method}", t_ref, t_c, REF_NAME)
+        print(f"{'':<4}{max(iters)} iterations at most, {info['nfev'] / N:.1f} evaluations per equation")
+    print("-" * 78)
+    print(f"* one equation at a time, timed on {N_LOOP:,} equations and scaled to {N:,}")
+    print(f"worker threads: {calco.get_num_threads()}")
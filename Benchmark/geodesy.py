@@ -0,0 +1,86 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+N = 1_000_000
+N_SCALAR = 100_000     # per-point Python loops are timed on a prefix and scaled up
+
+random.seed(0)
+lat1 = array.array('d', [random.uniform(-89.0, 89.0) for _ in range(N)])
+lon1 = array.array('d', [random.uniform(-180.0, 180.0) for _ in range(N)])
+lat2 = array.array('d', [random.uniform(-89.0, 89.0) for _ in range(N)])
+lon2 = array.array('d', [random.uniform(-180.0, 180.0) for _ in range(N)])
+radius = array.array('d', [random.uniform(1.0, 2.0) for _ in range(N)])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<30}{ref_name:<14}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.2f}{t_ref / t_calco:>9.1f}x")
+
+def haversine_per_call(la1, lo1, la2, lo2, r=6371008.8):
+    # The chain of scalar calls a caller would write without the fused kernel.
+    p1 = calco.degrees_to_radians(la1)
+    p2 = calco.degrees_to_radians(la2)
+    dp = calco.degrees_to_radians(la2 - la1) / 2
+    dl = calco.degrees_to_radians(lo2 - lo1) / 2
+    a = calco.sine(dp) ** 2 + calco.cosine(p1) * calco.cosine(p2) * calco.sine(dl) ** 2
+    return 2 * r * math.asin(min(1.0, calco.square_root(a)))
+
+def to_cartesian_per_call(r, lat, lon):
+    p = calco.degrees_to_radians(lat)
+    l = calco.degrees_to_radians(lon)
+    c = calco.cosine(p)
+    return r * c * calco.cosine(l), r * c * calco.sine(l), r * calco.sine(p)
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    scale = N / N_SCALAR
+    print(f"{'Operation':<30}{'Reference':<14}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 74)
+
+    t_ref, ref = timed(lambda: [haversine_per_call(lat1[i], lon1[i], lat2[i], lon2[i]) for i in range(N_SCALAR)],
+                       repeat=1)
+    t_c, got = timed(lambda: calco.haversine(lat1, lon1, lat2, lon2))
+    assert max(abs(a - b) for a, b in zip(got, ref)) < 1e-6
+    row(f"haversine, {N:,} pairs", t_ref * scale, t_c, "per-call*")
+
+    t_ref, ref = timed(lambda: [to_cartesian_per_call(radius[i], lat1[i], lon1[i]) for i in range(N_SCALAR)],
+                       repeat=1)
+    t_c, (x, y, z) = timed(lambda: calco.spherical_to_cartesian(radius, lat1, lon1))
+    assert max(abs(a[0] - b) for a, b in zip(ref, x)) < 1e-12
+    row(f"spherical_to_cartesian", t_ref * scale, t_c, "per-call*")
+
+    t_ref, _ = timed(lambda: [math.atan2(y[i], x[i]) for i in range(N_SCALAR)], repeat=1)
+    t_c, _ = timed(lambda: calco.cartesian_to_spherical(x, y, z))
+    row(f"cartesian_to_spherical", t_ref * scale, t_c, "atan2 only*")
+
+    t_c, _ = timed(lambda: calco.bearing(lat1, lon1, lat2, lon2))
+    row(f"bearing", t_ref * scale, t_c, "atan2 only*")
+
+    n_vincenty = N // 10
+    t_c, _ = timed(lambda: calco.vincenty(lat1[:n_vincenty], lon1[:n_vincenty], lat2[:n_vincenty],
+                                          lon2[:n_vincenty]), repeat=1)
+    print(f"{f'vincenty, {n_vincenty:,} pairs':<30}{'':<14}{'':>10}{t_c * 1e3:>10.2f}")
+    print("-" * 74)
+    print(f"* per-point Python loop timed on {N_SCALAR:,} points and scaled to {N:,}")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,100 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+try:
+    import numpy
+    from scipy.spatial import distance
+except ImportError:
+    numpy = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+DIM = 16
+N_PAIRWISE = 2000      # pdist: about 2 million pairs
+N_DATA = 20000
+N_QUERIES = 500
+K = 10
+N_ROWWISE = 1_000_000
+
+random.seed(0)
+points = array.array('d', [random.gauss(0.0, 1.0) for _ in range(N_PAIRWISE * DIM)])
+data = array.array('d', [random.gauss(0.0, 1.0) for _ in range(N_DATA * DIM)])
+queries = array.array('d', [random.gauss(0.0, 1.0) for _ in range(N_QUERIES * DIM)])
+xs = array.array('d', [random.uniform(-1e3, 1e3) for _ in range(N_ROWWISE)])
+ys = array.array('d', [random.uniform(-1e3, 1e3) for _ in range(N_ROWWISE)])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def rows(buf, dim):
+    return [buf[i:i + dim] for i in range(0, len(buf), dim)]
+
+def row(label, t_ref, t_calco, ref_name):
+    speedup = f"{t_ref / t_calco:>9.1f}x" if t_ref else f"{'':>10}"
+    print(f"{label:<30}{ref_name:<14}{t_ref * 1e3 if t_ref else float('nan'):>10.1f}{t_calco * 1e3:>10.2f}{speedup}")
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Operation':<30}{'Reference':<14}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 74)
+
+    # 2-D distances: hypotenuse per pair versus one call over SoA buffers.
+    t_ref, ref = timed(lambda: [calco.hypotenuse(x, y) for x, y in zip(xs, ys)], repeat=1)
+    t_c, got = timed(lambda: calco.norms((xs, ys)))
+    assert max(abs(a - b) for a, b in zip(got, ref)) < 1e-9
+    row(f"norms, {N_ROWWISE:,} 2-D points", t_ref, t_c, "hypotenuse")
+    t_c, _ = timed(lambda: calco.norms((xs, ys), metric='cityblock'))
+    row(f"norms, cityblock", 0.0, t_c, "")
+
+    pts = rows(points, DIM)
+    sample = pts[:400]
+    t_ref, _ = timed(lambda: [math.dist(p, q) for i, p in enumerate(sample) for q in sample[i + 1:]], repeat=1)
+    t_ref *= (N_PAIRWISE * (N_PAIRWISE - 1)) / (len(sample) * (len(sample) - 1))
+    t_c, got = timed(lambda: calco.pdist(points, DIM))
+    assert abs(got[1] - math.dist(pts[0], pts[2])) < 1e-12
+    row(f"pdist, {N_PAIRWISE} x {DIM}-D", t_ref, t_c, "math.dist*")
+    if numpy is not None:
+        arr = numpy.frombuffer(points).reshape(N_PAIRWISE, DIM)
+        t_ref, _ = timed(lambda: distance.pdist(arr))
+        row("", t_ref, t_c, "scipy pdist")
+
+    t_c, got = timed(lambda: calco.cdist(queries, data, DIM))
+    row(f"cdist, {N_QUERIES} x {N_DATA}", 0.0, t_c, "")
+    if numpy is not None:
+        qa = numpy.frombuffer(queries).reshape(N_QUERIES, DIM)
+        da = numpy.frombuffer(data).reshape(N_DATA, DIM)
+        t_ref, _ = timed(lambda: distance.cdist(qa, da))
+        row("", t_ref, t_c, "scipy cdist")
+
+    t_c, (idx, dist) = timed(lambda: calco.knn(data, queries, K, DIM))
+    drows = rows(data, DIM)
+    q0 = queries[:DIM]
+    assert list(idx[:K]) == sorted(range(N_DATA), key=lambda j: math.dist(q0, drows[j]))[:K]
+    row(f"knn, k={K}, {N_QUERIES} queries", 0.0, t_c, "")
+    if numpy is not None:
+        from scipy.spatial import cKDTree
+        t_ref, _ = timed(lambda: cKDTree(da).query(qa, K))
+        row("", t_ref, t_c, "cKDTree")
+    print("-" * 74)
+    print("* math.dist time extrapolated from the first 400 points")
+    if numpy is None:
+        print("SciPy is not installed; its rows are skipped")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,55 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+COUNT = 500_000
+
+random.seed(0)
+ns = array.array('q', [random.randrange(0, 60) for _ in range(COUNT)])
+ks = array.array('q', [random.randrange(0, 30) for _ in range(COUNT)])
+big = array.array('q', [random.getrandbits(62) for _ in range(COUNT)])
+big2 = array.array('q', [random.getrandbits(62) for _ in range(COUNT)])
+mods = array.array('q', [random.getrandbits(61) | 1 for _ in range(COUNT)])
+small_ks = array.array('q', [k % 8 for k in ks])
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func):
+    start = time.perf_counter()
+    result = func()
+    return time.perf_counter() - start, result
+
+def compare(label, python_fn, calco_fn):
+    t_py, ref = timed(python_fn)
+    t_c, got = timed(calco_fn)
+    assert list(got) == list(ref), label
+    print(f"{label:<22}{t_py:>12.4f}{t_c:>12.4f}{t_py / t_c:>10.1f}x")
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{COUNT:,} elements")
+    print("-" * 56)
+    print(f"{'Operation':<22}{'Python (s)':>12}{'calco (s)':>12}{'Speedup':>10}")
+    print("-" * 56)
+    compare("comb", lambda: [math.comb(n, k) for n, k in zip(ns, ks)], lambda: calco.comb(ns, ks))
+    compare("perm", lambda: [math.perm(n, k) for n, k in zip(ns, small_ks)], lambda: calco.perm(ns, small_ks))
+    compare("gcd", lambda: [math.gcd(a, b) for a, b in zip(big, big2)], lambda: calco.gcd(big, big2))
+    compare("isqrt", lambda: [math.isqrt(a) for a in big], lambda: calco.isqrt(big))
+    compare("powmod", lambda: [pow(a, b, m) for a, b, m in zip(big, big2, mods)], lambda: calco.powmod(big, big2, mods))
+    t_py, ref = timed(lambda: [math.log(math.comb(n, k)) if k <= n else -math.inf for n, k in zip(ns, ks)])
+    t_c, got = timed(lambda: calco.log_comb(ns, ks))
+    assert max(abs(a - b) for a, b in zip(got, ref) if b != -math.inf) < 1e-12
+    print(f"{'log_comb':<22}{t_py:>12.4f}{t_c:>12.4f}{t_py / t_c:>10.1f}x")
+    print("-" * 56)
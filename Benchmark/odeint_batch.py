@@ -0,0 +1,110 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+try:
+    from scipy.integrate import solve_ivp
+except ImportError:
+    solve_ivp = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+M = 10_000             # trajectories per batch
+M_LOOP = 100           # per-trajectory loops are timed on a prefix and scaled up
+T_SPAN = (0.0, 20.0)
+RTOL, ATOL = 1e-6, 1e-9
+
+random.seed(0)
+# Damped, driven Duffing oscillators: x'' + d x' + a x + b x^3 = g cos(w t), one (d, g) per trajectory.
+damping = [random.uniform(0.05, 0.3) for _ in range(M)]
+drive = [random.uniform(0.1, 0.5) for _ in range(M)]
+y0 = array.array('d', [random.uniform(-1.0, 1.0) for _ in range(2 * M)])
+params = array.array('d', damping + drive)
+
+DUFFING = [
+    'y1',
+    ('-', ('*', 'p1', ('cosine', ('*', 1.2, 't'))),
+          ('+', ('*', 'p0', 'y1'), ('-', ('**', 'y0', 3), 'y0'))),
+]
+
+def duffing_vectorized(t, y, p):
+    # The same system as a vectorized Python callback: one call per stage for the whole batch.
+    n = len(t)
+    x, v, d, g = y[:n], y[n:], p[:n], p[n:]
+    return list(v) + [g[i] * math.cos(1.2 * t[i]) - d[i] * v[i] + x[i] - x[i] ** 3 for i in range(n)]
+
+def duffing_per_call(t, s, d, g):
+    # Right-hand side of one trajectory through scalar calco calls, as a per-trajectory loop does it.
+    x, v = s
+    force = calco.multiply(g, calco.cosine(calco.multiply(1.2, t)))
+    return [v, calco.subtract(force, calco.add(calco.multiply(d, v), calco.subtract(calco.power(x, 3), x)))]
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<16}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def loop_solve_ivp(count):
+    return [solve_ivp(lambda t, s, d=damping[i], g=drive[i]: duffing_per_call(t, s, d, g), T_SPAN,
+                      [y0[i], y0[M + i]], method='RK45', rtol=RTOL, atol=ATOL).y[:, -1]
+            for i in range(count)]
+
+def loop_odeint(count):
+    # Without SciPy: the same DOPRI5 integration, one trajectory per odeint_batch call.
+    out = []
+    for i in range(count):
+        f = lambda t, y, p: duffing_per_call(t[0], y, p[0], p[1])
+        out.append(calco.odeint_batch(f, array.array('d', [y0[i], y0[M + i]]), T_SPAN, 2, rtol=RTOL, atol=ATOL,
+                                      params=array.array('d', [damping[i], drive[i]])))
+    return out
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    scale = M / M_LOOP
+    if solve_ivp is not None:
+        t_ref, _ = timed(lambda: loop_solve_ivp(M_LOOP), repeat=1)
+        ref_name = "solve_ivp loop*"
+    else:
+        t_ref, _ = timed(lambda: loop_odeint(M_LOOP), repeat=1)
+        ref_name = "per-traj loop*"
+    t_ref *= scale
+    print(f"{'Duffing, ' + format(M, ',') + ' trajectories':<34}{'Reference':<16}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 80)
+    t_py, y_py = timed(lambda: calco.odeint_batch(duffing_vectorized, y0, T_SPAN, 2, rtol=RTOL, atol=ATOL,
+                                                  params=params), repeat=1)
+    row("odeint_batch, Python rhs", t_ref, t_py, ref_name)
+    t_c, (y_c, info) = timed(lambda: calco.odeint_batch(DUFFING, y0, T_SPAN, 2, rtol=RTOL, atol=ATOL,
+                                                        params=params, full_output=True))
+    row("odeint_batch, compiled rhs", t_ref, t_c, ref_name)
+    t_eval = array.array('d', [T_SPAN[1] * k / 200 for k in range(201)])
+    t_d, _ = timed(lambda: calco.odeint_batch(DUFFING, y0, T_SPAN, 2, rtol=RTOL, atol=ATOL, params=params,
+                                              t_eval=t_eval))
+    row("  + dense output at 201 times", t_ref, t_d, ref_name)
+    t_4, _ = timed(lambda: calco.odeint_batch(DUFFING, y0, T_SPAN, 2, method='rk4', h=0.01, params=params))
+    row("odeint_batch rk4, h = 0.01", t_ref, t_4, ref_name)
+    print("-" * 80)
+    print(f"* timed on {M_LOOP} trajectories and scaled to {M:,}")
+    if solve_ivp is None:
+        print("SciPy is not installed; the reference is odeint_batch called once per trajectory")
+    drift = max(abs(a - b) for a, b in zip(y_py, y_c))
+    print(f"compiled vs Python rhs: max difference {drift:.2e}; {info['naccept'] / M:.0f} steps and "
+          f"{info['nreject'] / M:.1f} rejections per trajectory")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,58 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+COUNT = 1_000_000
+EXPONENTS = [2.0, 3.0, -1.0, 0.5, -0.5, 1.5, 1 / 3, 0.75, 7.0, 2.2]
+
+random.seed(0)
+values = [random.uniform(0.01, 100.0) for _ in range(COUNT)]
+xs = array.array('d', values)
+out = array.array('d', bytes(8 * COUNT))
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    return best
+
+def max_ulps(got, ref):
+    return max(abs(a - b) / math.ulp(b) for a, b in zip(got, ref))
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    # The pow() column runs the same kernel with the next representable exponent, which is
+    # never specialized, so the difference is the cost of calling pow() per element.
+    print(f"{COUNT:,} elements, time per call (ms)")
+    print("-" * 78)
+    print(f"{'Exponent':<12}{'Kind':<10}{'Python **':>12}{'pow()':>10}{'power_by':>10}{'vs pow':>10}{'max ulp':>10}")
+    print("-" * 78)
+    for y in EXPONENTS:
+        kernel = calco.power_by(y)
+        generic = calco.power_by(math.nextafter(y, math.inf))
+        t_py = timed(lambda: [v ** y for v in values], repeat=1)
+        t_pow = timed(lambda: generic(xs, out=out))
+        t_fast = timed(lambda: kernel(xs, out=out))
+        ulps = max_ulps(kernel(xs)[:20000], [math.pow(v, y) for v in values[:20000]])
+        print(f"{y:<12.6g}{kernel.kind:<10}{t_py * 1e3:>12.1f}{t_pow * 1e3:>10.2f}{t_fast * 1e3:>10.2f}"
+              f"{t_pow / t_fast:>9.1f}x{ulps:>10.0f}")
+    print("-" * 78)
+    t_math = timed(lambda: [math.pow(v, 2.0) for v in values], repeat=1)
+    t_calco = timed(lambda: [calco.power(v, 2.0) for v in values], repeat=1)
+    print(f"scalar power(x, 2.0): math.pow {t_math * 1e3:.1f} ms, calco.power {t_calco * 1e3:.1f} ms")
@@ -0,0 +1,79 @@
+import math
+import multiprocessing
+import random
+import struct
+import time
+from multiprocessing import shared_memory
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+SIZES = [4_096, 65_536, 1_048_576]
+PROCESSES = max(multiprocessing.cpu_count(), 2)
+CHUNK = 65_536
+
+random.seed(0)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<18}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def sine_list(chunk):
+    return [math.sin(v) for v in chunk]
+
+def pickled_map(mp_pool, values):
+    chunks = [values[i:i + CHUNK] for i in range(0, len(values), CHUNK)]
+    def run():
+        out = []
+        for part in mp_pool.map(sine_list, chunks):
+            out.extend(part)
+        return out
+    return run
+
+def shared_apply(pool, shm, out):
+    def run():
+        return pool.apply(calco.sine, shm, out, chunk=CHUNK)
+    return run
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    start = time.perf_counter()
+    pool = calco.procpool.Pool(PROCESSES)
+    t_start = time.perf_counter() - start
+    with multiprocessing.Pool(PROCESSES) as mp_pool:
+        print(f"{'Elementwise sine':<34}{'Reference':<18}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+        print("-" * 82)
+        for n in SIZES:
+            values = [random.uniform(-10.0, 10.0) for _ in range(n)]
+            shm = shared_memory.SharedMemory(create=True, size=8 * n)
+            out = shared_memory.SharedMemory(create=True, size=8 * n)
+            try:
+                struct.pack_into(f"{n}d", shm.buf, 0, *values)
+                t_ref, ref = timed(pickled_map(mp_pool, values))
+                t_c, _ = timed(shared_apply(pool, shm, out))
+                got = struct.unpack_from(f"{n}d", out.buf, 0)
+                err = max(abs(a - b) for a, b in zip(got, ref))
+                row(f"sine, {n:,} (max err {err:.0e})", t_ref, t_c, "Pool.map pickled")
+            finally:
+                shm.close(); shm.unlink()
+                out.close(); out.unlink()
+        print("-" * 82)
+    pool.close()
+    print(f"procpool startup: {t_start * 1e3:.1f} ms for {PROCESSES} processes; chunks of {CHUNK:,} elements")
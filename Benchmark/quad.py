@@ -0,0 +1,111 @@
+import array
+import math
+import time
+
+import calco
+
+try:
+    from scipy import integrate
+except ImportError:
+    integrate = None
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+SIMPSON_PANELS = 2000
+BATCH = 1000
+
+def smooth(x):
+    return math.exp(-x) * math.cos(3.0 * x)
+
+def smooth_batch(xs):
+    return array.array('d', [math.exp(-x) * math.cos(3.0 * x) for x in xs])
+
+def singular(x):
+    return math.log(x) / math.sqrt(x)
+
+def singular_batch(xs):
+    return array.array('d', [math.log(x) / math.sqrt(x) for x in xs])
+
+# Closed forms: int_0^4 e^-x cos 3x dx and int_0^1 log(x) / sqrt(x) dx.
+SMOOTH_EXACT = (1.0 - math.exp(-4.0) * (math.cos(12.0) - 3.0 * math.sin(12.0))) / 10.0
+SINGULAR_EXACT = -4.0
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+class Counted:
+    def __init__(self, f):
+        self.f = f
+        self.calls = 0
+        self.nodes = 0
+
+    def __call__(self, x):
+        self.calls += 1
+        self.nodes += len(x) if not isinstance(x, float) else 1
+        return self.f(x)
+
+def simpson(f, a, b, panels):
+    h = (b - a) / panels
+    total = f(a) + f(b)
+    for i in range(1, panels):
+        total += (4.0 if i % 2 else 2.0) * f(a + i * h)
+    return total * h / 3.0
+
+def report(label, func, exact):
+    start = time.perf_counter()
+    value, calls, nodes = func()
+    elapsed = time.perf_counter() - start
+    print(f"{label:<34}{elapsed * 1e3:>10.3f}{calls:>8}{nodes:>8}{abs(value - exact):>12.1e}")
+
+def run_simpson(f, a, b):
+    c = Counted(f)
+    return simpson(c, a, b, SIMPSON_PANELS), c.calls, c.nodes
+
+def run_calco(f, a, b, **kwargs):
+    c = Counted(f)
+    value, _, info = calco.quad(c, a, b, full_output=True, **kwargs)
+    return value, info['ncalls'], info['neval']
+
+def run_scipy(f, a, b):
+    value, _, info = integrate.quad(f, a, b, full_output=1)
+    return value, info['neval'], info['neval']
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Method':<34}{'ms':>10}{'calls':>8}{'nodes':>8}{'abs err':>12}")
+    print("-" * 72)
+    print("e^-x cos 3x on [0, 4]")
+    report("  Python Simpson loop", lambda: run_simpson(smooth, 0.0, 4.0), SMOOTH_EXACT)
+    report("  calco.quad, per node", lambda: run_calco(smooth, 0.0, 4.0, vectorized=False), SMOOTH_EXACT)
+    report("  calco.quad, batched", lambda: run_calco(smooth_batch, 0.0, 4.0), SMOOTH_EXACT)
+    if integrate is not None:
+        report("  scipy.integrate.quad", lambda: run_scipy(smooth, 0.0, 4.0), SMOOTH_EXACT)
+    print("log(x) / sqrt(x) on [0, 1]")
+    report("  calco.quad gk21, batched", lambda: run_calco(singular_batch, 0.0, 1.0, limit=200), SINGULAR_EXACT)
+    report("  calco.quad tanh-sinh, batched",
+           lambda: run_calco(singular_batch, 0.0, 1.0, rule='tanh-sinh'), SINGULAR_EXACT)
+    if integrate is not None:
+        report("  scipy.integrate.quad", lambda: run_scipy(singular, 0.0, 1.0), SINGULAR_EXACT)
+    print("-" * 72)
+
+    # Many integrals of a calco kernel: no Python callback at all.
+    lo = array.array('d', [0.001 * i for i in range(BATCH)])
+    hi = array.array('d', [0.001 * i + 1.0 for i in range(BATCH)])
+    start = time.perf_counter()
+    values, errors, info = calco.quad("sine", lo, hi, full_output=True)
+    t_batch = time.perf_counter() - start
+    worst = max(abs(v - (math.cos(a) - math.cos(b))) for v, a, b in zip(values, lo, hi))
+    print(f"{BATCH} integrals of sine, one call: {t_batch * 1e3:.3f} ms, {info['neval']} nodes, max error {worst:.1e}")
+    if integrate is not None:
+        start = time.perf_counter()
+        for a, b in zip(lo, hi):
+            integrate.quad(math.sin, a, b)
+        print(f"{BATCH} scipy.integrate.quad calls: {(time.perf_counter() - start) * 1e3:.3f} ms")
+    else:
+        print("scipy is not installed; its rows are skipped")
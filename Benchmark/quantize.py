@@ -0,0 +1,78 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+N = 4_000_000
+N_LOOP = 200_000       # per-element Python loops are timed on a prefix and scaled up
+STEP, OFFSET = 1.0 / 64, 0.5
+
+random.seed(0)
+data = array.array('d', [random.gauss(0.0, 1.0) for _ in range(N)])
+data32 = array.array('f', data)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<18}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def loop_scaled(func, typecode):
+    def run():
+        return array.array(typecode, [func(v) for v in data[:N_LOOP]])
+    t, _ = timed(run, repeat=1)
+    return t * (N / N_LOOP)
+
+def half_even_int8(v):
+    # The usual per-value recipe: scale, round (ties to even), clamp into the int8 range.
+    return max(-128, min(127, round((v - OFFSET) / STEP)))
+
+def floor_int32(v):
+    return max(-2**31, min(2**31 - 1, math.floor((v - OFFSET) / STEP)))
+
+def stochastic_int16(v, rnd=random.random):
+    t = (v - OFFSET) / STEP
+    f = math.floor(t)
+    return max(-32768, min(32767, f + (rnd() < t - f)))
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Operation (' + format(N, ',') + ' values)':<34}{'Reference':<18}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 82)
+    t_ref = loop_scaled(half_even_int8, 'b')
+    t_c, q8 = timed(lambda: calco.quantize(data, STEP, offset=OFFSET, dtype='int8'))
+    row("half_even -> int8", t_ref, t_c, "Python loop*")
+    assert all(q8[i] == half_even_int8(data[i]) for i in range(N_LOOP))
+    t_c, _ = timed(lambda: calco.quantize(data32, STEP, offset=OFFSET, dtype='int8'))
+    row("half_even -> int8, float32 in", t_ref, t_c, "Python loop*")
+    t_c, _ = timed(lambda: calco.quantize(data, STEP, offset=OFFSET, mode='floor', dtype='int32'))
+    row("floor -> int32", loop_scaled(floor_int32, 'i'), t_c, "Python loop*")
+    t_c, _ = timed(lambda: calco.quantize(data, STEP, offset=OFFSET, mode='stochastic', dtype='int16', seed=1))
+    row("stochastic -> int16", loop_scaled(stochastic_int16, 'h'), t_c, "Python loop*")
+    t_ref = loop_scaled(lambda v: round(v / STEP), 'q')
+    t_c, q64 = timed(lambda: calco.quantize(data, STEP))
+    row("half_even -> int64", t_ref, t_c, "Python loop*")
+    t_ref, _ = timed(lambda: array.array('d', [v * STEP + OFFSET for v in q8]), repeat=1)
+    t_c, _ = timed(lambda: calco.dequantize(q8, STEP, offset=OFFSET))
+    row("dequantize int8 -> float64", t_ref, t_c, "Python loop")
+    print("-" * 82)
+    print(f"* one value at a time, timed on {N_LOOP:,} values and scaled to {N:,}")
+    print(f"worker threads: {calco.get_num_threads()}")
@@ -0,0 +1,76 @@
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+COUNT = 200_000
+
+random.seed(0)
+coeffs = [(random.uniform(0.5, 2.0), random.uniform(5.0, 10.0), random.uniform(0.5, 2.0))
+          for _ in range(COUNT)]
+
+# -----------------------------
+# Larger root of a*x^2 + b*x + c, three ways
+# -----------------------------
+
+def chained():
+    """Each step returns a new float object."""
+    out = 0.0
+    for a, b, c in coeffs:
+        d = calco.subtract(calco.multiply(b, b), calco.multiply(4.0, calco.multiply(a, c)))
+        out = calco.add(out, calco.divide(calco.subtract(calco.square_root(d), b), calco.multiply(2.0, a)))
+    return out
+
+def register():
+    """One Register reused across the whole loop; only .value allocates."""
+    out = calco.Register()
+    r = calco.Register()
+    for a, b, c in coeffs:
+        r.set(b).imul(b).isubmul(4.0 * a, c).sqrt_().isub(b).idiv(2.0 * a)
+        out.iadd(r)
+    return out.value
+
+def register_file():
+    """Same computation on a RegisterFile: r0 = a, r1 = b, r2 = c, r3 = result, r4 = -4, r5 = 0.5."""
+    out = calco.Register()
+    f = calco.RegisterFile(6)
+    f.load(4, -4.0).load(5, 0.5)
+    for a, b, c in coeffs:
+        f.load(0, a).load(1, b).load(2, c)
+        f.mul(3, 0, 2).mul(3, 3, 4).fma(3, 1, 1, 3).unary(3, 'square_root', 3)
+        f.sub(3, 3, 1).div(3, 3, 0).mul(3, 3, 5)
+        out.iadd(f[3])
+    return out.value
+
+def plain():
+    out = 0.0
+    for a, b, c in coeffs:
+        out += (math.sqrt(b * b - 4.0 * a * c) - b) / (2.0 * a)
+    return out
+
+def timed(func):
+    start = time.perf_counter()
+    result = func()
+    return time.perf_counter() - start, result
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{COUNT:,} quadratic roots")
+    print("-" * 50)
+    print(f"{'Style':<28}{'Time (s)':>10}{'Sum':>12}")
+    print("-" * 50)
+    for label, func in (("plain Python + math", plain),
+                        ("chained calco calls", chained),
+                        ("calco.Register", register),
+                        ("calco.RegisterFile", register_file)):
+        t, total = timed(func)
+        print(f"{label:<28}{t:>10.4f}{total:>12.4f}")
+    print("-" * 50)
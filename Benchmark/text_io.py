@@ -0,0 +1,68 @@
+import array
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+COUNT = 1_000_000
+CHUNK = 1 << 20  # Bytes per read when streaming
+
+random.seed(0)
+values = [random.uniform(-1e6, 1e6) for _ in range(COUNT // 2)] + \
+         [round(random.uniform(0, 100), 2) for _ in range(COUNT // 2)]
+text = ",".join(map(repr, values)).encode()
+buf = array.array('d', values)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func):
+    start = time.perf_counter()
+    result = func()
+    return time.perf_counter() - start, result
+
+def parse_streaming():
+    """Feeds the text in CHUNK-sized pieces, carrying the unfinished token over."""
+    out, carry = [], b""
+    view = memoryview(text)
+    for pos in range(0, len(view), CHUNK):
+        piece = carry + view[pos:pos + CHUNK].tobytes()
+        last = pos + CHUNK >= len(view)
+        if last:
+            out.append(calco.parse_floats(piece))
+        else:
+            parsed, used = calco.parse_floats(piece, partial=True)
+            out.append(parsed)
+            carry = piece[used:]
+    return out
+
+# -----------------------------
+# Main Execution
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{COUNT:,} numbers, {len(text) / 2**20:.1f} MB of text")
+    print("-" * 50)
+    print(f"{'Operation':<28}{'Time (s)':>10}")
+    print("-" * 50)
+
+    t, ref = timed(lambda: [float(tok) for tok in text.split(b",")])
+    print(f"{'float() per token':<28}{t:>10.4f}")
+    t, parsed = timed(lambda: calco.parse_floats(text))
+    assert list(parsed) == ref
+    print(f"{'calco.parse_floats':<28}{t:>10.4f}")
+    t, chunks = timed(parse_streaming)
+    assert sum(len(c) for c in chunks) == COUNT
+    print(f"{'calco.parse_floats (stream)':<28}{t:>10.4f}")
+
+    t, ref_text = timed(lambda: ",".join(map(repr, values)).encode())
+    print(f"{'repr() + join':<28}{t:>10.4f}")
+    t, formatted = timed(lambda: calco.format_floats(buf))
+    assert formatted == ref_text
+    print(f"{'calco.format_floats':<28}{t:>10.4f}")
+    print("-" * 50)
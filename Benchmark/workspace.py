@@ -0,0 +1,68 @@
+import array
+import math
+import random
+import time
+
+import calco
+
+# -----------------------------
+# Configuration
+# -----------------------------
+
+SIZES = [256, 4_096, 65_536, 1_048_576]
+CALLS = 2_000_000      # total elements per measurement: CALLS // n calls of n elements
+
+random.seed(0)
+
+# -----------------------------
+# Benchmarking Core
+# -----------------------------
+
+def timed(func, repeat=3):
+    best = math.inf
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = func()
+        best = min(best, time.perf_counter() - start)
+    return best, result
+
+def row(label, t_ref, t_calco, ref_name):
+    print(f"{label:<34}{ref_name:<18}{t_ref * 1e3:>10.1f}{t_calco * 1e3:>10.1f}{t_ref / t_calco:>9.1f}x")
+
+def repeat_fresh(func, x, calls):
+    def run():
+        for _ in range(calls):
+            func(x)
+    return run
+
+def repeat_pooled(func, x, calls, ws):
+    def run():
+        for _ in range(calls):
+            with func(x, workspace=ws):
+                pass
+    return run
+
+# -----------------------------
+# Main
+# -----------------------------
+
+if __name__ == '__main__':
+    print(f"{'Repeated call':<34}{'Reference':<18}{'ref ms':>10}{'calco ms':>10}{'Speedup':>10}")
+    print("-" * 82)
+    for n in SIZES:
+        x = array.array('d', [random.gauss(0.0, 3.0) for _ in range(n)])
+        calls = max(CALLS // n, 20)
+        ws = calco.Workspace()
+        for name, func in [("sigmoid", calco.sigmoid), ("cumsum", calco.cumsum)]:
+            t_ref, _ = timed(repeat_fresh(func, x, calls))
+            t_c, _ = timed(repeat_pooled(func, x, calls, ws))
+            row(f"{name}, {calls:,} x {n:,}", t_ref, t_c, "new array")
+        stats = ws.stats()
+        print(f"{'':<4}pool: {stats['hits']:,} hits, {stats['misses']} misses, peak {stats['peak_bytes']:,} bytes")
+    print("-" * 82)
+    ws = calco.Workspace(huge_pages=True)
+    x = array.array('d', bytes(8 * SIZES[-1]))
+    t_c, _ = timed(repeat_pooled(calco.sigmoid, x, 20, ws))
+    print(f"{'sigmoid, huge_pages=True':<34}{'':<18}{'':>10}{t_c * 1e3:>10.1f}")
+    print("calls use `with result:` to hand each buffer back; `new array` allocates an array.array per call")
+    print(f"worker threads: {calco.get_num_threads()}")
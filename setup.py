@@ -1,4 +1,5 @@
 # setup.py
+import sys
 from setuptools import setup, Extension
 
 # List all source files here
@@ -7,6 +8,31 @@ calco_sources = [
     'src/calco_rounding_exp_log.c',
     'src/calco_trig_hyper.c',
     'src/calco_special_utility.c',
+    'src/calco_kernels.c',
+    'src/calco_pool.c',
+    'src/calco_grad.c',
+    'src/calco_random.c',
+    'src/calco_text.c',
+    'src/calco_scan.c',
+    'src/calco_stats.c',
+    'src/calco_interp.c',
+    'src/calco_poly.c',
+    'src/calco_register.c',
+    'src/calco_dd.c',
+    'src/calco_intmath.c',
+    'src/calco_power.c',
+    'src/calco_quad.c',
+    'src/calco_geometry.c',
+    'src/calco_geodesy.c',
+    'src/calco_linalg.c',
+    'src/calco_ode.c',
+    'src/calco_roots.c',
+    'src/calco_trig_reduce.c',
+    'src/calco_activations.c',
+    'src/calco_fft.c',
+    'src/calco_quantize.c',
+    'src/calco_workspace.c',
+    'src/calco_procpool.c',
     'src/calco_module.c'
 ]
 
@@ -14,6 +40,7 @@ calco_module = Extension(
     'calco',
     sources=calco_sources,
     include_dirs=['src'], # Specify the directory where calco.h is located
+    libraries=[] if sys.platform == 'win32' else ['m', 'rt'] if sys.platform.startswith('linux') else ['m'], # libm pulls in libmvec for vectorised math calls; librt has shm_open on older glibc
     extra_compile_args=['-O3', '-std=c99', '-ffast-math'] # -O3 for optimization, -std=c99 for modern C features, -ffast-math for potentially faster but less precise math operations
 )
 
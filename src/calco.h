@@ -29,7 +29,7 @@ PyObject* calco_add(PyObject* self, PyObject* args);
 PyObject* calco_subtract(PyObject* self, PyObject* args);
 PyObject* calco_multiply(PyObject* self, PyObject* args);
 PyObject* calco_divide(PyObject* self, PyObject* args);
-PyObject* calco_power(PyObject* self, PyObject* args);
+PyObject* calco_power(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 PyObject* calco_square_root(PyObject* self, PyObject* args);
 PyObject* calco_cube_root(PyObject* self, PyObject* args);
 PyObject* calco_absolute_value(PyObject* self, PyObject* args);
@@ -91,6 +91,337 @@ PyObject* calco_get_e(PyObject* self, PyObject* args);
 PyObject* calco_is_nan(PyObject* self, PyObject* args);
 PyObject* calco_is_infinity(PyObject* self, PyObject* args);
 
+// -----------------------------------------------------------------------------
+// Buffer Kernels (calco_kernels.c)
+// Element-wise versions of the unary functions above, applied over float64 buffers.
+// -----------------------------------------------------------------------------
+typedef double (*calco_unary_fn)(double);
+typedef void (*calco_block_fn)(const double* in, double* out, Py_ssize_t n);
+
+typedef struct {
+    const char* name;       // Name as exposed in CalcoMethods
+    PyCFunction scalar;     // Scalar wrapper (used to recognise calco.<name> objects)
+    calco_unary_fn kernel;  // Element kernel with the same semantics as the wrapper
+    calco_block_fn block;   // Optional whole-block form of kernel (vectorized), or NULL
+} calco_unary_entry;
+
+// Work description for applying a unary kernel to [chunk * chunk_size, ...) of a buffer
+typedef struct {
+    calco_unary_fn kernel;
+    const double* in;
+    double* out;
+    Py_ssize_t n;
+    Py_ssize_t chunk_size;
+    calco_block_fn block;   // Used instead of kernel when set
+} calco_unary_task;
+
+const calco_unary_entry* calco_lookup_unary(PyObject* func);
+calco_unary_fn calco_unary_kernel(const char* name);
+const calco_unary_entry* calco_unary_entry_at(Py_ssize_t id);
+void calco_unary_chunk(void* ctx, Py_ssize_t chunk);
+char calco_buffer_format(const Py_buffer* view);
+int calco_get_typed_buffer(PyObject* obj, Py_buffer* view, int writable, const char* accepted);
+int calco_get_double_buffer(PyObject* obj, Py_buffer* view, int writable);
+Py_ssize_t calco_itemsize(char typecode);
+PyObject* calco_new_array(char typecode, Py_ssize_t n, Py_buffer* view);
+PyObject* calco_new_plain_array(char typecode, Py_ssize_t n, Py_buffer* view);
+PyObject* calco_new_double_array(Py_ssize_t n, Py_buffer* view);
+int calco_get_out_buffer(PyObject* out, Py_ssize_t n, Py_buffer* view, PyObject** out_obj);
+double* calco_read_doubles(PyObject* obj, Py_ssize_t* n);
+
+// -----------------------------------------------------------------------------
+// Native Worker Pool (calco_pool.c)
+// All calco_pool_* functions are called WITHOUT holding the GIL unless noted.
+// -----------------------------------------------------------------------------
+typedef void (*calco_chunk_fn)(void* ctx, Py_ssize_t chunk);
+
+typedef struct calco_job {
+    calco_chunk_fn fn;
+    void* ctx;
+    Py_ssize_t nchunks;
+    Py_ssize_t next;                        // Next chunk index to hand out
+    Py_ssize_t running;                     // Chunks handed out but not yet finished
+    int cancelled;
+    int finished;
+    void (*on_finish)(struct calco_job* job); // Called once, with the pool lock held
+    struct calco_job* link;                 // Queue link
+} calco_job;
+
+void calco_pool_init(void);
+void calco_pool_parallel_for(calco_chunk_fn fn, void* ctx, Py_ssize_t nchunks);
+int calco_pool_submit(calco_job* job, int block);
+int calco_pool_cancel(calco_job* job);
+void calco_pool_wait(calco_job* job);
+void calco_pool_lock(void);
+void calco_pool_unlock(void);
+int calco_pool_size(void);
+
+#define CALCO_DEFAULT_CHUNK 65536
+
+// Pool, asynchronous offload and buffer application
+PyObject* calco_apply(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_submit(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_set_num_threads(PyObject* self, PyObject* args);
+PyObject* calco_get_num_threads(PyObject* self, PyObject* args);
+PyObject* calco_set_max_pending(PyObject* self, PyObject* args);
+
+extern PyTypeObject CalcoFutureType;
+
+// -----------------------------------------------------------------------------
+// Forward-Mode Differentiation (calco_grad.c, exposed as the calco.grad submodule)
+// -----------------------------------------------------------------------------
+typedef void (*calco_dual_fn)(double x, int order, double* r); // r = f, f'[, f'']
+
+double calco_digamma(double x);
+double calco_trigamma(double x);
+calco_dual_fn calco_dual_kernel(const char* name);
+
+extern struct PyModuleDef calcogradmodule;
+
+// -----------------------------------------------------------------------------
+// Random Number Generation (calco_random.c, exposed as the calco.random submodule)
+// -----------------------------------------------------------------------------
+extern struct PyModuleDef calcorandommodule;
+int calco_random_exec(PyObject* m);
+void calco_random_uniform(uint64_t seed, uint32_t stream, uint64_t first, Py_ssize_t n, double* dst);
+
+// -----------------------------------------------------------------------------
+// Descriptive Statistics (calco_stats.c, exposed as the calco.stats submodule)
+// -----------------------------------------------------------------------------
+extern struct PyModuleDef calcostatsmodule;
+int calco_stats_exec(PyObject* m);
+
+// -----------------------------------------------------------------------------
+// Text Conversion (calco_text.c)
+// -----------------------------------------------------------------------------
+void calco_text_init(void);
+PyObject* calco_parse_floats(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_format_floats(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Scans and Rolling Windows (calco_scan.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_cumsum(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_cumprod(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_sum(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_mean(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_var(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_std(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_min(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rolling_max(PyObject* self, PyObject* args, PyObject* kwargs);
+
+extern PyTypeObject CalcoRollingStatsType;
+
+// -----------------------------------------------------------------------------
+// Interpolation (calco_interp.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_interp(PyObject* self, PyObject* args, PyObject* kwargs);
+
+extern PyTypeObject CalcoPchipType;
+extern PyTypeObject CalcoCubicSplineType;
+
+// -----------------------------------------------------------------------------
+// Polynomials (calco_poly.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_polyval(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_ratval(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_polyval_many(PyObject* self, PyObject* args, PyObject* kwargs);
+
+extern PyTypeObject CalcoPolynomialType;
+
+// -----------------------------------------------------------------------------
+// Registers (calco_register.c)
+// -----------------------------------------------------------------------------
+int calco_register_init(void);
+
+extern PyTypeObject CalcoRegisterType;
+extern PyTypeObject CalcoRegisterFileType;
+
+// -----------------------------------------------------------------------------
+// Double-Double Arithmetic (calco_dd.c; inline operations in calco_dd.h)
+// -----------------------------------------------------------------------------
+PyObject* calco_dd_add_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_sub_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_mul_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_div_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_sqrt_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_exp_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_log_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_sin_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_cos_buffers(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dd_sum(PyObject* self, PyObject* args);
+PyObject* calco_dd_dot(PyObject* self, PyObject* args);
+
+extern PyTypeObject CalcoDDType;
+
+// -----------------------------------------------------------------------------
+// Integer Functions (calco_intmath.c)
+// -----------------------------------------------------------------------------
+void calco_intmath_init(void);
+PyObject* calco_factorial(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_comb(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_perm(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_gcd(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_lcm(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_isqrt(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_ipow(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_powmod(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_log_factorial(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+PyObject* calco_log_comb(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+
+// -----------------------------------------------------------------------------
+// Specialized Powers (calco_power.c)
+// -----------------------------------------------------------------------------
+double calco_fast_pow(double x, double y);
+PyObject* calco_power_by(PyObject* self, PyObject* args, PyObject* kwargs);
+
+extern PyTypeObject CalcoPowerByType;
+
+// -----------------------------------------------------------------------------
+// Numerical Integration (calco_quad.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_quad(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Vector Geometry (calco_geometry.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_norms(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_distances(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_pdist(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_cdist(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_knn(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Geodesy (calco_geodesy.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_polar_to_cartesian(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_cartesian_to_polar(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_spherical_to_cartesian(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_cartesian_to_spherical(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_haversine(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_bearing(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_vincenty(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Batched Small Linear Algebra (calco_linalg.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_batch_det(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_batch_inv(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_batch_solve(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_batch_matmul(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_batch_matvec(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_batch_eigh3(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Batched ODE Integration (calco_ode.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_odeint_batch(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Batched Root Finding (calco_roots.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_find_roots(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Degree Trigonometry and Argument Reduction (calco_trig_reduce.c)
+// -----------------------------------------------------------------------------
+int calco_rem_pio2_large(double x, double* r);
+int calco_rem_pio2_large_dd(double x, double* hi, double* lo);
+double calco_sind_kernel(double x);
+double calco_cosd_kernel(double x);
+double calco_tand_kernel(double x);
+double calco_asind_kernel(double x);
+double calco_acosd_kernel(double x);
+double calco_sine_kernel(double x);
+double calco_cosine_kernel(double x);
+double calco_tangent_kernel(double x);
+void calco_sind_block(const double* in, double* out, Py_ssize_t n);
+void calco_cosd_block(const double* in, double* out, Py_ssize_t n);
+void calco_tand_block(const double* in, double* out, Py_ssize_t n);
+void calco_asind_block(const double* in, double* out, Py_ssize_t n);
+void calco_acosd_block(const double* in, double* out, Py_ssize_t n);
+void calco_sine_block(const double* in, double* out, Py_ssize_t n);
+void calco_cosine_block(const double* in, double* out, Py_ssize_t n);
+void calco_tangent_block(const double* in, double* out, Py_ssize_t n);
+PyObject* calco_sind(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_cosd(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_tand(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_asind(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_acosd(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_atan2d(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Activation Kernels (calco_activations.c)
+// -----------------------------------------------------------------------------
+double calco_log1p_kernel(double x);
+double calco_sigmoid_kernel(double x);
+double calco_logit_kernel(double x);
+double calco_softplus_kernel(double x);
+double calco_gelu_kernel(double x);
+double calco_silu_kernel(double x);
+void calco_log1p_block(const double* in, double* out, Py_ssize_t n);
+void calco_sigmoid_block(const double* in, double* out, Py_ssize_t n);
+void calco_logit_block(const double* in, double* out, Py_ssize_t n);
+void calco_softplus_block(const double* in, double* out, Py_ssize_t n);
+void calco_gelu_block(const double* in, double* out, Py_ssize_t n);
+void calco_silu_block(const double* in, double* out, Py_ssize_t n);
+PyObject* calco_log1p(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_sigmoid(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_logit(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_softplus(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_gelu(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_silu(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_logaddexp(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_logaddexp2(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_logsumexp(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_softmax(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Fast Fourier Transforms (calco_fft.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_fft(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_ifft(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_rfft(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Rounding and Quantization (calco_quantize.c)
+// -----------------------------------------------------------------------------
+PyObject* calco_quantize(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_dequantize(PyObject* self, PyObject* args, PyObject* kwargs);
+
+// -----------------------------------------------------------------------------
+// Output Workspace (calco_workspace.c)
+// Batch functions are registered through a shim that accepts workspace= and makes it current
+// for the call; calco_new_array then returns a memoryview into the workspace's pooled memory.
+// -----------------------------------------------------------------------------
+typedef PyObject* (*calco_fastcall_fn)(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+
+extern PyTypeObject CalcoWorkspaceType;
+int calco_workspace_init(void);
+PyObject* calco_workspace_current(void); // Borrowed; NULL when no workspace is current
+PyObject* calco_workspace_array(PyObject* ws, char typecode, Py_ssize_t n, Py_buffer* view);
+PyObject* calco_workspace_call(PyCFunctionWithKeywords fn, PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* calco_workspace_fastcall(calco_fastcall_fn fn, PyObject* self, PyObject* const* args, Py_ssize_t nargs,
+                                   PyObject* kwnames);
+
+// Defines fn_ws, the workspace= shim of a METH_VARARGS | METH_KEYWORDS function, method or tp_call.
+#define CALCO_WORKSPACE_SHIM(fn) \
+    static PyObject* fn##_ws(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return calco_workspace_call((PyCFunctionWithKeywords)(void(*)(void))fn, self, args, kwargs); \
+    }
+
+// Same for a METH_FASTCALL | METH_KEYWORDS function.
+#define CALCO_WORKSPACE_FASTCALL_SHIM(fn) \
+    static PyObject* fn##_ws(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames) { \
+        return calco_workspace_fastcall(fn, self, args, nargs, kwnames); \
+    }
+
+// -----------------------------------------------------------------------------
+// Shared-Memory Process Pool (calco_procpool.c, exposed as the calco.procpool submodule)
+// -----------------------------------------------------------------------------
+extern struct PyModuleDef calcoprocpoolmodule;
+int calco_procpool_exec(PyObject* m);
+
 // -----------------------------------------------------------------------------
 // Module Definition (Declared here, defined in calco_module.c)
 // -----------------------------------------------------------------------------
@@ -0,0 +1,516 @@
+// calco_activations.c
+// Contains the numerically stable activation kernels used by scoring models: log1p, sigmoid,
+// logit, softplus, gelu, silu, logaddexp/logaddexp2 and row-wise logsumexp/softmax.
+//
+// Every kernel exists for float64 and float32 (computed in the element type, so float32 runs
+// twice as many lanes) and is written as straight-line code with selects so that the loops
+// vectorize through libmvec. Overflow is avoided by only ever exponentiating non-positive
+// arguments: sigmoid and softplus work from exp(-|x|), logaddexp from exp(-|a - b|), and
+// logsumexp/softmax subtract the row maximum.
+//
+// logsumexp and softmax find the maximum and the sum of exponentials in one pass (the online
+// softmax): each block of ACT_BLOCK values is scanned for its maximum and summed while it is
+// still in L1, and the running sum is rescaled whenever the maximum grows. softmax then writes
+// exp(x - max) / sum in a second pass over the row.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite, calco_isnan, calco_same_bits (folded away under -ffast-math)
+
+#define ACT_BLOCK 256
+
+#define MATH_D(fn) fn
+#define MATH_F(fn) fn##f
+
+// Bit-test NaN and equality per element type. -ffast-math lets fabs, max and == quietly turn a
+// NaN into a finite value, so the kernels below propagate NaN explicitly.
+#define ACT_ISNAN_d calco_isnan
+#define ACT_ISNAN_f calco_isnanf
+#define ACT_SAME_d calco_same_bits
+#define ACT_SAME_f calco_same_bitsf
+
+// exp(d) for d <= 0, flushed to zero below LO (where exp(d) is no longer a normal number): the
+// vector exp falls back to a scalar call per lane for such arguments.
+#define ACT_EXP_NONPOS(T, S, M, LO) \
+    static inline T exp_nonpos_##S(T d) { \
+        T e = M(exp)((d > (T)(LO)) ? d : (T)(LO)); \
+        return (d > (T)(LO)) ? e : (T)0.0; \
+    }
+
+ACT_EXP_NONPOS(double, d, MATH_D, -708.0)
+ACT_EXP_NONPOS(float, f, MATH_F, -87.0)
+
+// -----------------------------------------------------------------------------
+// Element Kernels (instantiated for double "d" and float "f")
+// -----------------------------------------------------------------------------
+
+#define ACT_ELEMENT_KERNELS(T, S, M) \
+    /* NaN for x <= -1, as natural_log is NaN for x <= 0 */ \
+    static inline T log1p_##S(T x) { \
+        T y = M(log1p)(x); \
+        return (x <= (T)-1.0) ? (T)NAN : y; \
+    } \
+    /* -ffast-math divides in float32 by the approximate reciprocal plus a Newton step, a unit */ \
+    /* or so off, so the symmetry point sigmoid(+-0) = 1/2 is set exactly */ \
+    static inline T sigmoid_##S(T x) { \
+        T e = exp_nonpos_##S(-M(fabs)(x)); \
+        T r = (T)1.0 / ((T)1.0 + e); \
+        r = (x >= (T)0.0) ? r : e * r; \
+        r = ACT_SAME_##S(M(fabs)(x), (T)0.0) ? (T)0.5 : r; \
+        return ACT_ISNAN_##S(x) ? x : r; \
+    } \
+    /* log(p / (1 - p)); -inf at 0, +inf at 1, NaN outside [0, 1] */ \
+    static inline T logit_##S(T p) { \
+        T y = M(log)(p) - M(log1p)(-p); \
+        return (p < (T)0.0 || p > (T)1.0) ? (T)NAN : y; \
+    } \
+    static inline T softplus_##S(T x) { \
+        T pos = (x > (T)0.0) ? x : (T)0.0; \
+        T y = pos + M(log1p)(exp_nonpos_##S(-M(fabs)(x))); \
+        return ACT_ISNAN_##S(x) ? x : y; \
+    } \
+    static inline T silu_##S(T x) { \
+        return x * sigmoid_##S(x); \
+    } \
+    /* Exact (erf) form; erfc keeps full relative accuracy in the negative tail */ \
+    static inline T gelu_##S(T x) { \
+        return (T)0.5 * x * M(erfc)(x * (T)-0.70710678118654752440); \
+    } \
+    /* Equal arguments (including equal infinities) take the exact branch; a NaN in either */ \
+    /* argument gives NaN (a + b), whichever side it is on */ \
+    static inline T logaddexp_##S(T a, T b) { \
+        T m = (a > b) ? a : b; \
+        T y = m + M(log1p)(exp_nonpos_##S(-M(fabs)(a - b))); \
+        y = ACT_SAME_##S(a, b) ? a + (T)0.69314718055994530942 : y; \
+        return (ACT_ISNAN_##S(a) || ACT_ISNAN_##S(b)) ? a + b : y; \
+    } \
+    static inline T logaddexp2_##S(T a, T b) { \
+        T m = (a > b) ? a : b; \
+        T y = m + M(log1p)(M(exp2)(-M(fabs)(a - b))) * (T)1.44269504088896340736; \
+        y = ACT_SAME_##S(a, b) ? a + (T)1.0 : y; \
+        return (ACT_ISNAN_##S(a) || ACT_ISNAN_##S(b)) ? a + b : y; \
+    }
+
+ACT_ELEMENT_KERNELS(double, d, MATH_D)
+ACT_ELEMENT_KERNELS(float, f, MATH_F)
+
+#define ACT_UNARY_BLOCK(name, T, S) \
+    static void name##_block_##S(const T* in, T* out, Py_ssize_t n) { \
+        for (Py_ssize_t i = 0; i < n; i++) { \
+            out[i] = name##_##S(in[i]); \
+        } \
+    }
+
+#define ACT_UNARY(name) \
+    ACT_UNARY_BLOCK(name, double, d) \
+    ACT_UNARY_BLOCK(name, float, f) \
+    double calco_##name##_kernel(double x) { return name##_d(x); } \
+    void calco_##name##_block(const double* in, double* out, Py_ssize_t n) { name##_block_d(in, out, n); }
+
+ACT_UNARY(log1p)
+ACT_UNARY(sigmoid)
+ACT_UNARY(logit)
+ACT_UNARY(softplus)
+ACT_UNARY(gelu)
+ACT_UNARY(silu)
+
+// Binary kernels; a step of 0 broadcasts a scalar operand.
+#define ACT_BINARY_BLOCK(name, T, S) \
+    static void name##_block_##S(const T* a, Py_ssize_t as, const T* b, Py_ssize_t bs, T* out, Py_ssize_t n) { \
+        if (as && bs) { \
+            for (Py_ssize_t i = 0; i < n; i++) { \
+                out[i] = name##_##S(a[i], b[i]); \
+            } \
+        } else if (as) { \
+            T bv = b[0]; \
+            for (Py_ssize_t i = 0; i < n; i++) { \
+                out[i] = name##_##S(a[i], bv); \
+            } \
+        } else { \
+            T av = a[0]; \
+            for (Py_ssize_t i = 0; i < n; i++) { \
+                out[i] = name##_##S(av, b[i * bs]); \
+            } \
+        } \
+    }
+
+ACT_BINARY_BLOCK(logaddexp, double, d)
+ACT_BINARY_BLOCK(logaddexp, float, f)
+ACT_BINARY_BLOCK(logaddexp2, double, d)
+ACT_BINARY_BLOCK(logaddexp2, float, f)
+
+// -----------------------------------------------------------------------------
+// Online Log-Sum-Exp and Softmax Rows
+// -----------------------------------------------------------------------------
+
+// One pass over a row: the maximum m and s = sum exp(x - m). Blocks are summed in T and the
+// block sums accumulated in double. A non-finite m (a +inf or NaN element, or a row of -inf)
+// leaves s meaningless; callers test m first. NaN is tracked separately, as the max drops it.
+#define ACT_ONLINE_ROW(T, S) \
+    static double online_row_##S(const T* x, Py_ssize_t n, T* m_out) { \
+        T m = x[0]; \
+        double s = 0.0; \
+        int has_nan = 0; \
+        for (Py_ssize_t start = 0; start < n; start += ACT_BLOCK) { \
+            Py_ssize_t end = (start + ACT_BLOCK < n) ? start + ACT_BLOCK : n; \
+            T bm = x[start]; \
+            for (Py_ssize_t i = start; i < end; i++) { \
+                bm = (x[i] > bm) ? x[i] : bm; \
+                has_nan |= ACT_ISNAN_##S(x[i]); \
+            } \
+            if (bm > m) { \
+                s = calco_isfinite((double)m) ? s * exp((double)m - (double)bm) : 0.0; \
+                m = bm; \
+            } \
+            if (!calco_isfinite((double)m)) { \
+                continue; \
+            } \
+            T bsum = (T)0.0; \
+            for (Py_ssize_t i = start; i < end; i++) { \
+                bsum += exp_nonpos_##S(x[i] - m); \
+            } \
+            s += (double)bsum; \
+        } \
+        *m_out = has_nan ? (T)NAN : m; \
+        return s; \
+    } \
+    static T logsumexp_row_##S(const T* x, Py_ssize_t n) { \
+        T m; \
+        if (n == 0) { \
+            return (T)-INFINITY; \
+        } \
+        double s = online_row_##S(x, n, &m); \
+        return calco_isfinite((double)m) ? (T)((double)m + log(s)) : m; \
+    } \
+    static void softmax_row_##S(const T* x, T* out, Py_ssize_t n) { \
+        T m; \
+        if (n == 0) { \
+            return; \
+        } \
+        double s = online_row_##S(x, n, &m); \
+        if (!calco_isfinite((double)m)) { \
+            for (Py_ssize_t i = 0; i < n; i++) { \
+                out[i] = (T)NAN; \
+            } \
+            return; \
+        } \
+        T inv = (T)(1.0 / s); \
+        for (Py_ssize_t i = 0; i < n; i++) { \
+            out[i] = exp_nonpos_##S(x[i] - m) * inv; \
+        } \
+    }
+
+ACT_ONLINE_ROW(double, d)
+ACT_ONLINE_ROW(float, f)
+
+// -----------------------------------------------------------------------------
+// Pool Tasks
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    void (*block_d)(const double*, double*, Py_ssize_t);
+    void (*block_f)(const float*, float*, Py_ssize_t);
+    int is_float32;
+    const void* in;
+    void* out;
+    Py_ssize_t n;
+} act_unary_task;
+
+static void act_unary_chunk(void* ctx, Py_ssize_t chunk) {
+    const act_unary_task* t = (const act_unary_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    if (t->is_float32) {
+        t->block_f((const float*)t->in + start, (float*)t->out + start, end - start);
+    } else {
+        t->block_d((const double*)t->in + start, (double*)t->out + start, end - start);
+    }
+}
+
+typedef struct {
+    int base2;
+    int is_float32;
+    const void* a;
+    const void* b;
+    Py_ssize_t as, bs; // 1 for a buffer, 0 for a broadcast scalar
+    void* out;
+    Py_ssize_t n;
+} act_binary_task;
+
+static void act_binary_chunk(void* ctx, Py_ssize_t chunk) {
+    const act_binary_task* t = (const act_binary_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    if (t->is_float32) {
+        const float* a = (const float*)t->a + start * t->as;
+        const float* b = (const float*)t->b + start * t->bs;
+        float* out = (float*)t->out + start;
+        (t->base2 ? logaddexp2_block_f : logaddexp_block_f)(a, t->as, b, t->bs, out, end - start);
+    } else {
+        const double* a = (const double*)t->a + start * t->as;
+        const double* b = (const double*)t->b + start * t->bs;
+        double* out = (double*)t->out + start;
+        (t->base2 ? logaddexp2_block_d : logaddexp_block_d)(a, t->as, b, t->bs, out, end - start);
+    }
+}
+
+typedef struct {
+    int softmax;
+    int is_float32;
+    const void* x;
+    void* out;          // rows values (logsumexp) or rows * cols (softmax)
+    Py_ssize_t rows, cols;
+    Py_ssize_t rows_per_chunk;
+} act_row_task;
+
+static void act_row_chunk(void* ctx, Py_ssize_t chunk) {
+    const act_row_task* t = (const act_row_task*)ctx;
+    Py_ssize_t start = chunk * t->rows_per_chunk;
+    Py_ssize_t end = (start + t->rows_per_chunk < t->rows) ? start + t->rows_per_chunk : t->rows;
+    Py_ssize_t c = t->cols;
+    for (Py_ssize_t r = start; r < end; r++) {
+        if (t->is_float32) {
+            const float* x = (const float*)t->x + r * c;
+            if (t->softmax) {
+                softmax_row_f(x, (float*)t->out + r * c, c);
+            } else {
+                ((float*)t->out)[r] = logsumexp_row_f(x, c);
+            }
+        } else {
+            const double* x = (const double*)t->x + r * c;
+            if (t->softmax) {
+                softmax_row_d(x, (double*)t->out + r * c, c);
+            } else {
+                ((double*)t->out)[r] = logsumexp_row_d(x, c);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers
+// A float gives a float; a float64 or float32 buffer gives an array of the same type (or fills
+// out=, which must have the input's element type).
+// -----------------------------------------------------------------------------
+
+// Acquires out= for n elements of format fmt, or allocates a new array. Returns 0 or -1.
+static int act_out_buffer(PyObject* out, char fmt, Py_ssize_t n, Py_buffer* view, PyObject** out_obj) {
+    if (out == Py_None) {
+        *out_obj = calco_new_array(fmt, n, view);
+        return (*out_obj == NULL) ? -1 : 0;
+    }
+    char accepted[2] = {fmt, 0};
+    if (calco_get_typed_buffer(out, view, 1, accepted) < 0) {
+        return -1;
+    }
+    if (view->len / view->itemsize < n) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_ValueError, "out buffer is smaller than the result");
+        return -1;
+    }
+    Py_INCREF(out);
+    *out_obj = out;
+    return 0;
+}
+
+static PyObject* act_unary(PyObject* args, PyObject* kwargs, double (*scalar)(double),
+                           void (*block_d)(const double*, double*, Py_ssize_t),
+                           void (*block_f)(const float*, float*, Py_ssize_t)) {
+    static char* kwlist[] = {"x", "out", NULL};
+    PyObject *x, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O", kwlist, &x, &out)) {
+        return NULL;
+    }
+    if (PyFloat_Check(x) || PyLong_Check(x)) {
+        double v = PyFloat_AsDouble(x);
+        if (v == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires a buffer argument");
+            return NULL;
+        }
+        return PyFloat_FromDouble(scalar(v));
+    }
+    int fmt = calco_get_typed_buffer(x, &in_view, 0, "df");
+    if (fmt < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / in_view.itemsize;
+    if (act_out_buffer(out, (char)fmt, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    act_unary_task task = {block_d, block_f, fmt == 'f', in_view.buf, out_view.buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(act_unary_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+#define ACT_WRAPPER(name) \
+    PyObject* calco_##name(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return act_unary(args, kwargs, calco_##name##_kernel, name##_block_d, name##_block_f); \
+    }
+
+ACT_WRAPPER(log1p)
+ACT_WRAPPER(sigmoid)
+ACT_WRAPPER(logit)
+ACT_WRAPPER(softplus)
+ACT_WRAPPER(gelu)
+ACT_WRAPPER(silu)
+
+static PyObject* act_logaddexp(PyObject* args, PyObject* kwargs, int base2) {
+    static char* kwlist[] = {"a", "b", "out", NULL};
+    PyObject *ins[2], *out = Py_None, *out_obj = NULL, *result = NULL;
+    Py_buffer views[2], out_view;
+    double scalars_d[2];
+    float scalars_f[2];
+    const void* ptr[2] = {NULL, NULL};
+    Py_ssize_t step[2] = {0, 0};
+    int is_view[2] = {0, 0};
+    int fmt = 0;
+    Py_ssize_t n = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$O", kwlist, &ins[0], &ins[1], &out)) {
+        return NULL;
+    }
+    for (int k = 0; k < 2; k++) {
+        if (PyFloat_Check(ins[k]) || PyLong_Check(ins[k])) {
+            scalars_d[k] = PyFloat_AsDouble(ins[k]);
+            if (scalars_d[k] == -1.0 && PyErr_Occurred()) {
+                goto done;
+            }
+            scalars_f[k] = (float)scalars_d[k];
+            continue;
+        }
+        int f = calco_get_typed_buffer(ins[k], &views[k], 0, "df");
+        if (f < 0) {
+            goto done;
+        }
+        is_view[k] = 1;
+        Py_ssize_t len = views[k].len / views[k].itemsize;
+        if (n >= 0 && (len != n || f != fmt)) {
+            PyErr_SetString(PyExc_ValueError, "a and b buffers must have the same length and element type");
+            goto done;
+        }
+        n = len;
+        fmt = f;
+        ptr[k] = views[k].buf;
+        step[k] = 1;
+    }
+    if (n < 0) {
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires at least one buffer argument");
+            goto done;
+        }
+        double a = scalars_d[0], b = scalars_d[1];
+        result = PyFloat_FromDouble(base2 ? logaddexp2_d(a, b) : logaddexp_d(a, b));
+        goto done;
+    }
+    for (int k = 0; k < 2; k++) {
+        if (!is_view[k]) {
+            ptr[k] = (fmt == 'f') ? (const void*)&scalars_f[k] : (const void*)&scalars_d[k];
+        }
+    }
+    if (act_out_buffer(out, (char)fmt, n, &out_view, &out_obj) < 0) {
+        goto done;
+    }
+    act_binary_task task = {base2, fmt == 'f', ptr[0], ptr[1], step[0], step[1], out_view.buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(act_binary_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&out_view);
+    result = out_obj;
+done:
+    for (int k = 0; k < 2; k++) {
+        if (is_view[k]) {
+            PyBuffer_Release(&views[k]);
+        }
+    }
+    return result;
+}
+
+PyObject* calco_logaddexp(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return act_logaddexp(args, kwargs, 0);
+}
+
+PyObject* calco_logaddexp2(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return act_logaddexp(args, kwargs, 1);
+}
+
+// Row-wise reductions over a C-contiguous buffer. cols defaults to the second dimension of a
+// 2-D buffer; a 1-D buffer without cols is a single row (and logsumexp then returns a float).
+static PyObject* act_rows(PyObject* args, PyObject* kwargs, int softmax) {
+    static char* kwlist[] = {"x", "cols", "out", NULL};
+    PyObject *x, *cols_obj = Py_None, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$O", kwlist, &x, &cols_obj, &out)) {
+        return NULL;
+    }
+    int fmt = calco_get_typed_buffer(x, &in_view, 0, "df");
+    if (fmt < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / in_view.itemsize;
+    Py_ssize_t cols;
+    int single = 0;
+    if (cols_obj != Py_None) {
+        cols = PyLong_AsSsize_t(cols_obj);
+        if (cols == -1 && PyErr_Occurred()) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+    } else if (in_view.ndim == 2) {
+        cols = in_view.shape[1];
+    } else {
+        cols = n;
+        single = 1;
+    }
+    if (cols < 1 && !(single && n == 0)) {
+        PyBuffer_Release(&in_view);
+        PyErr_SetString(PyExc_ValueError, "cols must be at least 1");
+        return NULL;
+    }
+    if (!single && n % cols != 0) {
+        PyBuffer_Release(&in_view);
+        PyErr_Format(PyExc_ValueError, "buffer length %zd is not a multiple of cols %zd", n, cols);
+        return NULL;
+    }
+    Py_ssize_t rows = single ? 1 : n / cols;
+    if (single && !softmax) {
+        if (out != Py_None) {
+            PyBuffer_Release(&in_view);
+            PyErr_SetString(PyExc_TypeError, "out= requires cols or a 2-D buffer");
+            return NULL;
+        }
+        double r;
+        Py_BEGIN_ALLOW_THREADS
+        r = (fmt == 'f') ? (double)logsumexp_row_f((const float*)in_view.buf, n)
+                         : logsumexp_row_d((const double*)in_view.buf, n);
+        Py_END_ALLOW_THREADS
+        PyBuffer_Release(&in_view);
+        return PyFloat_FromDouble(r);
+    }
+    if (act_out_buffer(out, (char)fmt, softmax ? n : rows, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    Py_ssize_t per_chunk = (cols > 0 && CALCO_DEFAULT_CHUNK / cols > 1) ? CALCO_DEFAULT_CHUNK / cols : 1;
+    act_row_task task = {softmax, fmt == 'f', in_view.buf, out_view.buf, rows, cols, per_chunk};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(act_row_chunk, &task, (rows + per_chunk - 1) / per_chunk);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+PyObject* calco_logsumexp(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return act_rows(args, kwargs, 0);
+}
+
+PyObject* calco_softmax(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return act_rows(args, kwargs, 1);
+}
@@ -49,13 +49,19 @@ PyObject* calco_divide(PyObject* self, PyObject* args) {
     return Py_BuildValue("d", a / b);
 }
 
-// Removed 'static' keyword
-PyObject* calco_power(PyObject* self, PyObject* args) {
-    double base, exponent;
-    if (!PyArg_ParseTuple(args, "dd", &base, &exponent)) {
+// Fast-call form: power sits in inner loops of user code, where argument-tuple parsing costs
+// more than the specialized evaluation saves.
+PyObject* calco_power(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    if (nargs != 2) {
+        PyErr_Format(PyExc_TypeError, "power expected 2 arguments, got %zd", nargs);
+        return NULL;
+    }
+    double base = PyFloat_CheckExact(args[0]) ? PyFloat_AS_DOUBLE(args[0]) : PyFloat_AsDouble(args[0]);
+    double exponent = PyFloat_CheckExact(args[1]) ? PyFloat_AS_DOUBLE(args[1]) : PyFloat_AsDouble(args[1]);
+    if (PyErr_Occurred()) {
         return NULL;
     }
-    return Py_BuildValue("d", pow(base, exponent));
+    return PyFloat_FromDouble(calco_fast_pow(base, exponent));
 }
 
 // Removed 'static' keyword
@@ -0,0 +1,959 @@
+// calco_dd.c
+// Contains double-double elementary functions (exp, log, sin, cos), the calco.dd scalar type
+// and the dd_* kernels that run double-double arithmetic over pairs of hi/lo float64 buffers.
+// Results carry about 32 significant digits at a small multiple of the cost of double.
+
+#include "calco.h"    // Include the main header for prototypes and definitions
+#include "calco_dd.h" // Double-double arithmetic
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Constants
+// Multi-part constants were rounded from 100-digit values; each part is the nearest double to
+// what the previous parts leave over.
+// -----------------------------------------------------------------------------
+
+static const double LN2_PARTS[3] = {6.93147180559945286e-01, 2.31904681384629956e-17, 5.70770843841621207e-34};
+static const double PIO2_PARTS[3] = {1.57079632679489656e+00, 6.12323399573676604e-17, -1.49738490485916983e-33};
+static const calco_dd DD_LN2 = {6.93147180559945286e-01, 2.31904681384629956e-17};
+static const calco_dd DD_PI16 = {1.96349540849362070e-01, 7.65404249467095754e-18};
+
+// sin(k pi / 16) and cos(k pi / 16) for k = 0..4
+static const calco_dd SIN_TABLE[5] = {
+    {0.0, 0.0},
+    {1.95090322016128276e-01, -7.99107906846173126e-18},
+    {3.82683432365089782e-01, -1.00507726964615876e-17},
+    {5.55570233019602178e-01, 4.70941094056167682e-17},
+    {7.07106781186547573e-01, -4.83364665672645673e-17},
+};
+static const calco_dd COS_TABLE[5] = {
+    {1.0, 0.0},
+    {9.80785280403230431e-01, 1.85469399978250057e-17},
+    {9.23879532511286738e-01, 1.76450470843366771e-17},
+    {8.31469612302545236e-01, 1.40738569847280239e-18},
+    {7.07106781186547573e-01, -4.83364665672645673e-17},
+};
+
+// 2^(j/64) - 1 for j = -32..32, indexed by j + 32
+static const calco_dd EXP2_TABLE_M1[65] = {
+    {-2.92893218813452483e-01, 7.17468466399326131e-18},
+    {-2.85193330804014988e-01, -6.01582124452682759e-18},
+    {-2.77409596511476675e-01, -1.51187906749699366e-17},
+    {-2.69541102909676533e-01, 2.75092653008817449e-17},
+    {-2.61586927030250327e-01, -1.74199727844639790e-17},
+    {-2.53546135854367582e-01, 7.09646007714201789e-18},
+    {-2.45417786203288635e-01, 4.68838484354307507e-18},
+    {-2.37200924627730847e-01, 3.86442669545020847e-19},
+    {-2.28894587296029600e-01, 1.19935984328591908e-17},
+    {-2.20497799881081508e-01, -8.84954034884127600e-18},
+    {-2.12009577446056752e-01, -5.06845823563915199e-18},
+    {-2.03428924328866556e-01, 5.03911851969801072e-18},
+    {-1.94754834025372858e-01, 1.23535962848989439e-17},
+    {-1.85986289071326111e-01, -5.80919980790650615e-18},
+    {-1.77122260923017583e-01, 4.88275166288396400e-18},
+    {-1.68161709836631784e-01, 1.69938786793658600e-18},
+    {-1.59103584746285470e-01, 1.32394744872785722e-17},
+    {-1.49946823140738261e-01, -4.01185968519885012e-18},
+    {-1.40690350938761033e-01, -9.25690209131555494e-18},
+    {-1.31333082363146864e-01, -1.19336291191641272e-17},
+    {-1.21873919813350259e-01, 9.22915669429910358e-19},
+    {-1.12311753736739378e-01, 4.39308336715394512e-18},
+    {-1.02645462498446402e-01, -4.76405859385841260e-18},
+    {-9.28739122498006275e-02, 5.66349353665607984e-18},
+    {-8.29959567953287708e-02, 2.53774831341367888e-18},
+    {-7.30104374583072091e-02, -6.70171377761985702e-18},
+    {-6.29161829448500465e-02, -2.85824144939179660e-18},
+    {-5.27120092065171825e-02, 3.13922986826819237e-18},
+    {-4.23967193014263555e-02, 2.41142095027801229e-18},
+    {-3.19691032538527778e-02, 3.08967247603103316e-18},
+    {-2.14279379122998652e-02, -2.98971420213646098e-19},
+    {-1.07719868060245152e-02, -6.22305157082601653e-19},
+    {0.00000000000000000e+00, 0.00000000000000000e+00},
+    {1.08892860517004596e-02, 3.77732680422685470e-19},
+    {2.18971486541166792e-02, -9.49453989569773126e-19},
+    {3.30248790212284218e-02, 6.61944970119860497e-19},
+    {4.42737824274138381e-02, 2.25217020849290415e-18},
+    {5.56451783605571570e-02, 1.75932573877209198e-18},
+    {6.71404006768236139e-02, 4.26818717847092162e-18},
+    {7.87607977571197909e-02, 2.82233467850635428e-18},
+    {9.05077326652576619e-02, -2.71224518249579603e-18},
+    {1.02382583307840946e-01, -2.85078251555088239e-18},
+    {1.14386742595892543e-01, -6.91951789405994295e-18},
+    {1.26521618608241904e-01, -3.85258364330326042e-18},
+    {1.38788634756691648e-01, 5.86139991336733494e-18},
+    {1.51189229952982701e-01, 4.75152657300935938e-18},
+    {1.63724858777577503e-01, 1.05364727536120215e-17},
+    {1.76396991650281276e-01, 3.08813109229611199e-20},
+    {1.89207115002721055e-01, 1.20645766990275491e-17},
+    {2.02156731452703131e-01, 1.09386637612651808e-17},
+    {2.15247359980468872e-01, 6.14041992007186384e-18},
+    {2.28480536106869997e-01, 8.76775930260361398e-18},
+    {2.41857812073484058e-01, -8.93087531288846219e-18},
+    {2.55380757024691096e-01, -6.71138982129687842e-18},
+    {2.69050957191733220e-01, 2.66793213134218610e-18},
+    {2.82870016078778264e-01, 1.71359491824356097e-17},
+    {2.96839554651009641e-01, 2.53825027948883150e-17},
+    {3.10961211524764358e-01, -1.63042101239367115e-17},
+    {3.25236643159741268e-01, 2.69238391308692133e-17},
+    {3.39667524053303027e-01, -2.17494765141983342e-17},
+    {3.54255546936892707e-01, 2.14983325667720645e-17},
+    {3.69002422974590627e-01, -1.50843232713271725e-17},
+    {3.83909881963831967e-01, -1.21939653566900359e-17},
+    {3.98979672538311125e-01, 1.48801703720024264e-17},
+    {4.14213562373095034e-01, 1.43493693279865226e-17},
+};
+
+// 1 / k! for k = 3..21
+#define INV_FACT_FIRST 3
+#define INV_FACT_LAST 21
+static const calco_dd INV_FACT[INV_FACT_LAST - INV_FACT_FIRST + 1] = {
+    {1.66666666666666657e-01, 9.25185853854297066e-18},
+    {4.16666666666666644e-02, 2.31296463463574266e-18},
+    {8.33333333333333322e-03, 1.15648231731787138e-19},
+    {1.38888888888888894e-03, -5.30054395437357706e-20},
+    {1.98412698412698413e-04, 1.72095582934207053e-22},
+    {2.48015873015873016e-05, 2.15119478667758816e-23},
+    {2.75573192239858925e-06, -1.85839327404647208e-22},
+    {2.75573192239858883e-07, 2.37677146222502973e-23},
+    {2.50521083854417202e-08, -1.44881407093591197e-24},
+    {2.08767569878681002e-09, -1.20734505911325997e-25},
+    {1.60590438368216133e-10, 1.25852945887520981e-26},
+    {1.14707455977297245e-11, 2.06555127528307454e-28},
+    {7.64716373181981641e-13, 7.03872877733453001e-30},
+    {4.77947733238738525e-14, 4.39920548583408126e-31},
+    {2.81145725434552060e-15, 1.65088427308614326e-31},
+    {1.56192069685862253e-16, 1.19106796602737540e-32},
+    {8.22063524662432950e-18, 2.21418941196042654e-34},
+    {4.11031762331216484e-19, 1.44129733786595271e-36},
+    {1.95729410633912626e-20, -1.36435038300879085e-36},
+};
+
+#define DD_EPS 1e-33 // Series terms below DD_EPS relative to the leading term are dropped
+
+// -----------------------------------------------------------------------------
+// Elementary Functions
+// -----------------------------------------------------------------------------
+
+// Returns F and sets *m such that exp(a) = 2^m (1 + F), for finite a in the range of exp.
+// a = (64 m + j) ln2/64 + r with |j| <= 32 and |r| <= ln2/128, so exp(a) = 2^m 2^(j/64) e^r
+// with 2^(j/64) - 1 from a table and e^r - 1 from a short Taylor series. Keeping both factors
+// in the "minus one" form makes F accurate relative to itself: for m == 0 it is expm1(a).
+static calco_dd dd_expm1_reduced(calco_dd a, int* m) {
+    double k = floor(a.hi * (64.0 / LN2_PARTS[0]) + 0.5);
+    double j = k - 64.0 * floor(k / 64.0 + 0.5);
+    calco_dd r = calco_dd_sub(a, calco_dd_prod(k, LN2_PARTS[0] / 64.0));
+    r = calco_dd_sub(r, calco_dd_prod(k, LN2_PARTS[1] / 64.0));
+    r = calco_dd_add_d(r, -k * (LN2_PARTS[2] / 64.0));
+    *m = (int)((k - j) / 64.0);
+
+    calco_dd s = r;
+    if (r.hi != 0.0) {
+        calco_dd p = calco_dd_mul(r, r);
+        s = calco_dd_add(r, calco_dd_make(0.5 * p.hi, 0.5 * p.lo));
+        for (int i = INV_FACT_FIRST; i <= INV_FACT_LAST; i++) {
+            p = calco_dd_mul(p, r);
+            calco_dd t = calco_dd_mul(p, INV_FACT[i - INV_FACT_FIRST]);
+            s = calco_dd_add(s, t);
+            if (fabs(t.hi) <= DD_EPS * fabs(r.hi)) {
+                break;
+            }
+        }
+    }
+    calco_dd t = EXP2_TABLE_M1[(int)j + 32];
+    return (j == 0.0) ? s : calco_dd_add(calco_dd_add(t, s), calco_dd_mul(t, s));
+}
+
+// Results below about 1e-292 lose precision as lo becomes subnormal.
+calco_dd calco_dd_exp(calco_dd a) {
+    if (!calco_isfinite(a.hi)) {
+        return calco_dd_make((a.hi < 0.0 && !calco_isnan(a.hi)) ? 0.0 : a.hi, 0.0);
+    }
+    if (a.hi > 709.8) {
+        return calco_dd_make(HUGE_VAL, 0.0);
+    }
+    if (a.hi < -745.2) {
+        return calco_dd_make(0.0, 0.0);
+    }
+    int m;
+    calco_dd s = calco_dd_add_d(dd_expm1_reduced(a, &m), 1.0);
+    return calco_dd_make(ldexp(s.hi, m), ldexp(s.lo, m));
+}
+
+// log(a) = e ln2 + log(f) with a = f 2^e and f in [sqrt(1/2), sqrt(2)), so there is no
+// cancellation near a = 1. log(f) is one Newton step from x = log(f.hi) + f.lo / f.hi:
+// x + f exp(-x) - 1, evaluated as x + (f - 1) + f expm1(-x) so that the correction keeps
+// its relative accuracy when log(f) is tiny.
+calco_dd calco_dd_log(calco_dd a) {
+    if (a.hi <= 0.0) {
+        return calco_dd_make((a.hi == 0.0) ? -HUGE_VAL : NAN, 0.0);
+    }
+    if (!calco_isfinite(a.hi)) {
+        return calco_dd_make(a.hi, 0.0);
+    }
+    int e, m;
+    frexp(a.hi, &e);
+    if (ldexp(a.hi, -e) < 0.70710678118654752) {
+        e--;
+    }
+    calco_dd f = calco_dd_make(ldexp(a.hi, -e), ldexp(a.lo, -e));
+    double x = log(f.hi) + f.lo / f.hi;
+    calco_dd em1 = dd_expm1_reduced(calco_dd_make(-x, 0.0), &m);
+    if (m != 0) {
+        em1 = calco_dd_add_d(calco_dd_make(ldexp(em1.hi, m), ldexp(em1.lo, m)), ldexp(1.0, m) - 1.0);
+    }
+    calco_dd t = calco_dd_add(calco_dd_add_d(f, -1.0), calco_dd_mul(f, em1));
+    calco_dd y = calco_dd_add_d(t, x);
+    return (e == 0) ? y : calco_dd_add(y, calco_dd_mul_d(DD_LN2, (double)e));
+}
+
+// Taylor series for |t| <= pi/32.
+static calco_dd sin_taylor(calco_dd t) {
+    if (t.hi == 0.0) {
+        return t;
+    }
+    calco_dd x2 = calco_dd_neg(calco_dd_mul(t, t));
+    calco_dd s = t, p = t;
+    for (int k = INV_FACT_FIRST; k <= INV_FACT_LAST; k += 2) {
+        p = calco_dd_mul(p, x2);
+        calco_dd term = calco_dd_mul(p, INV_FACT[k - INV_FACT_FIRST]);
+        s = calco_dd_add(s, term);
+        if (fabs(term.hi) <= DD_EPS * fabs(t.hi)) {
+            break;
+        }
+    }
+    return s;
+}
+
+// Reduces a to t + j pi/2 + k pi/16 with |t| <= pi/32 and returns sin(t + k pi/16) and
+// cos(t + k pi/16) through *s and *c; the result is the quadrant j mod 4. pi/2 is carried to
+// 160 bits, which keeps the reduction accurate for |a| up to about 1e16; from DD_TRIG_MEDIUM
+// on, hi (and lo, if it is that large too) first go through the Payne-Hanek reduction.
+#define DD_TRIG_MEDIUM 0x1p50
+
+static int dd_sincos_reduced(calco_dd a, calco_dd* s, calco_dd* c) {
+    int quadrant = 0;
+    if (fabs(a.hi) >= DD_TRIG_MEDIUM) {
+        calco_dd r, r_lo;
+        quadrant = calco_rem_pio2_large_dd(a.hi, &r.hi, &r.lo);
+        if (fabs(a.lo) >= DD_TRIG_MEDIUM) {
+            quadrant += calco_rem_pio2_large_dd(a.lo, &r_lo.hi, &r_lo.lo);
+            a = calco_dd_add(r, r_lo);
+        } else {
+            a = calco_dd_add_d(r, a.lo);
+        }
+    }
+    double j = floor(a.hi / PIO2_PARTS[0] + 0.5);
+    calco_dd t = calco_dd_sub(a, calco_dd_prod(j, PIO2_PARTS[0]));
+    t = calco_dd_sub(t, calco_dd_prod(j, PIO2_PARTS[1]));
+    t = calco_dd_add_d(t, -j * PIO2_PARTS[2]);
+    int k = (int)floor(t.hi / DD_PI16.hi + 0.5);
+    k = (k < -4) ? -4 : (k > 4) ? 4 : k;
+    t = calco_dd_sub(t, calco_dd_mul_d(DD_PI16, (double)k));
+
+    calco_dd st = sin_taylor(t);
+    calco_dd ct = calco_dd_sqrt(calco_dd_add_d(calco_dd_neg(calco_dd_mul(st, st)), 1.0));
+    calco_dd sk = SIN_TABLE[k < 0 ? -k : k], ck = COS_TABLE[k < 0 ? -k : k];
+    if (k < 0) {
+        sk = calco_dd_neg(sk);
+    }
+    *s = calco_dd_add(calco_dd_mul(st, ck), calco_dd_mul(ct, sk));
+    *c = calco_dd_sub(calco_dd_mul(ct, ck), calco_dd_mul(st, sk));
+    return ((int)(j - 4.0 * floor(j / 4.0)) + quadrant) & 3;
+}
+
+calco_dd calco_dd_sin(calco_dd a) {
+    if (!calco_isfinite(a.hi)) {
+        return calco_dd_make(NAN, 0.0);
+    }
+    calco_dd s, c;
+    switch (dd_sincos_reduced(a, &s, &c)) {
+        case 0: return s;
+        case 1: return c;
+        case 2: return calco_dd_neg(s);
+        default: return calco_dd_neg(c);
+    }
+}
+
+calco_dd calco_dd_cos(calco_dd a) {
+    if (!calco_isfinite(a.hi)) {
+        return calco_dd_make(NAN, 0.0);
+    }
+    calco_dd s, c;
+    switch (dd_sincos_reduced(a, &s, &c)) {
+        case 0: return c;
+        case 1: return calco_dd_neg(s);
+        case 2: return calco_dd_neg(c);
+        default: return s;
+    }
+}
+
+// x ** n by binary powering; negative n inverts at the end.
+static calco_dd dd_powi(calco_dd x, long long n) {
+    unsigned long long m = (n < 0) ? 0ULL - (unsigned long long)n : (unsigned long long)n;
+    calco_dd r = calco_dd_make(1.0, 0.0);
+    while (m > 0) {
+        if (m & 1) {
+            r = calco_dd_mul(r, x);
+        }
+        m >>= 1;
+        if (m > 0) {
+            x = calco_dd_mul(x, x);
+        }
+    }
+    return (n < 0) ? calco_dd_div(calco_dd_make(1.0, 0.0), r) : r;
+}
+
+// -----------------------------------------------------------------------------
+// Decimal Conversion
+// Strings go through the decimal module: hi is the correctly rounded double and lo the
+// correctly rounded remainder, and output is the exact hi + lo rounded once to 32 digits.
+// -----------------------------------------------------------------------------
+
+static PyObject* decimal_type = NULL;    // decimal.Decimal
+static PyObject* decimal_context = NULL; // decimal.Context(prec=32)
+
+static int decimal_ready(void) {
+    if (decimal_context != NULL) {
+        return 0;
+    }
+    PyObject* mod = PyImport_ImportModule("decimal");
+    if (mod == NULL) {
+        return -1;
+    }
+    decimal_type = PyObject_GetAttrString(mod, "Decimal");
+    PyObject* context = PyObject_GetAttrString(mod, "Context");
+    Py_DECREF(mod);
+    if (decimal_type != NULL && context != NULL) {
+        PyObject* kwargs = Py_BuildValue("{s:i}", "prec", 32);
+        PyObject* noargs = PyTuple_New(0);
+        if (kwargs != NULL && noargs != NULL) {
+            decimal_context = PyObject_Call(context, noargs, kwargs);
+        }
+        Py_XDECREF(kwargs);
+        Py_XDECREF(noargs);
+    }
+    Py_XDECREF(context);
+    if (decimal_context == NULL) {
+        Py_CLEAR(decimal_type);
+        return -1;
+    }
+    return 0;
+}
+
+// Splits any number with float() and exact subtraction (Decimal, Fraction, ...) into hi + lo.
+static int dd_from_number(PyObject* o, calco_dd* v) {
+    // Checked with PyErr_Occurred() alone: under -ffast-math, NaN may compare equal to -1.0.
+    double hi = PyFloat_AsDouble(o);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    v->hi = hi;
+    v->lo = 0.0;
+    if (!calco_isfinite(hi)) {
+        return 0;
+    }
+    PyObject* hi_obj = PyFloat_FromDouble(hi);
+    PyObject* exact = (hi_obj != NULL) ? PyObject_CallFunctionObjArgs((PyObject*)Py_TYPE(o), hi_obj, NULL) : NULL;
+    PyObject* rem = (exact != NULL) ? PyNumber_Subtract(o, exact) : NULL;
+    Py_XDECREF(hi_obj);
+    Py_XDECREF(exact);
+    if (rem == NULL) {
+        return -1;
+    }
+    v->lo = PyFloat_AsDouble(rem);
+    Py_DECREF(rem);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+static int dd_from_string(PyObject* s, calco_dd* v) {
+    if (decimal_ready() < 0) {
+        return -1;
+    }
+    PyObject* d = PyObject_CallFunctionObjArgs(decimal_type, s, NULL);
+    if (d == NULL) {
+        return -1;
+    }
+    int rc = dd_from_number(d, v);
+    Py_DECREF(d);
+    return rc;
+}
+
+// Returns hi + lo as a str with 32 significant digits.
+static PyObject* dd_to_string(calco_dd v) {
+    if (!calco_isfinite(v.hi)) {
+        PyObject* f = PyFloat_FromDouble(v.hi);
+        PyObject* r = (f != NULL) ? PyObject_Repr(f) : NULL;
+        Py_XDECREF(f);
+        return r;
+    }
+    if (decimal_ready() < 0) {
+        return NULL;
+    }
+    PyObject* hi = PyFloat_FromDouble(v.hi);
+    PyObject* lo = PyFloat_FromDouble(v.lo);
+    PyObject* dhi = (hi != NULL) ? PyObject_CallFunctionObjArgs(decimal_type, hi, NULL) : NULL;
+    PyObject* dlo = (lo != NULL) ? PyObject_CallFunctionObjArgs(decimal_type, lo, NULL) : NULL;
+    PyObject* sum = (dhi != NULL && dlo != NULL) ? PyObject_CallMethod(decimal_context, "add", "OO", dhi, dlo) : NULL;
+    PyObject* r = (sum != NULL) ? PyObject_Str(sum) : NULL;
+    Py_XDECREF(hi);
+    Py_XDECREF(lo);
+    Py_XDECREF(dhi);
+    Py_XDECREF(dlo);
+    Py_XDECREF(sum);
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// calco.dd
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    calco_dd v;
+} CalcoDD;
+
+static PyObject* dd_wrap(calco_dd v) {
+    CalcoDD* r = PyObject_New(CalcoDD, &CalcoDDType);
+    if (r != NULL) {
+        r->v = v;
+    }
+    return (PyObject*)r;
+}
+
+// Reads a dd, float or int operand. Returns 1, 0 if the type is not supported (no exception
+// set), or -1 with an exception set. Ints keep up to 106 bits.
+static int dd_operand(PyObject* o, calco_dd* v) {
+    if (Py_TYPE(o) == &CalcoDDType) {
+        *v = ((CalcoDD*)o)->v;
+        return 1;
+    }
+    if (PyFloat_Check(o)) {
+        *v = calco_dd_make(PyFloat_AS_DOUBLE(o), 0.0);
+        return 1;
+    }
+    if (PyLong_Check(o)) {
+        return (dd_from_number(o, v) < 0) ? -1 : 1;
+    }
+    return 0;
+}
+
+static PyObject* dd_new(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "lo", NULL};
+    PyObject* x = NULL;
+    double lo = 0.0;
+    calco_dd v = {0.0, 0.0};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Od", kwlist, &x, &lo)) {
+        return NULL;
+    }
+    if (x != NULL) {
+        int rc = PyUnicode_Check(x) ? dd_from_string(x, &v) : dd_operand(x, &v);
+        if (rc == 0 && !PyUnicode_Check(x)) {
+            rc = dd_from_number(x, &v);
+        }
+        if (rc < 0) {
+            return NULL;
+        }
+    }
+    if (lo != 0.0) {
+        v = calco_dd_add_d(v, lo);
+    }
+    CalcoDD* r = (CalcoDD*)type->tp_alloc(type, 0);
+    if (r != NULL) {
+        r->v = v;
+    }
+    return (PyObject*)r;
+}
+
+static PyObject* dd_repr(CalcoDD* self) {
+    PyObject* s = dd_to_string(self->v);
+    if (s == NULL) {
+        return NULL;
+    }
+    PyObject* r = PyUnicode_FromFormat("dd('%U')", s);
+    Py_DECREF(s);
+    return r;
+}
+
+static PyObject* dd_str(CalcoDD* self) {
+    return dd_to_string(self->v);
+}
+
+static Py_hash_t dd_hash(CalcoDD* self) {
+    // Equal to hash(hi) when lo == 0, so dd(x) and x hash alike.
+    PyObject* hi = PyFloat_FromDouble(self->v.hi);
+    if (hi == NULL) {
+        return -1;
+    }
+    Py_hash_t h = PyObject_Hash(hi);
+    Py_DECREF(hi);
+    if (h == -1 || self->v.lo == 0.0) {
+        return h;
+    }
+    PyObject* lo = PyFloat_FromDouble(self->v.lo);
+    if (lo == NULL) {
+        return -1;
+    }
+    Py_hash_t hl = PyObject_Hash(lo);
+    Py_DECREF(lo);
+    if (hl == -1) {
+        return -1;
+    }
+    h ^= (Py_hash_t)((Py_uhash_t)hl * 1000003U);
+    return (h == -1) ? -2 : h;
+}
+
+static PyObject* dd_richcompare(PyObject* a, PyObject* b, int op) {
+    calco_dd x, y;
+    int ra = dd_operand(a, &x), rb = (ra > 0) ? dd_operand(b, &y) : 0;
+    if (ra < 0 || rb < 0) {
+        return NULL;
+    }
+    if (ra == 0 || rb == 0) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    // Both are normalized, so (hi, lo) order is value order; NaN compares unequal to everything.
+    int unordered = calco_isnan(x.hi) || calco_isnan(y.hi);
+    int c = (x.hi < y.hi) ? -1 : (x.hi > y.hi) ? 1 : (x.lo < y.lo) ? -1 : (x.lo > y.lo) ? 1 : 0;
+    int result;
+    switch (op) {
+        case Py_LT: result = !unordered && c < 0; break;
+        case Py_LE: result = !unordered && c <= 0; break;
+        case Py_EQ: result = !unordered && c == 0; break;
+        case Py_NE: result = unordered || c != 0; break;
+        case Py_GT: result = !unordered && c > 0; break;
+        default: result = !unordered && c >= 0; break;
+    }
+    return PyBool_FromLong(result);
+}
+
+#define DD_BINARY(name, expr) \
+    static PyObject* dd_nb_##name(PyObject* a, PyObject* b) { \
+        calco_dd x, y; \
+        int ra = dd_operand(a, &x), rb = (ra > 0) ? dd_operand(b, &y) : 0; \
+        if (ra < 0 || rb < 0) { \
+            return NULL; \
+        } \
+        if (ra == 0 || rb == 0) { \
+            Py_RETURN_NOTIMPLEMENTED; \
+        } \
+        return dd_wrap(expr); \
+    }
+
+DD_BINARY(add, calco_dd_add(x, y))
+DD_BINARY(sub, calco_dd_sub(x, y))
+DD_BINARY(mul, calco_dd_mul(x, y))
+DD_BINARY(div, calco_dd_div(x, y))
+
+// Integer exponents use binary powering; others go through exp(y log x).
+static PyObject* dd_nb_pow(PyObject* a, PyObject* b, PyObject* mod) {
+    calco_dd x, y;
+    if (mod != Py_None) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    int ra = dd_operand(a, &x);
+    if (ra < 0) {
+        return NULL;
+    }
+    if (ra == 0) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (PyLong_Check(b)) {
+        int overflow;
+        long long n = PyLong_AsLongLongAndOverflow(b, &overflow);
+        if (n == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (!overflow) {
+            return dd_wrap(dd_powi(x, n));
+        }
+    }
+    int rb = dd_operand(b, &y);
+    if (rb < 0) {
+        return NULL;
+    }
+    if (rb == 0) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (y.hi == floor(y.hi) && y.lo == 0.0 && fabs(y.hi) < 9.2e18) {
+        return dd_wrap(dd_powi(x, (long long)y.hi));
+    }
+    return dd_wrap(calco_dd_exp(calco_dd_mul(y, calco_dd_log(x))));
+}
+
+static PyObject* dd_nb_neg(CalcoDD* self) {
+    return dd_wrap(calco_dd_neg(self->v));
+}
+
+static PyObject* dd_nb_pos(CalcoDD* self) {
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+static PyObject* dd_nb_abs(CalcoDD* self) {
+    return dd_wrap((self->v.hi < 0.0) ? calco_dd_neg(self->v) : self->v);
+}
+
+static int dd_nb_bool(CalcoDD* self) {
+    return self->v.hi != 0.0;
+}
+
+static PyObject* dd_nb_float(CalcoDD* self) {
+    return PyFloat_FromDouble(self->v.hi);
+}
+
+static PyNumberMethods dd_as_number = {
+    .nb_add = dd_nb_add,
+    .nb_subtract = dd_nb_sub,
+    .nb_multiply = dd_nb_mul,
+    .nb_true_divide = dd_nb_div,
+    .nb_power = dd_nb_pow,
+    .nb_negative = (unaryfunc)dd_nb_neg,
+    .nb_positive = (unaryfunc)dd_nb_pos,
+    .nb_absolute = (unaryfunc)dd_nb_abs,
+    .nb_bool = (inquiry)dd_nb_bool,
+    .nb_float = (unaryfunc)dd_nb_float,
+};
+
+#define DD_METHOD(name, fn) \
+    static PyObject* dd_method_##name(CalcoDD* self, PyObject* unused) { \
+        return dd_wrap(fn(self->v)); \
+    }
+
+DD_METHOD(sqrt, calco_dd_sqrt)
+DD_METHOD(exp, calco_dd_exp)
+DD_METHOD(log, calco_dd_log)
+DD_METHOD(sin, calco_dd_sin)
+DD_METHOD(cos, calco_dd_cos)
+
+static PyObject* dd_reduce(CalcoDD* self, PyObject* unused) {
+    return Py_BuildValue("(O(dd))", (PyObject*)Py_TYPE(self), self->v.hi, self->v.lo);
+}
+
+static PyObject* dd_get_hi(CalcoDD* self, void* closure) {
+    return PyFloat_FromDouble(self->v.hi);
+}
+
+static PyObject* dd_get_lo(CalcoDD* self, void* closure) {
+    return PyFloat_FromDouble(self->v.lo);
+}
+
+static PyMethodDef dd_methods[] = {
+    {"sqrt", (PyCFunction)dd_method_sqrt, METH_NOARGS, "Square root."},
+    {"exp", (PyCFunction)dd_method_exp, METH_NOARGS, "Exponential."},
+    {"log", (PyCFunction)dd_method_log, METH_NOARGS, "Natural logarithm."},
+    {"sin", (PyCFunction)dd_method_sin, METH_NOARGS, "Sine (accurate for |x| up to about 1e16)."},
+    {"cos", (PyCFunction)dd_method_cos, METH_NOARGS, "Cosine (accurate for |x| up to about 1e16)."},
+    {"__reduce__", (PyCFunction)dd_reduce, METH_NOARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef dd_getset[] = {
+    {"hi", (getter)dd_get_hi, NULL, "Leading double (float(x) == x.hi).", NULL},
+    {"lo", (getter)dd_get_lo, NULL, "Trailing double, |lo| <= ulp(hi) / 2.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+PyTypeObject CalcoDDType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.dd",
+    .tp_basicsize = sizeof(CalcoDD),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "dd(x=0.0, lo=0.0): Double-double number hi + lo with about 32 significant digits. x may be a "
+              "float, int, str, Decimal, Fraction or dd; lo is added exactly. Supports + - * / ** with floats "
+              "and ints, comparison, and the sqrt/exp/log/sin/cos methods.",
+    .tp_methods = dd_methods,
+    .tp_getset = dd_getset,
+    .tp_as_number = &dd_as_number,
+    .tp_repr = (reprfunc)dd_repr,
+    .tp_str = (reprfunc)dd_str,
+    .tp_hash = (hashfunc)dd_hash,
+    .tp_richcompare = dd_richcompare,
+    .tp_new = dd_new,
+};
+
+// -----------------------------------------------------------------------------
+// Buffer Kernels
+// An operand is a float64 buffer (lo = 0), a (hi, lo) pair of float64 buffers, or a scalar
+// (float, int or dd) broadcast over the buffers. Results are returned as a (hi, lo) pair.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    Py_buffer views[2];
+    int nviews;
+    const double* hi;
+    const double* lo; // NULL when the operand is a single buffer
+    Py_ssize_t step;  // 0 for a broadcast scalar
+    Py_ssize_t n;     // -1 for a broadcast scalar
+    calco_dd scalar;
+} dd_arg;
+
+static void dd_arg_release(dd_arg* a) {
+    for (int i = 0; i < a->nviews; i++) {
+        PyBuffer_Release(&a->views[i]);
+    }
+    a->nviews = 0;
+}
+
+static int dd_arg_get(PyObject* obj, dd_arg* a) {
+    memset(a, 0, sizeof(*a));
+    int rc = dd_operand(obj, &a->scalar);
+    if (rc != 0) {
+        a->hi = &a->scalar.hi;
+        a->lo = &a->scalar.lo;
+        a->n = -1;
+        return (rc < 0) ? -1 : 0;
+    }
+    a->step = 1;
+    if (PyTuple_Check(obj) && PyTuple_GET_SIZE(obj) == 2) {
+        for (int i = 0; i < 2; i++) {
+            if (calco_get_double_buffer(PyTuple_GET_ITEM(obj, i), &a->views[i], 0) < 0) {
+                dd_arg_release(a);
+                return -1;
+            }
+            a->nviews++;
+        }
+        if (a->views[0].len != a->views[1].len) {
+            dd_arg_release(a);
+            PyErr_SetString(PyExc_ValueError, "hi and lo buffers must have the same length");
+            return -1;
+        }
+        a->lo = (const double*)a->views[1].buf;
+    } else {
+        if (calco_get_double_buffer(obj, &a->views[0], 0) < 0) {
+            return -1;
+        }
+        a->nviews = 1;
+    }
+    a->hi = (const double*)a->views[0].buf;
+    a->n = a->views[0].len / (Py_ssize_t)sizeof(double);
+    return 0;
+}
+
+static inline calco_dd dd_arg_at(const dd_arg* a, Py_ssize_t i) {
+    return calco_dd_make(a->hi[i * a->step], (a->lo != NULL) ? a->lo[i * a->step] : 0.0);
+}
+
+typedef enum { DD_ADD, DD_SUB, DD_MUL, DD_DIV, DD_SQRT, DD_EXP, DD_LOG, DD_SIN, DD_COS } dd_op;
+
+typedef struct {
+    dd_op op;
+    const dd_arg* a;
+    const dd_arg* b; // NULL for unary operations
+    double* out_hi;
+    double* out_lo;
+    Py_ssize_t n;
+} dd_task;
+
+static void dd_elementwise_chunk(void* ctx, Py_ssize_t chunk) {
+    const dd_task* t = (const dd_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK > t->n) ? t->n : start + CALCO_DEFAULT_CHUNK;
+    for (Py_ssize_t i = start; i < end; i++) {
+        calco_dd x = dd_arg_at(t->a, i), r;
+        calco_dd y = (t->b != NULL) ? dd_arg_at(t->b, i) : x;
+        switch (t->op) {
+            case DD_ADD: r = calco_dd_add(x, y); break;
+            case DD_SUB: r = calco_dd_sub(x, y); break;
+            case DD_MUL: r = calco_dd_mul(x, y); break;
+            case DD_DIV: r = calco_dd_div(x, y); break;
+            case DD_SQRT: r = calco_dd_sqrt(x); break;
+            case DD_EXP: r = calco_dd_exp(x); break;
+            case DD_LOG: r = calco_dd_log(x); break;
+            case DD_SIN: r = calco_dd_sin(x); break;
+            default: r = calco_dd_cos(x); break;
+        }
+        t->out_hi[i] = r.hi;
+        t->out_lo[i] = r.lo;
+    }
+}
+
+// Reads `out` (None or a (hi, lo) pair of writable buffers) and returns the result pair.
+static PyObject* dd_get_out_pair(PyObject* out, Py_ssize_t n, Py_buffer views[2]) {
+    PyObject* objs[2] = {NULL, NULL};
+    if (out != Py_None && !(PyTuple_Check(out) && PyTuple_GET_SIZE(out) == 2)) {
+        PyErr_SetString(PyExc_TypeError, "out must be None or a (hi, lo) pair of float64 buffers");
+        return NULL;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (calco_get_out_buffer((out == Py_None) ? Py_None : PyTuple_GET_ITEM(out, i), n, &views[i], &objs[i]) < 0) {
+            if (i == 1) {
+                PyBuffer_Release(&views[0]);
+                Py_DECREF(objs[0]);
+            }
+            return NULL;
+        }
+    }
+    PyObject* pair = PyTuple_Pack(2, objs[0], objs[1]);
+    Py_DECREF(objs[0]);
+    Py_DECREF(objs[1]);
+    if (pair == NULL) {
+        PyBuffer_Release(&views[0]);
+        PyBuffer_Release(&views[1]);
+    }
+    return pair;
+}
+
+static PyObject* dd_elementwise(dd_op op, const char* name, PyObject* args, PyObject* kwargs) {
+    static char* binary_kwlist[] = {"a", "b", "out", NULL};
+    static char* unary_kwlist[] = {"a", "out", NULL};
+    PyObject *a_obj, *b_obj = NULL, *out = Py_None;
+    char format[16];
+    int binary = (op <= DD_DIV);
+    PyOS_snprintf(format, sizeof(format), binary ? "OO|O:%s" : "O|O:%s", name);
+    if (binary ? !PyArg_ParseTupleAndKeywords(args, kwargs, format, binary_kwlist, &a_obj, &b_obj, &out)
+               : !PyArg_ParseTupleAndKeywords(args, kwargs, format, unary_kwlist, &a_obj, &out)) {
+        return NULL;
+    }
+    dd_arg a, b;
+    if (dd_arg_get(a_obj, &a) < 0) {
+        return NULL;
+    }
+    if (binary && dd_arg_get(b_obj, &b) < 0) {
+        dd_arg_release(&a);
+        return NULL;
+    }
+    Py_ssize_t n = a.n;
+    PyObject* result = NULL;
+    if (binary && b.n >= 0) {
+        if (n >= 0 && n != b.n) {
+            PyErr_SetString(PyExc_ValueError, "operands must have the same length");
+            goto done;
+        }
+        n = b.n;
+    }
+    if (n < 0) {
+        PyErr_Format(PyExc_TypeError, "%s() needs at least one buffer operand", name);
+        goto done;
+    }
+    Py_buffer out_views[2];
+    result = dd_get_out_pair(out, n, out_views);
+    if (result == NULL) {
+        goto done;
+    }
+    dd_task task = {op, &a, binary ? &b : NULL, (double*)out_views[0].buf, (double*)out_views[1].buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(dd_elementwise_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&out_views[0]);
+    PyBuffer_Release(&out_views[1]);
+done:
+    dd_arg_release(&a);
+    if (binary) {
+        dd_arg_release(&b);
+    }
+    return result;
+}
+
+#define DD_KERNEL(name, op) \
+    PyObject* calco_##name##_buffers(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return dd_elementwise(op, #name, args, kwargs); \
+    }
+
+DD_KERNEL(dd_add, DD_ADD)
+DD_KERNEL(dd_sub, DD_SUB)
+DD_KERNEL(dd_mul, DD_MUL)
+DD_KERNEL(dd_div, DD_DIV)
+DD_KERNEL(dd_sqrt, DD_SQRT)
+DD_KERNEL(dd_exp, DD_EXP)
+DD_KERNEL(dd_log, DD_LOG)
+DD_KERNEL(dd_sin, DD_SIN)
+DD_KERNEL(dd_cos, DD_COS)
+
+// -----------------------------------------------------------------------------
+// Compensated Sum and Dot Product
+// Each chunk accumulates a double-double partial (Sum2 / Dot2 of Ogita, Rump and Oishi); the
+// partials are then added in chunk order, so the result does not depend on the thread count.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    const double* x;
+    const double* x_lo; // Second half of a (hi, lo) pair for dd_sum, or NULL
+    const double* y;    // NULL for dd_sum
+    Py_ssize_t n;
+    calco_dd* partials;
+} dd_reduce_task;
+
+static void dd_reduce_chunk(void* ctx, Py_ssize_t chunk) {
+    const dd_reduce_task* t = (const dd_reduce_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK > t->n) ? t->n : start + CALCO_DEFAULT_CHUNK;
+    calco_dd s = {0.0, 0.0};
+    if (t->y != NULL) {
+        for (Py_ssize_t i = start; i < end; i++) {
+            double e;
+            double p = calco_two_prod(t->x[i], t->y[i], &e);
+            calco_dd_accumulate(&s, p);
+            s.lo += e;
+        }
+    } else {
+        for (Py_ssize_t i = start; i < end; i++) {
+            calco_dd_accumulate(&s, t->x[i]);
+        }
+        for (Py_ssize_t i = start; t->x_lo != NULL && i < end; i++) {
+            s.lo += t->x_lo[i];
+        }
+    }
+    t->partials[chunk] = calco_isfinite(s.hi) ? calco_dd_norm(s.hi, s.lo) : calco_dd_make(s.hi, 0.0);
+}
+
+static PyObject* dd_reduce_run(dd_reduce_task* t) {
+    Py_ssize_t nchunks = (t->n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    calco_dd total = {0.0, 0.0};
+    if (nchunks > 0) {
+        t->partials = (calco_dd*)PyMem_Malloc(nchunks * sizeof(calco_dd));
+        if (t->partials == NULL) {
+            return PyErr_NoMemory();
+        }
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_parallel_for(dd_reduce_chunk, t, nchunks);
+        Py_END_ALLOW_THREADS
+        for (Py_ssize_t c = 0; c < nchunks; c++) {
+            total = calco_dd_add(total, t->partials[c]);
+        }
+        PyMem_Free(t->partials);
+    }
+    return dd_wrap(total);
+}
+
+PyObject* calco_dd_sum(PyObject* self, PyObject* args) {
+    PyObject* obj;
+    dd_arg a;
+    if (!PyArg_ParseTuple(args, "O:dd_sum", &obj) || dd_arg_get(obj, &a) < 0) {
+        return NULL;
+    }
+    if (a.n < 0) {
+        PyErr_SetString(PyExc_TypeError, "dd_sum() expects a float64 buffer or a (hi, lo) pair of them");
+        return NULL;
+    }
+    dd_reduce_task task = {a.hi, a.lo, NULL, a.n, NULL};
+    PyObject* result = dd_reduce_run(&task);
+    dd_arg_release(&a);
+    return result;
+}
+
+PyObject* calco_dd_dot(PyObject* self, PyObject* args) {
+    PyObject *x_obj, *y_obj;
+    Py_buffer x_view, y_view;
+    if (!PyArg_ParseTuple(args, "OO:dd_dot", &x_obj, &y_obj)) {
+        return NULL;
+    }
+    if (calco_get_double_buffer(x_obj, &x_view, 0) < 0) {
+        return NULL;
+    }
+    if (calco_get_double_buffer(y_obj, &y_view, 0) < 0) {
+        PyBuffer_Release(&x_view);
+        return NULL;
+    }
+    PyObject* result = NULL;
+    if (x_view.len != y_view.len) {
+        PyErr_SetString(PyExc_ValueError, "x and y must have the same length");
+    } else {
+        dd_reduce_task task = {(const double*)x_view.buf, NULL, (const double*)y_view.buf,
+                               x_view.len / (Py_ssize_t)sizeof(double), NULL};
+        result = dd_reduce_run(&task);
+    }
+    PyBuffer_Release(&x_view);
+    PyBuffer_Release(&y_view);
+    return result;
+}
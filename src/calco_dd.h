@@ -0,0 +1,129 @@
+// calco_dd.h
+// Double-double arithmetic: a value is the unevaluated sum hi + lo of two doubles with
+// |lo| <= ulp(hi) / 2, giving about 106 bits (32 decimal digits) of significand.
+// The basic operations are inline so buffer kernels can use them without call overhead; the
+// elementary functions live in calco_dd.c. Accuracy follows the QD library (Hida, Li and
+// Bailey): add/sub/mul/div/sqrt are within a few units of 2^-106 relative.
+
+#ifndef CALCO_DD_H
+#define CALCO_DD_H
+
+#include "calco_eft.h" // TwoSum / TwoProd
+
+typedef struct {
+    double hi;
+    double lo;
+} calco_dd;
+
+static inline calco_dd calco_dd_make(double hi, double lo) {
+    calco_dd r = {hi, lo};
+    return r;
+}
+
+// Renormalizes hi + lo so that hi == fl(hi + lo).
+static inline calco_dd calco_dd_norm(double hi, double lo) {
+    calco_dd r;
+    r.hi = calco_fast_two_sum(hi, lo, &r.lo);
+    return r;
+}
+
+static inline calco_dd calco_dd_neg(calco_dd a) {
+    return calco_dd_make(-a.hi, -a.lo);
+}
+
+// Non-finite results propagate through hi alone; the error terms would otherwise turn an
+// infinity into NaN (inf - inf).
+static inline calco_dd calco_dd_add(calco_dd a, calco_dd b) {
+    double e, f;
+    double s = calco_two_sum(a.hi, b.hi, &e);
+    if (!calco_isfinite(s)) {
+        return calco_dd_make(s, 0.0);
+    }
+    double t = calco_two_sum(a.lo, b.lo, &f);
+    e += t;
+    s = calco_fast_two_sum(s, e, &e);
+    e += f;
+    return calco_dd_norm(s, e);
+}
+
+static inline calco_dd calco_dd_add_d(calco_dd a, double b) {
+    double e;
+    double s = calco_two_sum(a.hi, b, &e);
+    if (!calco_isfinite(s)) {
+        return calco_dd_make(s, 0.0);
+    }
+    return calco_dd_norm(s, e + a.lo);
+}
+
+static inline calco_dd calco_dd_sub(calco_dd a, calco_dd b) {
+    return calco_dd_add(a, calco_dd_neg(b));
+}
+
+static inline calco_dd calco_dd_mul(calco_dd a, calco_dd b) {
+    double e;
+    double p = calco_two_prod(a.hi, b.hi, &e);
+    if (!calco_isfinite(p)) {
+        return calco_dd_make(p, 0.0);
+    }
+    e += a.hi * b.lo + a.lo * b.hi;
+    return calco_dd_norm(p, e);
+}
+
+static inline calco_dd calco_dd_mul_d(calco_dd a, double b) {
+    double e;
+    double p = calco_two_prod(a.hi, b, &e);
+    if (!calco_isfinite(p)) {
+        return calco_dd_make(p, 0.0);
+    }
+    return calco_dd_norm(p, e + a.lo * b);
+}
+
+// Exact product of two doubles as a double-double.
+static inline calco_dd calco_dd_prod(double a, double b) {
+    calco_dd r;
+    r.hi = calco_two_prod(a, b, &r.lo);
+    return calco_isfinite(r.hi) ? r : calco_dd_make(r.hi, 0.0);
+}
+
+// Long division: three double quotients, each correcting the remainder of the last.
+static inline calco_dd calco_dd_div(calco_dd a, calco_dd b) {
+    double q1 = a.hi / b.hi;
+    if (!calco_isfinite(q1) || !calco_isfinite(b.hi) || b.hi == 0.0) {
+        return calco_dd_make(q1, 0.0);
+    }
+    calco_dd r = calco_dd_sub(a, calco_dd_mul_d(b, q1));
+    double q2 = r.hi / b.hi;
+    r = calco_dd_sub(r, calco_dd_mul_d(b, q2));
+    double q3 = r.hi / b.hi;
+    calco_dd q = calco_dd_norm(q1, q2);
+    return calco_dd_add_d(q, q3);
+}
+
+// One Newton step from the double square root (Karp and Markstein).
+static inline calco_dd calco_dd_sqrt(calco_dd a) {
+    if (a.hi <= 0.0) {
+        return calco_dd_make((a.hi == 0.0) ? 0.0 : NAN, 0.0);
+    }
+    double y = sqrt(a.hi);
+    if (!calco_isfinite(y)) {
+        return calco_dd_make(y, 0.0);
+    }
+    double e;
+    double p = calco_two_prod(y, y, &e);
+    double r = ((calco_opaque(a.hi - p) - e) + a.lo) / (2.0 * y);
+    return calco_dd_norm(y, r);
+}
+
+// Accumulates x into the running sum s (Sum2 of Ogita, Rump and Oishi).
+static inline void calco_dd_accumulate(calco_dd* s, double x) {
+    double e;
+    s->hi = calco_two_sum(s->hi, x, &e);
+    s->lo += e;
+}
+
+calco_dd calco_dd_exp(calco_dd a);
+calco_dd calco_dd_log(calco_dd a);
+calco_dd calco_dd_sin(calco_dd a);
+calco_dd calco_dd_cos(calco_dd a);
+
+#endif // CALCO_DD_H
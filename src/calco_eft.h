@@ -0,0 +1,107 @@
+// calco_eft.h
+// Error-free transformations (TwoSum, TwoProd) for compensated arithmetic.
+// The library is built with -ffast-math, which lets the compiler reassociate and cancel the
+// very roundoff terms these functions exist to capture, so every intermediate passes through
+// calco_opaque(): an empty asm statement the optimizer cannot see through (a volatile round
+// trip on compilers without GNU inline asm).
+
+#ifndef CALCO_EFT_H
+#define CALCO_EFT_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2_MATH__)))
+#define CALCO_OPAQUE_CONSTRAINT "+x"
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define CALCO_OPAQUE_CONSTRAINT "+w"
+#endif
+
+static inline double calco_opaque(double v) {
+#ifdef CALCO_OPAQUE_CONSTRAINT
+    __asm__("" : CALCO_OPAQUE_CONSTRAINT(v));
+#else
+    volatile double t = v;
+    v = t;
+#endif
+    return v;
+}
+
+// isfinite() and isnan() for -ffast-math builds, where the compiler may assume every value
+// is finite and fold the library macros to constants. These test the exponent bits directly.
+static inline int calco_isfinite(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x7FF0000000000000ULL) != 0x7FF0000000000000ULL;
+}
+
+static inline int calco_isnan(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x7FFFFFFFFFFFFFFFULL) > 0x7FF0000000000000ULL;
+}
+
+static inline int calco_isnanf(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x7FFFFFFFu) > 0x7F800000u;
+}
+
+// v == c by bit pattern (so +0 and -0 differ). Under -ffast-math the compiler may drop the
+// unordered check from a floating-point ==, so NaN would match; it may also use v == c to skip
+// a separate calco_isnan test. Integer comparison has neither problem and still vectorizes.
+static inline int calco_same_bits(double v, double c) {
+    uint64_t a, b;
+    memcpy(&a, &v, sizeof(a));
+    memcpy(&b, &c, sizeof(b));
+    return a == b;
+}
+
+static inline int calco_same_bitsf(float v, float c) {
+    uint32_t a, b;
+    memcpy(&a, &v, sizeof(a));
+    memcpy(&b, &c, sizeof(b));
+    return a == b;
+}
+
+// Returns s = fl(a + b) and stores e such that s + e == a + b exactly (Knuth).
+static inline double calco_two_sum(double a, double b, double* e) {
+    double s = calco_opaque(a + b);
+    double bb = calco_opaque(s - a);
+    double da = calco_opaque(a - calco_opaque(s - bb));
+    double db = calco_opaque(b - bb);
+    *e = da + db;
+    return s;
+}
+
+// As calco_two_sum, valid only when |a| >= |b| (or a == 0) (Dekker).
+static inline double calco_fast_two_sum(double a, double b, double* e) {
+    double s = calco_opaque(a + b);
+    *e = b - calco_opaque(s - a);
+    return s;
+}
+
+// Returns p = fl(a * b) and stores e such that p + e == a * b exactly, barring overflow
+// (a hardware FMA when available, otherwise Dekker's product with Veltkamp splitting).
+static inline double calco_two_prod(double a, double b, double* e) {
+    double p = calco_opaque(a * b);
+#ifdef FP_FAST_FMA
+    *e = fma(a, b, -p);
+#else
+    const double splitter = 134217729.0; // 2^27 + 1
+    double t = calco_opaque(splitter * a);
+    double ahi = calco_opaque(t - calco_opaque(t - a));
+    double alo = calco_opaque(a - ahi);
+    t = calco_opaque(splitter * b);
+    double bhi = calco_opaque(t - calco_opaque(t - b));
+    double blo = calco_opaque(b - bhi);
+    double err = calco_opaque(calco_opaque(ahi * bhi) - p);
+    err = calco_opaque(err + calco_opaque(ahi * blo));
+    err = calco_opaque(err + calco_opaque(alo * bhi));
+    *e = err + alo * blo;
+#endif
+    return p;
+}
+
+#endif // CALCO_EFT_H
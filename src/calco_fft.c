@@ -0,0 +1,691 @@
+// calco_fft.c
+// Contains the fast Fourier transforms fft, ifft and rfft over rows of complex or real
+// float64/float32 buffers, with plans cached per size.
+//
+// A complex buffer is either interleaved (re, im) float64/float32 values or a buffer with the
+// complex formats 'Zd'/'Zf' (numpy complex128/complex64). Each row is copied into split real
+// and imaginary work arrays (float32 is widened to double), transformed there, and written back
+// in the element type of the input.
+//
+// Power-of-two sizes run an iterative decimation-in-time transform: a bit-reversal permutation,
+// then radix-4 passes (one radix-2 pass first when log2 n is odd), each reading its twiddles
+// contiguously from per-stage tables so that the butterfly loops vectorize. Other sizes use
+// Bluestein's algorithm: the DFT as a convolution with the chirp exp(-i pi k^2 / n), done by
+// two power-of-two transforms of length m >= 2n - 1. rfft of even n packs the row into a
+// complex transform of n / 2 and untangles the halves with one extra pass.
+//
+// Twiddles come from the shared quadrant sincos (calco_sincos.h) with the angle reduced exactly
+// in integers, 2 pi j / N = (pi / 2) (q + d / N), so every table entry is accurate to an ulp.
+// Plans are built with the GIL held and kept in a small most-recently-used cache; a plan is
+// reference counted so that evicting it never frees one that a running transform still uses.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_sincos.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define FFT_CACHE_MAX 32          // Plans kept for reuse
+#define FFT_PARALLEL_MIN 32768    // Rows at least this long split each pass over the pool
+#define FFT_STAGE_CHUNK 8192      // Butterflies per pool chunk within one pass
+#define FFT_ROW_CHUNK 65536       // Work-array points per pool chunk of whole rows
+
+// -----------------------------------------------------------------------------
+// Plans
+// -----------------------------------------------------------------------------
+
+typedef enum { PLAN_POW2, PLAN_BLUESTEIN, PLAN_REAL_HALF, PLAN_REAL_FULL } plan_kind;
+
+typedef struct fft_plan {
+    plan_kind kind;
+    Py_ssize_t n;            // Transform length
+    Py_ssize_t work;         // Length of each work array the transform runs in
+    Py_ssize_t scratch;      // Doubles of scratch per row (work arrays and any extras)
+    int refs;                // Users, plus one while cached (changed with the GIL held)
+    struct fft_plan* next;   // Cache list, most recently used first
+    struct fft_plan* sub;    // Bluestein: power-of-two plan of length work; real: complex plan
+    Py_ssize_t* rev;         // Power of two: bit-reversal permutation
+    double* tw_re;           // Power of two: W_2m^j at offset m - 1; real half: W_n^k, k <= n / 2
+    double* tw_im;
+    double* chirp_re;        // Bluestein: w_k = exp(-i pi k^2 / n)
+    double* chirp_im;
+    double* kern_re;         // Bluestein: FFT_m of conj(w) wrapped to length m, scaled by 1 / m
+    double* kern_im;
+} fft_plan;
+
+static fft_plan* plan_cache = NULL;
+
+// exp(-2 pi i j / N), reducing the angle exactly: with q = round(4 j / N) and d = 4 j - q N,
+// the angle is q pi/2 plus (pi/2) d / N, |d| <= N / 2.
+static void twiddle(uint64_t j, uint64_t n, double* re, double* im) {
+    uint64_t q = (4 * j + n / 2) / n;
+    int64_t d = (int64_t)(4 * j) - (int64_t)(q * n);
+    double s, c;
+    calco_sincos_quadrant((int)(q & 3), (double)d * (1.57079632679489661923 / (double)n), &s, &c);
+    *re = c;
+    *im = -s;
+}
+
+static void pow2_exec(const fft_plan* p, double* re, double* im, int par);
+
+static void plan_release(fft_plan* p) {
+    if (p == NULL || --p->refs > 0) {
+        return;
+    }
+    plan_release(p->sub);
+    PyMem_Free(p->rev);
+    PyMem_Free(p->tw_re);
+    PyMem_Free(p->tw_im);
+    PyMem_Free(p->chirp_re);
+    PyMem_Free(p->chirp_im);
+    PyMem_Free(p->kern_re);
+    PyMem_Free(p->kern_im);
+    PyMem_Free(p);
+}
+
+static fft_plan* plan_acquire(Py_ssize_t n, int real);
+
+static int plan_build(fft_plan* p) {
+    Py_ssize_t n = p->n;
+    if (p->kind == PLAN_POW2) {
+        p->work = n;
+        p->rev = (Py_ssize_t*)PyMem_Malloc(n * sizeof(Py_ssize_t));
+        p->tw_re = (double*)PyMem_Malloc(n * sizeof(double));
+        p->tw_im = (double*)PyMem_Malloc(n * sizeof(double));
+        if (p->rev == NULL || p->tw_re == NULL || p->tw_im == NULL) {
+            return -1;
+        }
+        for (Py_ssize_t i = 0, r = 0; i < n; i++) {
+            p->rev[i] = r;
+            Py_ssize_t bit = n >> 1;
+            while (bit > 0 && (r & bit)) { // Increment r with reversed carries
+                r ^= bit;
+                bit >>= 1;
+            }
+            r |= bit;
+        }
+        for (Py_ssize_t m = 1; m < n; m *= 2) {
+            for (Py_ssize_t j = 0; j < m; j++) {
+                twiddle((uint64_t)j, (uint64_t)(2 * m), &p->tw_re[m - 1 + j], &p->tw_im[m - 1 + j]);
+            }
+        }
+    } else if (p->kind == PLAN_BLUESTEIN) {
+        Py_ssize_t m = 1;
+        while (m < 2 * n - 1) {
+            m *= 2;
+        }
+        if ((p->sub = plan_acquire(m, 0)) == NULL) {
+            return -1;
+        }
+        p->work = m;
+        p->chirp_re = (double*)PyMem_Malloc(n * sizeof(double));
+        p->chirp_im = (double*)PyMem_Malloc(n * sizeof(double));
+        p->kern_re = (double*)PyMem_Calloc(m, sizeof(double));
+        p->kern_im = (double*)PyMem_Calloc(m, sizeof(double));
+        if (p->chirp_re == NULL || p->chirp_im == NULL || p->kern_re == NULL || p->kern_im == NULL) {
+            return -1;
+        }
+        // k^2 mod 2n by the recurrence (k + 1)^2 = k^2 + 2k + 1, exact for any n.
+        uint64_t two_n = 2 * (uint64_t)n, sq = 0;
+        for (Py_ssize_t k = 0; k < n; k++) {
+            twiddle(sq, two_n, &p->chirp_re[k], &p->chirp_im[k]);
+            sq += 2 * (uint64_t)k + 1;
+            sq -= (sq >= two_n) ? two_n : 0;
+            sq -= (sq >= two_n) ? two_n : 0;
+        }
+        for (Py_ssize_t k = 0; k < n; k++) {
+            double br = p->chirp_re[k] / (double)m, bi = -p->chirp_im[k] / (double)m;
+            p->kern_re[k] = br;
+            p->kern_im[k] = bi;
+            if (k > 0) {
+                p->kern_re[m - k] = br;
+                p->kern_im[m - k] = bi;
+            }
+        }
+        pow2_exec(p->sub, p->kern_re, p->kern_im, 0);
+    } else {
+        Py_ssize_t h = n / 2;
+        if ((p->sub = plan_acquire(p->kind == PLAN_REAL_HALF ? h : n, 0)) == NULL) {
+            return -1;
+        }
+        p->work = p->sub->work;
+        if (p->kind == PLAN_REAL_HALF) {
+            p->tw_re = (double*)PyMem_Malloc((h + 1) * sizeof(double));
+            p->tw_im = (double*)PyMem_Malloc((h + 1) * sizeof(double));
+            if (p->tw_re == NULL || p->tw_im == NULL) {
+                return -1;
+            }
+            for (Py_ssize_t k = 0; k <= h; k++) {
+                twiddle((uint64_t)k, (uint64_t)n, &p->tw_re[k], &p->tw_im[k]);
+            }
+        }
+    }
+    p->scratch = 2 * p->work + ((p->kind == PLAN_REAL_HALF) ? 2 * (n / 2 + 1) : 0);
+    return 0;
+}
+
+// Returns a plan for a complex (real == 0) or real-input transform of length n >= 1, from the
+// cache or newly built, with one reference owned by the caller. Requires the GIL.
+static fft_plan* plan_acquire(Py_ssize_t n, int real) {
+    fft_plan **link = &plan_cache, *p;
+    int count = 0;
+    for (; (p = *link) != NULL; link = &p->next, count++) {
+        if (p->n == n && (p->kind == PLAN_REAL_HALF || p->kind == PLAN_REAL_FULL) == (real != 0)) {
+            *link = p->next; // Move to the front
+            p->next = plan_cache;
+            plan_cache = p;
+            p->refs++;
+            return p;
+        }
+    }
+    p = (fft_plan*)PyMem_Calloc(1, sizeof(fft_plan));
+    if (p == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    p->n = n;
+    p->refs = 1;
+    if (real) {
+        p->kind = (n % 2 == 0) ? PLAN_REAL_HALF : PLAN_REAL_FULL;
+    } else {
+        p->kind = ((n & (n - 1)) == 0) ? PLAN_POW2 : PLAN_BLUESTEIN;
+    }
+    if (plan_build(p) < 0) {
+        plan_release(p);
+        if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    p->refs++; // The cache's reference
+    p->next = plan_cache;
+    plan_cache = p;
+    if (count + 1 > FFT_CACHE_MAX) { // Evict the least recently used plan
+        for (link = &plan_cache; (*link)->next != NULL; link = &(*link)->next) {
+        }
+        fft_plan* last = *link;
+        *link = NULL;
+        plan_release(last);
+    }
+    return p;
+}
+
+// -----------------------------------------------------------------------------
+// Power-of-Two Transform
+// -----------------------------------------------------------------------------
+
+static void permute_range(const fft_plan* p, double* re, double* im, Py_ssize_t start, Py_ssize_t end) {
+    const Py_ssize_t* rev = p->rev;
+    for (Py_ssize_t i = start; i < end; i++) {
+        Py_ssize_t r = rev[i];
+        if (i < r) {
+            double tr = re[i], ti = im[i];
+            re[i] = re[r];
+            im[i] = im[r];
+            re[r] = tr;
+            im[r] = ti;
+        }
+    }
+}
+
+// The first pass when log2 n is odd: radix-2 butterflies b in [b0, b1) with unit twiddles.
+static void radix2_range(double* re, double* im, Py_ssize_t b0, Py_ssize_t b1) {
+    for (Py_ssize_t b = b0; b < b1; b++) {
+        double ar = re[2 * b], ai = im[2 * b], cr = re[2 * b + 1], ci = im[2 * b + 1];
+        re[2 * b] = ar + cr;
+        im[2 * b] = ai + ci;
+        re[2 * b + 1] = ar - cr;
+        im[2 * b + 1] = ai - ci;
+    }
+}
+
+// The radix-4 butterflies j in [j0, j1) of one block: two radix-2 stages (half sizes m and 2m)
+// fused, on the quarters x0..x3 of the block with w1 = W_2m^j and w2 = W_4m^j (so that
+// W_4m^(j+m) = -i w2).
+static void radix4_block(double* restrict r0, double* restrict i0, double* restrict r1, double* restrict i1,
+                         double* restrict r2, double* restrict i2, double* restrict r3, double* restrict i3,
+                         const double* restrict w1r, const double* restrict w1i, const double* restrict w2r,
+                         const double* restrict w2i, Py_ssize_t j0, Py_ssize_t j1) {
+    for (Py_ssize_t j = j0; j < j1; j++) {
+        double t1r = w1r[j] * r1[j] - w1i[j] * i1[j], t1i = w1r[j] * i1[j] + w1i[j] * r1[j];
+        double t3r = w1r[j] * r3[j] - w1i[j] * i3[j], t3i = w1r[j] * i3[j] + w1i[j] * r3[j];
+        double b0r = r0[j] + t1r, b0i = i0[j] + t1i, b1r = r0[j] - t1r, b1i = i0[j] - t1i;
+        double b2r = r2[j] + t3r, b2i = i2[j] + t3i, b3r = r2[j] - t3r, b3i = i2[j] - t3i;
+        double u2r = w2r[j] * b2r - w2i[j] * b2i, u2i = w2r[j] * b2i + w2i[j] * b2r;
+        double u3r = w2r[j] * b3r - w2i[j] * b3i, u3i = w2r[j] * b3i + w2i[j] * b3r;
+        r0[j] = b0r + u2r;
+        i0[j] = b0i + u2i;
+        r2[j] = b0r - u2r;
+        i2[j] = b0i - u2i;
+        r1[j] = b1r + u3i;
+        i1[j] = b1i - u3r;
+        r3[j] = b1r - u3i;
+        i3[j] = b1i + u3r;
+    }
+}
+
+// A radix-4 pass over butterflies b in [b0, b1): butterfly b is j = b mod m of block b / m,
+// working on offsets j, j + m, j + 2m and j + 3m of the block.
+static void radix4_range(double* re, double* im, Py_ssize_t m, const double* w1r, const double* w1i,
+                         const double* w2r, const double* w2i, Py_ssize_t b0, Py_ssize_t b1) {
+    if (m == 1) { // Unit twiddles
+        for (Py_ssize_t b = b0; b < b1; b++) {
+            double* xr = re + 4 * b;
+            double* xi = im + 4 * b;
+            double b0r = xr[0] + xr[1], b0i = xi[0] + xi[1], b1r = xr[0] - xr[1], b1i = xi[0] - xi[1];
+            double b2r = xr[2] + xr[3], b2i = xi[2] + xi[3], b3r = xr[2] - xr[3], b3i = xi[2] - xi[3];
+            xr[0] = b0r + b2r;
+            xi[0] = b0i + b2i;
+            xr[2] = b0r - b2r;
+            xi[2] = b0i - b2i;
+            xr[1] = b1r + b3i;
+            xi[1] = b1i - b3r;
+            xr[3] = b1r - b3i;
+            xi[3] = b1i + b3r;
+        }
+        return;
+    }
+    Py_ssize_t b = b0;
+    while (b < b1) {
+        Py_ssize_t blk = b / m, j0 = b - blk * m;
+        Py_ssize_t j1 = (m - j0 < b1 - b) ? m : j0 + (b1 - b);
+        double* r0 = re + 4 * m * blk;
+        double* i0 = im + 4 * m * blk;
+        radix4_block(r0, i0, r0 + m, i0 + m, r0 + 2 * m, i0 + 2 * m, r0 + 3 * m, i0 + 3 * m, w1r, w1i, w2r, w2i, j0, j1);
+        b += j1 - j0;
+    }
+}
+
+// One pass of a power-of-two transform split across the pool.
+typedef struct {
+    const fft_plan* plan;
+    double* re;
+    double* im;
+    int pass;          // 0 permutation, 2 radix-2, 4 radix-4
+    Py_ssize_t m;
+    Py_ssize_t count;  // Indices (permutation) or butterflies in the pass
+} fft_pass_task;
+
+static void fft_pass_chunk(void* ctx, Py_ssize_t chunk) {
+    const fft_pass_task* t = (const fft_pass_task*)ctx;
+    Py_ssize_t b0 = chunk * FFT_STAGE_CHUNK;
+    Py_ssize_t b1 = (b0 + FFT_STAGE_CHUNK < t->count) ? b0 + FFT_STAGE_CHUNK : t->count;
+    const fft_plan* p = t->plan;
+    Py_ssize_t m = t->m;
+    if (t->pass == 0) {
+        permute_range(p, t->re, t->im, b0, b1);
+    } else if (t->pass == 2) {
+        radix2_range(t->re, t->im, b0, b1);
+    } else {
+        radix4_range(t->re, t->im, m, p->tw_re + m - 1, p->tw_im + m - 1, p->tw_re + 2 * m - 1,
+                     p->tw_im + 2 * m - 1, b0, b1);
+    }
+}
+
+static void run_pass(fft_pass_task* t, int par) {
+    Py_ssize_t nchunks = (t->count + FFT_STAGE_CHUNK - 1) / FFT_STAGE_CHUNK;
+    if (par && nchunks > 1) {
+        calco_pool_parallel_for(fft_pass_chunk, t, nchunks);
+    } else {
+        for (Py_ssize_t c = 0; c < nchunks; c++) {
+            fft_pass_chunk(t, c);
+        }
+    }
+}
+
+// Forward transform of re/im in place. With par set, each pass is split over the pool (the
+// caller is not a pool worker).
+static void pow2_exec(const fft_plan* p, double* re, double* im, int par) {
+    Py_ssize_t n = p->n;
+    if (n < 2) {
+        return;
+    }
+    fft_pass_task t = {p, re, im, 0, 0, n};
+    run_pass(&t, par);
+    Py_ssize_t m = 1;
+    int log2n = 0;
+    while (((Py_ssize_t)1 << log2n) < n) {
+        log2n++;
+    }
+    if (log2n & 1) {
+        t.pass = 2;
+        t.count = n / 2;
+        run_pass(&t, par);
+        m = 2;
+    }
+    t.pass = 4;
+    t.count = n / 4;
+    for (; m < n; m *= 4) {
+        t.m = m;
+        run_pass(&t, par);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Bluestein and Real-Input Transforms
+// -----------------------------------------------------------------------------
+
+// Forward transform of re/im[0, n) in place; the arrays have p->work elements.
+static void complex_exec(const fft_plan* p, double* re, double* im, int par) {
+    if (p->kind == PLAN_POW2) {
+        pow2_exec(p, re, im, par);
+        return;
+    }
+    Py_ssize_t n = p->n, m = p->work;
+    const double *wr = p->chirp_re, *wi = p->chirp_im, *kr = p->kern_re, *ki = p->kern_im;
+    for (Py_ssize_t k = 0; k < n; k++) {
+        double xr = re[k], xi = im[k];
+        re[k] = xr * wr[k] - xi * wi[k];
+        im[k] = xr * wi[k] + xi * wr[k];
+    }
+    memset(re + n, 0, (m - n) * sizeof(double));
+    memset(im + n, 0, (m - n) * sizeof(double));
+    pow2_exec(p->sub, re, im, par);
+    for (Py_ssize_t k = 0; k < m; k++) { // conj(A * B / m): the inverse transform as a forward one
+        double ar = re[k], ai = im[k];
+        re[k] = ar * kr[k] - ai * ki[k];
+        im[k] = -(ar * ki[k] + ai * kr[k]);
+    }
+    pow2_exec(p->sub, re, im, par);
+    for (Py_ssize_t k = 0; k < n; k++) {
+        double cr = re[k], ci = -im[k];
+        re[k] = cr * wr[k] - ci * wi[k];
+        im[k] = cr * wi[k] + ci * wr[k];
+    }
+}
+
+// Real-input transform of even length n: re/im hold the packed z_j = x_2j + i x_2j+1 on entry,
+// and X[0, n/2] is written to xr/xi.
+static void real_half_exec(const fft_plan* p, double* re, double* im, double* xr, double* xi, int par) {
+    Py_ssize_t h = p->n / 2;
+    complex_exec(p->sub, re, im, par);
+    const double *wr = p->tw_re, *wi = p->tw_im;
+    for (Py_ssize_t k = 0; k <= h; k++) {
+        Py_ssize_t a = (k == h) ? 0 : k, b = (k == 0) ? 0 : h - k;
+        double zr = re[a], zi = im[a], cr = re[b], ci = -im[b];
+        double er = 0.5 * (zr + cr), ei = 0.5 * (zi + ci);
+        double or_ = 0.5 * (zi - ci), oi = -0.5 * (zr - cr); // (Z_k - conj Z_h-k) / 2i
+        xr[k] = er + wr[k] * or_ - wi[k] * oi;
+        xi[k] = ei + wr[k] * oi + wi[k] * or_;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Rows
+// -----------------------------------------------------------------------------
+
+typedef enum { FFT_FORWARD, FFT_INVERSE, FFT_REAL } fft_op;
+
+typedef struct {
+    const fft_plan* plan;
+    fft_op op;
+    int is_float32;
+    const void* in;
+    void* out;
+    Py_ssize_t rows, cols;
+    Py_ssize_t out_cols;        // Complex values per output row
+    Py_ssize_t rows_per_chunk;
+    int nomem;
+} fft_task;
+
+static void load(const fft_task* t, Py_ssize_t r, double* re, double* im) {
+    Py_ssize_t c = t->cols;
+    double sgn = (t->op == FFT_INVERSE) ? -1.0 : 1.0; // ifft(x) = conj(fft(conj(x))) / n
+    if (t->op == FFT_REAL) {
+        if (t->plan->kind == PLAN_REAL_HALF) { // Pack pairs of reals into complex values
+            if (t->is_float32) {
+                const float* x = (const float*)t->in + r * c;
+                for (Py_ssize_t j = 0; j < c / 2; j++) {
+                    re[j] = x[2 * j];
+                    im[j] = x[2 * j + 1];
+                }
+            } else {
+                const double* x = (const double*)t->in + r * c;
+                for (Py_ssize_t j = 0; j < c / 2; j++) {
+                    re[j] = x[2 * j];
+                    im[j] = x[2 * j + 1];
+                }
+            }
+        } else if (t->is_float32) {
+            const float* x = (const float*)t->in + r * c;
+            for (Py_ssize_t j = 0; j < c; j++) {
+                re[j] = x[j];
+            }
+        } else {
+            memcpy(re, (const double*)t->in + r * c, c * sizeof(double));
+        }
+        return;
+    }
+    if (t->is_float32) {
+        const float* x = (const float*)t->in + 2 * r * c;
+        for (Py_ssize_t j = 0; j < c; j++) {
+            re[j] = x[2 * j];
+            im[j] = sgn * x[2 * j + 1];
+        }
+    } else {
+        const double* x = (const double*)t->in + 2 * r * c;
+        for (Py_ssize_t j = 0; j < c; j++) {
+            re[j] = x[2 * j];
+            im[j] = sgn * x[2 * j + 1];
+        }
+    }
+}
+
+static void store(const fft_task* t, Py_ssize_t r, const double* re, const double* im) {
+    Py_ssize_t c = t->out_cols;
+    double scale = (t->op == FFT_INVERSE) ? 1.0 / (double)t->cols : 1.0;
+    double sgn = (t->op == FFT_INVERSE) ? -scale : scale;
+    if (t->is_float32) {
+        float* y = (float*)t->out + 2 * r * c;
+        for (Py_ssize_t k = 0; k < c; k++) {
+            y[2 * k] = (float)(re[k] * scale);
+            y[2 * k + 1] = (float)(im[k] * sgn);
+        }
+    } else {
+        double* y = (double*)t->out + 2 * r * c;
+        for (Py_ssize_t k = 0; k < c; k++) {
+            y[2 * k] = re[k] * scale;
+            y[2 * k + 1] = im[k] * sgn;
+        }
+    }
+}
+
+static void run_row(const fft_task* t, Py_ssize_t r, double* scratch, int par) {
+    const fft_plan* p = t->plan;
+    double* re = scratch;
+    double* im = scratch + p->work;
+    load(t, r, re, im);
+    if (t->op == FFT_REAL && p->kind == PLAN_REAL_HALF) {
+        double* xr = im + p->work;
+        double* xi = xr + (t->cols / 2 + 1);
+        real_half_exec(p, re, im, xr, xi, par);
+        store(t, r, xr, xi);
+    } else if (t->op == FFT_REAL) { // Odd n: a complex transform of the row with zero imaginary parts
+        memset(im, 0, t->cols * sizeof(double));
+        complex_exec(p->sub, re, im, par);
+        store(t, r, re, im);
+    } else {
+        complex_exec(p, re, im, par);
+        store(t, r, re, im);
+    }
+}
+
+static void fft_rows_chunk(void* ctx, Py_ssize_t chunk) {
+    fft_task* t = (fft_task*)ctx;
+    Py_ssize_t start = chunk * t->rows_per_chunk;
+    Py_ssize_t end = (start + t->rows_per_chunk < t->rows) ? start + t->rows_per_chunk : t->rows;
+    double* scratch = (double*)PyMem_RawMalloc(t->plan->scratch * sizeof(double));
+    if (scratch == NULL) {
+        t->nomem = 1;
+        return;
+    }
+    for (Py_ssize_t r = start; r < end; r++) {
+        run_row(t, r, scratch, 0);
+    }
+    PyMem_RawFree(scratch);
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers
+// -----------------------------------------------------------------------------
+
+// Acquires a C-contiguous float64/float32 buffer, also accepting the complex formats 'Zd' and
+// 'Zf' as interleaved pairs. Sets *fmt to 'd' or 'f' and *cplx for the Z formats, and returns
+// the number of float values, or -1 with an exception set.
+static Py_ssize_t fft_get_buffer(PyObject* obj, Py_buffer* view, int writable, int* fmt, int* cplx) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj, view, flags) < 0) {
+        return -1;
+    }
+    const char* f = (view->format != NULL) ? view->format : "B";
+    if (f[0] == '<' || f[0] == '=' || f[0] == '@') {
+        f++;
+    }
+    *cplx = 0;
+    if (f[0] == 'Z' && (f[1] == 'd' || f[1] == 'f') && f[2] == 0 && view->itemsize == ((f[1] == 'd') ? 16 : 8)) {
+        *fmt = f[1];
+        *cplx = 1;
+    } else {
+        *fmt = calco_buffer_format(view);
+        if (*fmt != 'd' && *fmt != 'f') {
+            PyBuffer_Release(view);
+            PyErr_SetString(PyExc_TypeError, "expected a contiguous float64/float32 buffer (interleaved re, im for "
+                                             "complex data) or a complex128/complex64 buffer");
+            return -1;
+        }
+    }
+    return view->len / ((*fmt == 'd') ? 8 : 4);
+}
+
+static PyObject* fft_run(PyObject* args, PyObject* kwargs, fft_op op) {
+    static char* kwlist[] = {"x", "cols", "out", "parallel", NULL};
+    PyObject *x, *cols_obj = Py_None, *out = Py_None, *out_obj = NULL;
+    int parallel = 1, fmt, cplx, out_fmt, out_cplx;
+    Py_buffer in_view, out_view;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$Op", kwlist, &x, &cols_obj, &out, &parallel)) {
+        return NULL;
+    }
+    Py_ssize_t nvals = fft_get_buffer(x, &in_view, 0, &fmt, &cplx);
+    if (nvals < 0) {
+        return NULL;
+    }
+    if (op == FFT_REAL && cplx) {
+        PyBuffer_Release(&in_view);
+        PyErr_SetString(PyExc_TypeError, "rfft expects real input");
+        return NULL;
+    }
+    int real = (op == FFT_REAL);
+    Py_ssize_t per_value = real ? 1 : 2;   // Floats per input point
+    if (!real && nvals % 2 != 0) {
+        PyBuffer_Release(&in_view);
+        PyErr_SetString(PyExc_ValueError, "interleaved complex input must have an even number of values");
+        return NULL;
+    }
+    Py_ssize_t points = nvals / per_value, cols;
+    if (cols_obj != Py_None) {
+        cols = PyLong_AsSsize_t(cols_obj);
+        if (cols == -1 && PyErr_Occurred()) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+    } else if (in_view.ndim == 2) {
+        cols = cplx ? in_view.shape[1] : in_view.shape[1] / per_value;
+    } else {
+        cols = points;
+    }
+    if (points == 0 && cols_obj == Py_None) {
+        cols = 1; // An empty buffer is zero rows, and transforms to an empty result
+    }
+    if (cols < 1 || points % cols != 0) {
+        PyBuffer_Release(&in_view);
+        PyErr_Format(PyExc_ValueError, "cols must be at least 1 and divide the %zd input points", points);
+        return NULL;
+    }
+    Py_ssize_t rows = points / cols;
+    Py_ssize_t out_cols = real ? cols / 2 + 1 : cols;
+    Py_ssize_t out_vals = 2 * rows * out_cols;
+    if (out == Py_None) {
+        if ((out_obj = calco_new_array((char)fmt, out_vals, &out_view)) == NULL) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+    } else {
+        Py_ssize_t have = fft_get_buffer(out, &out_view, 1, &out_fmt, &out_cplx);
+        if (have < 0) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+        const char* ob = (const char*)out_view.buf;
+        const char* ib = (const char*)in_view.buf;
+        const char* msg = NULL;
+        if (out_fmt != fmt) {
+            msg = "out must have the same element type as x";
+        } else if (have < out_vals) {
+            msg = "out buffer is smaller than the result";
+        } else if (real && ob < ib + in_view.len && ib < ob + out_view.len) {
+            msg = "rfft cannot write into its input";
+        }
+        if (msg != NULL) {
+            PyBuffer_Release(&in_view);
+            PyBuffer_Release(&out_view);
+            PyErr_SetString(PyExc_ValueError, msg);
+            return NULL;
+        }
+        Py_INCREF(out);
+        out_obj = out;
+    }
+    if (rows == 0) {
+        PyBuffer_Release(&in_view);
+        PyBuffer_Release(&out_view);
+        return out_obj;
+    }
+    fft_plan* plan = plan_acquire(cols, real);
+    if (plan == NULL) {
+        goto fail;
+    }
+    fft_task task = {plan, op, fmt == 'f', in_view.buf, out_view.buf, rows, cols, out_cols, 1, 0};
+    if (parallel && cols < FFT_PARALLEL_MIN) { // Whole rows per pool chunk
+        task.rows_per_chunk = (FFT_ROW_CHUNK / plan->work > 1) ? FFT_ROW_CHUNK / plan->work : 1;
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_parallel_for(fft_rows_chunk, &task, (rows + task.rows_per_chunk - 1) / task.rows_per_chunk);
+        Py_END_ALLOW_THREADS
+    } else { // Long rows one at a time, each pass split over the pool
+        double* scratch = (double*)PyMem_Malloc(plan->scratch * sizeof(double));
+        if (scratch == NULL) {
+            plan_release(plan);
+            PyErr_NoMemory();
+            goto fail;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        for (Py_ssize_t r = 0; r < rows; r++) {
+            run_row(&task, r, scratch, parallel);
+        }
+        Py_END_ALLOW_THREADS
+        PyMem_Free(scratch);
+    }
+    plan_release(plan);
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    if (task.nomem) {
+        Py_DECREF(out_obj);
+        return PyErr_NoMemory();
+    }
+    return out_obj;
+fail:
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    Py_DECREF(out_obj);
+    return NULL;
+}
+
+PyObject* calco_fft(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return fft_run(args, kwargs, FFT_FORWARD);
+}
+
+PyObject* calco_ifft(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return fft_run(args, kwargs, FFT_INVERSE);
+}
+
+PyObject* calco_rfft(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return fft_run(args, kwargs, FFT_REAL);
+}
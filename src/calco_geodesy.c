@@ -0,0 +1,517 @@
+// calco_geodesy.c
+// Contains fused coordinate-transform and geodesic kernels over buffers of points: polar and
+// spherical conversions, haversine distance, initial bearing and Vincenty's ellipsoidal
+// distance. Angles may be given in degrees and are reduced in degrees (calco_sincos.h), so a
+// point costs one pass instead of a chain of calco calls and temporaries.
+//
+// Every coordinate argument is a float or a float64 buffer (SoA: one buffer per coordinate);
+// floats broadcast against buffers. With only floats the result is a float (or a tuple of
+// floats); otherwise new arrays, or the out= buffer(s).
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isnan (isnan is folded away under -ffast-math)
+#include "calco_sincos.h"
+
+#include <string.h>
+
+#define GEO_MAX_IN 4
+#define GEO_MAX_OUT 3
+
+// Mean Earth radius (IUGG) and the WGS 84 ellipsoid.
+#define GEO_EARTH_RADIUS 6371008.8
+#define GEO_WGS84_A 6378137.0
+#define GEO_WGS84_F (1.0 / 298.257223563)
+
+// -----------------------------------------------------------------------------
+// Batch Driver
+// Kernels see contiguous arrays only: each chunk is walked in blocks of GEO_BLOCK points, and a
+// scalar operand is expanded once into a block of copies, so the loops over points stay free of
+// strides and vectorize whether or not an operand broadcasts.
+// -----------------------------------------------------------------------------
+
+#define GEO_BLOCK 512
+
+typedef struct geo_task geo_task;
+
+// Evaluates n points; returns the number of points that failed (Vincenty only).
+typedef Py_ssize_t (*geo_kernel)(const geo_task* t, const double* const* in, double* const* out, Py_ssize_t n);
+
+struct geo_task {
+    geo_kernel kernel;
+    const double* in[GEO_MAX_IN];
+    Py_ssize_t step[GEO_MAX_IN]; // 1 for a buffer, 0 for a broadcast scalar
+    int nin, nout;
+    double* out[GEO_MAX_OUT];
+    Py_ssize_t n;
+    int degrees;
+    double p[4];               // Kernel parameters (radius, ellipsoid, tolerance)
+    int max_iter;
+    Py_ssize_t* failed;        // Per-chunk count of points that did not converge (Vincenty)
+};
+
+static void geo_chunk(void* ctx, Py_ssize_t chunk) {
+    geo_task* t = (geo_task*)ctx;
+    double broadcast[GEO_MAX_IN][GEO_BLOCK];
+    const double* in[GEO_MAX_IN];
+    double* out[GEO_MAX_OUT];
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    Py_ssize_t failed = 0;
+    int k;
+    for (k = 0; k < t->nin; k++) {
+        if (t->step[k] == 0) {
+            for (Py_ssize_t i = 0; i < GEO_BLOCK; i++) {
+                broadcast[k][i] = t->in[k][0];
+            }
+        }
+    }
+    for (Py_ssize_t i = start; i < end; i += GEO_BLOCK) {
+        Py_ssize_t len = (end - i < GEO_BLOCK) ? end - i : GEO_BLOCK;
+        for (k = 0; k < t->nin; k++) {
+            in[k] = t->step[k] ? t->in[k] + i : broadcast[k];
+        }
+        for (k = 0; k < t->nout; k++) {
+            out[k] = t->out[k] + i;
+        }
+        failed += t->kernel(t, in, out, len);
+    }
+    if (t->failed != NULL) {
+        t->failed[chunk] = failed;
+    }
+}
+
+// Reads the nin operands, runs the kernel over them on the pool and builds the result.
+// Returns a new reference, or NULL with an exception set. *failed receives the total of the
+// per-chunk failure counts when not NULL.
+static PyObject* geo_run(geo_task* task, PyObject* const* ins, int nin, int nout, PyObject* out,
+                         Py_ssize_t* failed) {
+    Py_buffer views[GEO_MAX_IN], out_views[GEO_MAX_OUT];
+    double scalars[GEO_MAX_IN];
+    double scalar_out[GEO_MAX_OUT];
+    PyObject* out_objs[GEO_MAX_OUT] = {NULL};
+    int nout_views = 0, k;
+    Py_ssize_t n = -1;
+    PyObject* result = NULL;
+    int is_view[GEO_MAX_IN] = {0};
+    for (k = 0; k < nin; k++) {
+        if (PyFloat_Check(ins[k]) || PyLong_Check(ins[k])) {
+            scalars[k] = PyFloat_AsDouble(ins[k]);
+            if (PyErr_Occurred()) {
+                goto done;
+            }
+            task->in[k] = &scalars[k];
+            task->step[k] = 0;
+            continue;
+        }
+        if (calco_get_double_buffer(ins[k], &views[k], 0) < 0) {
+            goto done;
+        }
+        is_view[k] = 1;
+        Py_ssize_t len = views[k].len / (Py_ssize_t)sizeof(double);
+        if (n >= 0 && len != n) {
+            PyErr_SetString(PyExc_ValueError, "coordinate buffers must have the same length");
+            goto done;
+        }
+        n = len;
+        task->in[k] = (const double*)views[k].buf;
+        task->step[k] = 1;
+    }
+    int scalar_mode = (n < 0);
+    if (scalar_mode) {
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires at least one buffer operand");
+            goto done;
+        }
+        n = 1;
+        for (k = 0; k < nout; k++) {
+            task->out[k] = &scalar_out[k];
+        }
+    } else if (nout == 1) {
+        if (calco_get_out_buffer(out, n, &out_views[0], &out_objs[0]) < 0) {
+            goto done;
+        }
+        nout_views = 1;
+        task->out[0] = (double*)out_views[0].buf;
+    } else {
+        if (out != Py_None && (!PyTuple_Check(out) || PyTuple_GET_SIZE(out) != nout)) {
+            PyErr_Format(PyExc_TypeError, "out must be a tuple of %d float64 buffers", nout);
+            goto done;
+        }
+        for (k = 0; k < nout; k++) {
+            if (calco_get_out_buffer((out == Py_None) ? Py_None : PyTuple_GET_ITEM(out, k), n, &out_views[k],
+                                     &out_objs[k]) < 0) {
+                goto done;
+            }
+            nout_views++;
+            task->out[k] = (double*)out_views[k].buf;
+        }
+    }
+    task->n = n;
+    task->nin = nin;
+    task->nout = nout;
+    Py_ssize_t nchunks = (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    if (failed != NULL) {
+        task->failed = (Py_ssize_t*)PyMem_Calloc(nchunks > 0 ? nchunks : 1, sizeof(Py_ssize_t));
+        if (task->failed == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(geo_chunk, task, nchunks);
+    Py_END_ALLOW_THREADS
+    if (failed != NULL) {
+        *failed = 0;
+        for (Py_ssize_t c = 0; c < nchunks; c++) {
+            *failed += task->failed[c];
+        }
+        PyMem_Free(task->failed);
+    }
+    if (scalar_mode) {
+        result = (nout == 1) ? PyFloat_FromDouble(scalar_out[0])
+               : (nout == 2) ? Py_BuildValue("(dd)", scalar_out[0], scalar_out[1])
+                             : Py_BuildValue("(ddd)", scalar_out[0], scalar_out[1], scalar_out[2]);
+    } else if (nout == 1) {
+        result = out_objs[0];
+        out_objs[0] = NULL;
+    } else {
+        result = PyTuple_New(nout);
+        for (k = 0; result != NULL && k < nout; k++) {
+            PyTuple_SET_ITEM(result, k, out_objs[k]);
+            out_objs[k] = NULL;
+        }
+    }
+done:
+    for (k = 0; k < nin; k++) {
+        if (is_view[k]) {
+            PyBuffer_Release(&views[k]);
+        }
+    }
+    for (k = 0; k < nout_views; k++) {
+        PyBuffer_Release(&out_views[k]);
+    }
+    for (k = 0; k < nout; k++) {
+        Py_XDECREF(out_objs[k]);
+    }
+    return result;
+}
+
+// sin and cos of n angles in degrees or radians, as separate passes: a loop that needs both
+// sin(x) and cos(x) of one radian x is merged into a scalar sincos call and stays scalar, while
+// single-function loops map onto the vector math library.
+static void geo_sincos(const double* x, int degrees, double* s, double* c, Py_ssize_t n) {
+    Py_ssize_t i;
+    if (degrees) {
+        for (i = 0; i < n; i++) {
+            calco_sincos_deg(x[i], &s[i], &c[i]);
+        }
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        s[i] = sin(x[i]);
+    }
+    for (i = 0; i < n; i++) {
+        c[i] = cos(x[i]);
+    }
+}
+
+static inline double geo_angle_out(double radians, int degrees) {
+    return degrees ? radians * CALCO_RAD_TO_DEG : radians;
+}
+
+// -----------------------------------------------------------------------------
+// Coordinate Transforms
+// Spherical coordinates are geographic: latitude from the equator, longitude from the x axis.
+// -----------------------------------------------------------------------------
+
+static Py_ssize_t k_polar_to_cartesian(const geo_task* t, const double* const* in, double* const* out,
+                                       Py_ssize_t n) {
+    const double* r = in[0];
+    double *x = out[0], *y = out[1];
+    geo_sincos(in[1], t->degrees, y, x, n);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        x[i] *= r[i];
+        y[i] *= r[i];
+    }
+    return 0;
+}
+
+static Py_ssize_t k_cartesian_to_polar(const geo_task* t, const double* const* in, double* const* out,
+                                       Py_ssize_t n) {
+    const double *x = in[0], *y = in[1];
+    double *r = out[0], *theta = out[1];
+    double scale = geo_angle_out(1.0, t->degrees);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        r[i] = hypot(x[i], y[i]);
+        theta[i] = scale * atan2(y[i], x[i]);
+    }
+    return 0;
+}
+
+static Py_ssize_t k_spherical_to_cartesian(const geo_task* t, const double* const* in, double* const* out,
+                                           Py_ssize_t n) {
+    double slon[GEO_BLOCK], clon[GEO_BLOCK];
+    const double* r = in[0];
+    double *x = out[0], *y = out[1], *z = out[2];
+    geo_sincos(in[1], t->degrees, z, x, n); // sin(lat) and cos(lat)
+    geo_sincos(in[2], t->degrees, slon, clon, n);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double rc = r[i] * x[i];
+        x[i] = rc * clon[i];
+        y[i] = rc * slon[i];
+        z[i] *= r[i];
+    }
+    return 0;
+}
+
+static Py_ssize_t k_cartesian_to_spherical(const geo_task* t, const double* const* in, double* const* out,
+                                           Py_ssize_t n) {
+    const double *x = in[0], *y = in[1], *z = in[2];
+    double *r = out[0], *lat = out[1], *lon = out[2];
+    double scale = geo_angle_out(1.0, t->degrees);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double rho = hypot(x[i], y[i]);
+        r[i] = hypot(rho, z[i]);
+        lat[i] = scale * atan2(z[i], rho);
+        lon[i] = scale * atan2(y[i], x[i]);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Geodesics
+// Inputs are (lat1, lon1, lat2, lon2). Haversine works on a sphere of the given radius; the
+// half-angle differences are reduced in the input unit, so nearby points keep their digits.
+// -----------------------------------------------------------------------------
+
+static Py_ssize_t k_haversine(const geo_task* t, const double* const* in, double* const* out,
+                              Py_ssize_t n) {
+    double s1[GEO_BLOCK], c1[GEO_BLOCK], s2[GEO_BLOCK], c2[GEO_BLOCK];
+    double hlat[GEO_BLOCK], hlon[GEO_BLOCK];
+    const double *lat1 = in[0], *lon1 = in[1], *lat2 = in[2], *lon2 = in[3];
+    double* d = out[0];
+    double diameter = 2.0 * t->p[0];
+    Py_ssize_t i;
+    if (n <= 0) {
+        return 0; // Never taken; tells the compiler the scratch below gets filled
+    }
+    for (i = 0; i < n; i++) {
+        hlat[i] = 0.5 * (lat2[i] - lat1[i]);
+        hlon[i] = 0.5 * (lon2[i] - lon1[i]);
+    }
+    geo_sincos(lat1, t->degrees, s1, c1, n);
+    geo_sincos(lat2, t->degrees, s2, c2, n);
+    // Only the cosines of the latitudes and the sines of the half differences are used; the
+    // rest lands in scratch.
+    geo_sincos(hlat, t->degrees, d, s1, n);
+    geo_sincos(hlon, t->degrees, s2, s1, n);
+    // The clamp is a min, which -ffast-math may resolve to 1 for NaN; a NaN input (and so a NaN
+    // h) is passed through by bit test instead of becoming half the circumference.
+    for (i = 0; i < n; i++) {
+        double h = d[i] * d[i] + c1[i] * c2[i] * s2[i] * s2[i];
+        double hc = (h < 1.0) ? h : 1.0;
+        d[i] = calco_isnan(h) ? h : diameter * asin(sqrt(hc));
+    }
+    return 0;
+}
+
+// Initial bearing, clockwise from north, in [0, 360) degrees (or [0, 2 pi) radians).
+static Py_ssize_t k_bearing(const geo_task* t, const double* const* in, double* const* out,
+                            Py_ssize_t n) {
+    double s1[GEO_BLOCK], c1[GEO_BLOCK], s2[GEO_BLOCK], c2[GEO_BLOCK], sdl[GEO_BLOCK], cdl[GEO_BLOCK];
+    const double *lat1 = in[0], *lon1 = in[1], *lat2 = in[2], *lon2 = in[3];
+    double* b = out[0];
+    double scale = geo_angle_out(1.0, t->degrees);
+    double full = scale * (2.0 * M_PI);
+    Py_ssize_t i;
+    for (i = 0; i < n; i++) {
+        b[i] = lon2[i] - lon1[i]; // The output holds the longitude difference until the last pass
+    }
+    geo_sincos(lat1, t->degrees, s1, c1, n);
+    geo_sincos(lat2, t->degrees, s2, c2, n);
+    geo_sincos(b, t->degrees, sdl, cdl, n);
+    for (i = 0; i < n; i++) {
+        double theta = scale * atan2(sdl[i] * c2[i], c1[i] * s2[i] - s1[i] * c2[i] * cdl[i]);
+        b[i] = (theta < 0.0) ? theta + full : theta; // NaN stays NaN on either side
+    }
+    return 0;
+}
+
+// Vincenty's inverse formula on an ellipsoid with semi-major axis a and flattening f,
+// iterating on the longitude on the auxiliary sphere. Nearly antipodal points may not
+// converge; they give NaN and are counted in t->failed.
+static Py_ssize_t k_vincenty(const geo_task* t, const double* const* in, double* const* out,
+                             Py_ssize_t n) {
+    const double *lat1s = in[0], *lon1s = in[1], *lat2s = in[2], *lon2s = in[3];
+    double* d = out[0];
+    double a = t->p[0], f = t->p[1], tol = t->p[2];
+    double b = a * (1.0 - f);
+    int degrees = t->degrees;
+    double s1[GEO_BLOCK], c1[GEO_BLOCK], s2[GEO_BLOCK], c2[GEO_BLOCK];
+    Py_ssize_t failed = 0;
+    geo_sincos(lat1s, degrees, s1, c1, n);
+    geo_sincos(lat2s, degrees, s2, c2, n);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double lat1 = lat1s[i], lon1 = lon1s[i], lat2 = lat2s[i], lon2 = lon2s[i];
+        double sp1 = s1[i], cp1 = c1[i], sp2 = s2[i], cp2 = c2[i];
+        // NaN input: NaN out, not a failure. Tested up front because -ffast-math may let a NaN
+        // sin_sigma pass the coincident-points test below and give a distance of 0.
+        if (calco_isnan(lat1) || calco_isnan(lon1) || calco_isnan(lat2) || calco_isnan(lon2)) {
+            d[i] = NAN;
+            continue;
+        }
+        // Reduced latitudes: tan U = (1 - f) tan(lat), without forming the tangent.
+        double n1 = hypot((1.0 - f) * sp1, cp1), n2 = hypot((1.0 - f) * sp2, cp2);
+        double su1 = (1.0 - f) * sp1 / n1, cu1 = cp1 / n1;
+        double su2 = (1.0 - f) * sp2 / n2, cu2 = cp2 / n2;
+        double L = degrees ? (lon2 - lon1) * CALCO_DEG_TO_RAD : lon2 - lon1;
+        double lambda = L, sin_sigma = 0.0, cos_sigma = 1.0, sigma = 0.0, cos2_alpha = 1.0, cos_2sm = 0.0;
+        int it, converged = 0;
+        for (it = 0; it < t->max_iter; it++) {
+            double sl = sin(lambda), cl = cos(lambda);
+            double p = cu2 * sl, q = cu1 * su2 - su1 * cu2 * cl;
+            sin_sigma = sqrt(p * p + q * q);
+            cos_sigma = su1 * su2 + cu1 * cu2 * cl;
+            if (sin_sigma == 0.0 && cos_sigma > 0.0) {
+                converged = 1; // Coincident points
+                break;
+            }
+            // sin_sigma == 0 with cos_sigma < 0: antipodal points on a meridian (pole to pole), so
+            // sigma = pi along a meridian (alpha = 0).
+            sigma = atan2(sin_sigma, cos_sigma);
+            double sin_alpha = (sin_sigma != 0.0) ? cu1 * cu2 * sl / sin_sigma : 0.0;
+            cos2_alpha = 1.0 - sin_alpha * sin_alpha;
+            cos_2sm = (cos2_alpha != 0.0) ? cos_sigma - 2.0 * su1 * su2 / cos2_alpha : 0.0;
+            double C = f / 16.0 * cos2_alpha * (4.0 + f * (4.0 - 3.0 * cos2_alpha));
+            double prev = lambda;
+            lambda = L + (1.0 - C) * f * sin_alpha *
+                     (sigma + C * sin_sigma * (cos_2sm + C * cos_sigma * (-1.0 + 2.0 * cos_2sm * cos_2sm)));
+            if (fabs(lambda - prev) <= tol) {
+                converged = 1;
+                break;
+            }
+        }
+        if (!converged || calco_isnan(lambda)) {
+            d[i] = NAN;
+            failed++;
+            continue;
+        }
+        if (sin_sigma == 0.0 && cos_sigma > 0.0) {
+            d[i] = 0.0;
+            continue;
+        }
+        double u2 = cos2_alpha * (a * a - b * b) / (b * b);
+        double A = 1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)));
+        double B = u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)));
+        double c2 = cos_2sm * cos_2sm;
+        double dsigma = B * sin_sigma * (cos_2sm + B / 4.0 * (cos_sigma * (-1.0 + 2.0 * c2) -
+                        B / 6.0 * cos_2sm * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * c2)));
+        d[i] = b * A * (sigma - dsigma);
+    }
+    return failed;
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers
+// -----------------------------------------------------------------------------
+
+static PyObject* transform(PyObject* args, PyObject* kwargs, char** kwlist, const char* fmt, int nin, int nout,
+                           geo_kernel kernel, int default_degrees) {
+    PyObject* ins[GEO_MAX_IN] = {NULL};
+    PyObject* out = Py_None;
+    int degrees = default_degrees;
+    int ok = (nin == 2) ? PyArg_ParseTupleAndKeywords(args, kwargs, fmt, kwlist, &ins[0], &ins[1], &degrees, &out)
+                        : PyArg_ParseTupleAndKeywords(args, kwargs, fmt, kwlist, &ins[0], &ins[1], &ins[2], &degrees,
+                                                      &out);
+    if (!ok) {
+        return NULL;
+    }
+    geo_task task;
+    memset(&task, 0, sizeof(task));
+    task.kernel = kernel;
+    task.degrees = degrees;
+    return geo_run(&task, ins, nin, nout, out, NULL);
+}
+
+PyObject* calco_polar_to_cartesian(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"r", "theta", "degrees", "out", NULL};
+    return transform(args, kwargs, kwlist, "OO|$pO", 2, 2, k_polar_to_cartesian, 0);
+}
+
+PyObject* calco_cartesian_to_polar(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "y", "degrees", "out", NULL};
+    return transform(args, kwargs, kwlist, "OO|$pO", 2, 2, k_cartesian_to_polar, 0);
+}
+
+PyObject* calco_spherical_to_cartesian(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"r", "lat", "lon", "degrees", "out", NULL};
+    return transform(args, kwargs, kwlist, "OOO|$pO", 3, 3, k_spherical_to_cartesian, 1);
+}
+
+PyObject* calco_cartesian_to_spherical(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "y", "z", "degrees", "out", NULL};
+    return transform(args, kwargs, kwlist, "OOO|$pO", 3, 3, k_cartesian_to_spherical, 1);
+}
+
+PyObject* calco_haversine(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"lat1", "lon1", "lat2", "lon2", "radius", "degrees", "out", NULL};
+    PyObject* ins[4];
+    PyObject* out = Py_None;
+    geo_task task;
+    memset(&task, 0, sizeof(task));
+    task.p[0] = GEO_EARTH_RADIUS;
+    task.degrees = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|$dpO", kwlist, &ins[0], &ins[1], &ins[2], &ins[3],
+                                     &task.p[0], &task.degrees, &out)) {
+        return NULL;
+    }
+    task.kernel = k_haversine;
+    return geo_run(&task, ins, 4, 1, out, NULL);
+}
+
+PyObject* calco_bearing(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"lat1", "lon1", "lat2", "lon2", "degrees", "out", NULL};
+    PyObject* ins[4];
+    PyObject* out = Py_None;
+    geo_task task;
+    memset(&task, 0, sizeof(task));
+    task.degrees = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|$pO", kwlist, &ins[0], &ins[1], &ins[2], &ins[3],
+                                     &task.degrees, &out)) {
+        return NULL;
+    }
+    task.kernel = k_bearing;
+    return geo_run(&task, ins, 4, 1, out, NULL);
+}
+
+PyObject* calco_vincenty(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"lat1", "lon1", "lat2", "lon2", "a", "f", "tol", "max_iter", "degrees", "out", NULL};
+    PyObject* ins[4];
+    PyObject* out = Py_None;
+    geo_task task;
+    memset(&task, 0, sizeof(task));
+    task.p[0] = GEO_WGS84_A;
+    task.p[1] = GEO_WGS84_F;
+    task.p[2] = 1e-12;
+    task.max_iter = 200;
+    task.degrees = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|$dddipO", kwlist, &ins[0], &ins[1], &ins[2], &ins[3],
+                                     &task.p[0], &task.p[1], &task.p[2], &task.max_iter, &task.degrees, &out)) {
+        return NULL;
+    }
+    if (!(task.p[0] > 0.0) || !(task.p[1] >= 0.0 && task.p[1] < 1.0) || task.max_iter < 1) {
+        PyErr_SetString(PyExc_ValueError, "vincenty requires a > 0, 0 <= f < 1 and max_iter >= 1");
+        return NULL;
+    }
+    task.kernel = k_vincenty;
+    Py_ssize_t failed = 0;
+    PyObject* result = geo_run(&task, ins, 4, 1, out, &failed);
+    if (result != NULL && failed > 0 &&
+        PyErr_WarnFormat(PyExc_RuntimeWarning, 1,
+                         "vincenty: %zd point pair(s) did not converge (nearly antipodal); their distance is nan",
+                         failed) < 0) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    return result;
+}
@@ -0,0 +1,768 @@
+// calco_geometry.c
+// Contains vector geometry over point sets: per-point norms, per-pair distances, pairwise
+// distance matrices (pdist, cdist) and brute-force k-nearest-neighbour search.
+//
+// A point set is either one float64 buffer of n * dim coordinates, point after point (AoS),
+// or a sequence of dim float64 buffers of n coordinates each (SoA).
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite (isfinite is folded away under -ffast-math)
+
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Metrics
+// -----------------------------------------------------------------------------
+
+enum { METRIC_EUCLIDEAN, METRIC_SQEUCLIDEAN, METRIC_CITYBLOCK, METRIC_CHEBYSHEV };
+
+static int parse_metric(const char* name) {
+    if (strcmp(name, "euclidean") == 0) {
+        return METRIC_EUCLIDEAN;
+    }
+    if (strcmp(name, "sqeuclidean") == 0) {
+        return METRIC_SQEUCLIDEAN;
+    }
+    if (strcmp(name, "cityblock") == 0 || strcmp(name, "manhattan") == 0) {
+        return METRIC_CITYBLOCK;
+    }
+    if (strcmp(name, "chebyshev") == 0) {
+        return METRIC_CHEBYSHEV;
+    }
+    PyErr_Format(PyExc_ValueError,
+                 "unknown metric '%s' (expected 'euclidean', 'sqeuclidean', 'cityblock' or 'chebyshev')", name);
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+// Point Sets
+// Coordinate j of point i is coord[j][i * stride]: stride is dim for AoS and 1 for SoA.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    Py_ssize_t n;
+    Py_ssize_t d;
+    Py_ssize_t stride;
+    const double** coord;
+    Py_buffer* views;
+    Py_ssize_t nviews;
+} point_set;
+
+static void points_release(point_set* p) {
+    for (Py_ssize_t j = 0; j < p->nviews; j++) {
+        PyBuffer_Release(&p->views[j]);
+    }
+    PyMem_Free(p->views);
+    PyMem_Free((void*)p->coord);
+    memset(p, 0, sizeof(*p));
+}
+
+// Reads a point set; dim is -1 when not given. Returns 0, or -1 with an exception set.
+static int points_read(PyObject* obj, Py_ssize_t dim, point_set* p) {
+    memset(p, 0, sizeof(*p));
+    if (PyObject_CheckBuffer(obj)) {
+        if (dim < 1) {
+            PyErr_SetString(PyExc_ValueError, "dim (>= 1) is required for a flat point buffer");
+            return -1;
+        }
+        p->views = (Py_buffer*)PyMem_Malloc(sizeof(Py_buffer));
+        p->coord = (const double**)PyMem_Malloc(dim * sizeof(double*));
+        if (p->views == NULL || p->coord == NULL) {
+            points_release(p);
+            PyErr_NoMemory();
+            return -1;
+        }
+        if (calco_get_double_buffer(obj, &p->views[0], 0) < 0) {
+            points_release(p);
+            return -1;
+        }
+        p->nviews = 1;
+        Py_ssize_t len = p->views[0].len / (Py_ssize_t)sizeof(double);
+        if (len % dim != 0) {
+            points_release(p);
+            PyErr_Format(PyExc_ValueError, "buffer length %zd is not a multiple of dim %zd", len, dim);
+            return -1;
+        }
+        p->n = len / dim;
+        p->d = dim;
+        p->stride = dim;
+        for (Py_ssize_t j = 0; j < dim; j++) {
+            p->coord[j] = (const double*)p->views[0].buf + j;
+        }
+        return 0;
+    }
+    PyObject* seq = PySequence_Fast(obj, "points must be a float64 buffer or a sequence of coordinate buffers");
+    if (seq == NULL) {
+        return -1;
+    }
+    Py_ssize_t d = PySequence_Fast_GET_SIZE(seq);
+    if (d < 1 || (dim >= 0 && dim != d)) {
+        Py_DECREF(seq);
+        PyErr_Format(PyExc_ValueError, "expected %zd coordinate buffers, got %zd", (dim >= 0) ? dim : 1, d);
+        return -1;
+    }
+    p->views = (Py_buffer*)PyMem_Malloc(d * sizeof(Py_buffer));
+    p->coord = (const double**)PyMem_Malloc(d * sizeof(double*));
+    if (p->views == NULL || p->coord == NULL) {
+        Py_DECREF(seq);
+        points_release(p);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t j = 0; j < d; j++) {
+        if (calco_get_double_buffer(PySequence_Fast_GET_ITEM(seq, j), &p->views[j], 0) < 0) {
+            Py_DECREF(seq);
+            points_release(p);
+            return -1;
+        }
+        p->nviews++;
+        Py_ssize_t len = p->views[j].len / (Py_ssize_t)sizeof(double);
+        if (j > 0 && len != p->n) {
+            Py_DECREF(seq);
+            points_release(p);
+            PyErr_SetString(PyExc_ValueError, "coordinate buffers must have the same length");
+            return -1;
+        }
+        p->n = len;
+        p->coord[j] = (const double*)p->views[j].buf;
+    }
+    Py_DECREF(seq);
+    p->d = d;
+    p->stride = 1;
+    return 0;
+}
+
+// Reads two point sets of one dimension. Without dim, a sequence of coordinate buffers is
+// read first so that it supplies the dimension of a flat buffer on the other side.
+static int points_read_pair(PyObject* x, PyObject* y, Py_ssize_t dim, point_set* px, point_set* py) {
+    int swap = (dim < 0 && PyObject_CheckBuffer(x) && !PyObject_CheckBuffer(y));
+    point_set* first = swap ? py : px;
+    point_set* second = swap ? px : py;
+    if (points_read(swap ? y : x, dim, first) < 0) {
+        return -1;
+    }
+    if (points_read(swap ? x : y, first->d, second) < 0) {
+        points_release(first);
+        return -1;
+    }
+    return 0;
+}
+
+// Returns the points as contiguous rows of d coordinates: the buffer itself for AoS input,
+// otherwise a PyMem copy stored in *owned. Returns NULL with MemoryError set on failure.
+static const double* points_rows(const point_set* p, double** owned) {
+    *owned = NULL;
+    if (p->stride == p->d) {
+        return p->coord[0];
+    }
+    double* rows = (double*)PyMem_Malloc((p->n * p->d > 0 ? p->n * p->d : 1) * sizeof(double));
+    if (rows == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t j = 0; j < p->d; j++) {
+        const double* c = p->coord[j];
+        for (Py_ssize_t i = 0; i < p->n; i++) {
+            rows[i * p->d + j] = c[i];
+        }
+    }
+    *owned = rows;
+    return rows;
+}
+
+// -----------------------------------------------------------------------------
+// Norms and Per-Pair Distances
+// The Euclidean norm sums squares directly and only rescales by the largest magnitude when
+// that sum overflows or drops into the subnormal range, as hypot does for two coordinates.
+// -----------------------------------------------------------------------------
+
+static double reduce_metric(const double* v, Py_ssize_t d, int metric) {
+    double s = 0.0;
+    Py_ssize_t j;
+    switch (metric) {
+        case METRIC_CITYBLOCK:
+            for (j = 0; j < d; j++) s += fabs(v[j]);
+            return s;
+        case METRIC_CHEBYSHEV:
+            for (j = 0; j < d; j++) s = (fabs(v[j]) > s) ? fabs(v[j]) : s;
+            return s;
+        default:
+            for (j = 0; j < d; j++) s += v[j] * v[j];
+            break;
+    }
+    if (metric == METRIC_EUCLIDEAN && (!calco_isfinite(s) || s < DBL_MIN / DBL_EPSILON)) {
+        double m = 0.0;
+        for (j = 0; j < d; j++) m = (fabs(v[j]) > m) ? fabs(v[j]) : m;
+        if (m == 0.0 || !calco_isfinite(m)) {
+            return m;
+        }
+        // Scale by a power of two (exact, and safe for subnormal m, where 1 / m overflows).
+        int e;
+        frexp(m, &e);
+        s = 0.0;
+        for (j = 0; j < d; j++) {
+            double u = ldexp(v[j], -e);
+            s += u * u;
+        }
+        return ldexp(sqrt(s), e);
+    }
+    return (metric == METRIC_EUCLIDEAN) ? sqrt(s) : s;
+}
+
+#define ROWWISE_BLOCK 256
+
+typedef struct {
+    const point_set* a;
+    const point_set* b;   // NULL for norms
+    int metric;
+    double* out;
+    Py_ssize_t chunk;     // Points per chunk
+} rowwise_task;
+
+static void rowwise_chunk(void* ctx, Py_ssize_t chunk) {
+    const rowwise_task* t = (const rowwise_task*)ctx;
+    const point_set* a = t->a;
+    const point_set* b = t->b;
+    Py_ssize_t d = a->d;
+    Py_ssize_t start = chunk * t->chunk;
+    Py_ssize_t end = (start + t->chunk < a->n) ? start + t->chunk : a->n;
+    double v[ROWWISE_BLOCK];
+    // Gathers one point (or one difference) at a time in blocks of coordinates; the common
+    // small dimensions take a single block.
+    for (Py_ssize_t i = start; i < end; i++) {
+        if (d <= ROWWISE_BLOCK) {
+            for (Py_ssize_t j = 0; j < d; j++) {
+                v[j] = a->coord[j][i * a->stride] - ((b != NULL) ? b->coord[j][i * b->stride] : 0.0);
+            }
+            t->out[i] = reduce_metric(v, d, t->metric);
+            continue;
+        }
+        // Long vectors: combine per-block partial results.
+        double acc = 0.0, scale_max = 0.0;
+        int plain = (t->metric != METRIC_EUCLIDEAN);
+        for (Py_ssize_t j0 = 0; j0 < d; j0 += ROWWISE_BLOCK) {
+            Py_ssize_t len = (d - j0 < ROWWISE_BLOCK) ? d - j0 : ROWWISE_BLOCK;
+            for (Py_ssize_t j = 0; j < len; j++) {
+                v[j] = a->coord[j0 + j][i * a->stride] -
+                       ((b != NULL) ? b->coord[j0 + j][i * b->stride] : 0.0);
+            }
+            double r = reduce_metric(v, len, plain ? t->metric : METRIC_EUCLIDEAN);
+            if (t->metric == METRIC_CHEBYSHEV) {
+                acc = (r > acc) ? r : acc;
+            } else if (plain) {
+                acc += r;
+            } else if (r > scale_max) {
+                // Keep the running sum of squares relative to the largest block norm.
+                acc = acc * (scale_max / r) * (scale_max / r) + 1.0;
+                scale_max = r;
+            } else if (r > 0.0) {
+                acc += (r / scale_max) * (r / scale_max);
+            }
+        }
+        t->out[i] = plain ? acc : scale_max * sqrt(acc);
+    }
+}
+
+static PyObject* rowwise(PyObject* a_obj, PyObject* b_obj, Py_ssize_t dim, const char* metric_name, PyObject* out) {
+    int metric = parse_metric(metric_name);
+    if (metric < 0) {
+        return NULL;
+    }
+    point_set a, b;
+    if ((b_obj == NULL) ? points_read(a_obj, dim, &a) : points_read_pair(a_obj, b_obj, dim, &a, &b)) {
+        return NULL;
+    }
+    if (b_obj != NULL && b.n != a.n) {
+        points_release(&a);
+        points_release(&b);
+        PyErr_SetString(PyExc_ValueError, "a and b must hold the same number of points");
+        return NULL;
+    }
+    Py_buffer out_view;
+    PyObject* out_obj;
+    if (calco_get_out_buffer(out, a.n, &out_view, &out_obj) < 0) {
+        points_release(&a);
+        if (b_obj != NULL) {
+            points_release(&b);
+        }
+        return NULL;
+    }
+    Py_ssize_t chunk = CALCO_DEFAULT_CHUNK / a.d;
+    rowwise_task task = {&a, (b_obj != NULL) ? &b : NULL, metric, (double*)out_view.buf, (chunk > 0) ? chunk : 1};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(rowwise_chunk, &task, (a.n + task.chunk - 1) / task.chunk);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&out_view);
+    points_release(&a);
+    if (b_obj != NULL) {
+        points_release(&b);
+    }
+    return out_obj;
+}
+
+static Py_ssize_t parse_dim(PyObject* dim_obj) {
+    if (dim_obj == Py_None) {
+        return -1;
+    }
+    Py_ssize_t dim = PyLong_AsSsize_t(dim_obj);
+    if (dim == -1 && PyErr_Occurred()) {
+        return -2;
+    }
+    if (dim < 1) {
+        PyErr_SetString(PyExc_ValueError, "dim must be at least 1");
+        return -2;
+    }
+    return dim;
+}
+
+PyObject* calco_norms(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"points", "dim", "metric", "out", NULL};
+    PyObject *points, *dim_obj = Py_None, *out = Py_None;
+    const char* metric = "euclidean";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$sO", kwlist, &points, &dim_obj, &metric, &out)) {
+        return NULL;
+    }
+    Py_ssize_t dim = parse_dim(dim_obj);
+    return (dim == -2) ? NULL : rowwise(points, NULL, dim, metric, out);
+}
+
+PyObject* calco_distances(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "dim", "metric", "out", NULL};
+    PyObject *a, *b, *dim_obj = Py_None, *out = Py_None;
+    const char* metric = "euclidean";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$sO", kwlist, &a, &b, &dim_obj, &metric, &out)) {
+        return NULL;
+    }
+    Py_ssize_t dim = parse_dim(dim_obj);
+    return (dim == -2) ? NULL : rowwise(a, b, dim, metric, out);
+}
+
+// -----------------------------------------------------------------------------
+// Distance Tiles
+// Squared Euclidean distances come from |a|^2 + |b|^2 - 2 a.b, so a tile of distances is a
+// small matrix product: a 4 x 4 register block of dot products streams both rows once per
+// coordinate with independent multiply-adds (contracted to FMA where the target has it).
+// The expansion cancels when the distance is small next to the norms; below
+// GEOM_CANCEL * (|a|^2 + |b|^2) the squared distance is recomputed from the differences, which
+// bounds its relative error by about dim * 2^-42.
+//
+// Rows of A are handed to the pool in blocks of GEOM_ROWS and rows of B are visited in tiles
+// sized to stay in cache, so each B tile is reused across the whole A block.
+// -----------------------------------------------------------------------------
+
+#define GEOM_ROWS 32
+#define GEOM_CANCEL (1.0 / 1024.0)
+#define GEOM_TILE_DOUBLES 32768
+
+typedef struct {
+    int metric;
+    Py_ssize_t d;
+    const double* a;   // Rows of A
+    const double* an;  // Squared norms of A's rows (Euclidean metrics only)
+    const double* b;
+    const double* bn;
+} geom_pair;
+
+static Py_ssize_t tile_cols(Py_ssize_t d) {
+    Py_ssize_t cols = GEOM_TILE_DOUBLES / d;
+    return (cols < 16) ? 16 : (cols > 1024) ? 1024 : cols;
+}
+
+static void squared_norms(const double* rows, Py_ssize_t n, Py_ssize_t d, double* out) {
+    for (Py_ssize_t i = 0; i < n; i++) {
+        const double* r = rows + i * d;
+        double s = 0.0;
+        for (Py_ssize_t k = 0; k < d; k++) {
+            s += r[k] * r[k];
+        }
+        out[i] = s;
+    }
+}
+
+static inline double direct_distance(const double* x, const double* y, Py_ssize_t d, int metric) {
+    double s = 0.0;
+    Py_ssize_t k;
+    switch (metric) {
+        case METRIC_CITYBLOCK:
+            for (k = 0; k < d; k++) s += fabs(x[k] - y[k]);
+            return s;
+        case METRIC_CHEBYSHEV:
+            for (k = 0; k < d; k++) {
+                double e = fabs(x[k] - y[k]);
+                s = (e > s) ? e : s;
+            }
+            return s;
+        default:
+            for (k = 0; k < d; k++) s += (x[k] - y[k]) * (x[k] - y[k]);
+            return s;
+    }
+}
+
+static inline double finish_metric(int metric, double v) {
+    if (metric != METRIC_EUCLIDEAN) {
+        return v;
+    }
+    return (v > 0.0) ? sqrt(v) : 0.0;
+}
+
+// Distance from the expansion, or from the differences when the expansion has cancelled.
+static inline double finish_squared(const geom_pair* g, Py_ssize_t i, Py_ssize_t j, double dot) {
+    double norms = g->an[i] + g->bn[j];
+    double d2 = norms - 2.0 * dot;
+    if (d2 < GEOM_CANCEL * norms) {
+        d2 = direct_distance(g->a + i * g->d, g->b + j * g->d, g->d, METRIC_SQEUCLIDEAN);
+    }
+    return finish_metric(g->metric, d2);
+}
+
+// Writes the distances for rows [i0, i1) x [j0, j1) to dst[(i - i0) * ldd + (j - j0)].
+static void dist_block(const geom_pair* g, Py_ssize_t i0, Py_ssize_t i1, Py_ssize_t j0, Py_ssize_t j1,
+                       double* dst, Py_ssize_t ldd) {
+    Py_ssize_t d = g->d;
+    if (g->metric == METRIC_CITYBLOCK || g->metric == METRIC_CHEBYSHEV) {
+        for (Py_ssize_t i = i0; i < i1; i++) {
+            for (Py_ssize_t j = j0; j < j1; j++) {
+                dst[(i - i0) * ldd + (j - j0)] = direct_distance(g->a + i * d, g->b + j * d, d, g->metric);
+            }
+        }
+        return;
+    }
+    Py_ssize_t i = i0;
+    for (; i + 4 <= i1; i += 4) {
+        const double* a0 = g->a + i * d;
+        const double* a1 = a0 + d;
+        const double* a2 = a1 + d;
+        const double* a3 = a2 + d;
+        Py_ssize_t j = j0;
+        for (; j + 4 <= j1; j += 4) {
+            const double* b0 = g->b + j * d;
+            const double* b1 = b0 + d;
+            const double* b2 = b1 + d;
+            const double* b3 = b2 + d;
+            double c[4][4] = {{0.0}};
+            for (Py_ssize_t k = 0; k < d; k++) {
+                double x0 = a0[k], x1 = a1[k], x2 = a2[k], x3 = a3[k];
+                double y0 = b0[k], y1 = b1[k], y2 = b2[k], y3 = b3[k];
+                c[0][0] += x0 * y0; c[0][1] += x0 * y1; c[0][2] += x0 * y2; c[0][3] += x0 * y3;
+                c[1][0] += x1 * y0; c[1][1] += x1 * y1; c[1][2] += x1 * y2; c[1][3] += x1 * y3;
+                c[2][0] += x2 * y0; c[2][1] += x2 * y1; c[2][2] += x2 * y2; c[2][3] += x2 * y3;
+                c[3][0] += x3 * y0; c[3][1] += x3 * y1; c[3][2] += x3 * y2; c[3][3] += x3 * y3;
+            }
+            for (int r = 0; r < 4; r++) {
+                for (int s = 0; s < 4; s++) {
+                    dst[(i + r - i0) * ldd + (j + s - j0)] = finish_squared(g, i + r, j + s, c[r][s]);
+                }
+            }
+        }
+        for (; j < j1; j++) {
+            for (int r = 0; r < 4; r++) {
+                const double* x = g->a + (i + r) * d;
+                const double* y = g->b + j * d;
+                double dot = 0.0;
+                for (Py_ssize_t k = 0; k < d; k++) dot += x[k] * y[k];
+                dst[(i + r - i0) * ldd + (j - j0)] = finish_squared(g, i + r, j, dot);
+            }
+        }
+    }
+    for (; i < i1; i++) {
+        const double* x = g->a + i * d;
+        for (Py_ssize_t j = j0; j < j1; j++) {
+            const double* y = g->b + j * d;
+            double dot = 0.0;
+            for (Py_ssize_t k = 0; k < d; k++) dot += x[k] * y[k];
+            dst[(i - i0) * ldd + (j - j0)] = finish_squared(g, i, j, dot);
+        }
+    }
+}
+
+typedef struct {
+    geom_pair g;
+    Py_ssize_t na;
+    Py_ssize_t nb;
+    double* out;
+    Py_ssize_t k;          // Neighbours per query (knn)
+    long long* idx;        // knn indices
+    int root;              // knn: rank by squared distance, report its square root
+    int nomem;
+} geom_task;
+
+static void cdist_chunk(void* ctx, Py_ssize_t chunk) {
+    geom_task* t = (geom_task*)ctx;
+    Py_ssize_t i0 = chunk * GEOM_ROWS;
+    Py_ssize_t i1 = (i0 + GEOM_ROWS < t->na) ? i0 + GEOM_ROWS : t->na;
+    Py_ssize_t cols = tile_cols(t->g.d);
+    for (Py_ssize_t j0 = 0; j0 < t->nb; j0 += cols) {
+        Py_ssize_t j1 = (j0 + cols < t->nb) ? j0 + cols : t->nb;
+        dist_block(&t->g, i0, i1, j0, j1, t->out + i0 * t->nb + j0, t->nb);
+    }
+}
+
+// Condensed output: pair (i, j), i < j, is at n*i - i*(i+1)/2 + (j - i - 1), as in SciPy.
+static void pdist_chunk(void* ctx, Py_ssize_t chunk) {
+    geom_task* t = (geom_task*)ctx;
+    Py_ssize_t n = t->na;
+    Py_ssize_t i0 = chunk * GEOM_ROWS;
+    Py_ssize_t i1 = (i0 + GEOM_ROWS < n) ? i0 + GEOM_ROWS : n;
+    Py_ssize_t cols = tile_cols(t->g.d);
+    double* tile = (double*)PyMem_RawMalloc(GEOM_ROWS * cols * sizeof(double));
+    if (tile == NULL) {
+        t->nomem = 1;
+        return;
+    }
+    for (Py_ssize_t j0 = i0 + 1; j0 < n; j0 += cols) {
+        Py_ssize_t j1 = (j0 + cols < n) ? j0 + cols : n;
+        dist_block(&t->g, i0, i1, j0, j1, tile, cols);
+        for (Py_ssize_t i = i0; i < i1; i++) {
+            double* row = t->out + n * i - i * (i + 1) / 2 - i - 1;
+            for (Py_ssize_t j = (j0 > i + 1) ? j0 : i + 1; j < j1; j++) {
+                row[j] = tile[(i - i0) * cols + (j - j0)];
+            }
+        }
+    }
+    PyMem_RawFree(tile);
+}
+
+typedef struct {
+    double dist;
+    long long index;
+} neighbour;
+
+static int neighbour_cmp(const void* x, const void* y) {
+    const neighbour* p = (const neighbour*)x;
+    const neighbour* q = (const neighbour*)y;
+    if (p->dist != q->dist) {
+        return (p->dist < q->dist) ? -1 : 1;
+    }
+    return (p->index > q->index) - (p->index < q->index);
+}
+
+// Max-heap of the k best candidates seen so far for one query (worst at the root).
+static void neighbour_offer(neighbour* heap, Py_ssize_t* size, Py_ssize_t k, double dist, long long index) {
+    Py_ssize_t i;
+    if (*size < k) {
+        i = (*size)++;
+        while (i > 0 && heap[(i - 1) / 2].dist < dist) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i].dist = dist;
+        heap[i].index = index;
+        return;
+    }
+    if (!(dist < heap[0].dist)) {
+        return;
+    }
+    i = 0;
+    for (;;) {
+        Py_ssize_t c = 2 * i + 1;
+        if (c >= k) {
+            break;
+        }
+        if (c + 1 < k && heap[c + 1].dist > heap[c].dist) {
+            c++;
+        }
+        if (heap[c].dist <= dist) {
+            break;
+        }
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i].dist = dist;
+    heap[i].index = index;
+}
+
+static void knn_chunk(void* ctx, Py_ssize_t chunk) {
+    geom_task* t = (geom_task*)ctx;
+    Py_ssize_t q0 = chunk * GEOM_ROWS;
+    Py_ssize_t q1 = (q0 + GEOM_ROWS < t->na) ? q0 + GEOM_ROWS : t->na;
+    Py_ssize_t k = t->k;
+    Py_ssize_t cols = tile_cols(t->g.d);
+    double* tile = (double*)PyMem_RawMalloc(GEOM_ROWS * cols * sizeof(double));
+    neighbour* heaps = (neighbour*)PyMem_RawMalloc(GEOM_ROWS * k * sizeof(neighbour));
+    Py_ssize_t sizes[GEOM_ROWS] = {0};
+    if (tile == NULL || heaps == NULL) {
+        PyMem_RawFree(tile);
+        PyMem_RawFree(heaps);
+        t->nomem = 1;
+        return;
+    }
+    for (Py_ssize_t j0 = 0; j0 < t->nb; j0 += cols) {
+        Py_ssize_t j1 = (j0 + cols < t->nb) ? j0 + cols : t->nb;
+        dist_block(&t->g, q0, q1, j0, j1, tile, cols);
+        for (Py_ssize_t q = q0; q < q1; q++) {
+            const double* row = tile + (q - q0) * cols;
+            neighbour* heap = heaps + (q - q0) * k;
+            for (Py_ssize_t j = j0; j < j1; j++) {
+                neighbour_offer(heap, &sizes[q - q0], k, row[j - j0], (long long)j);
+            }
+        }
+    }
+    for (Py_ssize_t q = q0; q < q1; q++) {
+        neighbour* heap = heaps + (q - q0) * k;
+        qsort(heap, k, sizeof(neighbour), neighbour_cmp);
+        for (Py_ssize_t r = 0; r < k; r++) {
+            t->out[q * k + r] = t->root ? finish_metric(METRIC_EUCLIDEAN, heap[r].dist) : heap[r].dist;
+            t->idx[q * k + r] = heap[r].index;
+        }
+    }
+    PyMem_RawFree(tile);
+    PyMem_RawFree(heaps);
+}
+
+// -----------------------------------------------------------------------------
+// pdist, cdist and knn
+// -----------------------------------------------------------------------------
+
+// Packs the rows of a point set and, for Euclidean metrics, their squared norms.
+static int pair_side(const point_set* p, int metric, const double** rows, double** owned, double** norms) {
+    *norms = NULL;
+    *rows = points_rows(p, owned);
+    if (*rows == NULL) {
+        return -1;
+    }
+    if (metric == METRIC_EUCLIDEAN || metric == METRIC_SQEUCLIDEAN) {
+        *norms = (double*)PyMem_Malloc((p->n > 0 ? p->n : 1) * sizeof(double));
+        if (*norms == NULL) {
+            PyMem_Free(*owned);
+            *owned = NULL;
+            PyErr_NoMemory();
+            return -1;
+        }
+        squared_norms(*rows, p->n, p->d, *norms);
+    }
+    return 0;
+}
+
+PyObject* calco_pdist(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"points", "dim", "metric", "out", NULL};
+    PyObject *points, *dim_obj = Py_None, *out = Py_None;
+    const char* metric_name = "euclidean";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$sO", kwlist, &points, &dim_obj, &metric_name, &out)) {
+        return NULL;
+    }
+    Py_ssize_t dim = parse_dim(dim_obj);
+    int metric = (dim == -2) ? -1 : parse_metric(metric_name);
+    point_set p;
+    if (metric < 0 || points_read(points, dim, &p) < 0) {
+        return NULL;
+    }
+    const double* rows;
+    double *owned, *norms;
+    if (pair_side(&p, metric, &rows, &owned, &norms) < 0) {
+        points_release(&p);
+        return NULL;
+    }
+    Py_ssize_t n = p.n;
+    Py_buffer out_view;
+    PyObject* out_obj = NULL;
+    if (calco_get_out_buffer(out, n * (n - 1) / 2, &out_view, &out_obj) == 0) {
+        geom_task task = {{metric, p.d, rows, norms, rows, norms}, n, n, (double*)out_view.buf, 0, NULL, 0, 0};
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_parallel_for(pdist_chunk, &task, (n + GEOM_ROWS - 1) / GEOM_ROWS);
+        Py_END_ALLOW_THREADS
+        PyBuffer_Release(&out_view);
+        if (task.nomem) {
+            Py_CLEAR(out_obj);
+            PyErr_NoMemory();
+        }
+    }
+    PyMem_Free(owned);
+    PyMem_Free(norms);
+    points_release(&p);
+    return out_obj;
+}
+
+PyObject* calco_cdist(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "dim", "metric", "out", NULL};
+    PyObject *a_obj, *b_obj, *dim_obj = Py_None, *out = Py_None;
+    const char* metric_name = "euclidean";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$sO", kwlist, &a_obj, &b_obj, &dim_obj, &metric_name, &out)) {
+        return NULL;
+    }
+    Py_ssize_t dim = parse_dim(dim_obj);
+    int metric = (dim == -2) ? -1 : parse_metric(metric_name);
+    point_set a, b;
+    if (metric < 0 || points_read_pair(a_obj, b_obj, dim, &a, &b) < 0) {
+        return NULL;
+    }
+    const double *ra = NULL, *rb = NULL;
+    double *oa = NULL, *ob = NULL, *na = NULL, *nb = NULL;
+    PyObject* out_obj = NULL;
+    if (b.d != a.d) {
+        PyErr_SetString(PyExc_ValueError, "a and b must have the same dimension");
+    } else if (pair_side(&a, metric, &ra, &oa, &na) == 0 && pair_side(&b, metric, &rb, &ob, &nb) == 0) {
+        Py_buffer out_view;
+        if (calco_get_out_buffer(out, a.n * b.n, &out_view, &out_obj) == 0) {
+            geom_task task = {{metric, a.d, ra, na, rb, nb}, a.n, b.n, (double*)out_view.buf, 0, NULL, 0, 0};
+            Py_BEGIN_ALLOW_THREADS
+            calco_pool_parallel_for(cdist_chunk, &task, (a.n + GEOM_ROWS - 1) / GEOM_ROWS);
+            Py_END_ALLOW_THREADS
+            PyBuffer_Release(&out_view);
+        }
+    }
+    PyMem_Free(oa);
+    PyMem_Free(ob);
+    PyMem_Free(na);
+    PyMem_Free(nb);
+    points_release(&a);
+    points_release(&b);
+    return out_obj;
+}
+
+PyObject* calco_knn(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"data", "queries", "k", "dim", "metric", NULL};
+    PyObject *data_obj, *query_obj, *dim_obj = Py_None;
+    Py_ssize_t k;
+    const char* metric_name = "euclidean";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOn|O$s", kwlist, &data_obj, &query_obj, &k, &dim_obj,
+                                     &metric_name)) {
+        return NULL;
+    }
+    Py_ssize_t dim = parse_dim(dim_obj);
+    int metric = (dim == -2) ? -1 : parse_metric(metric_name);
+    point_set data, queries;
+    if (metric < 0 || points_read_pair(data_obj, query_obj, dim, &data, &queries) < 0) {
+        return NULL;
+    }
+    // Euclidean neighbours are ranked by squared distance; only the k results take a root.
+    int rank_metric = (metric == METRIC_EUCLIDEAN) ? METRIC_SQEUCLIDEAN : metric;
+    const double *rq = NULL, *rd = NULL;
+    double *oq = NULL, *od = NULL, *nq = NULL, *nd = NULL;
+    PyObject *idx_obj = NULL, *dist_obj = NULL, *result = NULL;
+    if (queries.d != data.d) {
+        PyErr_SetString(PyExc_ValueError, "data and queries must have the same dimension");
+    } else if (k < 1 || k > data.n) {
+        PyErr_Format(PyExc_ValueError, "k must be between 1 and the number of data points (%zd)", data.n);
+    } else if (pair_side(&queries, rank_metric, &rq, &oq, &nq) == 0 &&
+               pair_side(&data, rank_metric, &rd, &od, &nd) == 0) {
+        Py_buffer idx_view, dist_view;
+        idx_obj = calco_new_array('q', queries.n * k, &idx_view);
+        dist_obj = (idx_obj == NULL) ? NULL : calco_new_double_array(queries.n * k, &dist_view);
+        if (dist_obj != NULL) {
+            geom_task task = {{rank_metric, data.d, rq, nq, rd, nd}, queries.n, data.n, (double*)dist_view.buf,
+                              k, (long long*)idx_view.buf, metric == METRIC_EUCLIDEAN, 0};
+            Py_BEGIN_ALLOW_THREADS
+            calco_pool_parallel_for(knn_chunk, &task, (queries.n + GEOM_ROWS - 1) / GEOM_ROWS);
+            Py_END_ALLOW_THREADS
+            PyBuffer_Release(&dist_view);
+            if (task.nomem) {
+                PyErr_NoMemory();
+            } else {
+                result = PyTuple_Pack(2, idx_obj, dist_obj);
+            }
+        }
+        if (idx_obj != NULL) {
+            PyBuffer_Release(&idx_view);
+        }
+    }
+    Py_XDECREF(idx_obj);
+    Py_XDECREF(dist_obj);
+    PyMem_Free(oq);
+    PyMem_Free(od);
+    PyMem_Free(nq);
+    PyMem_Free(nd);
+    points_release(&data);
+    points_release(&queries);
+    return result;
+}
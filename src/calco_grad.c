@@ -0,0 +1,708 @@
+// calco_grad.c
+// Contains forward-mode automatic differentiation (the calco.grad submodule).
+// Every function returns its value together with its derivative(s) from a single
+// evaluation, reusing intermediate results (sin gives cos, exp reuses itself, ...).
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <string.h>
+
+#define LN2 0.69314718055994530942
+#define LN10 2.30258509299404568402
+
+// -----------------------------------------------------------------------------
+// Polygamma Helpers
+// Recurrence up to x >= 10, then the asymptotic (Bernoulli) series; reflection for x < 0.
+// -----------------------------------------------------------------------------
+
+double calco_digamma(double x) {
+    double result = 0.0;
+    if (x <= 0.0 && floor(x) == x) {
+        return NAN;
+    }
+    if (x < 0.0) {
+        // psi(1 - x) - psi(x) = pi * cot(pi * x)
+        return calco_digamma(1.0 - x) - M_PI / tan(M_PI * x);
+    }
+    while (x < 10.0) {
+        result -= 1.0 / x;
+        x += 1.0;
+    }
+    double f = 1.0 / (x * x);
+    double series = f * (1.0 / 12 - f * (1.0 / 120 - f * (1.0 / 252 - f * (1.0 / 240 - f * (1.0 / 132 - f * (691.0 / 32760))))));
+    return result + log(x) - 0.5 / x - series;
+}
+
+double calco_trigamma(double x) {
+    double result = 0.0;
+    if (x <= 0.0 && floor(x) == x) {
+        return NAN;
+    }
+    if (x < 0.0) {
+        // psi1(1 - x) + psi1(x) = pi^2 / sin^2(pi * x)
+        double s = sin(M_PI * x);
+        return -calco_trigamma(1.0 - x) + (M_PI * M_PI) / (s * s);
+    }
+    while (x < 10.0) {
+        result += 1.0 / (x * x);
+        x += 1.0;
+    }
+    double z = 1.0 / x;
+    double f = z * z;
+    double series = z * (1.0 + z * (0.5 + z * (1.0 / 6 - f * (1.0 / 30 - f * (1.0 / 42 - f * (1.0 / 30 - f * (5.0 / 66 - f * (691.0 / 2730 - f * (7.0 / 6)))))))));
+    return result + series;
+}
+
+// -----------------------------------------------------------------------------
+// Dual Kernels
+// r[0] = f(x), r[1] = f'(x) and, when order >= 2, r[2] = f''(x).
+// Domain handling matches the scalar wrappers: NaN outside the domain.
+// -----------------------------------------------------------------------------
+
+static void set_nan(double* r) {
+    r[0] = r[1] = r[2] = NAN;
+}
+
+static void set_constant(double* r, double f) {
+    r[0] = f;
+    r[1] = r[2] = 0.0;
+}
+
+static void d_square_root(double x, int order, double* r) {
+    if (x < 0.0) { set_nan(r); return; }
+    r[0] = sqrt(x);
+    r[1] = 0.5 / r[0];
+    r[2] = -0.5 * r[1] / x;
+}
+
+static void d_cube_root(double x, int order, double* r) {
+    r[0] = cbrt(x);
+    r[1] = 1.0 / (3.0 * r[0] * r[0]);
+    r[2] = -2.0 * r[1] / (3.0 * x);
+}
+
+static void d_absolute_value(double x, int order, double* r) {
+    r[0] = fabs(x);
+    r[1] = copysign(1.0, x);
+    r[2] = 0.0;
+}
+
+static void d_floor_val(double x, int order, double* r) { set_constant(r, floor(x)); }
+static void d_ceil_val(double x, int order, double* r) { set_constant(r, ceil(x)); }
+static void d_round_val(double x, int order, double* r) { set_constant(r, round(x)); }
+static void d_nearbyint_val(double x, int order, double* r) { set_constant(r, nearbyint(x)); }
+static void d_truncate_val(double x, int order, double* r) { set_constant(r, trunc(x)); }
+
+static void d_natural_log(double x, int order, double* r) {
+    if (x <= 0.0) { set_nan(r); return; }
+    r[0] = log(x);
+    r[1] = 1.0 / x;
+    r[2] = -r[1] * r[1];
+}
+
+static void d_log_base10(double x, int order, double* r) {
+    if (x <= 0.0) { set_nan(r); return; }
+    r[0] = log10(x);
+    r[1] = 1.0 / (x * LN10);
+    r[2] = -r[1] / x;
+}
+
+static void d_log_base2(double x, int order, double* r) {
+    if (x <= 0.0) { set_nan(r); return; }
+    r[0] = log2(x);
+    r[1] = 1.0 / (x * LN2);
+    r[2] = -r[1] / x;
+}
+
+static void d_exponential(double x, int order, double* r) {
+    r[0] = r[1] = r[2] = exp(x);
+}
+
+static void d_exponential_base2(double x, int order, double* r) {
+    r[0] = exp2(x);
+    r[1] = r[0] * LN2;
+    r[2] = r[1] * LN2;
+}
+
+static void d_exponential_minus_1(double x, int order, double* r) {
+    r[0] = expm1(x);
+    r[1] = r[2] = r[0] + 1.0;
+}
+
+static void d_sine(double x, int order, double* r) {
+    r[0] = sin(x);
+    r[1] = cos(x);
+    r[2] = -r[0];
+}
+
+static void d_cosine(double x, int order, double* r) {
+    r[0] = cos(x);
+    r[1] = -sin(x);
+    r[2] = -r[0];
+}
+
+static void d_tangent(double x, int order, double* r) {
+    r[0] = tan(x);
+    if (fabs(r[0]) > 1.0 / DBL_EPSILON) { set_nan(r); return; }
+    r[1] = 1.0 + r[0] * r[0];
+    r[2] = 2.0 * r[0] * r[1];
+}
+
+static void d_arcsine(double x, int order, double* r) {
+    if (x < -1.0 || x > 1.0) { set_nan(r); return; }
+    double q = 1.0 - x * x;
+    r[0] = asin(x);
+    r[1] = 1.0 / sqrt(q);
+    r[2] = x * r[1] / q;
+}
+
+static void d_arccosine(double x, int order, double* r) {
+    if (x < -1.0 || x > 1.0) { set_nan(r); return; }
+    double q = 1.0 - x * x;
+    r[0] = acos(x);
+    r[1] = -1.0 / sqrt(q);
+    r[2] = x * r[1] / q;
+}
+
+static void d_arctangent(double x, int order, double* r) {
+    r[0] = atan(x);
+    r[1] = 1.0 / (1.0 + x * x);
+    r[2] = -2.0 * x * r[1] * r[1];
+}
+
+static void d_hyperbolic_sine(double x, int order, double* r) {
+    r[0] = sinh(x);
+    r[1] = cosh(x);
+    r[2] = r[0];
+}
+
+static void d_hyperbolic_cosine(double x, int order, double* r) {
+    r[0] = cosh(x);
+    r[1] = sinh(x);
+    r[2] = r[0];
+}
+
+static void d_hyperbolic_tangent(double x, int order, double* r) {
+    r[0] = tanh(x);
+    r[1] = 1.0 - r[0] * r[0];
+    r[2] = -2.0 * r[0] * r[1];
+}
+
+static void d_inverse_hyperbolic_sine(double x, int order, double* r) {
+    double q = 1.0 + x * x;
+    r[0] = asinh(x);
+    r[1] = 1.0 / sqrt(q);
+    r[2] = -x * r[1] / q;
+}
+
+static void d_inverse_hyperbolic_cosine(double x, int order, double* r) {
+    if (x < 1.0) { set_nan(r); return; }
+    double q = x * x - 1.0;
+    r[0] = acosh(x);
+    r[1] = 1.0 / sqrt(q);
+    r[2] = -x * r[1] / q;
+}
+
+static void d_inverse_hyperbolic_tangent(double x, int order, double* r) {
+    if (x <= -1.0 || x >= 1.0) { set_nan(r); return; }
+    r[0] = atanh(x);
+    r[1] = 1.0 / (1.0 - x * x);
+    r[2] = 2.0 * x * r[1] * r[1];
+}
+
+static void d_gamma_function(double x, int order, double* r) {
+    double psi = calco_digamma(x);
+    r[0] = tgamma(x);
+    r[1] = r[0] * psi;
+    r[2] = (order >= 2) ? r[0] * (psi * psi + calco_trigamma(x)) : 0.0;
+}
+
+static void d_log_gamma_function(double x, int order, double* r) {
+    r[0] = lgamma(x);
+    r[1] = calco_digamma(x);
+    r[2] = (order >= 2) ? calco_trigamma(x) : 0.0;
+}
+
+static void d_error_function(double x, int order, double* r) {
+    r[0] = erf(x);
+    r[1] = (2.0 / sqrt(M_PI)) * exp(-x * x);
+    r[2] = -2.0 * x * r[1];
+}
+
+static void d_complementary_error_function(double x, int order, double* r) {
+    r[0] = erfc(x);
+    r[1] = -(2.0 / sqrt(M_PI)) * exp(-x * x);
+    r[2] = -2.0 * x * r[1];
+}
+
+static void d_degrees_to_radians(double x, int order, double* r) {
+    r[0] = x * (M_PI / 180.0);
+    r[1] = M_PI / 180.0;
+    r[2] = 0.0;
+}
+
+static void d_radians_to_degrees(double x, int order, double* r) {
+    r[0] = x * (180.0 / M_PI);
+    r[1] = 180.0 / M_PI;
+    r[2] = 0.0;
+}
+
+typedef struct {
+    const char* name;
+    calco_dual_fn kernel;
+} calco_dual_entry;
+
+static const calco_dual_entry dual_table[] = {
+    {"square_root", d_square_root},
+    {"cube_root", d_cube_root},
+    {"absolute_value", d_absolute_value},
+    {"floor_val", d_floor_val},
+    {"ceil_val", d_ceil_val},
+    {"round_val", d_round_val},
+    {"nearbyint_val", d_nearbyint_val},
+    {"truncate_val", d_truncate_val},
+    {"natural_log", d_natural_log},
+    {"log_base10", d_log_base10},
+    {"log_base2", d_log_base2},
+    {"exponential", d_exponential},
+    {"exponential_base2", d_exponential_base2},
+    {"exponential_minus_1", d_exponential_minus_1},
+    {"sine", d_sine},
+    {"cosine", d_cosine},
+    {"tangent", d_tangent},
+    {"arcsine", d_arcsine},
+    {"arccosine", d_arccosine},
+    {"arctangent", d_arctangent},
+    {"hyperbolic_sine", d_hyperbolic_sine},
+    {"hyperbolic_cosine", d_hyperbolic_cosine},
+    {"hyperbolic_tangent", d_hyperbolic_tangent},
+    {"inverse_hyperbolic_sine", d_inverse_hyperbolic_sine},
+    {"inverse_hyperbolic_cosine", d_inverse_hyperbolic_cosine},
+    {"inverse_hyperbolic_tangent", d_inverse_hyperbolic_tangent},
+    {"gamma_function", d_gamma_function},
+    {"log_gamma_function", d_log_gamma_function},
+    {"error_function", d_error_function},
+    {"complementary_error_function", d_complementary_error_function},
+    {"degrees_to_radians", d_degrees_to_radians},
+    {"radians_to_degrees", d_radians_to_degrees},
+    {NULL, NULL}
+};
+
+// Returns the dual kernel registered under `name`, or NULL. Does not set an exception.
+calco_dual_fn calco_dual_kernel(const char* name) {
+    for (const calco_dual_entry* e = dual_table; e->name != NULL; e++) {
+        if (strcmp(e->name, name) == 0) {
+            return e->kernel;
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Scalar Wrappers: calco.grad.<name>(x, order=1) -> (f, df) or (f, df, d2f)
+// -----------------------------------------------------------------------------
+
+static PyObject* grad_unary_call(calco_dual_fn kernel, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "order", NULL};
+    double x;
+    int order = 1;
+    double r[3];
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "d|i", kwlist, &x, &order)) {
+        return NULL;
+    }
+    if (order != 1 && order != 2) {
+        PyErr_SetString(PyExc_ValueError, "order must be 1 or 2");
+        return NULL;
+    }
+    kernel(x, order, r);
+    if (order == 2) {
+        return Py_BuildValue("(ddd)", r[0], r[1], r[2]);
+    }
+    return Py_BuildValue("(dd)", r[0], r[1]);
+}
+
+#define CALCO_GRAD_UNARY(name) \
+    static PyObject* grad_##name(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return grad_unary_call(d_##name, args, kwargs); \
+    }
+
+CALCO_GRAD_UNARY(square_root)
+CALCO_GRAD_UNARY(cube_root)
+CALCO_GRAD_UNARY(absolute_value)
+CALCO_GRAD_UNARY(floor_val)
+CALCO_GRAD_UNARY(ceil_val)
+CALCO_GRAD_UNARY(round_val)
+CALCO_GRAD_UNARY(nearbyint_val)
+CALCO_GRAD_UNARY(truncate_val)
+CALCO_GRAD_UNARY(natural_log)
+CALCO_GRAD_UNARY(log_base10)
+CALCO_GRAD_UNARY(log_base2)
+CALCO_GRAD_UNARY(exponential)
+CALCO_GRAD_UNARY(exponential_base2)
+CALCO_GRAD_UNARY(exponential_minus_1)
+CALCO_GRAD_UNARY(sine)
+CALCO_GRAD_UNARY(cosine)
+CALCO_GRAD_UNARY(tangent)
+CALCO_GRAD_UNARY(arcsine)
+CALCO_GRAD_UNARY(arccosine)
+CALCO_GRAD_UNARY(arctangent)
+CALCO_GRAD_UNARY(hyperbolic_sine)
+CALCO_GRAD_UNARY(hyperbolic_cosine)
+CALCO_GRAD_UNARY(hyperbolic_tangent)
+CALCO_GRAD_UNARY(inverse_hyperbolic_sine)
+CALCO_GRAD_UNARY(inverse_hyperbolic_cosine)
+CALCO_GRAD_UNARY(inverse_hyperbolic_tangent)
+CALCO_GRAD_UNARY(gamma_function)
+CALCO_GRAD_UNARY(log_gamma_function)
+CALCO_GRAD_UNARY(error_function)
+CALCO_GRAD_UNARY(complementary_error_function)
+CALCO_GRAD_UNARY(degrees_to_radians)
+CALCO_GRAD_UNARY(radians_to_degrees)
+
+// -----------------------------------------------------------------------------
+// Multi-argument Functions: calco.grad.<name>(a, b, order=1)
+// r[0] = f, r[1] = df/da, r[2] = df/db and, for order=2, the Hessian's upper triangle
+// r[3] = d2f/da2, r[4] = d2f/dadb, r[5] = d2f/db2. Piecewise-linear functions have a zero
+// Hessian away from their kinks.
+// -----------------------------------------------------------------------------
+
+typedef void (*grad_binary_fn)(double a, double b, double* r);
+
+static void set_nan6(double* r) {
+    r[0] = r[1] = r[2] = r[3] = r[4] = r[5] = NAN;
+}
+
+static void b_add(double a, double b, double* r) {
+    r[0] = a + b;
+    r[1] = r[2] = 1.0;
+    r[3] = r[4] = r[5] = 0.0;
+}
+
+static void b_subtract(double a, double b, double* r) {
+    r[0] = a - b;
+    r[1] = 1.0;
+    r[2] = -1.0;
+    r[3] = r[4] = r[5] = 0.0;
+}
+
+static void b_multiply(double a, double b, double* r) {
+    r[0] = a * b;
+    r[1] = b;
+    r[2] = a;
+    r[3] = r[5] = 0.0;
+    r[4] = 1.0;
+}
+
+static void b_divide(double a, double b, double* r) {
+    if (b == 0.0) { set_nan6(r); return; }
+    double inv = 1.0 / b;
+    double f = a * inv;
+    r[0] = f;
+    r[1] = inv;
+    r[2] = -f * inv;
+    r[3] = 0.0;
+    r[4] = -inv * inv;
+    r[5] = 2.0 * f * inv * inv;
+}
+
+// The derivatives in the exponent need ln(base) and so base > 0; NaN otherwise.
+static void b_power(double base, double exponent, double* r) {
+    double f = pow(base, exponent);
+    double lb = (base > 0.0) ? log(base) : NAN;
+    double f_over_base = (base == 0.0) ? pow(base, exponent - 1.0) : f / base;
+    r[0] = f;
+    r[1] = exponent * f_over_base;
+    r[2] = f * lb;
+    r[3] = (base == 0.0) ? exponent * (exponent - 1.0) * pow(base, exponent - 2.0)
+                         : exponent * (exponent - 1.0) * f_over_base / base;
+    r[4] = f_over_base * (1.0 + exponent * lb);
+    r[5] = r[2] * lb;
+}
+
+static void b_hypotenuse(double x, double y, double* r) {
+    double h = hypot(x, y);
+    double h3 = h * h * h;
+    r[0] = h;
+    r[1] = x / h;
+    r[2] = y / h;
+    r[3] = y * y / h3;
+    r[4] = -x * y / h3;
+    r[5] = x * x / h3;
+}
+
+// Arguments in atan2 order: derivatives are with respect to y, then x.
+static void b_arctangent2(double y, double x, double* r) {
+    double q = x * x + y * y;
+    double q2 = q * q;
+    r[0] = atan2(y, x);
+    r[1] = x / q;
+    r[2] = -y / q;
+    r[3] = -2.0 * x * y / q2;
+    r[4] = (y * y - x * x) / q2;
+    r[5] = 2.0 * x * y / q2;
+}
+
+static void b_log_custom_base(double x, double base, double* r) {
+    if (x <= 0.0 || base <= 0.0 || base == 1.0) { set_nan6(r); return; }
+    double lx = log(x), lb = log(base);
+    double f = lx / lb;
+    r[0] = f;
+    r[1] = 1.0 / (x * lb);
+    r[2] = -f / (base * lb);
+    r[3] = -r[1] / x;
+    r[4] = -r[1] / (base * lb);
+    r[5] = f * (lb + 2.0) / (base * base * lb * lb);
+}
+
+static void b_float_modulo(double x, double y, double* r) {
+    if (y == 0.0) { set_nan6(r); return; }
+    r[0] = fmod(x, y);
+    r[1] = 1.0;
+    r[2] = -trunc(x / y);
+    r[3] = r[4] = r[5] = 0.0;
+}
+
+static void b_positive_difference(double x, double y, double* r) {
+    double active = (x > y) ? 1.0 : 0.0;
+    r[0] = fdim(x, y);
+    r[1] = active;
+    r[2] = -active;
+    r[3] = r[4] = r[5] = 0.0;
+}
+
+static void b_copy_sign_double(double magnitude, double sign_source, double* r) {
+    r[0] = copysign(magnitude, sign_source);
+    r[1] = copysign(1.0, magnitude) * copysign(1.0, sign_source);
+    r[2] = 0.0;
+    r[3] = r[4] = r[5] = 0.0;
+}
+
+static PyObject* grad_binary_call(grad_binary_fn kernel, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"", "", "order", NULL}; // Positional-only operands
+    double a, b, r[6];
+    int order = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "dd|i", kwlist, &a, &b, &order)) {
+        return NULL;
+    }
+    if (order != 1 && order != 2) {
+        PyErr_SetString(PyExc_ValueError, "order must be 1 or 2");
+        return NULL;
+    }
+    kernel(a, b, r);
+    if (order == 2) {
+        return Py_BuildValue("(dddddd)", r[0], r[1], r[2], r[3], r[4], r[5]);
+    }
+    return Py_BuildValue("(ddd)", r[0], r[1], r[2]);
+}
+
+#define CALCO_GRAD_BINARY(name) \
+    static PyObject* grad_##name(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return grad_binary_call(b_##name, args, kwargs); \
+    }
+
+CALCO_GRAD_BINARY(add)
+CALCO_GRAD_BINARY(subtract)
+CALCO_GRAD_BINARY(multiply)
+CALCO_GRAD_BINARY(divide)
+CALCO_GRAD_BINARY(power)
+CALCO_GRAD_BINARY(hypotenuse)
+CALCO_GRAD_BINARY(arctangent2)
+CALCO_GRAD_BINARY(log_custom_base)
+CALCO_GRAD_BINARY(float_modulo)
+CALCO_GRAD_BINARY(positive_difference)
+CALCO_GRAD_BINARY(copy_sign_double)
+
+// a * b + c: the only nonzero second derivative is d2f/dadb = 1. order=2 appends the upper
+// triangle (aa, ab, ac, bb, bc, cc).
+static PyObject* grad_fused_multiply_add(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"", "", "", "order", NULL};
+    double a, b, c;
+    int order = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ddd|i", kwlist, &a, &b, &c, &order)) {
+        return NULL;
+    }
+    if (order != 1 && order != 2) {
+        PyErr_SetString(PyExc_ValueError, "order must be 1 or 2");
+        return NULL;
+    }
+    if (order == 2) {
+        return Py_BuildValue("(dddddddddd)", fma(a, b, c), b, a, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0);
+    }
+    return Py_BuildValue("(dddd)", fma(a, b, c), b, a, 1.0);
+}
+
+// -----------------------------------------------------------------------------
+// Buffer Form: calco.grad.apply(func, x, dx=None, out=None, dout=None, d2out=None, order=1)
+// With a dx seed buffer, dout receives f'(x) * dx (the tangent of a dual-number input).
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    calco_dual_fn kernel;
+    int order;
+    const double* x;
+    const double* dx;
+    double* f;
+    double* df;
+    double* d2f;
+    Py_ssize_t n;
+} grad_task;
+
+static void grad_chunk(void* ctx, Py_ssize_t chunk) {
+    const grad_task* t = (const grad_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = start + CALCO_DEFAULT_CHUNK;
+    if (end > t->n) {
+        end = t->n;
+    }
+    double r[3];
+    for (Py_ssize_t i = start; i < end; i++) {
+        t->kernel(t->x[i], t->order, r);
+        t->f[i] = r[0];
+        t->df[i] = (t->dx != NULL) ? r[1] * t->dx[i] : r[1];
+        if (t->d2f != NULL) {
+            t->d2f[i] = r[2];
+        }
+    }
+}
+
+static PyObject* grad_apply(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"func", "x", "dx", "out", "dout", "d2out", "order", NULL};
+    PyObject *func, *xbuf, *dxbuf = Py_None, *out = Py_None, *dout = Py_None, *d2out = Py_None;
+    PyObject *f_obj = NULL, *df_obj = NULL, *d2f_obj = NULL, *result = NULL;
+    Py_buffer x_view, dx_view, f_view, df_view, d2f_view;
+    int order = 1;
+    int have_dx = 0, have_f = 0, have_df = 0, have_d2f = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|OOOOi", kwlist,
+                                     &func, &xbuf, &dxbuf, &out, &dout, &d2out, &order)) {
+        return NULL;
+    }
+    if (order != 1 && order != 2) {
+        PyErr_SetString(PyExc_ValueError, "order must be 1 or 2");
+        return NULL;
+    }
+    const calco_unary_entry* entry = calco_lookup_unary(func);
+    if (entry == NULL) {
+        return NULL;
+    }
+    const calco_dual_entry* dual = dual_table;
+    while (dual->name != NULL && strcmp(dual->name, entry->name) != 0) {
+        dual++;
+    }
+    if (calco_get_double_buffer(xbuf, &x_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = x_view.len / (Py_ssize_t)sizeof(double);
+    if (dxbuf != Py_None) {
+        if (calco_get_double_buffer(dxbuf, &dx_view, 0) < 0) {
+            goto done;
+        }
+        have_dx = 1;
+        if (dx_view.len != x_view.len) {
+            PyErr_SetString(PyExc_ValueError, "dx must have the same length as x");
+            goto done;
+        }
+    }
+    if (calco_get_out_buffer(out, n, &f_view, &f_obj) < 0) {
+        goto done;
+    }
+    have_f = 1;
+    if (calco_get_out_buffer(dout, n, &df_view, &df_obj) < 0) {
+        goto done;
+    }
+    have_df = 1;
+    if (order == 2) {
+        if (calco_get_out_buffer(d2out, n, &d2f_view, &d2f_obj) < 0) {
+            goto done;
+        }
+        have_d2f = 1;
+    }
+
+    grad_task task = {dual->kernel, order, (const double*)x_view.buf,
+                      have_dx ? (const double*)dx_view.buf : NULL,
+                      (double*)f_view.buf, (double*)df_view.buf,
+                      have_d2f ? (double*)d2f_view.buf : NULL, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(grad_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    result = (order == 2) ? PyTuple_Pack(3, f_obj, df_obj, d2f_obj) : PyTuple_Pack(2, f_obj, df_obj);
+
+done:
+    PyBuffer_Release(&x_view);
+    if (have_dx) PyBuffer_Release(&dx_view);
+    if (have_f) PyBuffer_Release(&f_view);
+    if (have_df) PyBuffer_Release(&df_view);
+    if (have_d2f) PyBuffer_Release(&d2f_view);
+    Py_XDECREF(f_obj);
+    Py_XDECREF(df_obj);
+    Py_XDECREF(d2f_obj);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Submodule Definition
+// -----------------------------------------------------------------------------
+
+CALCO_WORKSPACE_SHIM(grad_apply) // workspace= (calco_workspace.c)
+
+#define GRAD_UNARY_DEF(name, doc) \
+    {#name, (PyCFunction)(void(*)(void))grad_##name, METH_VARARGS | METH_KEYWORDS, doc}
+#define GRAD_BINARY_DEF(name, doc) GRAD_UNARY_DEF(name, doc)
+
+static PyMethodDef CalcoGradMethods[] = {
+    GRAD_UNARY_DEF(square_root, "Returns (sqrt(x), 1/(2 sqrt(x))[, f''])."),
+    GRAD_UNARY_DEF(cube_root, "Returns (cbrt(x), 1/(3 cbrt(x)^2)[, f''])."),
+    GRAD_UNARY_DEF(absolute_value, "Returns (|x|, sign(x)[, 0])."),
+    GRAD_UNARY_DEF(floor_val, "Returns (floor(x), 0[, 0])."),
+    GRAD_UNARY_DEF(ceil_val, "Returns (ceil(x), 0[, 0])."),
+    GRAD_UNARY_DEF(round_val, "Returns (round(x), 0[, 0])."),
+    GRAD_UNARY_DEF(nearbyint_val, "Returns (nearbyint(x), 0[, 0])."),
+    GRAD_UNARY_DEF(truncate_val, "Returns (trunc(x), 0[, 0])."),
+    GRAD_UNARY_DEF(natural_log, "Returns (ln(x), 1/x[, -1/x^2])."),
+    GRAD_UNARY_DEF(log_base10, "Returns (log10(x), 1/(x ln 10)[, f''])."),
+    GRAD_UNARY_DEF(log_base2, "Returns (log2(x), 1/(x ln 2)[, f''])."),
+    GRAD_UNARY_DEF(exponential, "Returns (e^x, e^x[, e^x]) from a single exp()."),
+    GRAD_UNARY_DEF(exponential_base2, "Returns (2^x, 2^x ln 2[, 2^x ln^2 2])."),
+    GRAD_UNARY_DEF(exponential_minus_1, "Returns (e^x - 1, e^x[, e^x])."),
+    GRAD_UNARY_DEF(sine, "Returns (sin(x), cos(x)[, -sin(x)])."),
+    GRAD_UNARY_DEF(cosine, "Returns (cos(x), -sin(x)[, -cos(x)])."),
+    GRAD_UNARY_DEF(tangent, "Returns (tan(x), 1 + tan^2(x)[, f''])."),
+    GRAD_UNARY_DEF(arcsine, "Returns (asin(x), 1/sqrt(1 - x^2)[, f''])."),
+    GRAD_UNARY_DEF(arccosine, "Returns (acos(x), -1/sqrt(1 - x^2)[, f''])."),
+    GRAD_UNARY_DEF(arctangent, "Returns (atan(x), 1/(1 + x^2)[, f''])."),
+    GRAD_UNARY_DEF(hyperbolic_sine, "Returns (sinh(x), cosh(x)[, sinh(x)])."),
+    GRAD_UNARY_DEF(hyperbolic_cosine, "Returns (cosh(x), sinh(x)[, cosh(x)])."),
+    GRAD_UNARY_DEF(hyperbolic_tangent, "Returns (tanh(x), 1 - tanh^2(x)[, f''])."),
+    GRAD_UNARY_DEF(inverse_hyperbolic_sine, "Returns (asinh(x), 1/sqrt(1 + x^2)[, f''])."),
+    GRAD_UNARY_DEF(inverse_hyperbolic_cosine, "Returns (acosh(x), 1/sqrt(x^2 - 1)[, f''])."),
+    GRAD_UNARY_DEF(inverse_hyperbolic_tangent, "Returns (atanh(x), 1/(1 - x^2)[, f''])."),
+    GRAD_UNARY_DEF(gamma_function, "Returns (gamma(x), gamma(x) digamma(x)[, f''])."),
+    GRAD_UNARY_DEF(log_gamma_function, "Returns (lgamma(x), digamma(x)[, trigamma(x)])."),
+    GRAD_UNARY_DEF(error_function, "Returns (erf(x), 2/sqrt(pi) e^(-x^2)[, f''])."),
+    GRAD_UNARY_DEF(complementary_error_function, "Returns (erfc(x), -2/sqrt(pi) e^(-x^2)[, f''])."),
+    GRAD_UNARY_DEF(degrees_to_radians, "Returns (x pi/180, pi/180[, 0])."),
+    GRAD_UNARY_DEF(radians_to_degrees, "Returns (x 180/pi, 180/pi[, 0])."),
+    GRAD_BINARY_DEF(add, "Returns (a + b, 1, 1[, 0, 0, 0])."),
+    GRAD_BINARY_DEF(subtract, "Returns (a - b, 1, -1[, 0, 0, 0])."),
+    GRAD_BINARY_DEF(multiply, "Returns (a * b, b, a[, 0, 1, 0])."),
+    GRAD_BINARY_DEF(divide, "Returns (a / b, 1/b, -a/b^2[, 0, -1/b^2, 2a/b^3])."),
+    GRAD_BINARY_DEF(power, "Returns (x^y, y x^(y-1), x^y ln x[, f_xx, f_xy, f_yy])."),
+    GRAD_BINARY_DEF(hypotenuse, "Returns (h, x/h, y/h[, y^2/h^3, -xy/h^3, x^2/h^3])."),
+    GRAD_BINARY_DEF(arctangent2, "Returns (atan2(y, x), df/dy, df/dx[, f_yy, f_yx, f_xx])."),
+    GRAD_BINARY_DEF(log_custom_base, "Returns (log_b(x), df/dx, df/db[, f_xx, f_xb, f_bb])."),
+    GRAD_BINARY_DEF(float_modulo, "Returns (fmod(x, y), 1, -trunc(x/y)[, 0, 0, 0])."),
+    GRAD_BINARY_DEF(positive_difference, "Returns (fdim(x, y), df/dx, df/dy[, 0, 0, 0])."),
+    GRAD_BINARY_DEF(copy_sign_double, "Returns (copysign(m, s), df/dm, 0[, 0, 0, 0])."),
+    GRAD_BINARY_DEF(fused_multiply_add, "Returns (a*b + c, b, a, 1[, 0, 1, 0, 0, 0, 0])."),
+    {"apply", (PyCFunction)(void(*)(void))grad_apply_ws, METH_VARARGS | METH_KEYWORDS,
+     "apply(func, x, dx=None, out=None, dout=None, d2out=None, order=1): Evaluates a unary calco function "
+     "and its derivative(s) over a float64 buffer. Returns (f, df) or (f, df, d2f); with a dx seed, df = f'(x) * dx."},
+    {NULL, NULL, 0, NULL}
+};
+
+struct PyModuleDef calcogradmodule = {
+    PyModuleDef_HEAD_INIT,
+    "calco.grad",
+    "Forward-mode automatic differentiation: each function returns its value and derivative(s) from one evaluation.",
+    -1,
+    CalcoGradMethods
+};
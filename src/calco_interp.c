@@ -0,0 +1,475 @@
+// calco_interp.c
+// Contains piecewise-polynomial interpolation on sorted grids: calco.interp (linear), and the
+// calco.PchipInterpolator (monotone cubic) and calco.CubicSpline (natural cubic) types.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite, calco_isnan, calco_same_bits (folded away under -ffast-math)
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Interpolation Tables
+// Knots and per-interval coefficients live in one allocation as separate arrays (x, a, b, c, d),
+// so evaluation touches one contiguous stream per coefficient. On interval i, with t = q - x[i],
+// the value is a[i] + t * (b[i] + t * (c[i] + t * d[i])).
+//
+// Sorted batches are located by walking forward from the previous query's interval for a few
+// steps, which makes dense sorted queries O(1) each; unsorted batches (and long gaps) use a
+// branch-free binary search over the interior knots stored in Eytzinger (BFS) order, so the
+// first levels of every search share cache lines.
+// -----------------------------------------------------------------------------
+
+#define WALK_STEPS 8
+
+typedef struct {
+    Py_ssize_t n;       // Number of knots (>= 2)
+    int degree;         // 1 (linear) or 3 (cubic)
+    int clamp;          // Use left/right outside [x[0], x[n - 1]] instead of extrapolating
+    double left;
+    double right;
+    double last;        // Value at x[n - 1], returned exactly there
+    double* x;          // n knots, strictly increasing
+    double* a;          // n - 1 coefficients each
+    double* b;
+    double* c;          // NULL for degree 1
+    double* d;
+    Py_ssize_t m;       // Interior knots x[1..n-2] in the search tree
+    double* eyt;        // 1-based Eytzinger keys
+    Py_ssize_t* rank;   // Sorted position of each Eytzinger node
+    void* block;        // The single allocation behind all arrays
+} interp_table;
+
+static Py_ssize_t eyt_build(interp_table* t, const double* keys, Py_ssize_t i, Py_ssize_t k) {
+    if (k <= t->m) {
+        i = eyt_build(t, keys, i, 2 * k);
+        t->eyt[k] = keys[i];
+        t->rank[k] = i;
+        i = eyt_build(t, keys, i + 1, 2 * k + 1);
+    }
+    return i;
+}
+
+// Allocates a table for n knots and fills x and the search tree from xp. The caller fills
+// the coefficients. Returns 0, or -1 with an exception set.
+static int table_alloc(interp_table* t, const double* xp, Py_ssize_t n, int degree) {
+    memset(t, 0, sizeof(*t));
+    if (n < 2) {
+        PyErr_SetString(PyExc_ValueError, "at least two knots are required");
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (!calco_isfinite(xp[i])) {
+            PyErr_SetString(PyExc_ValueError, "x must be finite");
+            return -1;
+        }
+    }
+    for (Py_ssize_t i = 1; i < n; i++) {
+        if (!(xp[i] > xp[i - 1])) {
+            PyErr_SetString(PyExc_ValueError, "x must be strictly increasing");
+            return -1;
+        }
+    }
+    Py_ssize_t ncoef = (degree == 3) ? 4 : 2;
+    Py_ssize_t m = n - 2;
+    size_t doubles = (size_t)n + (size_t)ncoef * (n - 1) + (size_t)m + 1;
+    t->block = PyMem_Malloc(doubles * sizeof(double) + (m + 1) * sizeof(Py_ssize_t));
+    if (t->block == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    t->n = n;
+    t->degree = degree;
+    t->m = m;
+    t->x = (double*)t->block;
+    t->a = t->x + n;
+    t->b = t->a + (n - 1);
+    t->c = (degree == 3) ? t->b + (n - 1) : NULL;
+    t->d = (degree == 3) ? t->c + (n - 1) : NULL;
+    t->eyt = t->b + (ncoef - 1) * (n - 1);
+    t->rank = (Py_ssize_t*)(t->eyt + m + 1);
+    memcpy(t->x, xp, n * sizeof(double));
+    eyt_build(t, xp + 1, 0, 1);
+    return 0;
+}
+
+static void table_free(interp_table* t) {
+    PyMem_Free(t->block);
+    t->block = NULL;
+}
+
+// Number of interior knots <= q, i.e. the interval index of q.
+static inline Py_ssize_t eyt_search(const interp_table* t, double q) {
+    Py_ssize_t k = 1;
+    while (k <= t->m) {
+        k = 2 * k + (t->eyt[k] <= q);
+    }
+    // Strip the trailing right turns and the last left turn: k becomes the first key > q.
+#if defined(__GNUC__)
+    k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+#else
+    while (k & 1) {
+        k >>= 1;
+    }
+    k >>= 1;
+#endif
+    return (k == 0) ? t->m : t->rank[k];
+}
+
+static inline Py_ssize_t table_locate(const interp_table* t, double q, Py_ssize_t hint) {
+    if (q >= t->x[hint]) {
+        Py_ssize_t last = t->n - 2;
+        for (int s = 0; s < WALK_STEPS; s++) {
+            if (hint == last || q < t->x[hint + 1]) {
+                return hint;
+            }
+            hint++;
+        }
+    }
+    return eyt_search(t, q);
+}
+
+// A NaN query gives NaN. Under -ffast-math the end tests below could send it to either end, so
+// it is caught by bit test, and the exact match at the last knot is a bit comparison too.
+static void table_eval(const interp_table* t, const double* in, double* out, Py_ssize_t count) {
+    // One cheap pass decides between the forward walk (sorted runs) and the plain tree search,
+    // so the per-query branch below is perfectly predictable.
+    int sorted = 1;
+    for (Py_ssize_t j = 1; j < count; j++) {
+        sorted &= (in[j - 1] <= in[j]);
+    }
+    Py_ssize_t i = 0;
+    double lo = t->x[0], hi = t->x[t->n - 1];
+    for (Py_ssize_t j = 0; j < count; j++) {
+        double q = in[j];
+        i = sorted ? table_locate(t, q, i) : eyt_search(t, q);
+        double s = q - t->x[i];
+        double y;
+        if (t->degree == 3) {
+            y = t->a[i] + s * (t->b[i] + s * (t->c[i] + s * t->d[i]));
+        } else {
+            y = t->a[i] + s * t->b[i];
+        }
+        y = calco_same_bits(q, hi) ? t->last : y;
+        if (t->clamp) {
+            y = (q < lo) ? t->left : y;
+            y = (q > hi) ? t->right : y;
+        }
+        out[j] = calco_isnan(q) ? q : y;
+    }
+}
+
+typedef struct {
+    const interp_table* table;
+    const double* in;
+    double* out;
+    Py_ssize_t n;
+} interp_task;
+
+static void interp_chunk(void* ctx, Py_ssize_t chunk) {
+    const interp_task* t = (const interp_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = start + CALCO_DEFAULT_CHUNK;
+    if (end > t->n) {
+        end = t->n;
+    }
+    table_eval(t->table, t->in + start, t->out + start, end - start);
+}
+
+// Evaluates a table at a float (returning a float) or at every element of a float64 buffer
+// (returning `out` or a new array), on the worker pool.
+static PyObject* table_call(const interp_table* table, PyObject* x, PyObject* out) {
+    Py_buffer in_view, out_view;
+    PyObject* out_obj;
+    if (PyFloat_Check(x) || PyLong_Check(x)) {
+        double q = PyFloat_AsDouble(x), y;
+        if (q == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        table_eval(table, &q, &y, 1);
+        return Py_BuildValue("d", y);
+    }
+    if (calco_get_double_buffer(x, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    interp_task task = {table, (const double*)in_view.buf, (double*)out_view.buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(interp_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// Coefficients
+// -----------------------------------------------------------------------------
+
+static void fill_linear(interp_table* t, const double* y) {
+    for (Py_ssize_t i = 0; i + 1 < t->n; i++) {
+        t->a[i] = y[i];
+        t->b[i] = (y[i + 1] - y[i]) / (t->x[i + 1] - t->x[i]);
+    }
+    t->last = y[t->n - 1];
+}
+
+// Hermite form on each interval from values y and end slopes s.
+static void fill_hermite(interp_table* t, const double* y, const double* s) {
+    for (Py_ssize_t i = 0; i + 1 < t->n; i++) {
+        double h = t->x[i + 1] - t->x[i];
+        double delta = (y[i + 1] - y[i]) / h;
+        t->a[i] = y[i];
+        t->b[i] = s[i];
+        t->c[i] = (3.0 * delta - 2.0 * s[i] - s[i + 1]) / h;
+        t->d[i] = (s[i] + s[i + 1] - 2.0 * delta) / (h * h);
+    }
+    t->last = y[t->n - 1];
+}
+
+static inline int same_sign(double a, double b) {
+    return (a > 0.0 && b > 0.0) || (a < 0.0 && b < 0.0);
+}
+
+// One-sided three-point end slope, limited to keep the curve monotone (Fritsch-Carlson).
+static double pchip_end_slope(double h0, double h1, double d0, double d1) {
+    double s = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+    if (!same_sign(s, d0)) {
+        return 0.0;
+    }
+    if (!same_sign(d0, d1) && fabs(s) > fabs(3.0 * d0)) {
+        return 3.0 * d0;
+    }
+    return s;
+}
+
+// Slopes of the monotone piecewise cubic Hermite interpolant: a weighted harmonic mean of the
+// neighbouring secants, or zero at local extrema. Returns 0, or -1 with MemoryError set.
+static int fill_pchip(interp_table* t, const double* y) {
+    Py_ssize_t n = t->n;
+    double* s = (double*)PyMem_Malloc(n * sizeof(double));
+    double* h = (double*)PyMem_Malloc((n - 1) * sizeof(double));
+    double* delta = (double*)PyMem_Malloc((n - 1) * sizeof(double));
+    if (s == NULL || h == NULL || delta == NULL) {
+        PyMem_Free(s);
+        PyMem_Free(h);
+        PyMem_Free(delta);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i + 1 < n; i++) {
+        h[i] = t->x[i + 1] - t->x[i];
+        delta[i] = (y[i + 1] - y[i]) / h[i];
+    }
+    if (n == 2) {
+        s[0] = s[1] = delta[0];
+    } else {
+        for (Py_ssize_t i = 1; i + 1 < n; i++) {
+            if (!same_sign(delta[i - 1], delta[i])) {
+                s[i] = 0.0;
+            } else {
+                double w1 = 2.0 * h[i] + h[i - 1];
+                double w2 = h[i] + 2.0 * h[i - 1];
+                s[i] = (w1 + w2) / (w1 / delta[i - 1] + w2 / delta[i]);
+            }
+        }
+        s[0] = pchip_end_slope(h[0], h[1], delta[0], delta[1]);
+        s[n - 1] = pchip_end_slope(h[n - 2], h[n - 3], delta[n - 2], delta[n - 3]);
+    }
+    fill_hermite(t, y, s);
+    PyMem_Free(s);
+    PyMem_Free(h);
+    PyMem_Free(delta);
+    return 0;
+}
+
+// Natural cubic spline: second derivatives M with M[0] = M[n-1] = 0 from the tridiagonal
+// continuity system, solved with the Thomas algorithm. Returns 0, or -1 with MemoryError set.
+static int fill_natural(interp_table* t, const double* y) {
+    Py_ssize_t n = t->n;
+    double* M = (double*)PyMem_Calloc(n, sizeof(double));
+    double* cp = (double*)PyMem_Calloc(n, sizeof(double));
+    if (M == NULL || cp == NULL) {
+        PyMem_Free(M);
+        PyMem_Free(cp);
+        PyErr_NoMemory();
+        return -1;
+    }
+    const double* x = t->x;
+    // Forward sweep over rows 1..n-2: h[i-1] M[i-1] + 2 (h[i-1] + h[i]) M[i] + h[i] M[i+1] = r[i]
+    for (Py_ssize_t i = 1; i + 1 < n; i++) {
+        double h0 = x[i] - x[i - 1], h1 = x[i + 1] - x[i];
+        double r = 6.0 * ((y[i + 1] - y[i]) / h1 - (y[i] - y[i - 1]) / h0);
+        double denom = 2.0 * (h0 + h1) - h0 * cp[i - 1];
+        cp[i] = h1 / denom;
+        M[i] = (r - h0 * M[i - 1]) / denom;
+    }
+    for (Py_ssize_t i = n - 3; i >= 1; i--) {
+        M[i] -= cp[i] * M[i + 1];
+    }
+    for (Py_ssize_t i = 0; i + 1 < n; i++) {
+        double h = x[i + 1] - x[i];
+        t->a[i] = y[i];
+        t->b[i] = (y[i + 1] - y[i]) / h - h * (2.0 * M[i] + M[i + 1]) / 6.0;
+        t->c[i] = M[i] * 0.5;
+        t->d[i] = (M[i + 1] - M[i]) / (6.0 * h);
+    }
+    t->last = y[n - 1];
+    PyMem_Free(M);
+    PyMem_Free(cp);
+    return 0;
+}
+
+// Reads knots and values and builds a table of the requested kind. Returns 0, or -1 with an
+// exception set.
+enum { KIND_LINEAR, KIND_PCHIP, KIND_NATURAL };
+
+static int table_build(interp_table* t, PyObject* xp_obj, PyObject* fp_obj, int kind) {
+    Py_ssize_t nx, ny;
+    double* xp = calco_read_doubles(xp_obj, &nx);
+    if (xp == NULL) {
+        return -1;
+    }
+    double* fp = calco_read_doubles(fp_obj, &ny);
+    if (fp == NULL) {
+        PyMem_Free(xp);
+        return -1;
+    }
+    int rc = -1;
+    if (nx != ny) {
+        PyErr_SetString(PyExc_ValueError, "x and y must have the same length");
+    } else if (table_alloc(t, xp, nx, (kind == KIND_LINEAR) ? 1 : 3) == 0) {
+        if (kind == KIND_LINEAR) {
+            fill_linear(t, fp);
+            rc = 0;
+        } else {
+            rc = (kind == KIND_PCHIP) ? fill_pchip(t, fp) : fill_natural(t, fp);
+        }
+        t->left = fp[0];
+        t->right = fp[nx - 1];
+        if (rc < 0) {
+            table_free(t);
+        }
+    }
+    PyMem_Free(xp);
+    PyMem_Free(fp);
+    return rc;
+}
+
+// -----------------------------------------------------------------------------
+// calco.interp
+// -----------------------------------------------------------------------------
+
+PyObject* calco_interp(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "xp", "fp", "out", "left", "right", NULL};
+    PyObject *x, *xp, *fp, *out = Py_None, *left = Py_None, *right = Py_None;
+    interp_table table;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|O$OO", kwlist, &x, &xp, &fp, &out, &left, &right)) {
+        return NULL;
+    }
+    if (table_build(&table, xp, fp, KIND_LINEAR) < 0) {
+        return NULL;
+    }
+    table.clamp = 1;
+    if ((left != Py_None && (table.left = PyFloat_AsDouble(left)) == -1.0 && PyErr_Occurred()) ||
+        (right != Py_None && (table.right = PyFloat_AsDouble(right)) == -1.0 && PyErr_Occurred())) {
+        table_free(&table);
+        return NULL;
+    }
+    PyObject* result = table_call(&table, x, out);
+    table_free(&table);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// calco.PchipInterpolator and calco.CubicSpline
+// Both types share one layout and evaluation; only the coefficient construction differs.
+// Outside the knots the end polynomials are extrapolated.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    interp_table table;
+} CalcoInterpolator;
+
+static int interpolator_init(CalcoInterpolator* self, PyObject* args, PyObject* kwargs, int kind) {
+    static char* kwlist[] = {"x", "y", NULL};
+    PyObject *x, *y;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", kwlist, &x, &y)) {
+        return -1;
+    }
+    // Coefficients are read without the GIL during evaluation, so they are never replaced.
+    if (self->table.block != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "interpolator is already initialized");
+        return -1;
+    }
+    return table_build(&self->table, x, y, kind);
+}
+
+static int pchip_init(CalcoInterpolator* self, PyObject* args, PyObject* kwargs) {
+    return interpolator_init(self, args, kwargs, KIND_PCHIP);
+}
+
+static int spline_init(CalcoInterpolator* self, PyObject* args, PyObject* kwargs) {
+    return interpolator_init(self, args, kwargs, KIND_NATURAL);
+}
+
+static void interpolator_dealloc(CalcoInterpolator* self) {
+    table_free(&self->table);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* interpolator_call(CalcoInterpolator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "out", NULL};
+    PyObject *x, *out = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", kwlist, &x, &out)) {
+        return NULL;
+    }
+    if (self->table.block == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "interpolator is not initialized");
+        return NULL;
+    }
+    return table_call(&self->table, x, out);
+}
+
+static PyObject* interpolator_get_size(CalcoInterpolator* self, void* closure) {
+    return PyLong_FromSsize_t(self->table.n);
+}
+
+static PyGetSetDef interpolator_getset[] = {
+    {"size", (getter)interpolator_get_size, NULL, "Number of knots.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+CALCO_WORKSPACE_SHIM(interpolator_call) // workspace= (calco_workspace.c)
+
+PyTypeObject CalcoPchipType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.PchipInterpolator",
+    .tp_basicsize = sizeof(CalcoInterpolator),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "PchipInterpolator(x, y): Monotone piecewise cubic Hermite interpolant (Fritsch-Carlson) through "
+              "strictly increasing knots x. Call with a float or a float64 buffer (and optional out=).",
+    .tp_getset = interpolator_getset,
+    .tp_init = (initproc)pchip_init,
+    .tp_call = (ternaryfunc)interpolator_call_ws,
+    .tp_dealloc = (destructor)interpolator_dealloc,
+    .tp_new = PyType_GenericNew,
+};
+
+PyTypeObject CalcoCubicSplineType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.CubicSpline",
+    .tp_basicsize = sizeof(CalcoInterpolator),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "CubicSpline(x, y): Natural cubic spline (zero second derivative at both ends) through strictly "
+              "increasing knots x. Call with a float or a float64 buffer (and optional out=).",
+    .tp_getset = interpolator_getset,
+    .tp_init = (initproc)spline_init,
+    .tp_call = (ternaryfunc)interpolator_call_ws,
+    .tp_dealloc = (destructor)interpolator_dealloc,
+    .tp_new = PyType_GenericNew,
+};
@@ -0,0 +1,724 @@
+// calco_intmath.c
+// Contains exact integer functions (factorial, comb, perm, gcd, lcm, isqrt, ipow, powmod) and
+// the log_factorial/log_comb helpers.
+//
+// Each function takes Python ints or int64 buffers. Scalars whose arguments and result fit in
+// 64 bits are computed in C from small tables and 128-bit intermediates; anything larger is
+// handed to math / pow() on Python ints, so scalar results are always exact. Buffer versions
+// return int64 arrays and raise OverflowError for an element whose result does not fit.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stdint.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Tables
+// -----------------------------------------------------------------------------
+
+#define FACT_MAX 20         // 20! is the largest factorial below 2^64
+#define PASCAL_MAX 67       // C(67, 33) is the largest central binomial coefficient below 2^64
+#define LOG_FACT_SIZE 256   // log(n!) is tabulated for n < LOG_FACT_SIZE
+#define STIRLERR_SIZE 16    // Stirling remainders are tabulated for n < STIRLERR_SIZE
+
+static uint64_t fact_table[FACT_MAX + 1];
+static uint64_t pascal_table[(PASCAL_MAX + 1) * (PASCAL_MAX + 2) / 2]; // Row n starts at n(n+1)/2
+static double log_fact_table[LOG_FACT_SIZE];
+static double stirlerr_table[STIRLERR_SIZE];
+
+#define HALF_LOG_2PI 0.91893853320467274178
+#define TWO_PI 6.28318530717958647693
+
+void calco_intmath_init(void) {
+    fact_table[0] = 1;
+    for (int n = 1; n <= FACT_MAX; n++) {
+        fact_table[n] = fact_table[n - 1] * (uint64_t)n;
+    }
+    for (int n = 0; n <= PASCAL_MAX; n++) {
+        uint64_t* row = pascal_table + n * (n + 1) / 2;
+        const uint64_t* prev = row - n;
+        row[0] = row[n] = 1;
+        for (int k = 1; k < n; k++) {
+            row[k] = prev[k - 1] + prev[k];
+        }
+    }
+    // Exact up to 20! (correctly rounded log of an exact integer), lgamma beyond.
+    for (int n = 0; n < LOG_FACT_SIZE; n++) {
+        log_fact_table[n] = (n <= FACT_MAX) ? log((double)fact_table[n]) : lgamma(n + 1.0);
+    }
+    // stirlerr(n) = log(n!) - (n + 1/2) log(n) + n - log(2 pi) / 2
+    stirlerr_table[0] = 0.0;
+    for (int n = 1; n < STIRLERR_SIZE; n++) {
+        stirlerr_table[n] = log_fact_table[n] - (n + 0.5) * log((double)n) + n - HALF_LOG_2PI;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 64-bit Kernels
+// Each returns INT_OK, INT_DOMAIN (argument outside the domain) or INT_OVERFLOW (the result
+// needs more than 64 bits, or the fast path does not cover the case).
+// -----------------------------------------------------------------------------
+
+enum { INT_OK, INT_DOMAIN, INT_OVERFLOW };
+
+static inline int ctz64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline int mul_overflow(uint64_t a, uint64_t b, uint64_t* r) {
+    *r = a * b;
+    return a != 0 && b > UINT64_MAX / a;
+}
+
+// Binary GCD (Stein).
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+    if (a == 0) {
+        return b;
+    }
+    if (b == 0) {
+        return a;
+    }
+    int shift = ctz64(a | b);
+    a >>= ctz64(a);
+    do {
+        // Both odd here; min and |difference| are selects rather than an unpredictable swap.
+        b >>= ctz64(b);
+        uint64_t d = (a > b) ? a - b : b - a;
+        a = (a < b) ? a : b;
+        b = d;
+    } while (b != 0);
+    return a << shift;
+}
+
+// (a * b) mod m for m > 0.
+static inline uint64_t mulmod_u64(uint64_t a, uint64_t b, uint64_t m) {
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t)(((unsigned __int128)a * b) % m);
+#else
+    if ((a | b) < (1ULL << 32)) {
+        return (a * b) % m;
+    }
+    uint64_t r = 0;
+    a %= m;
+    for (; b > 0; b >>= 1) {
+        if (b & 1) {
+            r = (r >= m - a) ? r - (m - a) : r + a;
+        }
+        a = (a >= m - a) ? a - (m - a) : a + a;
+    }
+    return r;
+#endif
+}
+
+static int factorial_u64(int64_t n, uint64_t* r) {
+    if (n < 0) {
+        return INT_DOMAIN;
+    }
+    if (n > FACT_MAX) {
+        return INT_OVERFLOW;
+    }
+    *r = fact_table[n];
+    return INT_OK;
+}
+
+// Multiplicative formula C(n - k + i, i) = C(n - k + i - 1, i - 1) (n - k + i) / i, where every
+// intermediate is itself a binomial coefficient, so it stops at the first one above 2^64.
+static int comb_u64(int64_t n, int64_t k, uint64_t* r) {
+    if (n < 0 || k < 0) {
+        return INT_DOMAIN;
+    }
+    if (k > n) {
+        *r = 0;
+        return INT_OK;
+    }
+    if (k > n - k) {
+        k = n - k;
+    }
+    if (n <= PASCAL_MAX) {
+        *r = pascal_table[n * (n + 1) / 2 + k];
+        return INT_OK;
+    }
+    uint64_t acc = 1;
+    for (int64_t i = 1; i <= k; i++) {
+        uint64_t x = (uint64_t)(n - k + i);
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 t = (unsigned __int128)acc * x / (uint64_t)i;
+        if (t > UINT64_MAX) {
+            return INT_OVERFLOW;
+        }
+        acc = (uint64_t)t;
+#else
+        // acc x is divisible by i; cancel gcd(acc, i) first so the quotient is formed exactly.
+        uint64_t g = gcd_u64(acc, (uint64_t)i);
+        if (mul_overflow(acc / g, x / ((uint64_t)i / g), &acc)) {
+            return INT_OVERFLOW;
+        }
+#endif
+    }
+    *r = acc;
+    return INT_OK;
+}
+
+static int perm_u64(int64_t n, int64_t k, uint64_t* r) {
+    if (n < 0 || k < 0) {
+        return INT_DOMAIN;
+    }
+    if (k > n) {
+        *r = 0;
+        return INT_OK;
+    }
+    if (n <= FACT_MAX) {
+        *r = fact_table[n] / fact_table[n - k];
+        return INT_OK;
+    }
+    uint64_t acc = 1;
+    for (int64_t i = 0; i < k; i++) {
+        if (mul_overflow(acc, (uint64_t)(n - i), &acc)) {
+            return INT_OVERFLOW;
+        }
+    }
+    *r = acc;
+    return INT_OK;
+}
+
+static inline uint64_t magnitude(int64_t v) {
+    return (v < 0) ? 0 - (uint64_t)v : (uint64_t)v;
+}
+
+static uint64_t isqrt_u64(uint64_t n) {
+    uint64_t r = (uint64_t)sqrt((double)n);
+    // The double estimate is within one of the answer; r is capped so r * r cannot overflow.
+    if (r > 0xFFFFFFFFULL) {
+        r = 0xFFFFFFFFULL;
+    }
+    while (r * r > n) {
+        r--;
+    }
+    while (r < 0xFFFFFFFFULL && (r + 1) * (r + 1) <= n) {
+        r++;
+    }
+    return r;
+}
+
+// base ** e by squaring; *negative is set for a negative result.
+static int ipow_u64(int64_t base, int64_t e, uint64_t* r, int* negative) {
+    if (e < 0) {
+        return INT_DOMAIN;
+    }
+    uint64_t b = magnitude(base), acc = 1;
+    *negative = (base < 0) && (e & 1);
+    if (b <= 1) {
+        *r = (e == 0) ? 1 : b;
+        return INT_OK;
+    }
+    for (uint64_t m = (uint64_t)e; m > 0; m >>= 1) {
+        if ((m & 1) && mul_overflow(acc, b, &acc)) {
+            return INT_OVERFLOW;
+        }
+        if ((m >> 1) > 0 && mul_overflow(b, b, &b)) {
+            return INT_OVERFLOW;
+        }
+    }
+    *r = acc;
+    return INT_OK;
+}
+
+// Negative exponents (modular inverses) and negative moduli are left to pow().
+static int powmod_u64(int64_t base, int64_t e, int64_t m, uint64_t* r) {
+    if (m == 0) {
+        return INT_DOMAIN;
+    }
+    if (e < 0 || m < 0) {
+        return INT_OVERFLOW;
+    }
+    uint64_t mod = (uint64_t)m;
+    uint64_t b = magnitude(base) % mod, acc = 1 % mod;
+    if (base < 0 && b != 0) {
+        b = mod - b;
+    }
+    for (uint64_t k = (uint64_t)e; k > 0; k >>= 1) {
+        if (k & 1) {
+            acc = mulmod_u64(acc, b, mod);
+        }
+        b = mulmod_u64(b, b, mod);
+    }
+    *r = acc;
+    return INT_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Logarithms
+// -----------------------------------------------------------------------------
+
+static double log_factorial_d(double n) {
+    if (n < LOG_FACT_SIZE) {
+        return log_fact_table[(int)n];
+    }
+    return lgamma(n + 1.0);
+}
+
+static double stirlerr(double n) {
+    if (n < STIRLERR_SIZE) {
+        return stirlerr_table[(int)n];
+    }
+    double r = 1.0 / (n * n);
+    return (1.0 / 12.0 - r * (1.0 / 360.0 - r * (1.0 / 1260.0 - r * (1.0 / 1680.0)))) / n;
+}
+
+// Exact for n <= PASCAL_MAX; otherwise Loader's saddle-point form
+//   -k log(k/n) - m log1p(-k/n) - log(2 pi k m / n) / 2 + stirlerr(n) - stirlerr(k) - stirlerr(m)
+// with m = n - k, which avoids differencing three large lgamma values.
+static double log_comb_d(double n, double k) {
+    if (k > n) {
+        return -HUGE_VAL;
+    }
+    double m = n - k;
+    if (k > m) {
+        double t = k;
+        k = m;
+        m = t;
+    }
+    if (k == 0.0) {
+        return 0.0;
+    }
+    if (n <= PASCAL_MAX) {
+        int ni = (int)n;
+        return log((double)pascal_table[ni * (ni + 1) / 2 + (int)k]);
+    }
+    return -k * log(k / n) - m * log1p(-k / n) - 0.5 * log(TWO_PI * k * (m / n)) +
+           stirlerr(n) - stirlerr(k) - stirlerr(m);
+}
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+
+typedef enum {
+    OP_FACTORIAL, OP_COMB, OP_PERM, OP_GCD, OP_LCM, OP_ISQRT, OP_IPOW, OP_POWMOD,
+    OP_LOG_FACTORIAL, OP_LOG_COMB
+} int_op;
+
+typedef struct {
+    const char* name;
+    int nargs;           // Operands taken by the buffer form (and by the scalar form, except gcd/lcm)
+    int real_result;     // Result is a double (log_*)
+    const char* fallback; // Attribute of math called when the fast path does not apply, or NULL
+} int_op_info;
+
+static const int_op_info OPS[] = {
+    {"factorial", 1, 0, "factorial"},
+    {"comb", 2, 0, "comb"},
+    {"perm", 2, 0, "perm"},
+    {"gcd", 2, 0, "gcd"},
+    {"lcm", 2, 0, "lcm"},
+    {"isqrt", 1, 0, "isqrt"},
+    {"ipow", 2, 0, NULL},
+    {"powmod", 3, 0, NULL},
+    {"log_factorial", 1, 1, NULL},
+    {"log_comb", 2, 1, NULL},
+};
+
+// Evaluates an integer operation on 64-bit arguments. gcd and lcm fold over all nargs values.
+static int int_eval(int_op op, const int64_t* a, int nargs, uint64_t* r, int* negative) {
+    *negative = 0;
+    switch (op) {
+        case OP_FACTORIAL: return factorial_u64(a[0], r);
+        case OP_COMB: return comb_u64(a[0], a[1], r);
+        case OP_PERM: return perm_u64(a[0], a[1], r);
+        case OP_ISQRT:
+            if (a[0] < 0) {
+                return INT_DOMAIN;
+            }
+            *r = isqrt_u64((uint64_t)a[0]);
+            return INT_OK;
+        case OP_IPOW: return ipow_u64(a[0], a[1], r, negative);
+        case OP_POWMOD: return powmod_u64(a[0], a[1], a[2], r);
+        case OP_GCD:
+            *r = 0;
+            for (int i = 0; i < nargs; i++) {
+                *r = gcd_u64(*r, magnitude(a[i]));
+            }
+            return INT_OK;
+        default: // OP_LCM
+            *r = 1;
+            for (int i = 0; i < nargs; i++) {
+                uint64_t v = magnitude(a[i]);
+                if (v == 0 || *r == 0) {
+                    *r = 0;
+                    continue;
+                }
+                if (mul_overflow(*r / gcd_u64(*r, v), v, r)) {
+                    return INT_OVERFLOW;
+                }
+            }
+            return INT_OK;
+    }
+}
+
+static int real_eval(int_op op, double n, double k, double* r) {
+    if (n < 0.0 || (op == OP_LOG_COMB && k < 0.0)) {
+        return INT_DOMAIN;
+    }
+    *r = (op == OP_LOG_FACTORIAL) ? log_factorial_d(n) : log_comb_d(n, k);
+    return INT_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Scalar Path
+// -----------------------------------------------------------------------------
+
+// Calls the exact Python-int implementation for arguments or results beyond 64 bits.
+static PyObject* int_fallback(int_op op, PyObject* const* args, int nargs) {
+    if (op == OP_IPOW || op == OP_POWMOD) {
+        if (op == OP_IPOW) {
+            PyObject* zero = PyLong_FromLong(0);
+            int negative = (zero != NULL) ? PyObject_RichCompareBool(args[1], zero, Py_LT) : -1;
+            Py_XDECREF(zero);
+            if (negative < 0) {
+                return NULL;
+            }
+            if (negative) {
+                PyErr_SetString(PyExc_ValueError, "ipow() exponent must be non-negative");
+                return NULL;
+            }
+        }
+        return PyNumber_Power(args[0], args[1], (op == OP_POWMOD) ? args[2] : Py_None);
+    }
+    static PyObject* math_fns[OP_LOG_FACTORIAL]; // Looked up once, kept for the process lifetime
+    if (math_fns[op] == NULL) {
+        PyObject* math = PyImport_ImportModule("math");
+        if (math == NULL) {
+            return NULL;
+        }
+        math_fns[op] = PyObject_GetAttrString(math, OPS[op].fallback);
+        Py_DECREF(math);
+        if (math_fns[op] == NULL) {
+            return NULL;
+        }
+    }
+    PyObject* tuple = PyTuple_New(nargs);
+    for (int i = 0; tuple != NULL && i < nargs; i++) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(tuple, i, args[i]);
+    }
+    PyObject* r = (tuple != NULL) ? PyObject_Call(math_fns[op], tuple, NULL) : NULL;
+    Py_XDECREF(tuple);
+    return r;
+}
+
+#define MAX_SCALAR_ARGS 64 // gcd/lcm with more arguments go straight to math
+
+// args are integers (already passed through PyNumber_Index).
+static PyObject* int_scalar(int_op op, PyObject* const* args, int nargs) {
+    int64_t a[MAX_SCALAR_ARGS];
+    int fits = nargs <= MAX_SCALAR_ARGS;
+    for (int i = 0; fits && i < nargs; i++) {
+        int overflow;
+        a[i] = PyLong_AsLongLongAndOverflow(args[i], &overflow);
+        if (a[i] == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        fits = !overflow;
+    }
+    if (OPS[op].real_result) {
+        double v[2] = {0.0, 0.0}, r;
+        for (int i = 0; i < nargs; i++) {
+            v[i] = fits ? (double)a[i] : PyLong_AsDouble(args[i]);
+            if (PyErr_Occurred()) {
+                return NULL;
+            }
+        }
+        if (real_eval(op, v[0], v[1], &r) != INT_OK) {
+            PyErr_Format(PyExc_ValueError, "%s() not defined for negative values", OPS[op].name);
+            return NULL;
+        }
+        return PyFloat_FromDouble(r);
+    }
+    if (fits) {
+        uint64_t r;
+        int negative;
+        int status = int_eval(op, a, nargs, &r, &negative);
+        if (status == INT_OK && !negative) {
+            return PyLong_FromUnsignedLongLong(r);
+        }
+        if (status == INT_OK && r <= (uint64_t)INT64_MAX + 1) {
+            return PyLong_FromLongLong((long long)(0 - r));
+        }
+    }
+    return int_fallback(op, args, nargs);
+}
+
+// -----------------------------------------------------------------------------
+// Buffer Path
+// Operands are int64 buffers or ints broadcast over them.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    Py_buffer view;
+    int has_view;
+    const int64_t* data;
+    Py_ssize_t step; // 0 for a broadcast scalar
+    Py_ssize_t n;    // -1 for a broadcast scalar
+    int64_t scalar;
+} int_arg;
+
+typedef struct {
+    int_op op;
+    int nargs;
+    const int_arg* args;
+    int64_t* out_int;
+    double* out_real;
+    Py_ssize_t n;
+    Py_ssize_t* failures; // Per chunk: index of the first failing element, or -1
+    int* statuses;        // Per chunk: its status
+} int_task;
+
+static void int_chunk(void* ctx, Py_ssize_t chunk) {
+    const int_task* t = (const int_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK > t->n) ? t->n : start + CALCO_DEFAULT_CHUNK;
+    int64_t a[3] = {0, 0, 0};
+    for (Py_ssize_t i = start; i < end; i++) {
+        for (int j = 0; j < t->nargs; j++) {
+            a[j] = t->args[j].data[i * t->args[j].step];
+        }
+        int status;
+        if (t->out_real != NULL) {
+            status = real_eval(t->op, (double)a[0], (double)a[1], &t->out_real[i]);
+        } else {
+            uint64_t r;
+            int negative;
+            status = int_eval(t->op, a, t->nargs, &r, &negative);
+            if (status == INT_OK && r > (negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX)) {
+                status = INT_OVERFLOW;
+            }
+            t->out_int[i] = negative ? (int64_t)(0 - r) : (int64_t)r;
+        }
+        if (status != INT_OK) {
+            t->failures[chunk] = i;
+            t->statuses[chunk] = status;
+            return;
+        }
+    }
+}
+
+static void int_args_release(int_arg* args, int nargs) {
+    for (int i = 0; i < nargs; i++) {
+        if (args[i].has_view) {
+            PyBuffer_Release(&args[i].view);
+            args[i].has_view = 0;
+        }
+    }
+}
+
+static PyObject* int_buffers(int_op op, PyObject* const* objs, PyObject* out) {
+    int nargs = OPS[op].nargs;
+    int_arg args[3];
+    Py_ssize_t n = -1;
+    memset(args, 0, sizeof(args));
+    for (int i = 0; i < nargs; i++) {
+        if (PyLong_Check(objs[i])) {
+            args[i].scalar = PyLong_AsLongLong(objs[i]);
+            if (args[i].scalar == -1 && PyErr_Occurred()) {
+                int_args_release(args, i);
+                return NULL;
+            }
+            args[i].data = &args[i].scalar;
+            continue;
+        }
+        if (calco_get_typed_buffer(objs[i], &args[i].view, 0, "q") < 0) {
+            int_args_release(args, i);
+            return NULL;
+        }
+        args[i].has_view = 1;
+        args[i].data = (const int64_t*)args[i].view.buf;
+        args[i].step = 1;
+        Py_ssize_t len = args[i].view.len / (Py_ssize_t)sizeof(int64_t);
+        if (n >= 0 && len != n) {
+            int_args_release(args, i + 1);
+            PyErr_SetString(PyExc_ValueError, "operands must have the same length");
+            return NULL;
+        }
+        n = len;
+    }
+
+    Py_buffer out_view;
+    PyObject* out_obj;
+    int real = OPS[op].real_result;
+    if (real) {
+        if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+            int_args_release(args, nargs);
+            return NULL;
+        }
+    } else if (out == Py_None) {
+        if ((out_obj = calco_new_array('q', n, &out_view)) == NULL) {
+            int_args_release(args, nargs);
+            return NULL;
+        }
+    } else {
+        if (calco_get_typed_buffer(out, &out_view, 1, "q") < 0) {
+            int_args_release(args, nargs);
+            return NULL;
+        }
+        if (out_view.len / (Py_ssize_t)sizeof(int64_t) < n) {
+            PyBuffer_Release(&out_view);
+            int_args_release(args, nargs);
+            PyErr_SetString(PyExc_ValueError, "out buffer is smaller than the input");
+            return NULL;
+        }
+        Py_INCREF(out);
+        out_obj = out;
+    }
+
+    Py_ssize_t nchunks = (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    Py_ssize_t* failures = (Py_ssize_t*)PyMem_Malloc((nchunks > 0 ? nchunks : 1) * sizeof(Py_ssize_t));
+    int* statuses = (int*)PyMem_Malloc((nchunks > 0 ? nchunks : 1) * sizeof(int));
+    if (failures == NULL || statuses == NULL) {
+        PyMem_Free(failures);
+        PyMem_Free(statuses);
+        PyBuffer_Release(&out_view);
+        int_args_release(args, nargs);
+        Py_DECREF(out_obj);
+        return PyErr_NoMemory();
+    }
+    for (Py_ssize_t c = 0; c < nchunks; c++) {
+        failures[c] = -1;
+    }
+    int_task task = {op, nargs, args, real ? NULL : (int64_t*)out_view.buf, real ? (double*)out_view.buf : NULL,
+                     n, failures, statuses};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(int_chunk, &task, nchunks);
+    Py_END_ALLOW_THREADS
+
+    for (Py_ssize_t c = 0; c < nchunks; c++) {
+        if (failures[c] < 0) {
+            continue;
+        }
+        if (statuses[c] == INT_DOMAIN) {
+            PyErr_Format(PyExc_ValueError, "%s(): invalid argument at index %zd", OPS[op].name, failures[c]);
+        } else {
+            PyErr_Format(PyExc_OverflowError, "%s(): result at index %zd does not fit in int64",
+                         OPS[op].name, failures[c]);
+        }
+        Py_CLEAR(out_obj);
+        break;
+    }
+    PyMem_Free(failures);
+    PyMem_Free(statuses);
+    PyBuffer_Release(&out_view);
+    int_args_release(args, nargs);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// Module Functions
+// -----------------------------------------------------------------------------
+
+// Converts each argument with PyNumber_Index (ints and int-likes), unless it is a buffer, and
+// runs the scalar or buffer form. Takes ownership of nothing; `args` is borrowed.
+static PyObject* int_call(int_op op, PyObject* const* args, int nargs, PyObject* out) {
+    PyObject* idx[MAX_SCALAR_ARGS] = {NULL};
+    int any_buffer = 0, all_exact = 1;
+    for (int i = 0; i < nargs; i++) {
+        int exact = PyLong_CheckExact(args[i]);
+        all_exact &= exact;
+        any_buffer |= !exact && !PyLong_Check(args[i]) && PyObject_CheckBuffer(args[i]);
+    }
+    if (any_buffer) {
+        if (nargs != OPS[op].nargs) {
+            PyErr_Format(PyExc_TypeError, "%s() takes exactly %d operands when given buffers", OPS[op].name,
+                         OPS[op].nargs);
+            return NULL;
+        }
+        return int_buffers(op, args, out);
+    }
+    if (out != Py_None) {
+        PyErr_Format(PyExc_TypeError, "%s(): out is only supported for buffer operands", OPS[op].name);
+        return NULL;
+    }
+    if (nargs > MAX_SCALAR_ARGS) {
+        return int_fallback(op, args, nargs);
+    }
+    if (all_exact) {
+        return int_scalar(op, args, nargs);
+    }
+    int n = 0;
+    PyObject* result = NULL;
+    for (; n < nargs; n++) {
+        if ((idx[n] = PyNumber_Index(args[n])) == NULL) {
+            goto done;
+        }
+    }
+    result = int_scalar(op, idx, nargs);
+done:
+    while (n > 0) {
+        Py_DECREF(idx[--n]);
+    }
+    return result;
+}
+
+// Module functions take positional operands (as math does) and a keyword-only out=.
+static int int_parse(const char* name, Py_ssize_t nargs, PyObject* kwnames, PyObject* const* args,
+                     Py_ssize_t min_args, Py_ssize_t max_args, PyObject** out) {
+    *out = Py_None;
+    Py_ssize_t nkw = (kwnames != NULL) ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i < nkw; i++) {
+        PyObject* key = PyTuple_GET_ITEM(kwnames, i);
+        if (PyUnicode_CompareWithASCIIString(key, "out") != 0) {
+            PyErr_Format(PyExc_TypeError, "%s() got an unexpected keyword argument '%U'", name, key);
+            return -1;
+        }
+        *out = args[nargs + i];
+    }
+    if (nargs < min_args || nargs > max_args) {
+        if (min_args == max_args) {
+            PyErr_Format(PyExc_TypeError, "%s() takes exactly %zd positional argument%s (%zd given)", name,
+                         min_args, (min_args == 1) ? "" : "s", nargs);
+        } else {
+            PyErr_Format(PyExc_TypeError, "%s() takes %zd to %zd positional arguments (%zd given)", name,
+                         min_args, max_args, nargs);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+#define INT_FUNC(name, op, min_args, max_args) \
+    PyObject* calco_##name(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames) { \
+        PyObject* out; \
+        if (int_parse(#name, nargs, kwnames, args, min_args, max_args, &out) < 0) { \
+            return NULL; \
+        } \
+        return int_call(op, args, (int)nargs, out); \
+    }
+
+INT_FUNC(factorial, OP_FACTORIAL, 1, 1)
+INT_FUNC(comb, OP_COMB, 2, 2)
+INT_FUNC(isqrt, OP_ISQRT, 1, 1)
+INT_FUNC(ipow, OP_IPOW, 2, 2)
+INT_FUNC(powmod, OP_POWMOD, 3, 3)
+INT_FUNC(gcd, OP_GCD, 0, INT32_MAX)
+INT_FUNC(lcm, OP_LCM, 0, INT32_MAX)
+INT_FUNC(log_factorial, OP_LOG_FACTORIAL, 1, 1)
+INT_FUNC(log_comb, OP_LOG_COMB, 2, 2)
+
+// perm(n) and perm(n, None) are n!, as for math.perm.
+PyObject* calco_perm(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames) {
+    PyObject* out;
+    if (int_parse("perm", nargs, kwnames, args, 1, 2, &out) < 0) {
+        return NULL;
+    }
+    if (nargs == 1 || args[1] == Py_None) {
+        return int_call(OP_FACTORIAL, args, 1, out);
+    }
+    return int_call(OP_PERM, args, 2, out);
+}
@@ -0,0 +1,340 @@
+// calco_kernels.c
+// Contains the element kernels behind the buffer API and helpers for acquiring typed buffers.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Unary Element Kernels
+// Each kernel matches the domain handling of its scalar wrapper exactly.
+// -----------------------------------------------------------------------------
+
+static double k_square_root(double x) { return (x < 0.0) ? NAN : sqrt(x); }
+static double k_cube_root(double x) { return cbrt(x); }
+static double k_absolute_value(double x) { return fabs(x); }
+static double k_floor_val(double x) { return floor(x); }
+static double k_ceil_val(double x) { return ceil(x); }
+static double k_round_val(double x) { return round(x); }
+static double k_nearbyint_val(double x) { return nearbyint(x); }
+static double k_truncate_val(double x) { return trunc(x); }
+static double k_natural_log(double x) { return (x <= 0.0) ? NAN : log(x); }
+static double k_log_base10(double x) { return (x <= 0.0) ? NAN : log10(x); }
+static double k_log_base2(double x) { return (x <= 0.0) ? NAN : log2(x); }
+static double k_exponential(double x) { return exp(x); }
+static double k_exponential_base2(double x) { return exp2(x); }
+static double k_exponential_minus_1(double x) { return expm1(x); }
+static double k_sine(double x) { return sin(x); }
+static double k_cosine(double x) { return cos(x); }
+static double k_tangent(double x) {
+    double t = tan(x);
+    return (fabs(t) > 1.0 / DBL_EPSILON) ? NAN : t; // |cos x| < DBL_EPSILON, without computing cos
+}
+static double k_arcsine(double x) { return (x < -1.0 || x > 1.0) ? NAN : asin(x); }
+static double k_arccosine(double x) { return (x < -1.0 || x > 1.0) ? NAN : acos(x); }
+static double k_arctangent(double x) { return atan(x); }
+static double k_hyperbolic_sine(double x) { return sinh(x); }
+static double k_hyperbolic_cosine(double x) { return cosh(x); }
+static double k_hyperbolic_tangent(double x) { return tanh(x); }
+static double k_inverse_hyperbolic_sine(double x) { return asinh(x); }
+static double k_inverse_hyperbolic_cosine(double x) { return (x < 1.0) ? NAN : acosh(x); }
+static double k_inverse_hyperbolic_tangent(double x) { return (x <= -1.0 || x >= 1.0) ? NAN : atanh(x); }
+static double k_gamma_function(double x) { return tgamma(x); }
+static double k_log_gamma_function(double x) { return lgamma(x); }
+static double k_error_function(double x) { return erf(x); }
+static double k_complementary_error_function(double x) { return erfc(x); }
+static double k_degrees_to_radians(double x) { return x * (M_PI / 180.0); }
+static double k_radians_to_degrees(double x) { return x * (180.0 / M_PI); }
+
+static const calco_unary_entry unary_table[] = {
+    {"square_root", calco_square_root, k_square_root},
+    {"cube_root", calco_cube_root, k_cube_root},
+    {"absolute_value", calco_absolute_value, k_absolute_value},
+    {"floor_val", calco_floor_val, k_floor_val},
+    {"ceil_val", calco_ceil_val, k_ceil_val},
+    {"round_val", calco_round_val, k_round_val},
+    {"nearbyint_val", calco_nearbyint_val, k_nearbyint_val},
+    {"truncate_val", calco_truncate_val, k_truncate_val},
+    {"natural_log", calco_natural_log, k_natural_log},
+    {"log_base10", calco_log_base10, k_log_base10},
+    {"log_base2", calco_log_base2, k_log_base2},
+    {"exponential", calco_exponential, k_exponential},
+    {"exponential_base2", calco_exponential_base2, k_exponential_base2},
+    {"exponential_minus_1", calco_exponential_minus_1, k_exponential_minus_1},
+    {"sine", calco_sine, k_sine, calco_sine_block},
+    {"cosine", calco_cosine, k_cosine, calco_cosine_block},
+    {"tangent", calco_tangent, k_tangent, calco_tangent_block},
+    {"arcsine", calco_arcsine, k_arcsine},
+    {"arccosine", calco_arccosine, k_arccosine},
+    {"arctangent", calco_arctangent, k_arctangent},
+    {"hyperbolic_sine", calco_hyperbolic_sine, k_hyperbolic_sine},
+    {"hyperbolic_cosine", calco_hyperbolic_cosine, k_hyperbolic_cosine},
+    {"hyperbolic_tangent", calco_hyperbolic_tangent, k_hyperbolic_tangent},
+    {"inverse_hyperbolic_sine", calco_inverse_hyperbolic_sine, k_inverse_hyperbolic_sine},
+    {"inverse_hyperbolic_cosine", calco_inverse_hyperbolic_cosine, k_inverse_hyperbolic_cosine},
+    {"inverse_hyperbolic_tangent", calco_inverse_hyperbolic_tangent, k_inverse_hyperbolic_tangent},
+    {"gamma_function", calco_gamma_function, k_gamma_function},
+    {"log_gamma_function", calco_log_gamma_function, k_log_gamma_function},
+    {"error_function", calco_error_function, k_error_function},
+    {"complementary_error_function", calco_complementary_error_function, k_complementary_error_function},
+    {"degrees_to_radians", calco_degrees_to_radians, k_degrees_to_radians},
+    {"radians_to_degrees", calco_radians_to_degrees, k_radians_to_degrees},
+    {"sind", (PyCFunction)(void (*)(void))calco_sind, calco_sind_kernel, calco_sind_block},
+    {"cosd", (PyCFunction)(void (*)(void))calco_cosd, calco_cosd_kernel, calco_cosd_block},
+    {"tand", (PyCFunction)(void (*)(void))calco_tand, calco_tand_kernel, calco_tand_block},
+    {"asind", (PyCFunction)(void (*)(void))calco_asind, calco_asind_kernel, calco_asind_block},
+    {"acosd", (PyCFunction)(void (*)(void))calco_acosd, calco_acosd_kernel, calco_acosd_block},
+    {"log1p", (PyCFunction)(void (*)(void))calco_log1p, calco_log1p_kernel, calco_log1p_block},
+    {"sigmoid", (PyCFunction)(void (*)(void))calco_sigmoid, calco_sigmoid_kernel, calco_sigmoid_block},
+    {"logit", (PyCFunction)(void (*)(void))calco_logit, calco_logit_kernel, calco_logit_block},
+    {"softplus", (PyCFunction)(void (*)(void))calco_softplus, calco_softplus_kernel, calco_softplus_block},
+    {"gelu", (PyCFunction)(void (*)(void))calco_gelu, calco_gelu_kernel, calco_gelu_block},
+    {"silu", (PyCFunction)(void (*)(void))calco_silu, calco_silu_kernel, calco_silu_block},
+    {NULL, NULL, NULL, NULL}
+};
+
+// Resolves a calco function object (e.g. calco.sine) or its name to a unary kernel.
+// Sets TypeError and returns NULL if the function has no element kernel.
+const calco_unary_entry* calco_lookup_unary(PyObject* func) {
+    const calco_unary_entry* e;
+    if (PyUnicode_Check(func)) {
+        const char* name = PyUnicode_AsUTF8(func);
+        if (name == NULL) {
+            return NULL;
+        }
+        for (e = unary_table; e->name != NULL; e++) {
+            if (strcmp(e->name, name) == 0) {
+                return e;
+            }
+        }
+    } else if (PyCFunction_Check(func)) {
+        PyCFunction meth = PyCFunction_GetFunction(func);
+        for (e = unary_table; e->name != NULL; e++) {
+            if (e->scalar == meth) {
+                return e;
+            }
+        }
+        // Batch functions are registered through their workspace= shims: match those by name.
+        PyObject* owner = PyCFunction_GetSelf(func);
+        const char* owner_name = (owner != NULL && PyModule_Check(owner)) ? PyModule_GetName(owner) : NULL;
+        if (owner_name != NULL && strcmp(owner_name, "calco") == 0) {
+            const char* name = ((PyCFunctionObject*)func)->m_ml->ml_name;
+            for (e = unary_table; e->name != NULL; e++) {
+                if (strcmp(e->name, name) == 0) {
+                    return e;
+                }
+            }
+        }
+        PyErr_Clear();
+    }
+    PyErr_Format(PyExc_TypeError, "%R is not a unary calco function", func);
+    return NULL;
+}
+
+// Returns the element kernel registered under `name`, or NULL. Does not set an exception.
+calco_unary_fn calco_unary_kernel(const char* name) {
+    for (const calco_unary_entry* e = unary_table; e->name != NULL; e++) {
+        if (strcmp(e->name, name) == 0) {
+            return e->kernel;
+        }
+    }
+    return NULL;
+}
+
+// Returns entry `id` of the unary table, or NULL past its end. Ids are stable within a build, so
+// processes running the same extension can name kernels by id.
+const calco_unary_entry* calco_unary_entry_at(Py_ssize_t id) {
+    static Py_ssize_t count = -1;
+    if (count < 0) {
+        for (count = 0; unary_table[count].name != NULL; count++) {
+        }
+    }
+    return (id >= 0 && id < count) ? &unary_table[id] : NULL;
+}
+
+void calco_unary_chunk(void* ctx, Py_ssize_t chunk) {
+    const calco_unary_task* t = (const calco_unary_task*)ctx;
+    Py_ssize_t start = chunk * t->chunk_size;
+    Py_ssize_t end = start + t->chunk_size;
+    if (end > t->n) {
+        end = t->n;
+    }
+    if (t->block != NULL) {
+        t->block(t->in + start, t->out + start, end - start);
+        return;
+    }
+    calco_unary_fn f = t->kernel;
+    for (Py_ssize_t i = start; i < end; i++) {
+        t->out[i] = f(t->in[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Buffer Helpers
+// -----------------------------------------------------------------------------
+
+// Returns the canonical struct format of a buffer's elements: 'd'/'f' for floats and
+// 'b'/'h'/'i'/'q' (signed) or 'B'/'H'/'I'/'Q' (unsigned) by item size for integers, so that
+// e.g. 'l' and 'q' compare equal on LP64 platforms. Returns 0 for anything else.
+char calco_buffer_format(const Py_buffer* view) {
+    const char* fmt = view->format;
+    if (fmt == NULL) {
+        fmt = "B";
+    }
+    if (fmt[0] == '<' || fmt[0] == '=' || fmt[0] == '@') {
+        fmt++;
+    }
+    if (fmt[0] == 0 || fmt[1] != 0) {
+        return 0;
+    }
+    static const char sized_signed[] = {0, 'b', 'h', 0, 'i', 0, 0, 0, 'q'};
+    static const char sized_unsigned[] = {0, 'B', 'H', 0, 'I', 0, 0, 0, 'Q'};
+    switch (fmt[0]) {
+    case 'd':
+        return (view->itemsize == 8) ? 'd' : 0;
+    case 'f':
+        return (view->itemsize == 4) ? 'f' : 0;
+    case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+        return (view->itemsize <= 8) ? sized_signed[view->itemsize] : 0;
+    case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N':
+        return (view->itemsize <= 8) ? sized_unsigned[view->itemsize] : 0;
+    default:
+        return 0;
+    }
+}
+
+// Acquires a C-contiguous buffer whose elements have one of the canonical formats listed in
+// `accepted` (see calco_buffer_format). Returns the format, or -1 with an exception set.
+int calco_get_typed_buffer(PyObject* obj, Py_buffer* view, int writable, const char* accepted) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj, view, flags) < 0) {
+        return -1;
+    }
+    char fmt = calco_buffer_format(view);
+    if (fmt == 0 || strchr(accepted, fmt) == NULL) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_TypeError, "expected a contiguous buffer with element format in '%s'", accepted);
+        return -1;
+    }
+    return fmt;
+}
+
+// Acquires a C-contiguous float64 buffer. Returns 0 on success, -1 with an exception set.
+int calco_get_double_buffer(PyObject* obj, Py_buffer* view, int writable) {
+    return (calco_get_typed_buffer(obj, view, writable, "d") < 0) ? -1 : 0;
+}
+
+Py_ssize_t calco_itemsize(char typecode) {
+    switch (typecode) {
+    case 'b': case 'B': return 1;
+    case 'h': case 'H': return 2;
+    case 'i': case 'I': case 'f': return 4;
+    default: return 8;
+    }
+}
+
+// Creates a result buffer of the given typecode and length n and acquires a writable view of it:
+// an array.array, or a memoryview into the current calco.Workspace during a workspace= call.
+PyObject* calco_new_array(char typecode, Py_ssize_t n, Py_buffer* view) {
+    PyObject* ws = calco_workspace_current();
+    if (ws != NULL) {
+        return calco_workspace_array(ws, typecode, n, view);
+    }
+    return calco_new_plain_array(typecode, n, view);
+}
+
+// Creates an array.array of the given typecode and length n and acquires a writable view of it.
+// Used directly for arrays handed to Python callbacks, which never come from a workspace.
+PyObject* calco_new_plain_array(char typecode, Py_ssize_t n, Py_buffer* view) {
+    PyObject* array_mod = PyImport_ImportModule("array");
+    if (array_mod == NULL) {
+        return NULL;
+    }
+    PyObject* arr = PyObject_CallMethod(array_mod, "array", "C", typecode);
+    Py_DECREF(array_mod);
+    if (arr == NULL) {
+        return NULL;
+    }
+    PyObject* raw = PyBytes_FromStringAndSize(NULL, n * calco_itemsize(typecode));
+    if (raw == NULL) {
+        Py_DECREF(arr);
+        return NULL;
+    }
+    PyObject* r = PyObject_CallMethod(arr, "frombytes", "O", raw);
+    Py_DECREF(raw);
+    if (r == NULL) {
+        Py_DECREF(arr);
+        return NULL;
+    }
+    Py_DECREF(r);
+    if (PyObject_GetBuffer(arr, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) < 0) {
+        Py_DECREF(arr);
+        return NULL;
+    }
+    return arr;
+}
+
+// Creates an array.array('d') of length n and acquires a writable view of it.
+PyObject* calco_new_double_array(Py_ssize_t n, Py_buffer* view) {
+    return calco_new_array('d', n, view);
+}
+
+// Copies a float64 buffer or a sequence of numbers into a new PyMem array of *n doubles.
+// Returns NULL with an exception set on failure.
+double* calco_read_doubles(PyObject* obj, Py_ssize_t* n) {
+    Py_buffer view;
+    double* out;
+    if (PyObject_CheckBuffer(obj)) {
+        if (calco_get_double_buffer(obj, &view, 0) < 0) {
+            return NULL;
+        }
+        *n = view.len / (Py_ssize_t)sizeof(double);
+        out = (double*)PyMem_Malloc((*n > 0 ? *n : 1) * sizeof(double));
+        if (out != NULL) {
+            memcpy(out, view.buf, *n * sizeof(double));
+        }
+        PyBuffer_Release(&view);
+        return (out == NULL) ? (double*)PyErr_NoMemory() : out;
+    }
+    PyObject* seq = PySequence_Fast(obj, "expected a float64 buffer or a sequence of numbers");
+    if (seq == NULL) {
+        return NULL;
+    }
+    *n = PySequence_Fast_GET_SIZE(seq);
+    out = (double*)PyMem_Malloc((*n > 0 ? *n : 1) * sizeof(double));
+    if (out == NULL) {
+        Py_DECREF(seq);
+        return (double*)PyErr_NoMemory();
+    }
+    for (Py_ssize_t i = 0; i < *n; i++) {
+        out[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, i));
+        if (out[i] == -1.0 && PyErr_Occurred()) {
+            PyMem_Free(out);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    return out;
+}
+
+// Acquires the destination of a buffer operation: the caller's `out` (which must hold at
+// least n doubles) or, if out is NULL/None, a freshly allocated array. *out_obj receives a
+// new reference to the object that will be returned to Python.
+int calco_get_out_buffer(PyObject* out, Py_ssize_t n, Py_buffer* view, PyObject** out_obj) {
+    if (out == NULL || out == Py_None) {
+        *out_obj = calco_new_double_array(n, view);
+        return (*out_obj == NULL) ? -1 : 0;
+    }
+    if (calco_get_double_buffer(out, view, 1) < 0) {
+        return -1;
+    }
+    if (view->len / (Py_ssize_t)sizeof(double) < n) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_ValueError, "out buffer is smaller than the input");
+        return -1;
+    }
+    Py_INCREF(out);
+    *out_obj = out;
+    return 0;
+}
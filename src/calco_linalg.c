@@ -0,0 +1,795 @@
+// calco_linalg.c
+// Contains batched linear algebra for many independent 2x2, 3x3 and 4x4 systems: determinant,
+// inverse, solve with partial pivoting, matrix products and the symmetric 3x3 eigenproblem.
+//
+// Matrices are packed SoA ("plane-major"): a batch of m matrices of size n x n is one float64
+// buffer of n * n * m values in which element (r, c) of matrix i sits at a[(r * n + c) * m + i],
+// and a batch of vectors stores component r of vector i at v[r * m + i].
+//
+// Kernels work on blocks of LA_BLOCK matrices gathered into local planes, and every statement is
+// a loop over the block, so the arithmetic of one matrix element runs for a whole vector of
+// matrices at once. Each kernel is written over the size n and instantiated for n = 2, 3 and 4.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <string.h>
+
+#define LA_CHUNK 4096 // Matrices per pool task
+#define LA_BLOCK 128  // Matrices per block of local planes
+#define LA_MAX 4
+
+// -----------------------------------------------------------------------------
+// Batch Driver
+// -----------------------------------------------------------------------------
+
+typedef enum { LA_DET, LA_INV, LA_SOLVE, LA_MATMUL, LA_MATVEC, LA_EIGH_JACOBI, LA_EIGH_ANALYTIC } la_op;
+
+typedef struct {
+    la_op op;
+    int n;
+    Py_ssize_t m;              // Batch size (plane stride)
+    const double* a;
+    const double* b;
+    double* out;
+    double* out2;              // Eigenvectors
+    unsigned char* flags;      // Solve: 1 where the system is singular or ill-conditioned
+    double rcond;
+} la_task;
+
+typedef double la_plane[LA_BLOCK];
+
+// Copies planes [0, count) of matrices [lo, lo + len) into local planes, and back.
+static inline void la_gather(const double* src, Py_ssize_t m, int count, Py_ssize_t lo, Py_ssize_t len,
+                             la_plane* dst) {
+    for (int p = 0; p < count; p++) {
+        memcpy(dst[p], src + p * m + lo, len * sizeof(double));
+    }
+}
+
+static inline void la_scatter(la_plane* src, int count, Py_ssize_t lo, Py_ssize_t len, double* dst, Py_ssize_t m) {
+    for (int p = 0; p < count; p++) {
+        memcpy(dst + p * m + lo, src[p], len * sizeof(double));
+    }
+}
+
+// Element (r, c) of matrix i of the block held in planes A.
+#define M(A, r, c) ((A)[(r) * n + (c)][i])
+
+// -----------------------------------------------------------------------------
+// Determinant and Inverse
+// Closed forms by cofactors (2x2 minors for n = 4), as in graphics libraries. The inverse is the
+// adjugate over the determinant and has no pivoting; batch_solve is the stable route and also
+// reports ill-conditioned systems.
+// -----------------------------------------------------------------------------
+
+static inline void la_det_block(la_plane* A, double* out, Py_ssize_t len, const int n) {
+    Py_ssize_t i;
+    if (n == 2) {
+        for (i = 0; i < len; i++) {
+            out[i] = M(A, 0, 0) * M(A, 1, 1) - M(A, 0, 1) * M(A, 1, 0);
+        }
+    } else if (n == 3) {
+        for (i = 0; i < len; i++) {
+            out[i] = M(A, 0, 0) * (M(A, 1, 1) * M(A, 2, 2) - M(A, 1, 2) * M(A, 2, 1)) -
+                     M(A, 0, 1) * (M(A, 1, 0) * M(A, 2, 2) - M(A, 1, 2) * M(A, 2, 0)) +
+                     M(A, 0, 2) * (M(A, 1, 0) * M(A, 2, 1) - M(A, 1, 1) * M(A, 2, 0));
+        }
+    } else {
+        for (i = 0; i < len; i++) {
+            double s0 = M(A, 0, 0) * M(A, 1, 1) - M(A, 1, 0) * M(A, 0, 1);
+            double s1 = M(A, 0, 0) * M(A, 1, 2) - M(A, 1, 0) * M(A, 0, 2);
+            double s2 = M(A, 0, 0) * M(A, 1, 3) - M(A, 1, 0) * M(A, 0, 3);
+            double s3 = M(A, 0, 1) * M(A, 1, 2) - M(A, 1, 1) * M(A, 0, 2);
+            double s4 = M(A, 0, 1) * M(A, 1, 3) - M(A, 1, 1) * M(A, 0, 3);
+            double s5 = M(A, 0, 2) * M(A, 1, 3) - M(A, 1, 2) * M(A, 0, 3);
+            double c5 = M(A, 2, 2) * M(A, 3, 3) - M(A, 3, 2) * M(A, 2, 3);
+            double c4 = M(A, 2, 1) * M(A, 3, 3) - M(A, 3, 1) * M(A, 2, 3);
+            double c3 = M(A, 2, 1) * M(A, 3, 2) - M(A, 3, 1) * M(A, 2, 2);
+            double c2 = M(A, 2, 0) * M(A, 3, 3) - M(A, 3, 0) * M(A, 2, 3);
+            double c1 = M(A, 2, 0) * M(A, 3, 2) - M(A, 3, 0) * M(A, 2, 2);
+            double c0 = M(A, 2, 0) * M(A, 3, 1) - M(A, 3, 0) * M(A, 2, 1);
+            out[i] = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+    }
+}
+
+static inline void la_det_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi, const int n) {
+    la_plane A[LA_MAX * LA_MAX];
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        la_gather(t->a, t->m, n * n, b, len, A);
+        la_det_block(A, t->out + b, len, n);
+    }
+}
+
+// B = adj(A) / det(A), plane by plane.
+static inline void la_inv_block(la_plane* A, la_plane* B, Py_ssize_t len, const int n) {
+    Py_ssize_t i;
+    int p;
+    if (n == 2) {
+        for (i = 0; i < len; i++) {
+            M(B, 0, 0) = M(A, 1, 1);
+            M(B, 0, 1) = -M(A, 0, 1);
+            M(B, 1, 0) = -M(A, 1, 0);
+            M(B, 1, 1) = M(A, 0, 0);
+        }
+    } else if (n == 3) {
+        for (i = 0; i < len; i++) {
+            M(B, 0, 0) = M(A, 1, 1) * M(A, 2, 2) - M(A, 1, 2) * M(A, 2, 1);
+            M(B, 0, 1) = M(A, 0, 2) * M(A, 2, 1) - M(A, 0, 1) * M(A, 2, 2);
+            M(B, 0, 2) = M(A, 0, 1) * M(A, 1, 2) - M(A, 0, 2) * M(A, 1, 1);
+            M(B, 1, 0) = M(A, 1, 2) * M(A, 2, 0) - M(A, 1, 0) * M(A, 2, 2);
+            M(B, 1, 1) = M(A, 0, 0) * M(A, 2, 2) - M(A, 0, 2) * M(A, 2, 0);
+            M(B, 1, 2) = M(A, 0, 2) * M(A, 1, 0) - M(A, 0, 0) * M(A, 1, 2);
+            M(B, 2, 0) = M(A, 1, 0) * M(A, 2, 1) - M(A, 1, 1) * M(A, 2, 0);
+            M(B, 2, 1) = M(A, 0, 1) * M(A, 2, 0) - M(A, 0, 0) * M(A, 2, 1);
+            M(B, 2, 2) = M(A, 0, 0) * M(A, 1, 1) - M(A, 0, 1) * M(A, 1, 0);
+        }
+    } else {
+        for (i = 0; i < len; i++) {
+            double s0 = M(A, 0, 0) * M(A, 1, 1) - M(A, 1, 0) * M(A, 0, 1);
+            double s1 = M(A, 0, 0) * M(A, 1, 2) - M(A, 1, 0) * M(A, 0, 2);
+            double s2 = M(A, 0, 0) * M(A, 1, 3) - M(A, 1, 0) * M(A, 0, 3);
+            double s3 = M(A, 0, 1) * M(A, 1, 2) - M(A, 1, 1) * M(A, 0, 2);
+            double s4 = M(A, 0, 1) * M(A, 1, 3) - M(A, 1, 1) * M(A, 0, 3);
+            double s5 = M(A, 0, 2) * M(A, 1, 3) - M(A, 1, 2) * M(A, 0, 3);
+            double c5 = M(A, 2, 2) * M(A, 3, 3) - M(A, 3, 2) * M(A, 2, 3);
+            double c4 = M(A, 2, 1) * M(A, 3, 3) - M(A, 3, 1) * M(A, 2, 3);
+            double c3 = M(A, 2, 1) * M(A, 3, 2) - M(A, 3, 1) * M(A, 2, 2);
+            double c2 = M(A, 2, 0) * M(A, 3, 3) - M(A, 3, 0) * M(A, 2, 3);
+            double c1 = M(A, 2, 0) * M(A, 3, 2) - M(A, 3, 0) * M(A, 2, 2);
+            double c0 = M(A, 2, 0) * M(A, 3, 1) - M(A, 3, 0) * M(A, 2, 1);
+            M(B, 0, 0) = M(A, 1, 1) * c5 - M(A, 1, 2) * c4 + M(A, 1, 3) * c3;
+            M(B, 0, 1) = -M(A, 0, 1) * c5 + M(A, 0, 2) * c4 - M(A, 0, 3) * c3;
+            M(B, 0, 2) = M(A, 3, 1) * s5 - M(A, 3, 2) * s4 + M(A, 3, 3) * s3;
+            M(B, 0, 3) = -M(A, 2, 1) * s5 + M(A, 2, 2) * s4 - M(A, 2, 3) * s3;
+            M(B, 1, 0) = -M(A, 1, 0) * c5 + M(A, 1, 2) * c2 - M(A, 1, 3) * c1;
+            M(B, 1, 1) = M(A, 0, 0) * c5 - M(A, 0, 2) * c2 + M(A, 0, 3) * c1;
+            M(B, 1, 2) = -M(A, 3, 0) * s5 + M(A, 3, 2) * s2 - M(A, 3, 3) * s1;
+            M(B, 1, 3) = M(A, 2, 0) * s5 - M(A, 2, 2) * s2 + M(A, 2, 3) * s1;
+            M(B, 2, 0) = M(A, 1, 0) * c4 - M(A, 1, 1) * c2 + M(A, 1, 3) * c0;
+            M(B, 2, 1) = -M(A, 0, 0) * c4 + M(A, 0, 1) * c2 - M(A, 0, 3) * c0;
+            M(B, 2, 2) = M(A, 3, 0) * s4 - M(A, 3, 1) * s2 + M(A, 3, 3) * s0;
+            M(B, 2, 3) = -M(A, 2, 0) * s4 + M(A, 2, 1) * s2 - M(A, 2, 3) * s0;
+            M(B, 3, 0) = -M(A, 1, 0) * c3 + M(A, 1, 1) * c1 - M(A, 1, 2) * c0;
+            M(B, 3, 1) = M(A, 0, 0) * c3 - M(A, 0, 1) * c1 + M(A, 0, 2) * c0;
+            M(B, 3, 2) = -M(A, 3, 0) * s3 + M(A, 3, 1) * s1 - M(A, 3, 2) * s0;
+            M(B, 3, 3) = M(A, 2, 0) * s3 - M(A, 2, 1) * s1 + M(A, 2, 2) * s0;
+        }
+    }
+    // The first row of the adjugate against the first column of A is the determinant.
+    double inv[LA_BLOCK];
+    for (i = 0; i < len; i++) {
+        inv[i] = M(B, 0, 0) * M(A, 0, 0);
+    }
+    for (p = 1; p < n; p++) {
+        for (i = 0; i < len; i++) {
+            inv[i] += M(B, 0, p) * M(A, p, 0);
+        }
+    }
+    for (i = 0; i < len; i++) {
+        inv[i] = 1.0 / inv[i];
+    }
+    for (p = 0; p < n * n; p++) {
+        for (i = 0; i < len; i++) {
+            B[p][i] *= inv[i];
+        }
+    }
+}
+
+static inline void la_inv_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi, const int n) {
+    la_plane A[LA_MAX * LA_MAX], B[LA_MAX * LA_MAX];
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        la_gather(t->a, t->m, n * n, b, len, A);
+        la_inv_block(A, B, len, n);
+        la_scatter(B, n * n, b, len, t->out, t->m);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Solve
+// Gaussian elimination with partial pivoting on the augmented matrix [A | b]. Pivot rows are
+// chosen by compare-and-swap with selects rather than a pivot index, so every matrix in the
+// block runs the same instruction stream. The conditioning test compares the smallest pivot with
+// the largest entry of A: a ratio below rcond (or a non-finite one) flags the system as singular
+// or ill-conditioned.
+// -----------------------------------------------------------------------------
+
+#define W(r, c) (aug[(r) * (LA_MAX + 1) + (c)])
+
+static inline void la_solve_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi, const int n) {
+    la_plane aug[LA_MAX * (LA_MAX + 1)];
+    double amax[LA_BLOCK], pmin[LA_BLOCK], f[LA_BLOCK];
+    Py_ssize_t m = t->m, i;
+    int r, c, j;
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        for (r = 0; r < n; r++) {
+            la_gather(t->a + r * n * m, m, n, b, len, &W(r, 0));
+            memcpy(W(r, n), t->b + r * m + b, len * sizeof(double));
+        }
+        for (i = 0; i < len; i++) {
+            amax[i] = 0.0;
+        }
+        for (r = 0; r < n; r++) {
+            for (c = 0; c < n; c++) {
+                double* e = W(r, c);
+                for (i = 0; i < len; i++) {
+                    amax[i] = (fabs(e[i]) > amax[i]) ? fabs(e[i]) : amax[i];
+                }
+            }
+        }
+        for (i = 0; i < len; i++) {
+            pmin[i] = amax[i];
+        }
+        for (c = 0; c < n; c++) {
+            for (r = c + 1; r < n; r++) {
+                double *pc = W(c, c), *pr = W(r, c);
+                for (j = n; j >= c; j--) { // The pivot column last, so the test reads it unswapped
+                    double *u = W(c, j), *v = W(r, j);
+                    for (i = 0; i < len; i++) {
+                        int swap = fabs(pr[i]) > fabs(pc[i]);
+                        double x = u[i], y = v[i];
+                        u[i] = swap ? y : x;
+                        v[i] = swap ? x : y;
+                    }
+                }
+            }
+            double* piv = W(c, c);
+            for (i = 0; i < len; i++) {
+                pmin[i] = (fabs(piv[i]) < pmin[i]) ? fabs(piv[i]) : pmin[i];
+            }
+            for (r = c + 1; r < n; r++) {
+                double* e = W(r, c);
+                for (i = 0; i < len; i++) {
+                    f[i] = e[i] / piv[i];
+                }
+                for (j = c + 1; j <= n; j++) {
+                    double *u = W(c, j), *v = W(r, j);
+                    for (i = 0; i < len; i++) {
+                        v[i] -= f[i] * u[i];
+                    }
+                }
+            }
+        }
+        // Back substitution leaves x in the last column.
+        for (r = n - 1; r >= 0; r--) {
+            double *x = W(r, n), *d = W(r, r);
+            for (j = r + 1; j < n; j++) {
+                double *e = W(r, j), *xj = W(j, n);
+                for (i = 0; i < len; i++) {
+                    x[i] -= e[i] * xj[i];
+                }
+            }
+            for (i = 0; i < len; i++) {
+                x[i] /= d[i];
+            }
+            memcpy(t->out + r * m + b, x, len * sizeof(double));
+        }
+        for (i = 0; i < len; i++) {
+            t->flags[b + i] = !(pmin[i] > t->rcond * amax[i]);
+        }
+    }
+}
+
+#undef W
+
+// -----------------------------------------------------------------------------
+// Products
+// -----------------------------------------------------------------------------
+
+static inline void la_matmul_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi, const int n) {
+    la_plane A[LA_MAX * LA_MAX], B[LA_MAX * LA_MAX], C[LA_MAX * LA_MAX];
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        la_gather(t->a, t->m, n * n, b, len, A);
+        la_gather(t->b, t->m, n * n, b, len, B);
+        for (int r = 0; r < n; r++) {
+            for (int c = 0; c < n; c++) {
+                Py_ssize_t i;
+                for (i = 0; i < len; i++) {
+                    M(C, r, c) = M(A, r, 0) * M(B, 0, c);
+                }
+                for (int k = 1; k < n; k++) {
+                    for (i = 0; i < len; i++) {
+                        M(C, r, c) += M(A, r, k) * M(B, k, c);
+                    }
+                }
+            }
+        }
+        la_scatter(C, n * n, b, len, t->out, t->m);
+    }
+}
+
+static inline void la_matvec_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi, const int n) {
+    la_plane A[LA_MAX * LA_MAX], v[LA_MAX], y[LA_MAX];
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        la_gather(t->a, t->m, n * n, b, len, A);
+        la_gather(t->b, t->m, n, b, len, v);
+        for (int r = 0; r < n; r++) {
+            Py_ssize_t i;
+            for (i = 0; i < len; i++) {
+                y[r][i] = M(A, r, 0) * v[0][i];
+            }
+            for (int k = 1; k < n; k++) {
+                for (i = 0; i < len; i++) {
+                    y[r][i] += M(A, r, k) * v[k][i];
+                }
+            }
+        }
+        la_scatter(y, n, b, len, t->out, t->m);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Symmetric 3x3 Eigen Decomposition
+// Only the upper triangle is read. Eigenvalues come out ascending in three planes, and the
+// eigenvectors as the columns of a 3x3 batch (component r of vector c at plane r * 3 + c).
+//
+// 'jacobi' runs a fixed number of cyclic Jacobi sweeps; a fixed count (instead of a convergence
+// test) keeps the block in lockstep, and JACOBI_SWEEPS reaches full double precision for any
+// input. 'analytic' takes the eigenvalues from the trigonometric closed form and the eigenvectors
+// from cross products; it is several times cheaper but loses accuracy on nearly equal
+// eigenvalues and on eigenvalues small next to the largest.
+// -----------------------------------------------------------------------------
+
+#define JACOBI_SWEEPS 6
+
+// One rotation in the (p, q) plane over the block: A = J^T A J and V = V J, with J chosen to
+// zero A[p][q]. t = tan(theta) is the smaller root of t^2 + 2 t cot(2 theta) - 1 = 0, written
+// without dividing by A[p][q]; a zero A[p][q] gives the identity.
+static void jacobi_rotate(la_plane* A, la_plane* V, Py_ssize_t len, const int p, const int q) {
+    const int n = 3;
+    double cs[LA_BLOCK], sn[LA_BLOCK];
+    Py_ssize_t i;
+    for (i = 0; i < len; i++) {
+        double apq = M(A, p, q), d = M(A, q, q) - M(A, p, p);
+        double den = fabs(d) + sqrt(d * d + 4.0 * apq * apq);
+        double safe = (den > 0.0) ? den : 1.0;
+        double tn = (den > 0.0) ? copysign(2.0, d) * apq / safe : 0.0;
+        cs[i] = 1.0 / sqrt(1.0 + tn * tn);
+        sn[i] = tn * cs[i];
+    }
+    for (int r = 0; r < 3; r++) {
+        double *arp = A[r * 3 + p], *arq = A[r * 3 + q], *vrp = V[r * 3 + p], *vrq = V[r * 3 + q];
+        for (i = 0; i < len; i++) {
+            double x = arp[i], y = arq[i];
+            arp[i] = cs[i] * x - sn[i] * y;
+            arq[i] = sn[i] * x + cs[i] * y;
+            x = vrp[i];
+            y = vrq[i];
+            vrp[i] = cs[i] * x - sn[i] * y;
+            vrq[i] = sn[i] * x + cs[i] * y;
+        }
+    }
+    for (int r = 0; r < 3; r++) {
+        double *apr = A[p * 3 + r], *aqr = A[q * 3 + r];
+        for (i = 0; i < len; i++) {
+            double x = apr[i], y = aqr[i];
+            apr[i] = cs[i] * x - sn[i] * y;
+            aqr[i] = sn[i] * x + cs[i] * y;
+        }
+    }
+}
+
+// Orders (w, columns of V) ascending by w with compare-and-swap.
+static void eig_sort_swap(la_plane* w, la_plane* V, Py_ssize_t len, const int p, const int q) {
+    Py_ssize_t i;
+    for (int r = 0; r < 3; r++) {
+        double *vp = V[r * 3 + p], *vq = V[r * 3 + q];
+        for (i = 0; i < len; i++) {
+            double x = vp[i], y = vq[i];
+            vp[i] = (w[q][i] < w[p][i]) ? y : x;
+            vq[i] = (w[q][i] < w[p][i]) ? x : y;
+        }
+    }
+    for (i = 0; i < len; i++) {
+        double x = w[p][i], y = w[q][i];
+        w[p][i] = (y < x) ? y : x;
+        w[q][i] = (y < x) ? x : y;
+    }
+}
+
+static void eigh_jacobi(la_plane* A, la_plane* w, la_plane* V, Py_ssize_t len) {
+    for (int p = 0; p < 9; p++) {
+        for (Py_ssize_t i = 0; i < len; i++) {
+            V[p][i] = (p % 4 == 0) ? 1.0 : 0.0;
+        }
+    }
+    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+        jacobi_rotate(A, V, len, 0, 1);
+        jacobi_rotate(A, V, len, 0, 2);
+        jacobi_rotate(A, V, len, 1, 2);
+    }
+    for (int k = 0; k < 3; k++) {
+        memcpy(w[k], A[k * 4], len * sizeof(double));
+    }
+    eig_sort_swap(w, V, len, 0, 1);
+    eig_sort_swap(w, V, len, 1, 2);
+    eig_sort_swap(w, V, len, 0, 1);
+}
+
+#define CROSS(o, a, b)                                  \
+    do {                                                \
+        (o)[0] = (a)[1] * (b)[2] - (a)[2] * (b)[1];     \
+        (o)[1] = (a)[2] * (b)[0] - (a)[0] * (b)[2];     \
+        (o)[2] = (a)[0] * (b)[1] - (a)[1] * (b)[0];     \
+    } while (0)
+
+#define NORM2(v) ((v)[0] * (v)[0] + (v)[1] * (v)[1] + (v)[2] * (v)[2])
+
+// Writes the longest of c0, c1, c2 normalized to out, or fallback when all three vanish. The
+// selects repeat their comparisons instead of keeping int flags, which would mix lane widths and
+// stop the loop from vectorizing.
+#define PICK_LONGEST(out, c0, c1, c2, fallback)                                                   \
+    do {                                                                                          \
+        double n0_ = NORM2(c0), n1_ = NORM2(c1), n2_ = NORM2(c2);                                 \
+        double b01_ = (n1_ > n0_) ? n1_ : n0_;                                                    \
+        double best_ = (n2_ > b01_) ? n2_ : b01_;                                                 \
+        double scale_ = 1.0 / sqrt((best_ > 0.0) ? best_ : 1.0);                                  \
+        (out)[0] = (best_ > 0.0) ? scale_ * ((n2_ > b01_) ? (c2)[0] : (n1_ > n0_) ? (c1)[0] : (c0)[0])   \
+                                 : (fallback)[0];                                                 \
+        (out)[1] = (best_ > 0.0) ? scale_ * ((n2_ > b01_) ? (c2)[1] : (n1_ > n0_) ? (c1)[1] : (c0)[1])   \
+                                 : (fallback)[1];                                                 \
+        (out)[2] = (best_ > 0.0) ? scale_ * ((n2_ > b01_) ? (c2)[2] : (n1_ > n0_) ? (c1)[2] : (c0)[2])   \
+                                 : (fallback)[2];                                                 \
+    } while (0)
+
+static void eigh_analytic(la_plane* A, la_plane* w, la_plane* V, Py_ssize_t len) {
+    const int n = 3;
+    const double third_turn = 2.0943951023931954923; // 2 pi / 3
+    for (Py_ssize_t i = 0; i < len; i++) {
+        // Scaling by the largest entry keeps the squares and cross products below in range.
+        double a00 = M(A, 0, 0), a01 = M(A, 0, 1), a02 = M(A, 0, 2);
+        double a11 = M(A, 1, 1), a12 = M(A, 1, 2), a22 = M(A, 2, 2);
+        double big = fabs(a00);
+        big = (fabs(a01) > big) ? fabs(a01) : big;
+        big = (fabs(a02) > big) ? fabs(a02) : big;
+        big = (fabs(a11) > big) ? fabs(a11) : big;
+        big = (fabs(a12) > big) ? fabs(a12) : big;
+        big = (fabs(a22) > big) ? fabs(a22) : big;
+        big = (big > 1e-300) ? big : 1e-300;
+        double inv_big = 1.0 / big;
+        a00 *= inv_big;
+        a01 *= inv_big;
+        a02 *= inv_big;
+        a11 *= inv_big;
+        a12 *= inv_big;
+        a22 *= inv_big;
+        double p1 = a01 * a01 + a02 * a02 + a12 * a12;
+        double q = (a00 + a11 + a22) * (1.0 / 3.0);
+        double b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+        double p = sqrt((b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * p1) * (1.0 / 6.0));
+        double pinv = (p > 0.0) ? 1.0 / ((p > 0.0) ? p : 1.0) : 0.0;
+        double detb = b00 * (b11 * b22 - a12 * a12) - a01 * (a01 * b22 - a12 * a02) + a02 * (a01 * a12 - b11 * a02);
+        double r = 0.5 * detb * pinv * pinv * pinv;
+        r = (r < 1.0) ? r : 1.0;
+        r = (r > -1.0) ? r : -1.0;
+        double phi = acos(r) * (1.0 / 3.0);
+        double w2 = q + 2.0 * p * cos(phi);
+        double w0 = q + 2.0 * p * cos(phi + third_turn);
+        double w1 = 3.0 * q - w0 - w2;
+
+        // The eigenvector of the better separated extreme eigenvalue comes from cross products
+        // of the rows of A - lambda I. The other extreme one is orthogonal to it and to the rows
+        // of its own shifted matrix (any orthogonal vector when that eigenvalue is repeated),
+        // and the middle one completes the right-handed frame.
+#define TOP ((w2 - w1) > (w1 - w0))
+        double lf = TOP ? w2 : w0, lo = TOP ? w0 : w2;
+        double r0[3] = {a00 - lf, a01, a02}, r1[3] = {a01, a11 - lf, a12}, r2[3] = {a02, a12, a22 - lf};
+        double c0[3], c1[3], c2[3], u[3], s[3], mid[3], perp[3];
+        const double ex[3] = {1.0, 0.0, 0.0};
+        CROSS(c0, r0, r1);
+        CROSS(c1, r0, r2);
+        CROSS(c2, r1, r2);
+        PICK_LONGEST(u, c0, c1, c2, ex);
+        // A unit vector orthogonal to u without branches (Duff et al., "Building an orthonormal
+        // basis, revisited").
+        double sg = copysign(1.0, u[2]);
+        double ib = -1.0 / (sg + u[2]);
+        perp[0] = 1.0 + sg * u[0] * u[0] * ib;
+        perp[1] = sg * u[0] * u[1] * ib;
+        perp[2] = -sg * u[0];
+        r0[0] = a00 - lo;
+        r1[1] = a11 - lo;
+        r2[2] = a22 - lo;
+        CROSS(c0, u, r0);
+        CROSS(c1, u, r1);
+        CROSS(c2, u, r2);
+        PICK_LONGEST(s, c0, c1, c2, perp);
+        // Columns (v0, v1, v2) with v1 = v2 x v0.
+        double v0[3] = {TOP ? s[0] : u[0], TOP ? s[1] : u[1], TOP ? s[2] : u[2]};
+        double v2[3] = {TOP ? u[0] : s[0], TOP ? u[1] : s[1], TOP ? u[2] : s[2]};
+#undef TOP
+        CROSS(mid, v2, v0);
+        w[0][i] = w0 * big;
+        w[1][i] = w1 * big;
+        w[2][i] = w2 * big;
+        M(V, 0, 0) = v0[0];
+        M(V, 1, 0) = v0[1];
+        M(V, 2, 0) = v0[2];
+        M(V, 0, 1) = mid[0];
+        M(V, 1, 1) = mid[1];
+        M(V, 2, 1) = mid[2];
+        M(V, 0, 2) = v2[0];
+        M(V, 1, 2) = v2[1];
+        M(V, 2, 2) = v2[2];
+    }
+}
+
+#undef CROSS
+#undef NORM2
+#undef PICK_LONGEST
+
+static void la_eigh_range(const la_task* t, Py_ssize_t lo, Py_ssize_t hi) {
+    la_plane A[9], V[9], w[3];
+    for (Py_ssize_t b = lo; b < hi; b += LA_BLOCK) {
+        Py_ssize_t len = (hi - b < LA_BLOCK) ? hi - b : LA_BLOCK;
+        la_gather(t->a, t->m, 9, b, len, A);
+        // Mirror the upper triangle.
+        memcpy(A[3], A[1], len * sizeof(double));
+        memcpy(A[6], A[2], len * sizeof(double));
+        memcpy(A[7], A[5], len * sizeof(double));
+        if (t->op == LA_EIGH_ANALYTIC) {
+            eigh_analytic(A, w, V, len);
+        } else {
+            eigh_jacobi(A, w, V, len);
+        }
+        la_scatter(w, 3, b, len, t->out, t->m);
+        la_scatter(V, 9, b, len, t->out2, t->m);
+    }
+}
+
+#undef M
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+
+#define LA_INSTANTIATE(name)                                                          \
+    static void name##_sized(const la_task* t, Py_ssize_t lo, Py_ssize_t hi) {        \
+        switch (t->n) {                                                               \
+            case 2: name##_range(t, lo, hi, 2); break;                                \
+            case 3: name##_range(t, lo, hi, 3); break;                                \
+            default: name##_range(t, lo, hi, 4); break;                               \
+        }                                                                             \
+    }
+
+LA_INSTANTIATE(la_det)
+LA_INSTANTIATE(la_inv)
+LA_INSTANTIATE(la_solve)
+LA_INSTANTIATE(la_matmul)
+LA_INSTANTIATE(la_matvec)
+
+static void la_chunk(void* ctx, Py_ssize_t chunk) {
+    la_task* t = (la_task*)ctx;
+    Py_ssize_t lo = chunk * LA_CHUNK;
+    Py_ssize_t hi = (lo + LA_CHUNK < t->m) ? lo + LA_CHUNK : t->m;
+    switch (t->op) {
+        case LA_DET: la_det_sized(t, lo, hi); break;
+        case LA_INV: la_inv_sized(t, lo, hi); break;
+        case LA_SOLVE: la_solve_sized(t, lo, hi); break;
+        case LA_MATMUL: la_matmul_sized(t, lo, hi); break;
+        case LA_MATVEC: la_matvec_sized(t, lo, hi); break;
+        default: la_eigh_range(t, lo, hi); break;
+    }
+}
+
+static void la_run(la_task* t) {
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(la_chunk, t, (t->m + LA_CHUNK - 1) / LA_CHUNK);
+    Py_END_ALLOW_THREADS
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers
+// -----------------------------------------------------------------------------
+
+// Opens a batch of n x n matrices and sets *m to the batch size.
+static int la_open_matrices(PyObject* obj, int n, Py_buffer* view, Py_ssize_t* m) {
+    if (n < 2 || n > LA_MAX) {
+        PyErr_SetString(PyExc_ValueError, "matrix size n must be 2, 3 or 4");
+        return -1;
+    }
+    if (calco_get_double_buffer(obj, view, 0) < 0) {
+        return -1;
+    }
+    Py_ssize_t len = view->len / (Py_ssize_t)sizeof(double);
+    if (len % (n * n) != 0) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError, "buffer length %zd is not a multiple of n * n = %d", len, n * n);
+        return -1;
+    }
+    *m = len / (n * n);
+    return 0;
+}
+
+// Opens a second operand that must hold exactly per_item * m values.
+static int la_open_operand(PyObject* obj, Py_ssize_t expected, const char* what, Py_buffer* view) {
+    if (calco_get_double_buffer(obj, view, 0) < 0) {
+        return -1;
+    }
+    if (view->len / (Py_ssize_t)sizeof(double) != expected) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError, "%s must hold %zd values to match the batch of matrices", what, expected);
+        return -1;
+    }
+    return 0;
+}
+
+// Shared body of the one-output wrappers: opens a (and b when b_per_item > 0), runs op and
+// returns the out buffer with out_per_item values per matrix.
+static PyObject* la_simple(la_op op, PyObject* a_obj, PyObject* b_obj, int n, Py_ssize_t b_per_item,
+                           Py_ssize_t out_per_item, PyObject* out) {
+    Py_buffer a_view, b_view, out_view;
+    PyObject* out_obj;
+    la_task task;
+    memset(&task, 0, sizeof(task));
+    if (la_open_matrices(a_obj, n, &a_view, &task.m) < 0) {
+        return NULL;
+    }
+    if (b_per_item > 0 && la_open_operand(b_obj, b_per_item * task.m, op == LA_MATMUL ? "b" : "v", &b_view) < 0) {
+        PyBuffer_Release(&a_view);
+        return NULL;
+    }
+    if (calco_get_out_buffer(out, out_per_item * task.m, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&a_view);
+        if (b_per_item > 0) {
+            PyBuffer_Release(&b_view);
+        }
+        return NULL;
+    }
+    task.op = op;
+    task.n = n;
+    task.a = (const double*)a_view.buf;
+    task.b = (b_per_item > 0) ? (const double*)b_view.buf : NULL;
+    task.out = (double*)out_view.buf;
+    la_run(&task);
+    PyBuffer_Release(&a_view);
+    if (b_per_item > 0) {
+        PyBuffer_Release(&b_view);
+    }
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+PyObject* calco_batch_det(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "n", "out", NULL};
+    PyObject *a, *out = Py_None;
+    int n;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oi|$O", kwlist, &a, &n, &out)) {
+        return NULL;
+    }
+    return la_simple(LA_DET, a, NULL, n, 0, 1, out);
+}
+
+PyObject* calco_batch_inv(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "n", "out", NULL};
+    PyObject *a, *out = Py_None;
+    int n;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oi|$O", kwlist, &a, &n, &out)) {
+        return NULL;
+    }
+    return la_simple(LA_INV, a, NULL, n, 0, (Py_ssize_t)n * n, out);
+}
+
+PyObject* calco_batch_matmul(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "n", "out", NULL};
+    PyObject *a, *b, *out = Py_None;
+    int n;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOi|$O", kwlist, &a, &b, &n, &out)) {
+        return NULL;
+    }
+    return la_simple(LA_MATMUL, a, b, n, (Py_ssize_t)n * n, (Py_ssize_t)n * n, out);
+}
+
+PyObject* calco_batch_matvec(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "v", "n", "out", NULL};
+    PyObject *a, *v, *out = Py_None;
+    int n;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOi|$O", kwlist, &a, &v, &n, &out)) {
+        return NULL;
+    }
+    return la_simple(LA_MATVEC, a, v, n, n, n, out);
+}
+
+PyObject* calco_batch_solve(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "n", "rcond", "out", NULL};
+    PyObject *a, *b, *out = Py_None;
+    Py_buffer a_view, b_view, out_view, flag_view;
+    PyObject *out_obj, *flags;
+    la_task task;
+    int n;
+    memset(&task, 0, sizeof(task));
+    task.rcond = 1e-12;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOi|$dO", kwlist, &a, &b, &n, &task.rcond, &out)) {
+        return NULL;
+    }
+    if (la_open_matrices(a, n, &a_view, &task.m) < 0) {
+        return NULL;
+    }
+    if (la_open_operand(b, n * task.m, "b", &b_view) < 0) {
+        PyBuffer_Release(&a_view);
+        return NULL;
+    }
+    if (calco_get_out_buffer(out, n * task.m, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&a_view);
+        PyBuffer_Release(&b_view);
+        return NULL;
+    }
+    flags = calco_new_array('B', task.m, &flag_view);
+    if (flags == NULL) {
+        PyBuffer_Release(&a_view);
+        PyBuffer_Release(&b_view);
+        PyBuffer_Release(&out_view);
+        Py_DECREF(out_obj);
+        return NULL;
+    }
+    task.op = LA_SOLVE;
+    task.n = n;
+    task.a = (const double*)a_view.buf;
+    task.b = (const double*)b_view.buf;
+    task.out = (double*)out_view.buf;
+    task.flags = (unsigned char*)flag_view.buf;
+    la_run(&task);
+    PyBuffer_Release(&a_view);
+    PyBuffer_Release(&b_view);
+    PyBuffer_Release(&out_view);
+    PyBuffer_Release(&flag_view);
+    PyObject* result = PyTuple_Pack(2, out_obj, flags);
+    Py_DECREF(out_obj);
+    Py_DECREF(flags);
+    return result;
+}
+
+PyObject* calco_batch_eigh3(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "method", "out", NULL};
+    PyObject *a, *out = Py_None;
+    const char* method = "jacobi";
+    Py_buffer a_view, w_view, v_view;
+    PyObject *w_obj, *v_obj;
+    la_task task;
+    memset(&task, 0, sizeof(task));
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$sO", kwlist, &a, &method, &out)) {
+        return NULL;
+    }
+    if (strcmp(method, "jacobi") == 0) {
+        task.op = LA_EIGH_JACOBI;
+    } else if (strcmp(method, "analytic") == 0) {
+        task.op = LA_EIGH_ANALYTIC;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown method '%s' (expected 'jacobi' or 'analytic')", method);
+        return NULL;
+    }
+    if (out != Py_None && (!PyTuple_Check(out) || PyTuple_GET_SIZE(out) != 2)) {
+        PyErr_SetString(PyExc_TypeError, "out must be a tuple of two float64 buffers (eigenvalues, eigenvectors)");
+        return NULL;
+    }
+    if (la_open_matrices(a, 3, &a_view, &task.m) < 0) {
+        return NULL;
+    }
+    if (calco_get_out_buffer(out == Py_None ? Py_None : PyTuple_GET_ITEM(out, 0), 3 * task.m, &w_view, &w_obj) < 0) {
+        PyBuffer_Release(&a_view);
+        return NULL;
+    }
+    if (calco_get_out_buffer(out == Py_None ? Py_None : PyTuple_GET_ITEM(out, 1), 9 * task.m, &v_view, &v_obj) < 0) {
+        PyBuffer_Release(&a_view);
+        PyBuffer_Release(&w_view);
+        Py_DECREF(w_obj);
+        return NULL;
+    }
+    task.n = 3;
+    task.a = (const double*)a_view.buf;
+    task.out = (double*)w_view.buf;
+    task.out2 = (double*)v_view.buf;
+    la_run(&task);
+    PyBuffer_Release(&a_view);
+    PyBuffer_Release(&w_view);
+    PyBuffer_Release(&v_view);
+    PyObject* result = PyTuple_Pack(2, w_obj, v_obj);
+    Py_DECREF(w_obj);
+    Py_DECREF(v_obj);
+    return result;
+}
@@ -4,6 +4,87 @@
 
 #include "calco.h" // Include the main header for function prototypes and definitions
 
+// -----------------------------------------------------------------------------
+// Workspace Shims
+// Batch functions accept workspace= (calco_workspace.c) through these wrappers.
+// -----------------------------------------------------------------------------
+CALCO_WORKSPACE_SHIM(calco_apply)
+CALCO_WORKSPACE_SHIM(calco_submit)
+CALCO_WORKSPACE_SHIM(calco_parse_floats)
+CALCO_WORKSPACE_SHIM(calco_cumsum)
+CALCO_WORKSPACE_SHIM(calco_cumprod)
+CALCO_WORKSPACE_SHIM(calco_rolling_sum)
+CALCO_WORKSPACE_SHIM(calco_rolling_mean)
+CALCO_WORKSPACE_SHIM(calco_rolling_var)
+CALCO_WORKSPACE_SHIM(calco_rolling_std)
+CALCO_WORKSPACE_SHIM(calco_rolling_min)
+CALCO_WORKSPACE_SHIM(calco_rolling_max)
+CALCO_WORKSPACE_SHIM(calco_interp)
+CALCO_WORKSPACE_SHIM(calco_polyval)
+CALCO_WORKSPACE_SHIM(calco_ratval)
+CALCO_WORKSPACE_SHIM(calco_polyval_many)
+CALCO_WORKSPACE_SHIM(calco_dd_add_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_sub_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_mul_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_div_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_sqrt_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_exp_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_log_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_sin_buffers)
+CALCO_WORKSPACE_SHIM(calco_dd_cos_buffers)
+CALCO_WORKSPACE_SHIM(calco_quad)
+CALCO_WORKSPACE_SHIM(calco_norms)
+CALCO_WORKSPACE_SHIM(calco_distances)
+CALCO_WORKSPACE_SHIM(calco_pdist)
+CALCO_WORKSPACE_SHIM(calco_cdist)
+CALCO_WORKSPACE_SHIM(calco_knn)
+CALCO_WORKSPACE_SHIM(calco_polar_to_cartesian)
+CALCO_WORKSPACE_SHIM(calco_cartesian_to_polar)
+CALCO_WORKSPACE_SHIM(calco_spherical_to_cartesian)
+CALCO_WORKSPACE_SHIM(calco_cartesian_to_spherical)
+CALCO_WORKSPACE_SHIM(calco_haversine)
+CALCO_WORKSPACE_SHIM(calco_bearing)
+CALCO_WORKSPACE_SHIM(calco_vincenty)
+CALCO_WORKSPACE_SHIM(calco_batch_det)
+CALCO_WORKSPACE_SHIM(calco_batch_inv)
+CALCO_WORKSPACE_SHIM(calco_batch_solve)
+CALCO_WORKSPACE_SHIM(calco_batch_matmul)
+CALCO_WORKSPACE_SHIM(calco_batch_matvec)
+CALCO_WORKSPACE_SHIM(calco_batch_eigh3)
+CALCO_WORKSPACE_SHIM(calco_odeint_batch)
+CALCO_WORKSPACE_SHIM(calco_find_roots)
+CALCO_WORKSPACE_SHIM(calco_sind)
+CALCO_WORKSPACE_SHIM(calco_cosd)
+CALCO_WORKSPACE_SHIM(calco_tand)
+CALCO_WORKSPACE_SHIM(calco_asind)
+CALCO_WORKSPACE_SHIM(calco_acosd)
+CALCO_WORKSPACE_SHIM(calco_atan2d)
+CALCO_WORKSPACE_SHIM(calco_log1p)
+CALCO_WORKSPACE_SHIM(calco_sigmoid)
+CALCO_WORKSPACE_SHIM(calco_logit)
+CALCO_WORKSPACE_SHIM(calco_softplus)
+CALCO_WORKSPACE_SHIM(calco_gelu)
+CALCO_WORKSPACE_SHIM(calco_silu)
+CALCO_WORKSPACE_SHIM(calco_logaddexp)
+CALCO_WORKSPACE_SHIM(calco_logaddexp2)
+CALCO_WORKSPACE_SHIM(calco_logsumexp)
+CALCO_WORKSPACE_SHIM(calco_softmax)
+CALCO_WORKSPACE_SHIM(calco_fft)
+CALCO_WORKSPACE_SHIM(calco_ifft)
+CALCO_WORKSPACE_SHIM(calco_rfft)
+CALCO_WORKSPACE_SHIM(calco_quantize)
+CALCO_WORKSPACE_SHIM(calco_dequantize)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_factorial)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_comb)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_perm)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_gcd)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_lcm)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_isqrt)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_ipow)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_powmod)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_log_factorial)
+CALCO_WORKSPACE_FASTCALL_SHIM(calco_log_comb)
+
 // -----------------------------------------------------------------------------
 // Module Methods Definition
 // This table lists all functions that will be accessible from the Python module.
@@ -13,7 +94,7 @@ PyMethodDef CalcoMethods[] = {
     {"subtract", calco_subtract, METH_VARARGS, "Subtracts two double numbers."},
     {"multiply", calco_multiply, METH_VARARGS, "Multiplies two double numbers."},
     {"divide", calco_divide, METH_VARARGS, "Divides two double numbers. Returns NaN for 0/0, Inf/-Inf for x/0."},
-    {"power", calco_power, METH_VARARGS, "Raises base to the power of exponent."},
+    {"power", (PyCFunction)(void(*)(void))calco_power, METH_FASTCALL, "Raises base to the power of exponent (small integer, half, third and quarter exponents use multiplication and roots)."},
     {"square_root", calco_square_root, METH_VARARGS, "Calculates the square root of a number. Returns NaN for negative numbers."},
     {"cube_root", calco_cube_root, METH_VARARGS, "Calculates the cube root of a number."},
     {"absolute_value", calco_absolute_value, METH_VARARGS, "Calculates the absolute value of a double."},
@@ -58,6 +139,89 @@ PyMethodDef CalcoMethods[] = {
     {"get_e", calco_get_e, METH_VARARGS, "Returns the value of E."},
     {"is_nan", calco_is_nan, METH_VARARGS, "Checks if a double is Not-a-Number (NaN)."},
     {"is_infinity", calco_is_infinity, METH_VARARGS, "Checks if a double is positive or negative infinity."},
+    {"apply", (PyCFunction)(void(*)(void))calco_apply_ws, METH_VARARGS | METH_KEYWORDS, "apply(func, buf, out=None): Applies a unary calco function to every element of a float64 buffer on the worker pool."},
+    {"submit", (PyCFunction)(void(*)(void))calco_submit_ws, METH_VARARGS | METH_KEYWORDS, "submit(func, buf, out=None, *, chunk=65536, block=True): Starts apply() in the background and returns an awaitable calco.Future."},
+    {"set_num_threads", calco_set_num_threads, METH_VARARGS, "Sets the number of native worker threads."},
+    {"get_num_threads", calco_get_num_threads, METH_VARARGS, "Returns the number of native worker threads."},
+    {"set_max_pending", calco_set_max_pending, METH_VARARGS, "Sets how many submitted jobs may be queued or running before submit() blocks or raises."},
+    {"parse_floats", (PyCFunction)(void(*)(void))calco_parse_floats_ws, METH_VARARGS | METH_KEYWORDS, "parse_floats(data, sep=b',', *, out=None, partial=False): Parses separated decimal numbers from a bytes-like object into float64 values; an empty field (b'1,,3') raises ValueError, while one sep after the last value is allowed (b'1\\n2\\n' with sep=b'\\n')."},
+    {"format_floats", (PyCFunction)(void(*)(void))calco_format_floats, METH_VARARGS | METH_KEYWORDS, "format_floats(buf, sep=b','): Formats a float64 buffer as shortest round-trip strings (like repr) joined by sep into one bytes object."},
+    {"cumsum", (PyCFunction)(void(*)(void))calco_cumsum_ws, METH_VARARGS | METH_KEYWORDS, "cumsum(buf, out=None, *, initial=0.0): Cumulative sum of a float64 buffer."},
+    {"cumprod", (PyCFunction)(void(*)(void))calco_cumprod_ws, METH_VARARGS | METH_KEYWORDS, "cumprod(buf, out=None, *, initial=1.0): Cumulative product of a float64 buffer."},
+    {"rolling_sum", (PyCFunction)(void(*)(void))calco_rolling_sum_ws, METH_VARARGS | METH_KEYWORDS, "rolling_sum(buf, window, out=None, *, min_periods=window): Sum over a sliding window ending at each element; NaN until min_periods samples are available."},
+    {"rolling_mean", (PyCFunction)(void(*)(void))calco_rolling_mean_ws, METH_VARARGS | METH_KEYWORDS, "rolling_mean(buf, window, out=None, *, min_periods=window): Mean over a sliding window ending at each element."},
+    {"rolling_var", (PyCFunction)(void(*)(void))calco_rolling_var_ws, METH_VARARGS | METH_KEYWORDS, "rolling_var(buf, window, out=None, *, min_periods=window, ddof=1): Variance over a sliding window ending at each element."},
+    {"rolling_std", (PyCFunction)(void(*)(void))calco_rolling_std_ws, METH_VARARGS | METH_KEYWORDS, "rolling_std(buf, window, out=None, *, min_periods=window, ddof=1): Standard deviation over a sliding window ending at each element."},
+    {"rolling_min", (PyCFunction)(void(*)(void))calco_rolling_min_ws, METH_VARARGS | METH_KEYWORDS, "rolling_min(buf, window, out=None, *, min_periods=window): Minimum over a sliding window ending at each element; NaN while the window holds a NaN."},
+    {"rolling_max", (PyCFunction)(void(*)(void))calco_rolling_max_ws, METH_VARARGS | METH_KEYWORDS, "rolling_max(buf, window, out=None, *, min_periods=window): Maximum over a sliding window ending at each element; NaN while the window holds a NaN."},
+    {"interp", (PyCFunction)(void(*)(void))calco_interp_ws, METH_VARARGS | METH_KEYWORDS, "interp(x, xp, fp, out=None, *, left=fp[0], right=fp[-1]): Linear interpolation of (xp, fp) at a float or a float64 buffer; xp must be strictly increasing."},
+    {"polyval", (PyCFunction)(void(*)(void))calco_polyval_ws, METH_VARARGS | METH_KEYWORDS, "polyval(coeffs, x, out=None, *, compensated=False): Evaluates a polynomial (coefficients highest degree first) at a float or a float64 buffer."},
+    {"ratval", (PyCFunction)(void(*)(void))calco_ratval_ws, METH_VARARGS | METH_KEYWORDS, "ratval(num, den, x, out=None, *, compensated=False): Evaluates the rational function num(x)/den(x) at a float or a float64 buffer."},
+    {"polyval_many", (PyCFunction)(void(*)(void))calco_polyval_many_ws, METH_VARARGS | METH_KEYWORDS, "polyval_many(coeffs, degree, x, out=None): Evaluates many polynomials of one degree, stored as consecutive rows of a float64 buffer, at the same x."},
+    {"dd_add", (PyCFunction)(void(*)(void))calco_dd_add_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_add(a, b, out=None): Double-double a + b elementwise. Operands are float64 buffers, (hi, lo) buffer pairs or scalars; returns a (hi, lo) pair of arrays."},
+    {"dd_sub", (PyCFunction)(void(*)(void))calco_dd_sub_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_sub(a, b, out=None): Double-double a - b elementwise. Operands are float64 buffers, (hi, lo) buffer pairs or scalars; returns a (hi, lo) pair of arrays."},
+    {"dd_mul", (PyCFunction)(void(*)(void))calco_dd_mul_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_mul(a, b, out=None): Double-double a * b elementwise. Operands are float64 buffers, (hi, lo) buffer pairs or scalars; returns a (hi, lo) pair of arrays."},
+    {"dd_div", (PyCFunction)(void(*)(void))calco_dd_div_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_div(a, b, out=None): Double-double a / b elementwise. Operands are float64 buffers, (hi, lo) buffer pairs or scalars; returns a (hi, lo) pair of arrays."},
+    {"dd_sqrt", (PyCFunction)(void(*)(void))calco_dd_sqrt_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_sqrt(a, out=None): Double-double sqrt of a float64 buffer or (hi, lo) pair; returns a (hi, lo) pair of arrays."},
+    {"dd_exp", (PyCFunction)(void(*)(void))calco_dd_exp_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_exp(a, out=None): Double-double exp of a float64 buffer or (hi, lo) pair; returns a (hi, lo) pair of arrays."},
+    {"dd_log", (PyCFunction)(void(*)(void))calco_dd_log_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_log(a, out=None): Double-double log of a float64 buffer or (hi, lo) pair; returns a (hi, lo) pair of arrays."},
+    {"dd_sin", (PyCFunction)(void(*)(void))calco_dd_sin_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_sin(a, out=None): Double-double sin of a float64 buffer or (hi, lo) pair; returns a (hi, lo) pair of arrays."},
+    {"dd_cos", (PyCFunction)(void(*)(void))calco_dd_cos_buffers_ws, METH_VARARGS | METH_KEYWORDS, "dd_cos(a, out=None): Double-double cos of a float64 buffer or (hi, lo) pair; returns a (hi, lo) pair of arrays."},
+    {"dd_sum", calco_dd_sum, METH_VARARGS, "dd_sum(a): Compensated sum of a float64 buffer or (hi, lo) pair, returned as a calco.dd."},
+    {"dd_dot", calco_dd_dot, METH_VARARGS, "dd_dot(x, y): Compensated dot product of two float64 buffers, returned as a calco.dd."},
+    {"factorial", (PyCFunction)(void(*)(void))calco_factorial_ws, METH_FASTCALL | METH_KEYWORDS, "factorial(n, /, *, out=None): Exact n! for an int, or elementwise over an int64 buffer."},
+    {"comb", (PyCFunction)(void(*)(void))calco_comb_ws, METH_FASTCALL | METH_KEYWORDS, "comb(n, k, /, *, out=None): Exact binomial coefficient C(n, k); operands may be ints or int64 buffers."},
+    {"perm", (PyCFunction)(void(*)(void))calco_perm_ws, METH_FASTCALL | METH_KEYWORDS, "perm(n, k=None, /, *, out=None): Exact number of k-permutations of n (n! when k is None); operands may be ints or int64 buffers."},
+    {"gcd", (PyCFunction)(void(*)(void))calco_gcd_ws, METH_FASTCALL | METH_KEYWORDS, "gcd(*integers, out=None): Greatest common divisor (binary GCD); with two int64 buffers, elementwise."},
+    {"lcm", (PyCFunction)(void(*)(void))calco_lcm_ws, METH_FASTCALL | METH_KEYWORDS, "lcm(*integers, out=None): Least common multiple; with two int64 buffers, elementwise."},
+    {"isqrt", (PyCFunction)(void(*)(void))calco_isqrt_ws, METH_FASTCALL | METH_KEYWORDS, "isqrt(n, /, *, out=None): Integer square root of an int, or elementwise over an int64 buffer."},
+    {"ipow", (PyCFunction)(void(*)(void))calco_ipow_ws, METH_FASTCALL | METH_KEYWORDS, "ipow(base, exp, /, *, out=None): Exact integer power (exp >= 0); operands may be ints or int64 buffers."},
+    {"powmod", (PyCFunction)(void(*)(void))calco_powmod_ws, METH_FASTCALL | METH_KEYWORDS, "powmod(base, exp, mod, /, *, out=None): pow(base, exp, mod) with 128-bit modular products; operands may be ints or int64 buffers."},
+    {"log_factorial", (PyCFunction)(void(*)(void))calco_log_factorial_ws, METH_FASTCALL | METH_KEYWORDS, "log_factorial(n, /, *, out=None): log(n!) as a float, from a table for small n and lgamma beyond."},
+    {"log_comb", (PyCFunction)(void(*)(void))calco_log_comb_ws, METH_FASTCALL | METH_KEYWORDS, "log_comb(n, k, /, *, out=None): log(C(n, k)) as a float, exact for n <= 67 and without lgamma cancellation beyond."},
+    {"power_by", (PyCFunction)(void(*)(void))calco_power_by, METH_VARARGS | METH_KEYWORDS, "power_by(exponent): Returns a calco.PowerBy that raises floats or float64 buffers to a fixed exponent with a specialized kernel."},
+    {"quad", (PyCFunction)(void(*)(void))calco_quad_ws, METH_VARARGS | METH_KEYWORDS, "quad(f, a, b, *, epsabs=1.49e-8, epsrel=1.49e-8, limit=None, rule='gk21', vectorized=True, full_output=False): Adaptive integral of f over [a, b] (limits may be infinite, or float64 buffers for a batch) as (value, error). f is a unary calco function, its name, or a callable taking a float64 array of nodes."},
+    {"norms", (PyCFunction)(void(*)(void))calco_norms_ws, METH_VARARGS | METH_KEYWORDS, "norms(points, dim=None, *, metric='euclidean', out=None): Norm of every point; points are a flat float64 buffer of n * dim coordinates or a sequence of dim coordinate buffers."},
+    {"distances", (PyCFunction)(void(*)(void))calco_distances_ws, METH_VARARGS | METH_KEYWORDS, "distances(a, b, dim=None, *, metric='euclidean', out=None): Distance between corresponding points of two point sets."},
+    {"pdist", (PyCFunction)(void(*)(void))calco_pdist_ws, METH_VARARGS | METH_KEYWORDS, "pdist(points, dim=None, *, metric='euclidean', out=None): Condensed pairwise distances (pair i < j at n*i - i*(i+1)/2 + j - i - 1). Metrics: euclidean, sqeuclidean, cityblock, chebyshev."},
+    {"cdist", (PyCFunction)(void(*)(void))calco_cdist_ws, METH_VARARGS | METH_KEYWORDS, "cdist(a, b, dim=None, *, metric='euclidean', out=None): Row-major len(a) x len(b) matrix of distances between two point sets."},
+    {"knn", (PyCFunction)(void(*)(void))calco_knn_ws, METH_VARARGS | METH_KEYWORDS, "knn(data, queries, k, dim=None, *, metric='euclidean'): Brute-force k nearest data points of every query, as (int64 indices, distances), each row sorted by distance."},
+    {"polar_to_cartesian", (PyCFunction)(void(*)(void))calco_polar_to_cartesian_ws, METH_VARARGS | METH_KEYWORDS, "polar_to_cartesian(r, theta, *, degrees=False, out=None): (x, y) from polar coordinates; floats or float64 buffers."},
+    {"cartesian_to_polar", (PyCFunction)(void(*)(void))calco_cartesian_to_polar_ws, METH_VARARGS | METH_KEYWORDS, "cartesian_to_polar(x, y, *, degrees=False, out=None): (r, theta) with theta = atan2(y, x)."},
+    {"spherical_to_cartesian", (PyCFunction)(void(*)(void))calco_spherical_to_cartesian_ws, METH_VARARGS | METH_KEYWORDS, "spherical_to_cartesian(r, lat, lon, *, degrees=True, out=None): (x, y, z) from radius, latitude and longitude."},
+    {"cartesian_to_spherical", (PyCFunction)(void(*)(void))calco_cartesian_to_spherical_ws, METH_VARARGS | METH_KEYWORDS, "cartesian_to_spherical(x, y, z, *, degrees=True, out=None): (r, lat, lon) with latitude measured from the equator."},
+    {"haversine", (PyCFunction)(void(*)(void))calco_haversine_ws, METH_VARARGS | METH_KEYWORDS, "haversine(lat1, lon1, lat2, lon2, *, radius=6371008.8, degrees=True, out=None): Great-circle distance on a sphere (meters by default)."},
+    {"bearing", (PyCFunction)(void(*)(void))calco_bearing_ws, METH_VARARGS | METH_KEYWORDS, "bearing(lat1, lon1, lat2, lon2, *, degrees=True, out=None): Initial great-circle bearing, clockwise from north, in [0, 360)."},
+    {"vincenty", (PyCFunction)(void(*)(void))calco_vincenty_ws, METH_VARARGS | METH_KEYWORDS, "vincenty(lat1, lon1, lat2, lon2, *, a=6378137.0, f=1/298.257223563, tol=1e-12, max_iter=200, degrees=True, out=None): Ellipsoidal (WGS 84) distance in meters by Vincenty's inverse formula; nan where it does not converge."},
+    {"batch_det", (PyCFunction)(void(*)(void))calco_batch_det_ws, METH_VARARGS | METH_KEYWORDS, "batch_det(a, n, *, out=None): Determinants of a plane-major batch of n x n matrices (n = 2, 3, 4); element (r, c) of matrix i is a[(r*n + c)*m + i]."},
+    {"batch_inv", (PyCFunction)(void(*)(void))calco_batch_inv_ws, METH_VARARGS | METH_KEYWORDS, "batch_inv(a, n, *, out=None): Inverses of a plane-major batch of n x n matrices by the closed-form adjugate."},
+    {"batch_solve", (PyCFunction)(void(*)(void))calco_batch_solve_ws, METH_VARARGS | METH_KEYWORDS, "batch_solve(a, b, n, *, rcond=1e-12, out=None): Solves a[i] x = b[i] for every matrix with partial pivoting; returns (x, flags) where flags (uint8) marks singular or ill-conditioned systems."},
+    {"batch_matmul", (PyCFunction)(void(*)(void))calco_batch_matmul_ws, METH_VARARGS | METH_KEYWORDS, "batch_matmul(a, b, n, *, out=None): Products a[i] @ b[i] of two plane-major batches of n x n matrices."},
+    {"batch_matvec", (PyCFunction)(void(*)(void))calco_batch_matvec_ws, METH_VARARGS | METH_KEYWORDS, "batch_matvec(a, v, n, *, out=None): Products a[i] @ v[i]; component r of vector i is v[r*m + i]."},
+    {"batch_eigh3", (PyCFunction)(void(*)(void))calco_batch_eigh3_ws, METH_VARARGS | METH_KEYWORDS, "batch_eigh3(a, *, method='jacobi', out=None): Eigenvalues (ascending) and eigenvectors (columns) of a plane-major batch of symmetric 3x3 matrices; method is 'jacobi' or 'analytic'."},
+    {"odeint_batch", (PyCFunction)(void(*)(void))calco_odeint_batch_ws, METH_VARARGS | METH_KEYWORDS, "odeint_batch(rhs, y0, t_span, n, *, method='rk45', rtol=1e-3, atol=1e-6, h=0.0, max_steps=100000, t_eval=None, params=None, out=None, full_output=False): Integrates a plane-major batch of trajectories of an n-dimensional ODE system; rhs is a vectorized callable rhs(t, y[, p]) or a sequence of n expressions compiled to C."},
+    {"find_roots", (PyCFunction)(void(*)(void))calco_find_roots_ws, METH_VARARGS | METH_KEYWORDS, "find_roots(f, lo, hi, *, method='brent', target=0.0, fprime=None, x0=None, xtol=2e-12, rtol=4*eps, maxiter=100, out=None, full_output=False): Solves f(x) = target for many brackets at once ('brent', 'newton' or 'bisect'); returns (roots, iterations, status) with status 0 converged, 1 maxiter, 2 not bracketed, 3 breakdown, 4 singular (converged onto a pole: |f| there exceeds |f(lo)| and |f(hi)|)."},
+    {"sind", (PyCFunction)(void(*)(void))calco_sind_ws, METH_VARARGS | METH_KEYWORDS, "sind(x, *, out=None): Sine of x in degrees with exact reduction modulo 360 (sind(180) == 0.0); x may be a float or a float64 buffer."},
+    {"cosd", (PyCFunction)(void(*)(void))calco_cosd_ws, METH_VARARGS | METH_KEYWORDS, "cosd(x, *, out=None): Cosine of x in degrees with exact reduction modulo 360 (cosd(90) == 0.0); x may be a float or a float64 buffer."},
+    {"tand", (PyCFunction)(void(*)(void))calco_tand_ws, METH_VARARGS | METH_KEYWORDS, "tand(x, *, out=None): Tangent of x in degrees; tand(45) == 1.0 exactly and odd multiples of 90 give NaN."},
+    {"asind", (PyCFunction)(void(*)(void))calco_asind_ws, METH_VARARGS | METH_KEYWORDS, "asind(x, *, out=None): Arcsine in degrees (NaN outside [-1, 1]); asind(0.5) == 30.0 exactly."},
+    {"acosd", (PyCFunction)(void(*)(void))calco_acosd_ws, METH_VARARGS | METH_KEYWORDS, "acosd(x, *, out=None): Arccosine in degrees (NaN outside [-1, 1]); acosd(0.5) == 60.0 exactly."},
+    {"atan2d", (PyCFunction)(void(*)(void))calco_atan2d_ws, METH_VARARGS | METH_KEYWORDS, "atan2d(y, x, *, out=None): Two-argument arctangent in degrees; y and x may be floats or equal-length float64 buffers (floats broadcast)."},
+    {"log1p", (PyCFunction)(void(*)(void))calco_log1p_ws, METH_VARARGS | METH_KEYWORDS, "log1p(x, *, out=None): log(1 + x), accurate for small x (NaN for x <= -1); x may be a float or a float64/float32 buffer."},
+    {"sigmoid", (PyCFunction)(void(*)(void))calco_sigmoid_ws, METH_VARARGS | METH_KEYWORDS, "sigmoid(x, *, out=None): Logistic function 1 / (1 + exp(-x)) without overflow for large |x|; x may be a float or a float64/float32 buffer."},
+    {"logit", (PyCFunction)(void(*)(void))calco_logit_ws, METH_VARARGS | METH_KEYWORDS, "logit(p, *, out=None): log(p / (1 - p)), the inverse of sigmoid (-inf at 0, inf at 1, NaN outside [0, 1])."},
+    {"softplus", (PyCFunction)(void(*)(void))calco_softplus_ws, METH_VARARGS | METH_KEYWORDS, "softplus(x, *, out=None): log(1 + exp(x)) computed as max(x, 0) + log1p(exp(-|x|)), without overflow."},
+    {"gelu", (PyCFunction)(void(*)(void))calco_gelu_ws, METH_VARARGS | METH_KEYWORDS, "gelu(x, *, out=None): Gaussian error linear unit x * Phi(x) (exact erf form)."},
+    {"silu", (PyCFunction)(void(*)(void))calco_silu_ws, METH_VARARGS | METH_KEYWORDS, "silu(x, *, out=None): Sigmoid linear unit x * sigmoid(x)."},
+    {"logaddexp", (PyCFunction)(void(*)(void))calco_logaddexp_ws, METH_VARARGS | METH_KEYWORDS, "logaddexp(a, b, *, out=None): log(exp(a) + exp(b)) without overflow; a and b may be floats or equal-length float64/float32 buffers (floats broadcast)."},
+    {"logaddexp2", (PyCFunction)(void(*)(void))calco_logaddexp2_ws, METH_VARARGS | METH_KEYWORDS, "logaddexp2(a, b, *, out=None): log2(2**a + 2**b) without overflow; a and b may be floats or equal-length buffers (floats broadcast)."},
+    {"logsumexp", (PyCFunction)(void(*)(void))calco_logsumexp_ws, METH_VARARGS | METH_KEYWORDS, "logsumexp(x, cols=None, *, out=None): Row-wise log(sum(exp(x))) over a float64/float32 buffer of rows of cols values (default: the 2-D shape, or one row giving a float), in one pass per row."},
+    {"softmax", (PyCFunction)(void(*)(void))calco_softmax_ws, METH_VARARGS | METH_KEYWORDS, "softmax(x, cols=None, *, out=None): Row-wise exp(x - max) / sum over a float64/float32 buffer of rows of cols values, with the maximum and sum found in one pass."},
+    {"fft", (PyCFunction)(void(*)(void))calco_fft_ws, METH_VARARGS | METH_KEYWORDS, "fft(x, cols=None, *, out=None, parallel=True): Discrete Fourier transform of each row of cols complex points (interleaved re, im float64/float32 values, or a complex128/complex64 buffer); returns interleaved values of the input's element type. Plans are cached per size."},
+    {"ifft", (PyCFunction)(void(*)(void))calco_ifft_ws, METH_VARARGS | METH_KEYWORDS, "ifft(x, cols=None, *, out=None, parallel=True): Inverse of fft, scaled by 1 / cols."},
+    {"rfft", (PyCFunction)(void(*)(void))calco_rfft_ws, METH_VARARGS | METH_KEYWORDS, "rfft(x, cols=None, *, out=None, parallel=True): Fourier transform of each row of cols real float64/float32 values; returns cols // 2 + 1 complex values per row, interleaved."},
+    {"quantize", (PyCFunction)(void(*)(void))calco_quantize_ws, METH_VARARGS | METH_KEYWORDS, "quantize(x, step=1.0, *, offset=0.0, lo=None, hi=None, mode='half_even', dtype=None, out=None, seed=0): Rounds (x - offset) / step with mode floor, ceil, trunc, half_away, half_even or stochastic, clamps to [lo, hi] and saturates into an int8/16/32/64 or uint8/16/32 buffer (default int64) in one pass; NaN gives clamp(0). A float gives an int."},
+    {"dequantize", (PyCFunction)(void(*)(void))calco_dequantize_ws, METH_VARARGS | METH_KEYWORDS, "dequantize(q, step=1.0, *, offset=0.0, out=None): q * step + offset from an integer buffer into float64 (or a float64/float32 out buffer)."},
     {NULL, NULL, 0, NULL}
 };
 
@@ -78,7 +242,64 @@ struct PyModuleDef calcomodule = {
 // This is the function Python calls when importing the module.
 // Its name must be PyInit_<module_name>, where <module_name> is defined in PyModuleDef.
 // -----------------------------------------------------------------------------
-PyMODINIT_FUNC PyInit_calco(void) {
-    return PyModule_Create(&calcomodule);
+// Creates a submodule from its definition, runs its optional exec hook (to add types),
+// attaches it as calco.<name> and registers it in sys.modules so that
+// `import calco.<name>` works as well.
+static int add_submodule(PyObject* m, struct PyModuleDef* def, const char* name, int (*exec)(PyObject*)) {
+    PyObject* sub = PyModule_Create(def);
+    if (sub == NULL) {
+        return -1;
+    }
+    if (exec != NULL && exec(sub) < 0) {
+        Py_DECREF(sub);
+        return -1;
+    }
+    PyObject* modules = PyImport_GetModuleDict();
+    if (PyDict_SetItemString(modules, def->m_name, sub) < 0 || PyModule_AddObject(m, name, sub) < 0) {
+        Py_DECREF(sub);
+        return -1;
+    }
+    return 0;
 }
 
+static int add_type(PyObject* m, PyTypeObject* type, const char* name) {
+    if (PyType_Ready(type) < 0) {
+        return -1;
+    }
+    Py_INCREF(type);
+    if (PyModule_AddObject(m, name, (PyObject*)type) < 0) {
+        Py_DECREF(type);
+        return -1;
+    }
+    return 0;
+}
+
+PyMODINIT_FUNC PyInit_calco(void) {
+    PyObject* m = PyModule_Create(&calcomodule);
+    if (m == NULL) {
+        return NULL;
+    }
+    calco_pool_init();
+    calco_text_init();
+    calco_intmath_init();
+    if (calco_register_init() < 0 ||
+        calco_workspace_init() < 0 ||
+        add_type(m, &CalcoFutureType, "Future") < 0 ||
+        add_type(m, &CalcoRollingStatsType, "RollingStats") < 0 ||
+        add_type(m, &CalcoPchipType, "PchipInterpolator") < 0 ||
+        add_type(m, &CalcoCubicSplineType, "CubicSpline") < 0 ||
+        add_type(m, &CalcoPolynomialType, "Polynomial") < 0 ||
+        add_type(m, &CalcoRegisterType, "Register") < 0 ||
+        add_type(m, &CalcoRegisterFileType, "RegisterFile") < 0 ||
+        add_type(m, &CalcoDDType, "dd") < 0 ||
+        add_type(m, &CalcoPowerByType, "PowerBy") < 0 ||
+        add_type(m, &CalcoWorkspaceType, "Workspace") < 0 ||
+        add_submodule(m, &calcogradmodule, "grad", NULL) < 0 ||
+        add_submodule(m, &calcorandommodule, "random", calco_random_exec) < 0 ||
+        add_submodule(m, &calcostatsmodule, "stats", calco_stats_exec) < 0 ||
+        add_submodule(m, &calcoprocpoolmodule, "procpool", calco_procpool_exec) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    return m;
+}
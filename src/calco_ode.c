@@ -0,0 +1,1033 @@
+// calco_ode.c
+// Contains calco.odeint_batch: integration of many independent trajectories of one small ODE
+// system y' = f(t, y) with Dormand-Prince RK45 (adaptive, per-trajectory step control) or the
+// classical fixed-step RK4.
+//
+// States are packed SoA like the batched linear algebra: component k of trajectory i sits at
+// y[k * m + i]. Every round advances each unfinished trajectory by one step attempt, and each
+// stage evaluates the right-hand side once for all of them. The right-hand side is either a
+// Python callable receiving whole arrays, or a tuple of expressions compiled into a small
+// register program that runs in C on the worker threads without touching Python.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite (isfinite is folded away under -ffast-math)
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ODE_CHUNK 1024  // Trajectories per pool task (compiled right-hand sides)
+#define ODE_BLOCK 256   // Trajectories per block of the expression program
+#define ODE_MAX_DEPTH 200
+
+// -----------------------------------------------------------------------------
+// Expression Programs
+// An expression is a number, 't', 'y<k>', 'p<k>' (the k-th per-trajectory parameter) or a tuple
+// (op, arg, ...) whose op is an arithmetic name ('add', '*', 'power', ...) or any unary calco
+// function, given by name or as the function object. Each node becomes one instruction over a
+// plane of ODE_BLOCK values, so a program of arithmetic instructions is a chain of loops the
+// compiler vectorizes.
+// -----------------------------------------------------------------------------
+
+typedef enum { ODE_COPY, ODE_ADD, ODE_SUB, ODE_MUL, ODE_DIV, ODE_POW, ODE_HYPOT, ODE_FMA, ODE_UNARY } ode_opcode;
+
+typedef struct {
+    ode_opcode op;
+    int dst, a, b, c;
+    calco_unary_fn fn;
+} ode_insn;
+
+// Slots: y components [0, n), t at n, parameters [n + 1, n + 1 + np), outputs (the derivative
+// components) from out0 = n + 1 + np, and constants and temporaries from first = out0 + n.
+typedef struct {
+    int n, np, out0, first;
+    int nslots;
+    double* value;             // Per slot from first: the constant, or NaN for a temporary
+    unsigned char* is_const;
+    int slot_cap;
+    ode_insn* code;
+    int ncode, code_cap;
+} ode_prog;
+
+static const struct {
+    const char* name;
+    const char* symbol;
+    PyCFunction fn;
+    ode_opcode op;
+    int arity;
+} ode_ops[] = {
+    {"add", "+", calco_add, ODE_ADD, 2},
+    {"subtract", "-", calco_subtract, ODE_SUB, 2},
+    {"multiply", "*", calco_multiply, ODE_MUL, 2},
+    {"divide", "/", calco_divide, ODE_DIV, 2},
+    {"power", "**", (PyCFunction)(void (*)(void))calco_power, ODE_POW, 2},
+    {"hypotenuse", NULL, calco_hypotenuse, ODE_HYPOT, 2},
+    {"fused_multiply_add", NULL, calco_fused_multiply_add, ODE_FMA, 3},
+    {NULL, NULL, NULL, ODE_COPY, 0}
+};
+
+static void prog_free(ode_prog* p) {
+    PyMem_Free(p->value);
+    PyMem_Free(p->is_const);
+    PyMem_Free(p->code);
+}
+
+// Adds a constant or temporary slot. Returns its index, or -1 with an exception set.
+static int prog_slot(ode_prog* p, int is_const, double value) {
+    int k = p->nslots - p->first;
+    if (k == p->slot_cap) {
+        int cap = (p->slot_cap > 0) ? 2 * p->slot_cap : 16;
+        double* v = (double*)PyMem_Realloc(p->value, cap * sizeof(double));
+        if (v == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        p->value = v;
+        unsigned char* c = (unsigned char*)PyMem_Realloc(p->is_const, cap);
+        if (c == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        p->is_const = c;
+        p->slot_cap = cap;
+    }
+    p->value[k] = is_const ? value : NAN;
+    p->is_const[k] = (unsigned char)is_const;
+    return p->nslots++;
+}
+
+static int prog_insn(ode_prog* p, ode_opcode op, int dst, int a, int b, int c, calco_unary_fn fn) {
+    if (p->ncode == p->code_cap) {
+        int cap = (p->code_cap > 0) ? 2 * p->code_cap : 16;
+        ode_insn* code = (ode_insn*)PyMem_Realloc(p->code, cap * sizeof(ode_insn));
+        if (code == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        p->code = code;
+        p->code_cap = cap;
+    }
+    ode_insn* in = &p->code[p->ncode++];
+    in->op = op;
+    in->dst = dst;
+    in->a = a;
+    in->b = b;
+    in->c = c;
+    in->fn = fn;
+    return 0;
+}
+
+// Emits an instruction into a new temporary and returns the temporary's slot.
+static int prog_op(ode_prog* p, ode_opcode op, int a, int b, int c, calco_unary_fn fn) {
+    int dst = prog_slot(p, 0, 0.0);
+    if (dst < 0 || prog_insn(p, op, dst, a, b, c, fn) < 0) {
+        return -1;
+    }
+    return dst;
+}
+
+static int prog_is_const(const ode_prog* p, int slot, double value) {
+    return slot >= p->first && p->is_const[slot - p->first] && p->value[slot - p->first] == value;
+}
+
+// Parses 'y<k>' or 'p<k>' with k < limit. Returns k, or -1 if name is not of that form.
+static int prog_index(const char* name, char prefix, int limit) {
+    if (name[0] != prefix || name[1] == '\0') {
+        return -1;
+    }
+    long k = 0;
+    for (const char* s = name + 1; *s != '\0'; s++) {
+        if (*s < '0' || *s > '9' || k > 1000000) {
+            return -1;
+        }
+        k = 10 * k + (*s - '0');
+    }
+    return (k < limit) ? (int)k : -1;
+}
+
+static int prog_leaf(ode_prog* p, PyObject* node) {
+    if (PyFloat_Check(node) || PyLong_Check(node)) {
+        double v = PyFloat_AsDouble(node);
+        if (v == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+        return prog_slot(p, 1, v);
+    }
+    const char* name = PyUnicode_AsUTF8(node);
+    if (name == NULL) {
+        return -1;
+    }
+    if (strcmp(name, "t") == 0) {
+        return p->n;
+    }
+    int k = prog_index(name, 'y', p->n);
+    if (k >= 0) {
+        return k;
+    }
+    k = prog_index(name, 'p', p->np);
+    if (k >= 0) {
+        return p->n + 1 + k;
+    }
+    PyErr_Format(PyExc_ValueError, "unknown variable '%s' (expected 't', 'y0'..'y%d' or a parameter 'p<k>' "
+                 "within the %d parameters given)", name, p->n - 1, p->np);
+    return -1;
+}
+
+// Compiles one expression and returns the slot holding its value, or -1 with an exception set.
+static int prog_emit(ode_prog* p, PyObject* node, int depth) {
+    if (depth > ODE_MAX_DEPTH) {
+        PyErr_SetString(PyExc_ValueError, "expression is nested too deeply");
+        return -1;
+    }
+    if (!PyTuple_Check(node)) {
+        if (PyFloat_Check(node) || PyLong_Check(node) || PyUnicode_Check(node)) {
+            return prog_leaf(p, node);
+        }
+        PyErr_Format(PyExc_TypeError, "expression nodes must be numbers, variable names or tuples, not %.200s",
+                     Py_TYPE(node)->tp_name);
+        return -1;
+    }
+    Py_ssize_t nargs = PyTuple_GET_SIZE(node) - 1;
+    if (nargs < 1 || nargs > 3) {
+        PyErr_SetString(PyExc_ValueError, "an operation is a tuple (op, arg[, arg[, arg]])");
+        return -1;
+    }
+    PyObject* op = PyTuple_GET_ITEM(node, 0);
+    int found = -1;
+    calco_unary_fn fn = NULL;
+    if (PyUnicode_Check(op)) {
+        const char* name = PyUnicode_AsUTF8(op);
+        if (name == NULL) {
+            return -1;
+        }
+        for (int i = 0; ode_ops[i].name != NULL; i++) {
+            if (strcmp(name, ode_ops[i].name) == 0 || (ode_ops[i].symbol && strcmp(name, ode_ops[i].symbol) == 0)) {
+                found = i;
+                break;
+            }
+        }
+        if (found < 0 && (fn = calco_unary_kernel(name)) == NULL) {
+            PyErr_Format(PyExc_ValueError, "unknown operation '%s'", name);
+            return -1;
+        }
+    } else if (PyCFunction_Check(op)) {
+        PyCFunction meth = PyCFunction_GetFunction(op);
+        for (int i = 0; ode_ops[i].name != NULL; i++) {
+            if (meth == ode_ops[i].fn) {
+                found = i;
+                break;
+            }
+        }
+        if (found < 0) {
+            const calco_unary_entry* e = calco_lookup_unary(op);
+            if (e == NULL) {
+                return -1;
+            }
+            fn = e->kernel;
+        }
+    } else {
+        PyErr_Format(PyExc_TypeError, "operation must be a name or a calco function, not %.200s", Py_TYPE(op)->tp_name);
+        return -1;
+    }
+
+    int arg[3] = {0, 0, 0};
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        arg[i] = prog_emit(p, PyTuple_GET_ITEM(node, i + 1), depth + 1);
+        if (arg[i] < 0) {
+            return -1;
+        }
+    }
+    if (found < 0) {
+        if (nargs != 1) {
+            PyErr_Format(PyExc_ValueError, "%R takes one argument, got %zd", op, nargs);
+            return -1;
+        }
+        return prog_op(p, ODE_UNARY, arg[0], 0, 0, fn);
+    }
+    ode_opcode code = ode_ops[found].op;
+    if (code == ODE_SUB && nargs == 1) {
+        int minus_one = prog_slot(p, 1, -1.0);
+        return (minus_one < 0) ? -1 : prog_op(p, ODE_MUL, minus_one, arg[0], 0, NULL);
+    }
+    if (nargs != ode_ops[found].arity) {
+        PyErr_Format(PyExc_ValueError, "'%s' takes %d arguments, got %zd", ode_ops[found].name, ode_ops[found].arity,
+                     nargs);
+        return -1;
+    }
+    // Constant exponents 1, 2, 3 and 0.5 become multiplications and a square root.
+    if (code == ODE_POW) {
+        if (prog_is_const(p, arg[1], 1.0)) {
+            return arg[0];
+        }
+        if (prog_is_const(p, arg[1], 2.0) || prog_is_const(p, arg[1], 3.0)) {
+            int sq = prog_op(p, ODE_MUL, arg[0], arg[0], 0, NULL);
+            return (sq < 0 || prog_is_const(p, arg[1], 2.0)) ? sq : prog_op(p, ODE_MUL, sq, arg[0], 0, NULL);
+        }
+        if (prog_is_const(p, arg[1], 0.5)) {
+            return prog_op(p, ODE_UNARY, arg[0], 0, 0, sqrt);
+        }
+    }
+    return prog_op(p, code, arg[0], arg[1], arg[2], NULL);
+}
+
+// Compiles one expression per component of the system.
+static int prog_compile(ode_prog* p, PyObject* exprs, int n, int np) {
+    memset(p, 0, sizeof(*p));
+    p->n = n;
+    p->np = np;
+    p->out0 = n + 1 + np;
+    p->first = p->out0 + n;
+    p->nslots = p->first;
+    PyObject* seq = PySequence_Fast(exprs, "rhs must be callable or a sequence of n expressions");
+    if (seq == NULL) {
+        return -1;
+    }
+    if (PySequence_Fast_GET_SIZE(seq) != n) {
+        PyErr_Format(PyExc_ValueError, "rhs has %zd expressions for a system of size n = %d",
+                     PySequence_Fast_GET_SIZE(seq), n);
+        Py_DECREF(seq);
+        return -1;
+    }
+    for (int k = 0; k < n; k++) {
+        int ncode = p->ncode;
+        int s = prog_emit(p, PySequence_Fast_GET_ITEM(seq, k), 0);
+        if (s < 0) {
+            Py_DECREF(seq);
+            return -1;
+        }
+        // A fresh temporary computed last is retargeted to the output; anything else is copied.
+        if (p->ncode > ncode && p->code[p->ncode - 1].dst == s && s >= p->first) {
+            p->code[p->ncode - 1].dst = p->out0 + k;
+        } else if (prog_insn(p, ODE_COPY, p->out0 + k, s, 0, 0, NULL) < 0) {
+            Py_DECREF(seq);
+            return -1;
+        }
+    }
+    Py_DECREF(seq);
+    return 0;
+}
+
+// Runs the program over na trajectories. slot[] has room for every slot, and the constant and
+// temporary slots already point at planes of ODE_BLOCK values (constants filled in).
+static void prog_run(const ode_prog* p, double** slot, const double* t, const double* y, const double* par,
+                     double* f, Py_ssize_t na) {
+    const int n = p->n;
+    for (Py_ssize_t j0 = 0; j0 < na; j0 += ODE_BLOCK) {
+        Py_ssize_t len = (na - j0 < ODE_BLOCK) ? na - j0 : ODE_BLOCK;
+        for (int k = 0; k < n; k++) {
+            slot[k] = (double*)y + k * na + j0;
+            slot[p->out0 + k] = f + k * na + j0;
+        }
+        slot[n] = (double*)t + j0;
+        for (int q = 0; q < p->np; q++) {
+            slot[n + 1 + q] = (double*)par + q * na + j0;
+        }
+        for (int c = 0; c < p->ncode; c++) {
+            const ode_insn* in = &p->code[c];
+            double* d = slot[in->dst];
+            const double* a = slot[in->a];
+            const double* b = slot[in->b];
+            const double* e = slot[in->c];
+            Py_ssize_t i;
+            switch (in->op) {
+                case ODE_COPY: for (i = 0; i < len; i++) d[i] = a[i]; break;
+                case ODE_ADD: for (i = 0; i < len; i++) d[i] = a[i] + b[i]; break;
+                case ODE_SUB: for (i = 0; i < len; i++) d[i] = a[i] - b[i]; break;
+                case ODE_MUL: for (i = 0; i < len; i++) d[i] = a[i] * b[i]; break;
+                case ODE_DIV: for (i = 0; i < len; i++) d[i] = a[i] / b[i]; break;
+                case ODE_POW: for (i = 0; i < len; i++) d[i] = pow(a[i], b[i]); break;
+                case ODE_HYPOT: for (i = 0; i < len; i++) d[i] = hypot(a[i], b[i]); break;
+                case ODE_FMA: for (i = 0; i < len; i++) d[i] = fma(a[i], b[i], e[i]); break;
+                case ODE_UNARY: {
+                    calco_unary_fn fn = in->fn;
+                    for (i = 0; i < len; i++) d[i] = fn(a[i]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Integrator
+// -----------------------------------------------------------------------------
+
+typedef enum { ODE_RK45, ODE_RK4 } ode_method;
+
+// Dormand-Prince 5(4): nodes, stage weights (the last row is the 5th-order solution, which
+// makes the method FSAL) and the error weights b - b*.
+static const double dp_c[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
+static const double dp_a[7][6] = {
+    {0.0},
+    {1.0 / 5.0},
+    {3.0 / 40.0, 9.0 / 40.0},
+    {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+    {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+    {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+    {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0},
+};
+static const double dp_e[7] = {71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0,
+                               22.0 / 525.0, -1.0 / 40.0};
+
+// Dense output (Shampine's 4th-order interpolant, as in SciPy): with x = (t - t_old) / h,
+// y(t) = y_old + h * sum_s k_s * (P[s][0] x + P[s][1] x^2 + P[s][2] x^3 + P[s][3] x^4).
+static const double dp_p[7][4] = {
+    {1.0, -8048581381.0 / 2820520608.0, 8663915743.0 / 2820520608.0, -12715105075.0 / 11282082432.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 131558114200.0 / 32700410799.0, -68118460800.0 / 10900136933.0, 87487479700.0 / 32700410799.0},
+    {0.0, -1754552775.0 / 470086768.0, 14199869525.0 / 1410260304.0, -10690763975.0 / 1880347072.0},
+    {0.0, 127303824393.0 / 49829197408.0, -318862633887.0 / 49829197408.0, 701980252875.0 / 199316789632.0},
+    {0.0, -282668133.0 / 205662961.0, 2019193451.0 / 616988883.0, -1453857185.0 / 822651844.0},
+    {0.0, 40617522.0 / 29380423.0, -110615467.0 / 29380423.0, 69997945.0 / 29380423.0},
+};
+
+typedef struct {
+    Py_ssize_t nfev;           // Right-hand side evaluations, counted per trajectory
+    Py_ssize_t ncalls;         // Batched evaluations (Python calls for a callable rhs)
+    Py_ssize_t naccept;
+    Py_ssize_t nreject;
+} ode_stats;
+
+typedef struct {
+    int n, np;
+    ode_method method;
+    PyObject* func;            // Python rhs, or NULL when prog is set
+    const ode_prog* prog;
+    Py_ssize_t m;              // Trajectories (plane stride)
+    const double* y0;
+    const double* params;
+    double t0, t1, rtol, atol, h;
+    Py_ssize_t max_steps;
+    const double* t_eval;
+    Py_ssize_t ne;
+    double* out;               // Final states, or one full state batch per t_eval point
+    unsigned char* status;     // 0 done, 1 max_steps reached, 2 step size underflow
+    ode_stats* stats;          // One per chunk
+    int nomem;
+} ode_task;
+
+// Scratch for a range of c trajectories. Per-trajectory state is indexed by position in the
+// range; the compact arrays hold the trajectories still active in the current round.
+typedef struct {
+    Py_ssize_t c;
+    double *y, *f, *t, *h;
+    double *tc, *hc, *ts, *acc, *yc, *ys, *yn, *pc;
+    double* k[7];
+    Py_ssize_t *act, *steps, *next;
+    unsigned char* rejected;
+    double** slot;             // Expression program slots
+    double* planes;
+} ode_work;
+
+static int work_alloc(ode_work* w, const ode_task* T, Py_ssize_t c) {
+    const int n = T->n;
+    int nplanes = (T->prog != NULL) ? T->prog->nslots - T->prog->first : 0;
+    Py_ssize_t nd = (Py_ssize_t)n * c * 13 + (Py_ssize_t)T->np * c + 6 * c + (Py_ssize_t)nplanes * ODE_BLOCK;
+    memset(w, 0, sizeof(*w));
+    double* d = (double*)PyMem_RawMalloc((nd > 0 ? nd : 1) * sizeof(double));
+    Py_ssize_t* s = (Py_ssize_t*)PyMem_RawMalloc((3 * c + 1) * sizeof(Py_ssize_t));
+    unsigned char* r = (unsigned char*)PyMem_RawMalloc(c + 1);
+    double** slot = (T->prog != NULL) ? (double**)PyMem_RawMalloc(T->prog->nslots * sizeof(double*)) : NULL;
+    if (d == NULL || s == NULL || r == NULL || (T->prog != NULL && slot == NULL)) {
+        PyMem_RawFree(d);
+        PyMem_RawFree(s);
+        PyMem_RawFree(r);
+        PyMem_RawFree(slot);
+        return -1;
+    }
+    w->c = c;
+    w->y = d; d += n * c;
+    w->f = d; d += n * c;
+    w->yc = d; d += n * c;
+    w->ys = d; d += n * c;
+    w->yn = d; d += n * c;
+    for (int s7 = 0; s7 < 7; s7++) {
+        w->k[s7] = d;
+        d += n * c;
+    }
+    w->t = d; d += c;
+    w->h = d; d += c;
+    w->tc = d; d += c;
+    w->hc = d; d += c;
+    w->ts = d; d += c;
+    w->acc = d; d += c;
+    w->pc = d; d += (Py_ssize_t)T->np * c;
+    w->planes = d;
+    w->act = s;
+    w->steps = s + c;
+    w->next = s + 2 * c;
+    w->rejected = r;
+    w->slot = slot;
+    for (int q = 0; q < nplanes; q++) {
+        double* plane = w->planes + (Py_ssize_t)q * ODE_BLOCK;
+        slot[T->prog->first + q] = plane;
+        if (T->prog->is_const[q]) {
+            for (int i = 0; i < ODE_BLOCK; i++) {
+                plane[i] = T->prog->value[q];
+            }
+        }
+    }
+    return 0;
+}
+
+static void work_free(ode_work* w) {
+    PyMem_RawFree(w->y);
+    PyMem_RawFree(w->act);
+    PyMem_RawFree(w->rejected);
+    PyMem_RawFree(w->slot);
+}
+
+// Calls the Python rhs as rhs(t, y) or rhs(t, y, p) with arrays over the na active
+// trajectories. Returns 0, or -1 with an exception set.
+static int ode_call(const ode_task* T, const double* t, const double* y, const double* par, double* f,
+                    Py_ssize_t na) {
+    Py_ssize_t ny = (Py_ssize_t)T->n * na;
+    Py_buffer view;
+    PyObject* t_arr = calco_new_plain_array('d', na, &view);
+    if (t_arr == NULL) {
+        return -1;
+    }
+    memcpy(view.buf, t, na * sizeof(double));
+    PyBuffer_Release(&view);
+    PyObject* y_arr = calco_new_plain_array('d', ny, &view);
+    if (y_arr == NULL) {
+        Py_DECREF(t_arr);
+        return -1;
+    }
+    memcpy(view.buf, y, ny * sizeof(double));
+    PyBuffer_Release(&view);
+    PyObject* p_arr = NULL;
+    if (T->params != NULL) {
+        p_arr = calco_new_plain_array('d', (Py_ssize_t)T->np * na, &view);
+        if (p_arr == NULL) {
+            Py_DECREF(t_arr);
+            Py_DECREF(y_arr);
+            return -1;
+        }
+        memcpy(view.buf, par, (Py_ssize_t)T->np * na * sizeof(double));
+        PyBuffer_Release(&view);
+    }
+    PyObject* res = PyObject_CallFunctionObjArgs(T->func, t_arr, y_arr, p_arr, NULL);
+    Py_DECREF(t_arr);
+    Py_DECREF(y_arr);
+    Py_XDECREF(p_arr);
+    if (res == NULL) {
+        return -1;
+    }
+    Py_ssize_t count;
+    double* values = calco_read_doubles(res, &count);
+    Py_DECREF(res);
+    if (values == NULL) {
+        return -1;
+    }
+    if (count != ny) {
+        PyMem_Free(values);
+        PyErr_Format(PyExc_ValueError, "rhs returned %zd values for %zd trajectories of size n = %d", count, na, T->n);
+        return -1;
+    }
+    memcpy(f, values, ny * sizeof(double));
+    PyMem_Free(values);
+    return 0;
+}
+
+static int ode_eval(const ode_task* T, ode_work* w, const double* t, const double* y, double* f, Py_ssize_t na,
+                    ode_stats* st) {
+    if (na == 0) {
+        return 0;
+    }
+    st->nfev += na;
+    st->ncalls++;
+    if (T->prog != NULL) {
+        prog_run(T->prog, w->slot, t, y, w->pc, f, na);
+        return 0;
+    }
+    return ode_call(T, t, y, w->pc, f, na);
+}
+
+// ys = yc + hc * sum_{r < s} a[r] k[r] over na trajectories of n components.
+static void ode_combine(double* ys, const double* yc, const double* hc, double* const* k, const double* a, int s,
+                        int n, Py_ssize_t na) {
+    Py_ssize_t len = (Py_ssize_t)n * na;
+    for (Py_ssize_t i = 0; i < len; i++) {
+        ys[i] = a[0] * k[0][i];
+    }
+    for (int r = 1; r < s; r++) {
+        const double ar = a[r];
+        const double* kr = k[r];
+        if (ar == 0.0) {
+            continue;
+        }
+        for (Py_ssize_t i = 0; i < len; i++) {
+            ys[i] += ar * kr[i];
+        }
+    }
+    for (int q = 0; q < n; q++) {
+        double* row = ys + q * na;
+        const double* y = yc + q * na;
+        for (Py_ssize_t i = 0; i < na; i++) {
+            row[i] = y[i] + hc[i] * row[i];
+        }
+    }
+}
+
+static double rms_scaled(const double* v, const double* y, Py_ssize_t stride, int n, double atol, double rtol) {
+    double s = 0.0;
+    for (int q = 0; q < n; q++) {
+        double r = v[q * stride] / (atol + rtol * fabs(y[q * stride]));
+        s += r * r;
+    }
+    return sqrt(s / n);
+}
+
+// SciPy's select_initial_step for every trajectory of the range, using one extra evaluation.
+// Expects f at the initial states and the compact arrays set up for all c trajectories.
+static int ode_initial_step(const ode_task* T, ode_work* w, double dir, ode_stats* st) {
+    const int n = T->n;
+    const Py_ssize_t c = w->c;
+    double span = fabs(T->t1 - T->t0);
+    for (Py_ssize_t j = 0; j < c; j++) {
+        double d0 = rms_scaled(w->y + j, w->y + j, c, n, T->atol, T->rtol);
+        double d1 = rms_scaled(w->f + j, w->y + j, c, n, T->atol, T->rtol);
+        double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+        h0 = (h0 < span) ? h0 : span;
+        w->hc[j] = h0;
+        w->ts[j] = T->t0 + dir * h0;
+        for (int q = 0; q < n; q++) {
+            w->ys[q * c + j] = w->y[q * c + j] + dir * h0 * w->f[q * c + j];
+        }
+    }
+    if (ode_eval(T, w, w->ts, w->ys, w->k[1], c, st) < 0) {
+        return -1;
+    }
+    for (Py_ssize_t j = 0; j < c; j++) {
+        double h0 = w->hc[j];
+        double s = 0.0;
+        for (int q = 0; q < n; q++) {
+            double r = (w->k[1][q * c + j] - w->f[q * c + j]) / (T->atol + T->rtol * fabs(w->y[q * c + j]));
+            s += r * r;
+        }
+        double d1 = rms_scaled(w->f + j, w->y + j, c, n, T->atol, T->rtol);
+        double d2 = sqrt(s / n) / h0;
+        double big = (d1 > d2) ? d1 : d2;
+        double h1 = (big <= 1e-15) ? ((h0 * 1e-3 > 1e-6) ? h0 * 1e-3 : 1e-6) : pow(0.01 / big, 0.2);
+        double h = (100.0 * h0 < h1) ? 100.0 * h0 : h1;
+        w->h[j] = (h < span) ? h : span;
+    }
+    return 0;
+}
+
+// Writes the interpolated state of trajectory j (compact index a) at every t_eval point up to
+// t_new, and the final state when it reaches t1.
+static void ode_emit(const ode_task* T, ode_work* w, Py_ssize_t lo, Py_ssize_t j, Py_ssize_t a, Py_ssize_t na,
+                     double t_old, double t_new, double h, double dir) {
+    const int n = T->n;
+    while (w->next[j] < T->ne && dir * (T->t_eval[w->next[j]] - t_new) <= 0.0) {
+        Py_ssize_t e = w->next[j]++;
+        double x = (T->t_eval[e] - t_old) / h;
+        double* dst = T->out + (Py_ssize_t)e * n * T->m + lo + j;
+        if (T->method == ODE_RK45) {
+            double wt[7];
+            for (int s = 0; s < 7; s++) {
+                wt[s] = h * x * (dp_p[s][0] + x * (dp_p[s][1] + x * (dp_p[s][2] + x * dp_p[s][3])));
+            }
+            for (int q = 0; q < n; q++) {
+                Py_ssize_t i = q * na + a;
+                double v = w->yc[i];
+                for (int s = 0; s < 7; s++) {
+                    v += wt[s] * w->k[s][i];
+                }
+                dst[q * T->m] = v;
+            }
+        } else {
+            // Cubic Hermite between the step's end points and slopes.
+            double x2 = x * x, x3 = x2 * x;
+            double h00 = 2.0 * x3 - 3.0 * x2 + 1.0, h10 = (x3 - 2.0 * x2 + x) * h;
+            double h01 = 3.0 * x2 - 2.0 * x3, h11 = (x3 - x2) * h;
+            for (int q = 0; q < n; q++) {
+                Py_ssize_t i = q * na + a;
+                dst[q * T->m] = h00 * w->yc[i] + h10 * w->k[0][i] + h01 * w->yn[i] + h11 * w->k[4][i];
+            }
+        }
+    }
+}
+
+// Integrates trajectories [lo, lo + c). Returns 0, or -1 with an exception set (Python rhs
+// only) or on allocation failure (task nomem set).
+static int ode_range(ode_task* T, Py_ssize_t lo, Py_ssize_t c, ode_stats* st) {
+    const int n = T->n;
+    const Py_ssize_t m = T->m;
+    const double dir = (T->t1 >= T->t0) ? 1.0 : -1.0;
+    const double span = fabs(T->t1 - T->t0);
+    Py_ssize_t nfixed = 0;
+    ode_work w;
+    if (work_alloc(&w, T, c) < 0) {
+        T->nomem = 1;
+        return -1;
+    }
+    int rc = -1;
+    for (int q = 0; q < n; q++) {
+        memcpy(w.y + q * c, T->y0 + q * m + lo, c * sizeof(double));
+    }
+    for (Py_ssize_t j = 0; j < c; j++) {
+        w.t[j] = T->t0;
+        w.steps[j] = 0;
+        w.next[j] = 0;
+        w.rejected[j] = 0;
+        w.act[j] = j;
+        T->status[lo + j] = 0;
+        // t_eval points at t0 come before any step.
+        while (w.next[j] < T->ne && T->t_eval[w.next[j]] == T->t0) {
+            double* dst = T->out + w.next[j]++ * n * m + lo + j;
+            for (int q = 0; q < n; q++) {
+                dst[q * m] = w.y[q * c + j];
+            }
+        }
+    }
+    Py_ssize_t na = (span > 0.0) ? c : 0;
+    if (na > 0) {
+        for (int q = 0; q < T->np; q++) {
+            memcpy(w.pc + q * c, T->params + q * m + lo, c * sizeof(double));
+        }
+        if (ode_eval(T, &w, w.t, w.y, w.f, c, st) < 0) {
+            goto done;
+        }
+        if (T->method == ODE_RK4) {
+            nfixed = (Py_ssize_t)ceil(span / T->h);
+            nfixed = (nfixed > 0) ? nfixed : 1;
+        } else if (T->h > 0.0) {
+            for (Py_ssize_t j = 0; j < c; j++) {
+                w.h[j] = (T->h < span) ? T->h : span;
+            }
+        } else if (ode_initial_step(T, &w, dir, st) < 0) {
+            goto done;
+        }
+    }
+
+    while (na > 0) {
+        // Gather the active trajectories.
+        for (Py_ssize_t a = 0; a < na; a++) {
+            Py_ssize_t j = w.act[a];
+            double rem = fabs(T->t1 - w.t[j]);
+            double hh = (T->method == ODE_RK4) ? ((w.steps[j] + 1 == nfixed) ? rem : span / nfixed)
+                                               : ((w.h[j] < rem) ? w.h[j] : rem);
+            w.tc[a] = w.t[j];
+            w.hc[a] = dir * hh;
+            for (int q = 0; q < n; q++) {
+                w.yc[q * na + a] = w.y[q * c + j];
+                w.k[0][q * na + a] = w.f[q * c + j];
+            }
+            for (int q = 0; q < T->np; q++) {
+                w.pc[q * na + a] = T->params[q * m + lo + j];
+            }
+        }
+
+        if (T->method == ODE_RK45) {
+            for (int s = 1; s < 7; s++) {
+                ode_combine(s < 6 ? w.ys : w.yn, w.yc, w.hc, w.k, dp_a[s], s, n, na);
+                for (Py_ssize_t a = 0; a < na; a++) {
+                    w.ts[a] = w.tc[a] + dp_c[s] * w.hc[a];
+                }
+                if (ode_eval(T, &w, w.ts, s < 6 ? w.ys : w.yn, w.k[s], na, st) < 0) {
+                    goto done;
+                }
+            }
+            // Scaled RMS of the embedded error estimate.
+            ode_combine(w.ys, w.yc, w.hc, w.k, dp_e, 7, n, na);
+            for (Py_ssize_t a = 0; a < na; a++) {
+                w.acc[a] = 0.0;
+            }
+            for (int q = 0; q < n; q++) {
+                const double* ye = w.ys + q * na;
+                const double* y = w.yc + q * na;
+                const double* yn = w.yn + q * na;
+                for (Py_ssize_t a = 0; a < na; a++) {
+                    double big = (fabs(y[a]) > fabs(yn[a])) ? fabs(y[a]) : fabs(yn[a]);
+                    double r = (ye[a] - y[a]) / (T->atol + T->rtol * big);
+                    w.acc[a] += r * r;
+                }
+            }
+        } else {
+            // k[0..3] are the RK4 stages; k[4] is the slope at the new state.
+            static const double rk4_a[4][3] = {{0.0}, {0.5}, {0.0, 0.5}, {0.0, 0.0, 1.0}};
+            static const double rk4_c[4] = {0.0, 0.5, 0.5, 1.0};
+            static const double rk4_b[4] = {1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0};
+            for (int s = 1; s < 4; s++) {
+                ode_combine(w.ys, w.yc, w.hc, w.k, rk4_a[s], s, n, na);
+                for (Py_ssize_t a = 0; a < na; a++) {
+                    w.ts[a] = w.tc[a] + rk4_c[s] * w.hc[a];
+                }
+                if (ode_eval(T, &w, w.ts, w.ys, w.k[s], na, st) < 0) {
+                    goto done;
+                }
+            }
+            ode_combine(w.yn, w.yc, w.hc, w.k, rk4_b, 4, n, na);
+            for (Py_ssize_t a = 0; a < na; a++) {
+                w.ts[a] = w.tc[a] + w.hc[a];
+            }
+            if (ode_eval(T, &w, w.ts, w.yn, w.k[4], na, st) < 0) {
+                goto done;
+            }
+        }
+
+        // Accept or reject each step, then rebuild the active list.
+        Py_ssize_t kept = 0;
+        for (Py_ssize_t a = 0; a < na; a++) {
+            Py_ssize_t j = w.act[a];
+            double h = w.hc[a];
+            double t_old = w.tc[a];
+            int last;
+            if (T->method == ODE_RK45) {
+                double err = sqrt(w.acc[a] / n);
+                if (!(calco_isfinite(err) && err <= 1.0)) {
+                    double factor = calco_isfinite(err) ? 0.9 * pow(err, -0.2) : 0.2;
+                    w.h[j] = fabs(h) * ((factor > 0.2) ? factor : 0.2);
+                    w.rejected[j] = 1;
+                    st->nreject++;
+                    if (!(w.h[j] > 16.0 * DBL_EPSILON * fabs(t_old)) || w.h[j] == 0.0) {
+                        T->status[lo + j] = 2;
+                    } else {
+                        w.act[kept++] = j;
+                    }
+                    continue;
+                }
+                double factor = (err == 0.0) ? 10.0 : 0.9 * pow(err, -0.2);
+                factor = (factor < 10.0) ? factor : 10.0;
+                if (w.rejected[j]) {
+                    factor = (factor < 1.0) ? factor : 1.0;
+                }
+                w.rejected[j] = 0;
+                last = (fabs(h) >= fabs(T->t1 - t_old));
+                if (!last) {
+                    w.h[j] = fabs(h) * factor;
+                }
+            } else {
+                last = (w.steps[j] + 1 == nfixed);
+            }
+            double t_new = last ? T->t1
+                                : (T->method == ODE_RK4) ? T->t0 + dir * (span / nfixed) * (double)(w.steps[j] + 1)
+                                                         : t_old + h;
+            st->naccept++;
+            ode_emit(T, &w, lo, j, a, na, t_old, t_new, h, dir);
+            for (int q = 0; q < n; q++) {
+                w.y[q * c + j] = w.yn[q * na + a];
+                w.f[q * c + j] = w.k[T->method == ODE_RK45 ? 6 : 4][q * na + a];
+            }
+            w.t[j] = t_new;
+            w.steps[j]++;
+            if (last) {
+                continue;
+            }
+            if (w.steps[j] >= T->max_steps) {
+                T->status[lo + j] = 1;
+            } else {
+                w.act[kept++] = j;
+            }
+        }
+        na = kept;
+    }
+
+    // Final states, and NaN for whatever a stopped trajectory did not reach.
+    for (Py_ssize_t j = 0; j < c; j++) {
+        int ok = (T->status[lo + j] == 0);
+        if (T->ne == 0) {
+            for (int q = 0; q < n; q++) {
+                T->out[q * m + lo + j] = ok ? w.y[q * c + j] : NAN;
+            }
+        }
+        for (Py_ssize_t e = w.next[j]; e < T->ne; e++) {
+            for (int q = 0; q < n; q++) {
+                T->out[(e * n + q) * m + lo + j] = NAN;
+            }
+        }
+    }
+    rc = 0;
+done:
+    work_free(&w);
+    return rc;
+}
+
+static void ode_chunk(void* ctx, Py_ssize_t chunk) {
+    ode_task* T = (ode_task*)ctx;
+    Py_ssize_t lo = chunk * ODE_CHUNK;
+    Py_ssize_t c = (T->m - lo < ODE_CHUNK) ? T->m - lo : ODE_CHUNK;
+    ode_range(T, lo, c, &T->stats[chunk]);
+}
+
+// -----------------------------------------------------------------------------
+// calco.odeint_batch
+// -----------------------------------------------------------------------------
+
+PyObject* calco_odeint_batch(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"rhs", "y0", "t_span", "n", "method", "rtol", "atol", "h", "max_steps", "t_eval",
+                             "params", "out", "full_output", NULL};
+    PyObject *rhs, *y0_obj, *t_eval_obj = Py_None, *params_obj = Py_None, *out = Py_None;
+    const char* method = "rk45";
+    int n, full_output = 0;
+    ode_task task;
+    memset(&task, 0, sizeof(task));
+    task.rtol = 1e-3;
+    task.atol = 1e-6;
+    task.max_steps = 100000;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO(dd)i|$sdddnOOOp", kwlist, &rhs, &y0_obj, &task.t0, &task.t1,
+                                     &n, &method, &task.rtol, &task.atol, &task.h, &task.max_steps, &t_eval_obj,
+                                     &params_obj, &out, &full_output)) {
+        return NULL;
+    }
+    if (strcmp(method, "rk45") == 0) {
+        task.method = ODE_RK45;
+    } else if (strcmp(method, "rk4") == 0) {
+        task.method = ODE_RK4;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown method '%s' (expected 'rk45' or 'rk4')", method);
+        return NULL;
+    }
+    if (n < 1) {
+        PyErr_SetString(PyExc_ValueError, "system size n must be at least 1");
+        return NULL;
+    }
+    if (!calco_isfinite(task.t0) || !calco_isfinite(task.t1)) {
+        PyErr_SetString(PyExc_ValueError, "t_span must be finite");
+        return NULL;
+    }
+    if (task.method == ODE_RK4 && !(task.h > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "method 'rk4' needs a step size h > 0");
+        return NULL;
+    }
+    if (!(task.rtol >= 0.0) || !(task.atol >= 0.0) || task.rtol + task.atol <= 0.0 || task.max_steps < 1) {
+        PyErr_SetString(PyExc_ValueError, "rtol and atol must be non-negative (not both zero) and max_steps positive");
+        return NULL;
+    }
+
+    Py_buffer y0_view, p_view, out_view, status_view;
+    PyObject *out_obj = NULL, *status = NULL, *result = NULL;
+    double* t_eval = NULL;
+    ode_prog prog;
+    int have_params = 0, have_prog = 0, have_out = 0;
+    memset(&prog, 0, sizeof(prog));
+    if (calco_get_double_buffer(y0_obj, &y0_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t len = y0_view.len / (Py_ssize_t)sizeof(double);
+    if (len % n != 0) {
+        PyErr_Format(PyExc_ValueError, "y0 length %zd is not a multiple of n = %d", len, n);
+        goto done;
+    }
+    task.n = n;
+    task.m = len / n;
+    task.y0 = (const double*)y0_view.buf;
+    if (params_obj != Py_None) {
+        if (calco_get_double_buffer(params_obj, &p_view, 0) < 0) {
+            goto done;
+        }
+        have_params = 1;
+        Py_ssize_t plen = p_view.len / (Py_ssize_t)sizeof(double);
+        if (task.m > 0 && plen % task.m != 0) {
+            PyErr_Format(PyExc_ValueError, "params length %zd is not a multiple of the %zd trajectories", plen, task.m);
+            goto done;
+        }
+        task.np = (task.m > 0) ? (int)(plen / task.m) : 0;
+        task.params = (const double*)p_view.buf;
+    }
+    if (t_eval_obj != Py_None) {
+        t_eval = calco_read_doubles(t_eval_obj, &task.ne);
+        if (t_eval == NULL) {
+            goto done;
+        }
+        double dir = (task.t1 >= task.t0) ? 1.0 : -1.0;
+        for (Py_ssize_t e = 0; e < task.ne; e++) {
+            double prev = (e > 0) ? t_eval[e - 1] : task.t0;
+            if (!(dir * (t_eval[e] - prev) >= 0.0) || !(dir * (task.t1 - t_eval[e]) >= 0.0)) {
+                PyErr_SetString(PyExc_ValueError, "t_eval must be sorted in the direction of integration and lie "
+                                "within t_span");
+                goto done;
+            }
+        }
+        task.t_eval = t_eval;
+    }
+    if (PyCallable_Check(rhs)) {
+        task.func = rhs;
+    } else {
+        have_prog = 1;
+        if (prog_compile(&prog, rhs, n, task.np) < 0) {
+            goto done;
+        }
+        task.prog = &prog;
+    }
+    Py_ssize_t nout = (task.ne > 0) ? task.ne * n * task.m : n * task.m;
+    if (calco_get_out_buffer(out, nout, &out_view, &out_obj) < 0) {
+        goto done;
+    }
+    have_out = 1;
+    task.out = (double*)out_view.buf;
+    status = calco_new_array('B', task.m, &status_view);
+    if (status == NULL) {
+        goto done;
+    }
+    task.status = (unsigned char*)status_view.buf;
+
+    Py_ssize_t nchunks = (task.func != NULL) ? 1 : (task.m + ODE_CHUNK - 1) / ODE_CHUNK;
+    task.stats = (ode_stats*)PyMem_Calloc(nchunks > 0 ? nchunks : 1, sizeof(ode_stats));
+    if (task.stats == NULL) {
+        PyErr_NoMemory();
+        PyBuffer_Release(&status_view);
+        goto done;
+    }
+    int rc = 0;
+    if (task.func != NULL) {
+        // A Python rhs needs the GIL for every stage, so the whole batch runs as one range.
+        rc = (task.m > 0) ? ode_range(&task, 0, task.m, &task.stats[0]) : 0;
+    } else {
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_parallel_for(ode_chunk, &task, nchunks);
+        Py_END_ALLOW_THREADS
+    }
+    PyBuffer_Release(&status_view);
+    if (task.nomem) {
+        PyErr_NoMemory();
+    }
+    if (rc < 0 || task.nomem) {
+        PyMem_Free(task.stats);
+        goto done;
+    }
+    ode_stats total = {0, 0, 0, 0};
+    for (Py_ssize_t i = 0; i < nchunks; i++) {
+        total.nfev += task.stats[i].nfev;
+        total.ncalls += task.stats[i].ncalls;
+        total.naccept += task.stats[i].naccept;
+        total.nreject += task.stats[i].nreject;
+    }
+    PyMem_Free(task.stats);
+    Py_ssize_t stopped = 0;
+    for (Py_ssize_t i = 0; i < task.m; i++) {
+        stopped += (task.status[i] != 0);
+    }
+    if (stopped > 0 && PyErr_WarnFormat(PyExc_RuntimeWarning, 1,
+                                        "odeint_batch: %zd of %zd trajectories stopped before t1 (max_steps "
+                                        "reached or step size underflow); their outputs are NaN", stopped,
+                                        task.m) < 0) {
+        goto done;
+    }
+    if (!full_output) {
+        result = out_obj;
+        out_obj = NULL;
+        goto done;
+    }
+    result = Py_BuildValue("(O{s:n,s:n,s:n,s:n,s:O,s:O})", out_obj, "nfev", total.nfev, "ncalls", total.ncalls,
+                           "naccept", total.naccept, "nreject", total.nreject, "status", status, "success",
+                           stopped ? Py_False : Py_True);
+done:
+    if (have_out) {
+        PyBuffer_Release(&out_view);
+    }
+    Py_XDECREF(out_obj);
+    Py_XDECREF(status);
+    if (have_prog) {
+        prog_free(&prog);
+    }
+    if (have_params) {
+        PyBuffer_Release(&p_view);
+    }
+    PyMem_Free(t_eval);
+    PyBuffer_Release(&y0_view);
+    return result;
+}
@@ -0,0 +1,449 @@
+// calco_poly.c
+// Contains polynomial and rational-function evaluation (polyval, ratval, polyval_many) and the
+// calco.Polynomial type with pre-packed coefficients.
+
+#include "calco.h"     // Include the main header for prototypes and definitions
+#include "calco_eft.h" // Error-free transformations for compensated Horner
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Packed Coefficients
+// Coefficients are taken highest degree first (as numpy.polyval) and stored lowest first,
+// zero-padded to a multiple of ESTRIN_GROUP so the Estrin path never needs a tail case.
+// -----------------------------------------------------------------------------
+
+#define LANES 8         // Query points evaluated together; the lane loops vectorize
+#define ESTRIN_GROUP 8  // Coefficients combined by one Estrin tree
+#define ESTRIN_MIN 8    // Lowest degree evaluated with Estrin instead of Horner
+
+typedef struct {
+    Py_ssize_t degree; // -1 for the zero polynomial
+    double* c;         // c[j] multiplies x^j; padded length is a multiple of ESTRIN_GROUP
+} poly_t;
+
+// Packs n highest-first coefficients. Returns 0, or -1 with MemoryError set.
+static int poly_pack(poly_t* p, const double* coeffs, Py_ssize_t n) {
+    Py_ssize_t padded = ((n + ESTRIN_GROUP - 1) / ESTRIN_GROUP) * ESTRIN_GROUP;
+    p->degree = n - 1;
+    p->c = (double*)PyMem_Calloc(padded > 0 ? padded : 1, sizeof(double));
+    if (p->c == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t j = 0; j < n; j++) {
+        p->c[j] = coeffs[n - 1 - j];
+    }
+    return 0;
+}
+
+// Reads highest-first coefficients from a buffer or sequence and packs them.
+static int poly_read(poly_t* p, PyObject* obj) {
+    Py_ssize_t n;
+    double* coeffs = calco_read_doubles(obj, &n);
+    if (coeffs == NULL) {
+        return -1;
+    }
+    int rc = poly_pack(p, coeffs, n);
+    PyMem_Free(coeffs);
+    return rc;
+}
+
+static void poly_free(poly_t* p) {
+    PyMem_Free(p->c);
+    p->c = NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Evaluation Schemes
+// Horner has the fewest operations but one long dependency chain; Estrin evaluates groups of
+// eight coefficients as independent trees (depth 3) joined by Horner in x^8, trading a few
+// multiplications for instruction-level parallelism on long polynomials. Both run LANES query
+// points at once so the compiler can keep several vectors in flight.
+// -----------------------------------------------------------------------------
+
+static inline void horner_lanes(const poly_t* p, const double* x, double* r) {
+    const double* c = p->c;
+    double acc[LANES];
+    for (int l = 0; l < LANES; l++) {
+        acc[l] = c[p->degree];
+    }
+    for (Py_ssize_t j = p->degree - 1; j >= 0; j--) {
+        double cj = c[j];
+        for (int l = 0; l < LANES; l++) {
+            acc[l] = acc[l] * x[l] + cj;
+        }
+    }
+    memcpy(r, acc, sizeof(acc));
+}
+
+static inline void estrin_lanes(const poly_t* p, const double* x, double* r) {
+    double x2[LANES], x4[LANES], x8[LANES], acc[LANES];
+    for (int l = 0; l < LANES; l++) {
+        x2[l] = x[l] * x[l];
+        x4[l] = x2[l] * x2[l];
+        x8[l] = x4[l] * x4[l];
+        acc[l] = 0.0;
+    }
+    for (Py_ssize_t g = p->degree / ESTRIN_GROUP; g >= 0; g--) {
+        const double* c = p->c + g * ESTRIN_GROUP;
+        for (int l = 0; l < LANES; l++) {
+            double p01 = c[0] + c[1] * x[l];
+            double p23 = c[2] + c[3] * x[l];
+            double p45 = c[4] + c[5] * x[l];
+            double p67 = c[6] + c[7] * x[l];
+            double q0 = p01 + p23 * x2[l];
+            double q1 = p45 + p67 * x2[l];
+            acc[l] = acc[l] * x8[l] + (q0 + q1 * x4[l]);
+        }
+    }
+    memcpy(r, acc, sizeof(acc));
+}
+
+// Compensated Horner (Graillat, Langlois & Louvet 2005): as accurate as Horner in twice the
+// working precision, i.e. the error bound no longer grows with the condition number until
+// it exceeds about 1/eps.
+static double horner_compensated(const poly_t* p, double x) {
+    const double* c = p->c;
+    double s = c[p->degree], e = 0.0;
+    for (Py_ssize_t j = p->degree - 1; j >= 0; j--) {
+        double pi, sigma;
+        double prod = calco_two_prod(s, x, &pi);
+        s = calco_two_sum(prod, c[j], &sigma);
+        e = e * x + (pi + sigma);
+    }
+    return s + e;
+}
+
+static inline void poly_lanes(const poly_t* p, const double* x, double* r, int compensated) {
+    if (p->degree < 0) {
+        memset(r, 0, LANES * sizeof(double));
+    } else if (compensated) {
+        for (int l = 0; l < LANES; l++) {
+            r[l] = horner_compensated(p, x[l]);
+        }
+    } else if (p->degree >= ESTRIN_MIN) {
+        estrin_lanes(p, x, r);
+    } else {
+        horner_lanes(p, x, r);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Buffer Evaluation
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    const poly_t* num;
+    const poly_t* den; // NULL for a plain polynomial
+    int compensated;
+    const double* in;
+    double* out;
+    Py_ssize_t n;
+} poly_task;
+
+// Evaluates elements [start, end); the tail is padded to a full lane block so every element,
+// including a lone scalar, goes through exactly the same arithmetic.
+static void poly_range(const poly_task* t, Py_ssize_t start, Py_ssize_t end) {
+    double xs[LANES], num[LANES], den[LANES];
+    for (Py_ssize_t i = start; i < end; i += LANES) {
+        Py_ssize_t len = (end - i < LANES) ? end - i : LANES;
+        const double* x = t->in + i;
+        if (len < LANES) {
+            memset(xs, 0, sizeof(xs));
+            memcpy(xs, x, len * sizeof(double));
+            x = xs;
+        }
+        poly_lanes(t->num, x, num, t->compensated);
+        if (t->den != NULL) {
+            poly_lanes(t->den, x, den, t->compensated);
+            for (int l = 0; l < LANES; l++) {
+                num[l] /= den[l];
+            }
+        }
+        memcpy(t->out + i, num, len * sizeof(double));
+    }
+}
+
+static void poly_chunk(void* ctx, Py_ssize_t chunk) {
+    const poly_task* t = (const poly_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = start + CALCO_DEFAULT_CHUNK;
+    poly_range(t, start, (end > t->n) ? t->n : end);
+}
+
+// Evaluates num (or num/den) at a float, returning a float, or at every element of a float64
+// buffer, returning `out` or a new array.
+static PyObject* poly_call(const poly_t* num, const poly_t* den, PyObject* x, PyObject* out, int compensated) {
+    Py_buffer in_view, out_view;
+    PyObject* out_obj;
+    poly_task task = {num, den, compensated, NULL, NULL, 0};
+    if (PyFloat_Check(x) || PyLong_Check(x)) {
+        double q = PyFloat_AsDouble(x), y;
+        if (q == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        task.in = &q;
+        task.out = &y;
+        task.n = 1;
+        poly_range(&task, 0, 1);
+        return Py_BuildValue("d", y);
+    }
+    if (calco_get_double_buffer(x, &in_view, 0) < 0) {
+        return NULL;
+    }
+    task.n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, task.n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    task.in = (const double*)in_view.buf;
+    task.out = (double*)out_view.buf;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(poly_chunk, &task, (task.n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// Module Functions
+// -----------------------------------------------------------------------------
+
+PyObject* calco_polyval(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"coeffs", "x", "out", "compensated", NULL};
+    PyObject *coeffs, *x, *out = Py_None;
+    int compensated = 0;
+    poly_t p;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$p", kwlist, &coeffs, &x, &out, &compensated)) {
+        return NULL;
+    }
+    if (poly_read(&p, coeffs) < 0) {
+        return NULL;
+    }
+    PyObject* result = poly_call(&p, NULL, x, out, compensated);
+    poly_free(&p);
+    return result;
+}
+
+PyObject* calco_ratval(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"num", "den", "x", "out", "compensated", NULL};
+    PyObject *num_obj, *den_obj, *x, *out = Py_None;
+    int compensated = 0;
+    poly_t num, den;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|O$p", kwlist, &num_obj, &den_obj, &x, &out, &compensated)) {
+        return NULL;
+    }
+    if (poly_read(&num, num_obj) < 0) {
+        return NULL;
+    }
+    if (poly_read(&den, den_obj) < 0) {
+        poly_free(&num);
+        return NULL;
+    }
+    PyObject* result = NULL;
+    if (den.degree < 0) {
+        PyErr_SetString(PyExc_ValueError, "denominator must have at least one coefficient");
+    } else {
+        result = poly_call(&num, &den, x, out, compensated);
+    }
+    poly_free(&num);
+    poly_free(&den);
+    return result;
+}
+
+// Many polynomials of one degree at a single point: each lane runs Horner on its own row.
+typedef struct {
+    const double* coeffs; // Rows of degree + 1 coefficients, highest first
+    Py_ssize_t degree;
+    Py_ssize_t rows;
+    double x;
+    double* out;
+} many_task;
+
+#define MANY_CHUNK 8192
+
+static void many_chunk(void* ctx, Py_ssize_t chunk) {
+    const many_task* t = (const many_task*)ctx;
+    Py_ssize_t stride = t->degree + 1;
+    Py_ssize_t end = (chunk + 1) * MANY_CHUNK;
+    end = (end > t->rows) ? t->rows : end;
+    Py_ssize_t r = chunk * MANY_CHUNK;
+    for (; r + LANES <= end; r += LANES) {
+        const double* row = t->coeffs + r * stride;
+        double acc[LANES];
+        for (int l = 0; l < LANES; l++) {
+            acc[l] = row[l * stride];
+        }
+        for (Py_ssize_t j = 1; j < stride; j++) {
+            for (int l = 0; l < LANES; l++) {
+                acc[l] = acc[l] * t->x + row[l * stride + j];
+            }
+        }
+        memcpy(t->out + r, acc, sizeof(acc));
+    }
+    for (; r < end; r++) {
+        const double* row = t->coeffs + r * stride;
+        double acc = row[0];
+        for (Py_ssize_t j = 1; j < stride; j++) {
+            acc = acc * t->x + row[j];
+        }
+        t->out[r] = acc;
+    }
+}
+
+PyObject* calco_polyval_many(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"coeffs", "degree", "x", "out", NULL};
+    PyObject *coeffs, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    Py_ssize_t degree;
+    double x;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Ond|O", kwlist, &coeffs, &degree, &x, &out)) {
+        return NULL;
+    }
+    if (degree < 0) {
+        PyErr_SetString(PyExc_ValueError, "degree must be >= 0");
+        return NULL;
+    }
+    if (calco_get_double_buffer(coeffs, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t total = in_view.len / (Py_ssize_t)sizeof(double);
+    if (total % (degree + 1) != 0) {
+        PyBuffer_Release(&in_view);
+        PyErr_SetString(PyExc_ValueError, "coeffs length must be a multiple of degree + 1");
+        return NULL;
+    }
+    many_task task = {(const double*)in_view.buf, degree, total / (degree + 1), x, NULL};
+    if (calco_get_out_buffer(out, task.rows, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    task.out = (double*)out_view.buf;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(many_chunk, &task, (task.rows + MANY_CHUNK - 1) / MANY_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// calco.Polynomial
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    poly_t poly;
+} CalcoPolynomial;
+
+static int polynomial_init(CalcoPolynomial* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"coeffs", NULL};
+    PyObject* coeffs;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &coeffs)) {
+        return -1;
+    }
+    // Coefficients are read without the GIL during evaluation, so they are never replaced.
+    if (self->poly.c != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Polynomial is already initialized");
+        return -1;
+    }
+    return poly_read(&self->poly, coeffs);
+}
+
+static void polynomial_dealloc(CalcoPolynomial* self) {
+    poly_free(&self->poly);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int polynomial_ready(CalcoPolynomial* self) {
+    if (self->poly.c == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Polynomial is not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* polynomial_call(CalcoPolynomial* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "out", "compensated", NULL};
+    PyObject *x, *out = Py_None;
+    int compensated = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$p", kwlist, &x, &out, &compensated)) {
+        return NULL;
+    }
+    if (polynomial_ready(self) < 0) {
+        return NULL;
+    }
+    return poly_call(&self->poly, NULL, x, out, compensated);
+}
+
+static PyObject* polynomial_derivative(CalcoPolynomial* self, PyObject* args) {
+    if (polynomial_ready(self) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = (self->poly.degree > 0) ? self->poly.degree : 0;
+    double* coeffs = (double*)PyMem_Malloc((n > 0 ? n : 1) * sizeof(double));
+    if (coeffs == NULL) {
+        return PyErr_NoMemory();
+    }
+    for (Py_ssize_t j = 0; j < n; j++) {
+        coeffs[n - 1 - j] = (double)(j + 1) * self->poly.c[j + 1];
+    }
+    CalcoPolynomial* d = PyObject_New(CalcoPolynomial, Py_TYPE(self));
+    if (d != NULL && poly_pack(&d->poly, coeffs, n) < 0) {
+        d->poly.c = NULL;
+        Py_CLEAR(d);
+    }
+    PyMem_Free(coeffs);
+    return (PyObject*)d;
+}
+
+static PyObject* polynomial_get_degree(CalcoPolynomial* self, void* closure) {
+    return PyLong_FromSsize_t(self->poly.degree);
+}
+
+static PyObject* polynomial_get_coeffs(CalcoPolynomial* self, void* closure) {
+    if (polynomial_ready(self) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = self->poly.degree + 1;
+    PyObject* t = PyTuple_New(n);
+    for (Py_ssize_t j = 0; t != NULL && j < n; j++) {
+        PyObject* v = PyFloat_FromDouble(self->poly.c[n - 1 - j]);
+        if (v == NULL) {
+            Py_CLEAR(t);
+            break;
+        }
+        PyTuple_SET_ITEM(t, j, v);
+    }
+    return t;
+}
+
+CALCO_WORKSPACE_SHIM(polynomial_call) // workspace= (calco_workspace.c)
+
+static PyMethodDef polynomial_methods[] = {
+    {"derivative", (PyCFunction)polynomial_derivative, METH_NOARGS, "Returns the derivative as a new Polynomial."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef polynomial_getset[] = {
+    {"degree", (getter)polynomial_get_degree, NULL, "Degree (-1 for the zero polynomial).", NULL},
+    {"coeffs", (getter)polynomial_get_coeffs, NULL, "Coefficients, highest degree first.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+PyTypeObject CalcoPolynomialType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.Polynomial",
+    .tp_basicsize = sizeof(CalcoPolynomial),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Polynomial(coeffs): Polynomial with coefficients given highest degree first. Call it with a float "
+              "or a float64 buffer (optional out=, compensated=False); Horner or Estrin is chosen by degree.",
+    .tp_methods = polynomial_methods,
+    .tp_getset = polynomial_getset,
+    .tp_init = (initproc)polynomial_init,
+    .tp_call = (ternaryfunc)polynomial_call_ws,
+    .tp_dealloc = (destructor)polynomial_dealloc,
+    .tp_new = PyType_GenericNew,
+};
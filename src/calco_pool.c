@@ -0,0 +1,721 @@
+// calco_pool.c
+// Contains the native worker pool, the asynchronous offload API (calco.submit / calco.Future)
+// and the synchronous buffer API (calco.apply).
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_threads.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#endif
+
+// -----------------------------------------------------------------------------
+// Worker Pool
+// Jobs are split into chunks. Workers always take chunks from the job at the head of
+// the queue, so a large job is spread across every thread before the next one starts.
+// -----------------------------------------------------------------------------
+
+static struct {
+    calco_mutex_t lock;
+    calco_cond_t work;      // Signalled when a job is queued or the thread target changes
+    calco_cond_t done;      // Broadcast when a job finishes
+    calco_job* head;
+    calco_job* tail;
+    int initialized;
+    int nthreads;           // Running worker threads
+    int target;             // Requested worker threads (0 = not configured yet)
+    Py_ssize_t pending;     // Queued or running jobs
+    Py_ssize_t max_pending; // Backpressure limit for calco_pool_submit
+} pool;
+
+// Called once from PyInit_calco. Workers are only started when the first job arrives.
+void calco_pool_init(void) {
+    if (!pool.initialized) {
+        calco_mutex_init(&pool.lock);
+        calco_cond_init(&pool.work);
+        calco_cond_init(&pool.done);
+        pool.max_pending = 64;
+        pool.initialized = 1;
+    }
+}
+
+void calco_pool_lock(void) {
+    calco_mutex_lock(&pool.lock);
+}
+
+void calco_pool_unlock(void) {
+    calco_mutex_unlock(&pool.lock);
+}
+
+// Removes a job from the queue. Pool lock must be held.
+static void pool_unlink(calco_job* job) {
+    calco_job* prev = NULL;
+    calco_job* cur = pool.head;
+    while (cur != NULL && cur != job) {
+        prev = cur;
+        cur = cur->link;
+    }
+    if (cur == NULL) {
+        return;
+    }
+    if (prev == NULL) {
+        pool.head = cur->link;
+    } else {
+        prev->link = cur->link;
+    }
+    if (pool.tail == cur) {
+        pool.tail = prev;
+    }
+    cur->link = NULL;
+}
+
+// Marks a job as finished. Pool lock must be held; the job must have no running chunks.
+static void pool_finish(calco_job* job) {
+    if (job->finished) {
+        return;
+    }
+    if (job->on_finish != NULL) {
+        job->on_finish(job);
+    }
+    job->finished = 1;
+    pool.pending--;
+    calco_cond_broadcast(&pool.done);
+}
+
+// Claims the next chunk of a job, or returns -1 if none is left. Pool lock must be held.
+static Py_ssize_t pool_claim(calco_job* job) {
+    if (job->cancelled || job->next >= job->nchunks) {
+        return -1;
+    }
+    Py_ssize_t c = job->next++;
+    job->running++;
+    if (job->next >= job->nchunks) {
+        pool_unlink(job);
+    }
+    return c;
+}
+
+// Runs one claimed chunk with the lock released and finishes the job if it was the last one.
+// Pool lock must be held on entry and is held on return.
+static void pool_run_chunk(calco_job* job, Py_ssize_t c) {
+    calco_mutex_unlock(&pool.lock);
+    job->fn(job->ctx, c);
+    calco_mutex_lock(&pool.lock);
+    job->running--;
+    if (job->running == 0 && (job->cancelled || job->next >= job->nchunks)) {
+        pool_finish(job);
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall pool_worker(void* arg)
+#else
+static void* pool_worker(void* arg)
+#endif
+{
+    (void)arg;
+    calco_mutex_lock(&pool.lock);
+    for (;;) {
+        while (pool.head == NULL && pool.nthreads <= pool.target) {
+            calco_cond_wait(&pool.work, &pool.lock);
+        }
+        if (pool.nthreads > pool.target) {
+            pool.nthreads--;
+            break;
+        }
+        calco_job* job = pool.head;
+        Py_ssize_t c = pool_claim(job);
+        if (c < 0) {
+            // Cancelled while queued: drop it, finishing it if nobody else is running it.
+            pool_unlink(job);
+            if (job->running == 0) {
+                pool_finish(job);
+            }
+            continue;
+        }
+        pool_run_chunk(job, c);
+    }
+    calco_mutex_unlock(&pool.lock);
+    return 0;
+}
+
+// Starts workers until nthreads reaches target. Pool lock must be held.
+static void pool_spawn(void) {
+    if (pool.target == 0) {
+        pool.target = calco_cpu_count();
+    }
+    while (pool.nthreads < pool.target) {
+#ifdef _WIN32
+        HANDLE h = (HANDLE)_beginthreadex(NULL, 0, pool_worker, NULL, 0, NULL);
+        if (h == 0) {
+            break;
+        }
+        CloseHandle(h);
+#else
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, pool_worker, NULL) != 0) {
+            break;
+        }
+        pthread_detach(tid);
+#endif
+        pool.nthreads++;
+    }
+}
+
+// Runs fn(ctx, 0..nchunks-1) on the pool and the calling thread, returning when all are done.
+void calco_pool_parallel_for(calco_chunk_fn fn, void* ctx, Py_ssize_t nchunks) {
+    if (nchunks <= 1) {
+        if (nchunks == 1) {
+            fn(ctx, 0);
+        }
+        return;
+    }
+    calco_job job = {fn, ctx, nchunks, 0, 0, 0, 0, NULL, NULL};
+    calco_mutex_lock(&pool.lock);
+    pool_spawn();
+    // Synchronous jobs go to the front: their caller is already blocked on them.
+    job.link = pool.head;
+    pool.head = &job;
+    if (pool.tail == NULL) {
+        pool.tail = &job;
+    }
+    pool.pending++;
+    calco_cond_broadcast(&pool.work);
+    Py_ssize_t c;
+    while ((c = pool_claim(&job)) >= 0) {
+        pool_run_chunk(&job, c);
+    }
+    while (!job.finished) {
+        calco_cond_wait(&pool.done, &pool.lock);
+    }
+    calco_mutex_unlock(&pool.lock);
+}
+
+// Queues an asynchronous job. If max_pending jobs are already queued, waits for room when
+// `block` is set and returns -1 otherwise.
+int calco_pool_submit(calco_job* job, int block) {
+    job->next = 0;
+    job->running = 0;
+    job->cancelled = 0;
+    job->finished = 0;
+    job->link = NULL;
+    calco_mutex_lock(&pool.lock);
+    while (pool.pending >= pool.max_pending) {
+        if (!block) {
+            calco_mutex_unlock(&pool.lock);
+            return -1;
+        }
+        calco_cond_wait(&pool.done, &pool.lock);
+    }
+    pool_spawn();
+    if (pool.tail == NULL) {
+        pool.head = job;
+    } else {
+        pool.tail->link = job;
+    }
+    pool.tail = job;
+    pool.pending++;
+    if (job->nchunks <= 0) {
+        pool_unlink(job);
+        pool_finish(job);
+    }
+    calco_cond_broadcast(&pool.work);
+    calco_mutex_unlock(&pool.lock);
+    return 0;
+}
+
+// Stops handing out chunks of a job. Chunks already running complete normally.
+// Returns 1 if the job had not finished yet.
+int calco_pool_cancel(calco_job* job) {
+    int was_running;
+    calco_mutex_lock(&pool.lock);
+    was_running = !job->finished;
+    if (was_running) {
+        job->cancelled = 1;
+        if (job->running == 0) {
+            pool_unlink(job);
+            pool_finish(job);
+        }
+    }
+    calco_mutex_unlock(&pool.lock);
+    return was_running;
+}
+
+void calco_pool_wait(calco_job* job) {
+    calco_mutex_lock(&pool.lock);
+    while (!job->finished) {
+        calco_cond_wait(&pool.done, &pool.lock);
+    }
+    calco_mutex_unlock(&pool.lock);
+}
+
+// -----------------------------------------------------------------------------
+// Pool Configuration
+// -----------------------------------------------------------------------------
+
+PyObject* calco_set_num_threads(PyObject* self, PyObject* args) {
+    int n;
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+    if (n < 1) {
+        PyErr_SetString(PyExc_ValueError, "number of threads must be >= 1");
+        return NULL;
+    }
+    calco_mutex_lock(&pool.lock);
+    pool.target = n;
+    if (pool.nthreads > 0) {
+        pool_spawn();
+        calco_cond_broadcast(&pool.work);
+    }
+    calco_mutex_unlock(&pool.lock);
+    Py_RETURN_NONE;
+}
+
+// Returns the number of threads parallel_for spreads work across (configured or default).
+int calco_pool_size(void) {
+    calco_mutex_lock(&pool.lock);
+    int n = (pool.target > 0) ? pool.target : calco_cpu_count();
+    calco_mutex_unlock(&pool.lock);
+    return n;
+}
+
+PyObject* calco_get_num_threads(PyObject* self, PyObject* args) {
+    if (!PyArg_ParseTuple(args, "")) {
+        return NULL;
+    }
+    return Py_BuildValue("i", calco_pool_size());
+}
+
+PyObject* calco_set_max_pending(PyObject* self, PyObject* args) {
+    Py_ssize_t n;
+    if (!PyArg_ParseTuple(args, "n", &n)) {
+        return NULL;
+    }
+    if (n < 1) {
+        PyErr_SetString(PyExc_ValueError, "max_pending must be >= 1");
+        return NULL;
+    }
+    calco_mutex_lock(&pool.lock);
+    pool.max_pending = n;
+    calco_cond_broadcast(&pool.done);
+    calco_mutex_unlock(&pool.lock);
+    Py_RETURN_NONE;
+}
+
+// -----------------------------------------------------------------------------
+// Synchronous Buffer Application
+// -----------------------------------------------------------------------------
+
+PyObject* calco_apply(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"func", "buf", "out", NULL};
+    PyObject *func, *buf, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O", kwlist, &func, &buf, &out)) {
+        return NULL;
+    }
+    const calco_unary_entry* entry = calco_lookup_unary(func);
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (calco_get_double_buffer(buf, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    calco_unary_task task = {entry->kernel, (const double*)in_view.buf, (double*)out_view.buf, n, CALCO_DEFAULT_CHUNK,
+                             entry->block};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(calco_unary_chunk, &task, (n + task.chunk_size - 1) / task.chunk_size);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// Asynchronous Offload (calco.Future)
+// Completion is signalled through an eventfd (Linux) or pipe (other POSIX systems) that is
+// created on first use of fileno() or await, so futures that are only polled stay cheap.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    calco_job job;
+    calco_unary_task task;
+    Py_buffer in_view;
+    Py_buffer out_view;
+    PyObject* out_obj;
+    int views_held;
+    int read_fd;
+    int write_fd;
+} CalcoFuture;
+
+static void future_notify(calco_job* job) {
+    CalcoFuture* f = (CalcoFuture*)((char*)job - offsetof(CalcoFuture, job));
+#ifndef _WIN32
+    if (f->write_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t r = write(f->write_fd, &one, (f->read_fd == f->write_fd) ? sizeof(one) : 1);
+        (void)r;
+    }
+#else
+    (void)f;
+#endif
+}
+
+static void future_close_fds(CalcoFuture* f) {
+#ifndef _WIN32
+    if (f->read_fd >= 0) {
+        close(f->read_fd);
+    }
+    if (f->write_fd >= 0 && f->write_fd != f->read_fd) {
+        close(f->write_fd);
+    }
+#endif
+    f->read_fd = f->write_fd = -1;
+}
+
+static void future_release_views(CalcoFuture* f) {
+    if (f->views_held) {
+        PyBuffer_Release(&f->in_view);
+        PyBuffer_Release(&f->out_view);
+        f->views_held = 0;
+    }
+}
+
+static void future_dealloc(CalcoFuture* f) {
+    if (f->views_held) {
+        // Workers may still be writing into the buffers: stop them before releasing.
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_cancel(&f->job);
+        calco_pool_wait(&f->job);
+        Py_END_ALLOW_THREADS
+        future_release_views(f);
+    }
+    future_close_fds(f);
+    Py_XDECREF(f->out_obj);
+    Py_TYPE(f)->tp_free((PyObject*)f);
+}
+
+static int future_is_finished(CalcoFuture* f) {
+    calco_pool_lock();
+    int finished = f->job.finished;
+    calco_pool_unlock();
+    return finished;
+}
+
+static PyObject* future_done(CalcoFuture* f, PyObject* unused) {
+    return PyBool_FromLong(future_is_finished(f));
+}
+
+static PyObject* future_cancelled(CalcoFuture* f, PyObject* unused) {
+    calco_pool_lock();
+    int cancelled = f->job.finished && f->job.cancelled;
+    calco_pool_unlock();
+    return PyBool_FromLong(cancelled);
+}
+
+static PyObject* future_cancel(CalcoFuture* f, PyObject* unused) {
+    int r;
+    Py_BEGIN_ALLOW_THREADS
+    r = calco_pool_cancel(&f->job);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(r);
+}
+
+static PyObject* cancelled_error(void) {
+    PyObject* asyncio = PyImport_ImportModule("asyncio");
+    if (asyncio == NULL) {
+        return NULL;
+    }
+    PyObject* exc = PyObject_GetAttrString(asyncio, "CancelledError");
+    Py_DECREF(asyncio);
+    return exc;
+}
+
+static PyObject* future_result(CalcoFuture* f, PyObject* unused) {
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_wait(&f->job);
+    Py_END_ALLOW_THREADS
+    future_release_views(f);
+    if (f->job.cancelled) {
+        PyObject* exc = cancelled_error();
+        if (exc != NULL) {
+            PyErr_SetString(exc, "calco job was cancelled");
+            Py_DECREF(exc);
+        }
+        return NULL;
+    }
+    Py_INCREF(f->out_obj);
+    return f->out_obj;
+}
+
+static PyObject* future_fileno(CalcoFuture* f, PyObject* unused) {
+#ifdef _WIN32
+    PyErr_SetString(PyExc_NotImplementedError, "fileno() is not available on Windows");
+    return NULL;
+#else
+    if (f->read_fd < 0) {
+        int fds[2];
+#ifdef __linux__
+        fds[0] = fds[1] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (fds[0] < 0) {
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+#else
+        if (pipe(fds) < 0) {
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+        calco_pool_lock();
+        f->read_fd = fds[0];
+        f->write_fd = fds[1];
+        if (f->job.finished) {
+            future_notify(&f->job);
+        }
+        calco_pool_unlock();
+    }
+    return Py_BuildValue("i", f->read_fd);
+#endif
+}
+
+// Reader callback installed by __await__: resolves the asyncio future once the job is done.
+static PyObject* future_wake(CalcoFuture* f, PyObject* aio_future) {
+    if (!future_is_finished(f)) {
+        Py_RETURN_NONE; // Spurious wakeup
+    }
+    PyObject* loop = PyObject_CallMethod(aio_future, "get_loop", NULL);
+    if (loop == NULL) {
+        return NULL;
+    }
+    PyObject* r = PyObject_CallMethod(loop, "remove_reader", "i", f->read_fd);
+    Py_DECREF(loop);
+    if (r == NULL) {
+        return NULL;
+    }
+    Py_DECREF(r);
+    r = PyObject_CallMethod(aio_future, "done", NULL);
+    if (r == NULL) {
+        return NULL;
+    }
+    int already_done = PyObject_IsTrue(r);
+    Py_DECREF(r);
+    if (already_done) {
+        Py_RETURN_NONE;
+    }
+    if (f->job.cancelled) {
+        future_release_views(f);
+        r = PyObject_CallMethod(aio_future, "cancel", NULL);
+        Py_XDECREF(r);
+        if (r == NULL) {
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+    PyObject* value = future_result(f, NULL);
+    if (value == NULL) {
+        PyObject *type, *exc, *tb;
+        PyErr_Fetch(&type, &exc, &tb);
+        PyErr_NormalizeException(&type, &exc, &tb);
+        Py_XDECREF(type);
+        Py_XDECREF(tb);
+        r = PyObject_CallMethod(aio_future, "set_exception", "O", exc);
+        Py_XDECREF(exc);
+    } else {
+        r = PyObject_CallMethod(aio_future, "set_result", "O", value);
+        Py_DECREF(value);
+    }
+    if (r == NULL) {
+        return NULL;
+    }
+    Py_DECREF(r);
+    Py_RETURN_NONE;
+}
+
+// Done callback installed by __await__: cancelling the awaiting task cancels the job.
+static PyObject* future_on_aio_done(CalcoFuture* f, PyObject* aio_future) {
+    PyObject* r = PyObject_CallMethod(aio_future, "cancelled", NULL);
+    if (r == NULL) {
+        return NULL;
+    }
+    int cancelled = PyObject_IsTrue(r);
+    Py_DECREF(r);
+    if (cancelled) {
+        PyObject* loop = PyObject_CallMethod(aio_future, "get_loop", NULL);
+        if (loop == NULL) {
+            return NULL;
+        }
+        r = PyObject_CallMethod(loop, "remove_reader", "i", f->read_fd);
+        Py_DECREF(loop);
+        Py_XDECREF(r);
+        if (r == NULL) {
+            return NULL;
+        }
+        r = future_cancel(f, NULL);
+        Py_XDECREF(r);
+        if (r == NULL) {
+            return NULL;
+        }
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* future_await(CalcoFuture* f) {
+    PyObject* asyncio = PyImport_ImportModule("asyncio");
+    if (asyncio == NULL) {
+        return NULL;
+    }
+    PyObject* loop = PyObject_CallMethod(asyncio, "get_running_loop", NULL);
+    Py_DECREF(asyncio);
+    if (loop == NULL) {
+        return NULL;
+    }
+    PyObject* aio_future = NULL;
+#ifdef _WIN32
+    // No pollable descriptor: park the wait on the default executor instead.
+    PyObject* wait = PyObject_GetAttrString((PyObject*)f, "result");
+    if (wait != NULL) {
+        aio_future = PyObject_CallMethod(loop, "run_in_executor", "OO", Py_None, wait);
+        Py_DECREF(wait);
+    }
+#else
+    PyObject *fd = NULL, *wake = NULL, *on_done = NULL, *r = NULL;
+    aio_future = PyObject_CallMethod(loop, "create_future", NULL);
+    if (aio_future == NULL) {
+        goto done;
+    }
+    fd = future_fileno(f, NULL);
+    wake = PyObject_GetAttrString((PyObject*)f, "_wake");
+    on_done = PyObject_GetAttrString((PyObject*)f, "_on_aio_done");
+    if (fd == NULL || wake == NULL || on_done == NULL) {
+        Py_CLEAR(aio_future);
+        goto done;
+    }
+    r = PyObject_CallMethod(loop, "add_reader", "OOO", fd, wake, aio_future);
+    if (r == NULL) {
+        Py_CLEAR(aio_future);
+        goto done;
+    }
+    Py_DECREF(r);
+    r = PyObject_CallMethod(aio_future, "add_done_callback", "O", on_done);
+    if (r == NULL) {
+        Py_CLEAR(aio_future);
+        goto done;
+    }
+    Py_DECREF(r);
+done:
+    Py_XDECREF(fd);
+    Py_XDECREF(wake);
+    Py_XDECREF(on_done);
+#endif
+    Py_DECREF(loop);
+    if (aio_future == NULL) {
+        return NULL;
+    }
+    PyObject* it = PyObject_CallMethod(aio_future, "__await__", NULL);
+    Py_DECREF(aio_future);
+    return it;
+}
+
+static PyMethodDef future_methods[] = {
+    {"done", (PyCFunction)future_done, METH_NOARGS, "Returns True if the job has finished or was cancelled."},
+    {"cancelled", (PyCFunction)future_cancelled, METH_NOARGS, "Returns True if the job was cancelled before completing."},
+    {"cancel", (PyCFunction)future_cancel, METH_NOARGS, "Stops the job at the next chunk boundary. Returns False if it had already finished."},
+    {"result", (PyCFunction)future_result, METH_NOARGS, "Waits (without holding the GIL) for the job and returns the output buffer."},
+    {"fileno", (PyCFunction)future_fileno, METH_NOARGS, "Returns a descriptor that becomes readable when the job finishes."},
+    {"_wake", (PyCFunction)future_wake, METH_O, NULL},
+    {"_on_aio_done", (PyCFunction)future_on_aio_done, METH_O, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyAsyncMethods future_as_async = {
+    (unaryfunc)future_await, // am_await
+    NULL,                    // am_aiter
+    NULL,                    // am_anext
+};
+
+PyTypeObject CalcoFutureType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.Future",
+    .tp_basicsize = sizeof(CalcoFuture),
+    .tp_dealloc = (destructor)future_dealloc,
+    .tp_as_async = &future_as_async,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Handle to a calco job running on the native worker pool. Awaitable from asyncio.",
+    .tp_methods = future_methods,
+};
+
+PyObject* calco_submit(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"func", "buf", "out", "chunk", "block", NULL};
+    PyObject *func, *buf, *out = Py_None;
+    Py_ssize_t chunk = CALCO_DEFAULT_CHUNK;
+    int block = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$np", kwlist, &func, &buf, &out, &chunk, &block)) {
+        return NULL;
+    }
+    if (chunk < 1) {
+        PyErr_SetString(PyExc_ValueError, "chunk must be >= 1");
+        return NULL;
+    }
+    const calco_unary_entry* entry = calco_lookup_unary(func);
+    if (entry == NULL) {
+        return NULL;
+    }
+    CalcoFuture* f = PyObject_New(CalcoFuture, &CalcoFutureType);
+    if (f == NULL) {
+        return NULL;
+    }
+    f->views_held = 0;
+    f->out_obj = NULL;
+    f->read_fd = f->write_fd = -1;
+    f->job.finished = 1; // Nothing to wait for until the job is queued
+    if (calco_get_double_buffer(buf, &f->in_view, 0) < 0) {
+        Py_DECREF(f);
+        return NULL;
+    }
+    Py_ssize_t n = f->in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &f->out_view, &f->out_obj) < 0) {
+        PyBuffer_Release(&f->in_view);
+        Py_DECREF(f);
+        return NULL;
+    }
+    f->views_held = 1;
+    f->task.kernel = entry->kernel;
+    f->task.block = entry->block;
+    f->task.in = (const double*)f->in_view.buf;
+    f->task.out = (double*)f->out_view.buf;
+    f->task.n = n;
+    f->task.chunk_size = chunk;
+    f->job.fn = calco_unary_chunk;
+    f->job.ctx = &f->task;
+    f->job.nchunks = (n + chunk - 1) / chunk;
+    f->job.on_finish = future_notify;
+
+    int r;
+    Py_BEGIN_ALLOW_THREADS
+    r = calco_pool_submit(&f->job, block);
+    Py_END_ALLOW_THREADS
+    if (r < 0) {
+        f->job.finished = 1;
+        future_release_views(f);
+        Py_DECREF(f);
+        PyErr_SetString(PyExc_BlockingIOError, "calco job queue is full");
+        return NULL;
+    }
+    return (PyObject*)f;
+}
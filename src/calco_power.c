@@ -0,0 +1,343 @@
+// calco_power.c
+// Contains exponent-specialized powers: the plan classifier behind calco.power, and the
+// calco.PowerBy type (returned by calco.power_by) that applies one fixed exponent to buffers.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite (isfinite is folded away under -ffast-math)
+
+// -----------------------------------------------------------------------------
+// Power Plans
+// An exponent is classified once into a plan x^y = (x^q * root(x)^r)^sign, where root is sqrt,
+// cbrt or the fourth root and q is a small integer evaluated by repeated squaring. Exponents
+// that do not fit (q > POW_MAX_CHAIN, or no denominator up to 4) fall back to pow(). The
+// shapes mirror the cases pow() itself treats specially, so results keep pow's semantics: a
+// negative base gives NaN for every non-integer exponent, and x^0 is 1 even for NaN.
+//
+// Each squaring doubles the relative error carried in, so q is capped where the result stays
+// within a few units in the last place; larger integer exponents are left to pow().
+//
+// An exponent such as 1.0 / 3 is taken to mean exactly one third, so the cube root can differ
+// from pow() by the rounding of the exponent itself (|log x| * 2^-54 relative, below one unit
+// for x < e^4). Zero and infinite bases take pow() under a root plan, since the roots keep the
+// sign of -0 and give NaN for -inf where pow() gives +0 or +inf. A negative integer exponent
+// takes the reciprocal only where x^q is exact, so the result is pow's correctly rounded 1/x^q;
+// other bases go to pow().
+// -----------------------------------------------------------------------------
+
+#define POW_MAX_CHAIN 8
+#define POW_BLOCK 256
+
+typedef enum {
+    POW_GENERIC = 0,
+    POW_INTEGER,    // x^q
+    POW_HALF,       // x^q * sqrt(x)
+    POW_THIRD,      // x^q * cbrt(x)^r, r in {1, 2}
+    POW_QUARTER     // x^q * x^(r/4), r in {1, 3}
+} pow_kind;
+
+typedef struct {
+    pow_kind kind;
+    int negative;   // Take the reciprocal of the positive-exponent result
+    unsigned q;     // Integer part of |y| (in units of the root)
+    unsigned r;     // Remaining root power
+    double y;
+} pow_plan;
+
+static const char* const pow_kind_names[] = {"generic", "integer", "half", "third", "quarter"};
+
+// Writes m = d * y if that is an integer with |m| <= limit, and checks that m / d rounds back
+// to y (so 1.0 / 3 matches the literal 1/3 but 0.3333 does not).
+static int exact_multiple(double y, double d, long limit, long* m) {
+    double t = nearbyint(d * y);
+    if (!(fabs(t) <= (double)limit) || t / d != y) {
+        return 0;
+    }
+    *m = (long)t;
+    return 1;
+}
+
+static void pow_plan_init(pow_plan* p, double y) {
+    long m;
+    p->kind = POW_GENERIC;
+    p->negative = 0;
+    p->q = 0;
+    p->r = 0;
+    p->y = y;
+    if (!calco_isfinite(y)) {
+        return;
+    }
+    if (exact_multiple(y, 1.0, POW_MAX_CHAIN, &m)) {
+        p->kind = POW_INTEGER;
+    } else if (exact_multiple(y, 2.0, 2 * POW_MAX_CHAIN + 1, &m)) {
+        p->kind = POW_HALF;
+    } else if (exact_multiple(y, 3.0, 3 * POW_MAX_CHAIN + 2, &m)) {
+        p->kind = POW_THIRD;
+    } else if (exact_multiple(y, 4.0, 4 * POW_MAX_CHAIN + 3, &m)) {
+        p->kind = POW_QUARTER;
+    } else {
+        return;
+    }
+    unsigned long a = (unsigned long)labs(m);
+    unsigned long d = (unsigned long)p->kind; // The root degree: 1, 2, 3 or 4
+    p->negative = m < 0;
+    p->q = (unsigned)(a / d);
+    p->r = (unsigned)(a % d);
+}
+
+// out[i] *= x[i]^q by binary powering over the whole block, one vectorizable pass per step.
+static void pow_chain_block(const double* x, double* out, Py_ssize_t n, unsigned q) {
+    double base[POW_BLOCK];
+    Py_ssize_t i;
+    switch (q) {
+        case 0:
+            return;
+        case 1:
+            for (i = 0; i < n; i++) out[i] *= x[i];
+            return;
+        case 2:
+            for (i = 0; i < n; i++) out[i] *= x[i] * x[i];
+            return;
+        case 3:
+            for (i = 0; i < n; i++) out[i] *= x[i] * x[i] * x[i];
+            return;
+    }
+    for (i = 0; i < n; i++) base[i] = x[i];
+    for (;;) {
+        if (q & 1u) {
+            for (i = 0; i < n; i++) out[i] *= base[i];
+        }
+        q >>= 1;
+        if (q == 0) {
+            break;
+        }
+        for (i = 0; i < n; i++) base[i] *= base[i];
+    }
+}
+
+// Whether x^q (q >= 2) is exact and a normal number: x has at most 53/q significant bits and
+// |x|^q stays within [2^-1022, 2^1022], so its reciprocal is normal too. Zeros, infinities and
+// NaN fail the exponent test.
+static inline int pow_exact_chain(double x, unsigned q) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int e = (int)((bits >> 52) & 0x7FF) - 1023;
+    int limit = 1022 / (int)q;
+    uint64_t low = (1ULL << (53 - 53 / q)) - 1; // Fraction bits past the first 53/q - 1
+    return (bits & low) == 0 && e > -limit && e < limit;
+}
+
+// Evaluates the plan on n <= POW_BLOCK elements. The root factor is formed first (it also
+// supplies the NaN for negative bases), the integer part is multiplied in, and the reciprocal
+// is taken last.
+static void pow_plan_block(const pow_plan* p, const double* x, double* out, Py_ssize_t n) {
+    Py_ssize_t i;
+    double y = p->y;
+    switch (p->kind) {
+        case POW_GENERIC:
+        default:
+            for (i = 0; i < n; i++) out[i] = pow(x[i], y);
+            return;
+        case POW_INTEGER:
+            for (i = 0; i < n; i++) out[i] = 1.0;
+            break;
+        case POW_HALF:
+            for (i = 0; i < n; i++) out[i] = sqrt(x[i]);
+            break;
+        case POW_THIRD:
+            // cbrt is defined for negative x, pow with a non-integer exponent is not.
+            for (i = 0; i < n; i++) out[i] = (x[i] < 0.0) ? NAN : cbrt(x[i]);
+            if (p->r == 2) {
+                for (i = 0; i < n; i++) out[i] *= out[i];
+            }
+            break;
+        case POW_QUARTER:
+            if (p->r == 3) {
+                for (i = 0; i < n; i++) {
+                    double h = sqrt(x[i]);
+                    out[i] = h * sqrt(h);
+                }
+            } else {
+                for (i = 0; i < n; i++) out[i] = sqrt(sqrt(x[i]));
+            }
+            break;
+    }
+    pow_chain_block(x, out, n, p->q);
+    if (p->kind == POW_INTEGER && p->negative && p->q >= 2) {
+        for (i = 0; i < n; i++) out[i] = pow_exact_chain(x[i], p->q) ? 1.0 / out[i] : pow(x[i], y);
+        return;
+    }
+    if (p->negative) {
+        for (i = 0; i < n; i++) out[i] = 1.0 / out[i];
+    }
+    if (p->kind != POW_INTEGER) {
+        for (i = 0; i < n; i++) {
+            if (x[i] == 0.0 || !calco_isfinite(x[i])) {
+                out[i] = pow(x[i], y);
+            }
+        }
+    }
+}
+
+static void pow_plan_apply(const pow_plan* p, const double* x, double* out, Py_ssize_t n) {
+    for (Py_ssize_t i = 0; i < n; i += POW_BLOCK) {
+        Py_ssize_t len = (n - i < POW_BLOCK) ? n - i : POW_BLOCK;
+        pow_plan_block(p, x + i, out + i, len);
+    }
+}
+
+// Scalar form used by calco.power and the Register types. The common exponents are tested
+// directly so a single call does not pay for classification. A NaN exponent goes straight to
+// pow(): under -ffast-math the equality tests below may match it. (x == 0.0 may match a NaN x
+// too, which pow() handles.)
+double calco_fast_pow(double x, double y) {
+    if (calco_isnan(y)) {
+        return pow(x, y);
+    }
+    if (y == 2.0) {
+        return x * x;
+    }
+    if (y == 0.5) {
+        // pow(-0, 0.5) is +0 and pow(-inf, 0.5) is +inf. Not pow(x, 0.5) itself: -ffast-math
+        // turns that back into sqrt(x).
+        return (x == 0.0 || !calco_isfinite(x)) ? fabs(x) : sqrt(x);
+    }
+    if (y == 3.0) {
+        return x * x * x;
+    }
+    if (y == -1.0) {
+        return 1.0 / x;
+    }
+    if (y == 1.0) {
+        return x;
+    }
+    pow_plan p;
+    double r;
+    pow_plan_init(&p, y);
+    pow_plan_block(&p, &x, &r, 1);
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// calco.PowerBy
+// The plan is built once at construction; generic exponents keep a tight pow() loop with a
+// loop-invariant exponent, which the compiler can hand to the vector math library.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    pow_plan plan;
+    int ready;
+} CalcoPowerBy;
+
+typedef struct {
+    const pow_plan* plan;
+    const double* in;
+    double* out;
+    Py_ssize_t n;
+} power_task;
+
+static void power_chunk(void* ctx, Py_ssize_t chunk) {
+    power_task* t = (power_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    pow_plan_apply(t->plan, t->in + start, t->out + start, end - start);
+}
+
+static int power_by_init(CalcoPowerBy* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"exponent", NULL};
+    double y;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "d", kwlist, &y)) {
+        return -1;
+    }
+    // The plan is read without the GIL during evaluation, so it is never replaced.
+    if (self->ready) {
+        PyErr_SetString(PyExc_RuntimeError, "PowerBy is already initialized");
+        return -1;
+    }
+    pow_plan_init(&self->plan, y);
+    self->ready = 1;
+    return 0;
+}
+
+static PyObject* power_by_call(CalcoPowerBy* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "out", NULL};
+    PyObject *x, *out = Py_None;
+    Py_buffer in_view, out_view;
+    PyObject* out_obj;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", kwlist, &x, &out)) {
+        return NULL;
+    }
+    if (!self->ready) {
+        PyErr_SetString(PyExc_RuntimeError, "PowerBy is not initialized");
+        return NULL;
+    }
+    if (PyFloat_Check(x) || PyLong_Check(x)) {
+        double v = PyFloat_AsDouble(x), r;
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        pow_plan_block(&self->plan, &v, &r, 1);
+        return PyFloat_FromDouble(r);
+    }
+    if (calco_get_double_buffer(x, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    power_task task = {&self->plan, (const double*)in_view.buf, (double*)out_view.buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(power_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+static PyObject* power_by_get_exponent(CalcoPowerBy* self, void* closure) {
+    return PyFloat_FromDouble(self->plan.y);
+}
+
+static PyObject* power_by_get_kind(CalcoPowerBy* self, void* closure) {
+    return PyUnicode_FromString(pow_kind_names[self->plan.kind]);
+}
+
+static PyObject* power_by_repr(CalcoPowerBy* self) {
+    PyObject* y = PyFloat_FromDouble(self->plan.y);
+    if (y == NULL) {
+        return NULL;
+    }
+    PyObject* r = PyUnicode_FromFormat("PowerBy(%R, kind='%s')", y, pow_kind_names[self->plan.kind]);
+    Py_DECREF(y);
+    return r;
+}
+
+static PyGetSetDef power_by_getset[] = {
+    {"exponent", (getter)power_by_get_exponent, NULL, "The fixed exponent.", NULL},
+    {"kind", (getter)power_by_get_kind, NULL,
+     "Evaluation strategy: 'integer', 'half', 'third', 'quarter' (root times an integer power) or 'generic' (pow).",
+     NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+CALCO_WORKSPACE_SHIM(power_by_call) // workspace= (calco_workspace.c)
+
+PyTypeObject CalcoPowerByType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.PowerBy",
+    .tp_basicsize = sizeof(CalcoPowerBy),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "PowerBy(exponent): x ** exponent with the evaluation specialized once for the exponent. Call with a "
+              "float or a float64 buffer (and optional out=).",
+    .tp_getset = power_by_getset,
+    .tp_init = (initproc)power_by_init,
+    .tp_call = (ternaryfunc)power_by_call_ws,
+    .tp_repr = (reprfunc)power_by_repr,
+    .tp_new = PyType_GenericNew,
+};
+
+PyObject* calco_power_by(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return PyObject_Call((PyObject*)&CalcoPowerByType, args, kwargs);
+}
@@ -0,0 +1,714 @@
+// calco_procpool.c
+// Contains the calco.procpool submodule: unary calco kernels run by a pool of worker processes
+// directly on multiprocessing.shared_memory segments, with nothing pickled.
+//
+// Pool(processes) starts interpreters that import calco and sit in _serve(), a C loop that never
+// touches Python objects. For apply(func, x, out), the parent sends every worker one fixed-size
+// request over its stdin pipe: the function's id in the unary table, the segment names, element
+// offsets, the length and the chunk size. Workers map the segments by name (mappings are cached
+// between jobs, so repeated jobs on the same segments do not fault the pages in again) and take
+// chunk indices from an atomic counter in a small control segment shared by the pool, so N
+// processes split one array with no copies and no coordination beyond a fetch-and-add. The parent
+// takes chunks from the same counter while it waits, then reads one fixed-size reply per worker.
+//
+// POSIX only (shm_open/mmap); on Windows Pool() raises NotImplementedError.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_threads.h" // calco_mutex_t, calco_cpu_count
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PP_NAME_MAX 120
+#define PP_MAP_CACHE 8
+#define PP_JOB_QUIT 0
+
+// -----------------------------------------------------------------------------
+// Protocol
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    int64_t job;            // PP_JOB_QUIT stops the worker
+    int64_t func;           // Unary table id
+    int64_t n, chunk;       // Elements and elements per chunk
+    int64_t in_offset, out_offset; // In elements
+    char in_name[PP_NAME_MAX];
+    char out_name[PP_NAME_MAX];
+} pp_request;               // Well under PIPE_BUF, so each write is atomic
+
+typedef struct {
+    int64_t job;            // 0 for the start-up handshake
+    int64_t chunks;         // Chunks this worker ran
+    int32_t err;            // errno of a failed mapping, or -1 for an unknown function; 0 on success
+    int32_t pad;
+} pp_reply;
+
+// Control segment: the chunk counter sits on its own cache line.
+typedef struct {
+    volatile int64_t next;
+    char pad[56];
+} pp_control;
+
+#ifndef _WIN32
+
+static int read_full(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return -1;
+        }
+        p += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+static int write_full(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t r = write(fd, p, len);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return -1;
+        }
+        p += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+// multiprocessing.shared_memory reports names without the leading slash that shm_open wants.
+static int shm_path(const char* name, char* path) {
+    size_t len = strlen(name);
+    if (len == 0 || len + 2 > PP_NAME_MAX) {
+        return -1;
+    }
+    if (name[0] == '/') {
+        memcpy(path, name, len + 1);
+    } else {
+        path[0] = '/';
+        memcpy(path + 1, name, len + 1);
+    }
+    return 0;
+}
+
+static int64_t claim_chunk(pp_control* ctl) {
+    return __atomic_fetch_add(&ctl->next, 1, __ATOMIC_RELAXED);
+}
+
+// Runs chunks of the job until the counter passes the end; returns how many this caller ran.
+static int64_t run_chunks(pp_control* ctl, const calco_unary_entry* e, const double* in, double* out,
+                          int64_t n, int64_t chunk) {
+    calco_unary_task task = {e->kernel, in, out, (Py_ssize_t)n, (Py_ssize_t)chunk, e->block};
+    int64_t nchunks = (n + chunk - 1) / chunk;
+    int64_t ran = 0;
+    for (int64_t c = claim_chunk(ctl); c < nchunks; c = claim_chunk(ctl)) {
+        calco_unary_chunk(&task, (Py_ssize_t)c);
+        ran++;
+    }
+    return ran;
+}
+
+// -----------------------------------------------------------------------------
+// Worker Side
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    char name[PP_NAME_MAX];
+    dev_t dev;
+    ino_t ino;
+    size_t size;
+    char* addr;
+    uint64_t used;
+} pp_mapping;
+
+typedef struct {
+    pp_mapping maps[PP_MAP_CACHE];
+    uint64_t clock;
+} pp_map_cache;
+
+// Maps a segment, reusing an earlier mapping of the same object. Returns NULL with errno set.
+static char* map_segment(pp_map_cache* cache, const char* name, size_t need) {
+    char path[PP_NAME_MAX];
+    if (shm_path(name, path) < 0) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    int fd = shm_open(path, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+    if ((size_t)st.st_size < need) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    pp_mapping* victim = &cache->maps[0];
+    for (int i = 0; i < PP_MAP_CACHE; i++) {
+        pp_mapping* m = &cache->maps[i];
+        if (m->addr != NULL && m->dev == st.st_dev && m->ino == st.st_ino && m->size == (size_t)st.st_size &&
+            strcmp(m->name, path) == 0) {
+            close(fd);
+            m->used = ++cache->clock;
+            return m->addr;
+        }
+        if (m->used < victim->used) {
+            victim = m;
+        }
+    }
+    void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    if (victim->addr != NULL) {
+        munmap(victim->addr, victim->size);
+    }
+    strcpy(victim->name, path);
+    victim->dev = st.st_dev;
+    victim->ino = st.st_ino;
+    victim->size = (size_t)st.st_size;
+    victim->addr = (char*)addr;
+    victim->used = ++cache->clock;
+    return victim->addr;
+}
+
+static void serve_loop(pp_control* ctl, int in_fd, int out_fd) {
+    pp_map_cache cache;
+    memset(&cache, 0, sizeof(cache));
+    pp_reply reply = {0, 0, 0, 0};
+    if (write_full(out_fd, &reply, sizeof(reply)) < 0) { // Handshake: the control segment is mapped
+        return;
+    }
+    pp_request req;
+    while (read_full(in_fd, &req, sizeof(req)) == 0 && req.job != PP_JOB_QUIT) {
+        memset(&reply, 0, sizeof(reply));
+        reply.job = req.job;
+        req.in_name[PP_NAME_MAX - 1] = req.out_name[PP_NAME_MAX - 1] = 0;
+        const calco_unary_entry* e = calco_unary_entry_at((Py_ssize_t)req.func);
+        size_t in_need = (size_t)(req.in_offset + req.n) * sizeof(double);
+        size_t out_need = (size_t)(req.out_offset + req.n) * sizeof(double);
+        char* in = NULL;
+        char* out = NULL;
+        if (e == NULL) {
+            reply.err = -1;
+        } else if ((in = map_segment(&cache, req.in_name, in_need)) == NULL ||
+                   (out = map_segment(&cache, req.out_name, out_need)) == NULL) {
+            reply.err = errno ? errno : EINVAL;
+        } else {
+            reply.chunks = run_chunks(ctl, e, (const double*)in + req.in_offset, (double*)out + req.out_offset,
+                                      req.n, req.chunk);
+        }
+        if (write_full(out_fd, &reply, sizeof(reply)) < 0) {
+            break;
+        }
+    }
+    for (int i = 0; i < PP_MAP_CACHE; i++) {
+        if (cache.maps[i].addr != NULL) {
+            munmap(cache.maps[i].addr, cache.maps[i].size);
+        }
+    }
+}
+
+static PyObject* procpool_serve(PyObject* self, PyObject* args) {
+    const char* ctl_name;
+    if (!PyArg_ParseTuple(args, "s", &ctl_name)) {
+        return NULL;
+    }
+    // Requests arrive on stdin and replies leave on a private copy of stdout; fd 1 is pointed at
+    // stderr so that nothing else written by this process can corrupt the protocol.
+    int out_fd = dup(1);
+    if (out_fd < 0 || dup2(2, 1) < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    char path[PP_NAME_MAX];
+    int fd = (shm_path(ctl_name, path) == 0) ? shm_open(path, O_RDWR, 0) : -1;
+    if (fd < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    void* ctl = mmap(NULL, sizeof(pp_control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ctl == MAP_FAILED) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_BEGIN_ALLOW_THREADS
+    serve_loop((pp_control*)ctl, 0, out_fd);
+    Py_END_ALLOW_THREADS
+    munmap(ctl, sizeof(pp_control));
+    close(out_fd);
+    Py_RETURN_NONE;
+}
+
+#endif // !_WIN32
+
+// -----------------------------------------------------------------------------
+// calco.procpool.Pool
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    int nproc;
+    PyObject* procs;        // list of subprocess.Popen, or NULL once closed
+    int* to_fd;             // Worker stdin (requests)
+    int* from_fd;           // Worker stdout (replies)
+    pp_control* ctl;
+    int64_t job;
+    int broken;
+    calco_mutex_t lock;     // Serializes jobs from several Python threads
+} CalcoProcPool;
+
+#ifndef _WIN32
+
+static int pool_close_impl(CalcoProcPool* self) {
+    if (self->procs == NULL) {
+        return 0;
+    }
+    pp_request quit;
+    memset(&quit, 0, sizeof(quit));
+    for (int i = 0; i < self->nproc; i++) {
+        if (self->to_fd[i] >= 0) {
+            write_full(self->to_fd[i], &quit, sizeof(quit));
+        }
+    }
+    int status = 0;
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(self->procs); i++) {
+        PyObject* p = PyList_GET_ITEM(self->procs, i);
+        PyObject* r = PyObject_CallMethod(p, "communicate", NULL); // Closes the pipes and waits
+        if (r == NULL) {
+            status = -1;
+            PyErr_Clear();
+            PyObject* k = PyObject_CallMethod(p, "kill", NULL);
+            Py_XDECREF(k);
+            PyErr_Clear();
+        }
+        Py_XDECREF(r);
+    }
+    Py_CLEAR(self->procs);
+    if (self->ctl != NULL) {
+        munmap(self->ctl, sizeof(pp_control));
+        self->ctl = NULL;
+    }
+    return status;
+}
+
+// Starts the worker interpreters and waits for their handshakes. Returns 0, or -1 with an
+// exception set.
+static int pool_start(CalcoProcPool* self, const char* ctl_name) {
+    PyObject* subprocess = PyImport_ImportModule("subprocess");
+    PyObject* calco = PyImport_ImportModule("calco");
+    PyObject* executable = PySys_GetObject("executable"); // Borrowed
+    PyObject* calco_file = (calco != NULL) ? PyModule_GetFilenameObject(calco) : NULL;
+    PyObject *os_path = NULL, *calco_dir = NULL, *argv = NULL, *pipe = NULL, *kwargs = NULL, *popen = NULL;
+    int status = -1, failed = 0;
+    if (subprocess == NULL || calco_file == NULL) {
+        goto done;
+    }
+    if (executable == NULL || executable == Py_None || PyUnicode_GetLength(executable) == 0) {
+        PyErr_SetString(PyExc_RuntimeError, "sys.executable is not set; cannot start worker processes");
+        goto done;
+    }
+    if ((os_path = PyImport_ImportModule("os.path")) == NULL ||
+        (calco_dir = PyObject_CallMethod(os_path, "dirname", "O", calco_file)) == NULL) {
+        goto done;
+    }
+    // The worker puts the directory calco was loaded from first on sys.path, so it imports this build.
+    argv = Py_BuildValue("([OsssO])", executable, "-c",
+                         "import sys; sys.path.insert(0, sys.argv[2]); import calco.procpool; "
+                         "calco.procpool._serve(sys.argv[1])",
+                         ctl_name, calco_dir);
+    pipe = (argv != NULL) ? PyObject_GetAttrString(subprocess, "PIPE") : NULL;
+    kwargs = (pipe != NULL) ? Py_BuildValue("{sOsOsO}", "stdin", pipe, "stdout", pipe, "close_fds", Py_True) : NULL;
+    if (kwargs == NULL || (popen = PyObject_GetAttrString(subprocess, "Popen")) == NULL) {
+        goto done;
+    }
+    for (int i = 0; i < self->nproc; i++) {
+        PyObject* p = PyObject_Call(popen, argv, kwargs);
+        if (p == NULL || PyList_Append(self->procs, p) < 0) {
+            Py_XDECREF(p);
+            goto done;
+        }
+        Py_DECREF(p);
+        PyObject* in = PyObject_GetAttrString(p, "stdin");
+        PyObject* out = PyObject_GetAttrString(p, "stdout");
+        PyObject* in_fd = (in != NULL) ? PyObject_CallMethod(in, "fileno", NULL) : NULL;
+        PyObject* out_fd = (out != NULL) ? PyObject_CallMethod(out, "fileno", NULL) : NULL;
+        self->to_fd[i] = (in_fd != NULL) ? (int)PyLong_AsLong(in_fd) : -1;
+        self->from_fd[i] = (out_fd != NULL) ? (int)PyLong_AsLong(out_fd) : -1;
+        Py_XDECREF(in);
+        Py_XDECREF(out);
+        Py_XDECREF(in_fd);
+        Py_XDECREF(out_fd);
+        if (PyErr_Occurred()) {
+            goto done;
+        }
+    }
+    // Wait for every worker to map the control segment before the caller unlinks it.
+    Py_BEGIN_ALLOW_THREADS
+    for (int i = 0; i < self->nproc; i++) {
+        pp_reply reply;
+        if (read_full(self->from_fd[i], &reply, sizeof(reply)) < 0) {
+            failed = 1;
+        }
+    }
+    Py_END_ALLOW_THREADS
+    if (failed) {
+        PyErr_SetString(PyExc_RuntimeError, "a procpool worker failed to start (see its stderr)");
+        goto done;
+    }
+    status = 0;
+done:
+    Py_XDECREF(subprocess);
+    Py_XDECREF(calco);
+    Py_XDECREF(calco_file);
+    Py_XDECREF(os_path);
+    Py_XDECREF(calco_dir);
+    Py_XDECREF(argv);
+    Py_XDECREF(pipe);
+    Py_XDECREF(kwargs);
+    Py_XDECREF(popen);
+    return status;
+}
+
+#endif // !_WIN32
+
+static int pool_init(CalcoProcPool* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"processes", NULL};
+    PyObject* processes = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &processes)) {
+        return -1;
+    }
+#ifdef _WIN32
+    PyErr_SetString(PyExc_NotImplementedError, "calco.procpool requires POSIX shared memory");
+    return -1;
+#else
+    if (self->procs != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Pool is already initialized");
+        return -1;
+    }
+    long n = (processes == Py_None) ? calco_cpu_count() : PyLong_AsLong(processes);
+    if (n == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (n < 1 || n > 1024) {
+        PyErr_SetString(PyExc_ValueError, "processes must be between 1 and 1024");
+        return -1;
+    }
+    self->nproc = (int)n;
+    self->to_fd = (int*)PyMem_Malloc(n * sizeof(int));
+    self->from_fd = (int*)PyMem_Malloc(n * sizeof(int));
+    if (self->to_fd == NULL || self->from_fd == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (long i = 0; i < n; i++) {
+        self->to_fd[i] = self->from_fd[i] = -1;
+    }
+    calco_mutex_init(&self->lock);
+
+    // The control segment only needs a name until every worker has mapped it.
+    static unsigned long serial = 0;
+    char ctl_name[PP_NAME_MAX];
+    snprintf(ctl_name, sizeof(ctl_name), "/calco_pp_%ld_%lu", (long)getpid(), serial++);
+    int fd = shm_open(ctl_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    void* ctl = MAP_FAILED;
+    if (ftruncate(fd, sizeof(pp_control)) == 0) {
+        ctl = mmap(NULL, sizeof(pp_control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (ctl == MAP_FAILED) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        shm_unlink(ctl_name);
+        return -1;
+    }
+    self->ctl = (pp_control*)ctl;
+    if ((self->procs = PyList_New(0)) == NULL) {
+        shm_unlink(ctl_name);
+        return -1;
+    }
+    int status = pool_start(self, ctl_name);
+    shm_unlink(ctl_name);
+    if (status < 0) {
+        PyObject *type, *value, *tb;
+        PyErr_Fetch(&type, &value, &tb);
+        pool_close_impl(self);
+        PyErr_Restore(type, value, tb);
+        return -1;
+    }
+    return 0;
+#endif
+}
+
+static void pool_dealloc(CalcoProcPool* self) {
+#ifndef _WIN32
+    PyObject *type, *value, *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    pool_close_impl(self);
+    PyErr_Restore(type, value, tb);
+#endif
+    PyMem_Free(self->to_fd);
+    PyMem_Free(self->from_fd);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+#ifndef _WIN32
+
+// Reads the segment name and a buffer view from a multiprocessing.shared_memory.SharedMemory
+// (or anything with .name and a writable .buf). Returns 0, or -1 with an exception set.
+static int shm_arg(PyObject* obj, const char* what, char* name, Py_buffer* view) {
+    PyObject* name_obj = PyObject_GetAttrString(obj, "name");
+    PyObject* buf = (name_obj != NULL) ? PyObject_GetAttrString(obj, "buf") : NULL;
+    if (buf == NULL) {
+        Py_XDECREF(name_obj);
+        PyErr_Format(PyExc_TypeError, "%s must be a multiprocessing.shared_memory.SharedMemory", what);
+        return -1;
+    }
+    const char* s = PyUnicode_Check(name_obj) ? PyUnicode_AsUTF8(name_obj) : NULL;
+    int status = -1;
+    if (s == NULL) {
+        if (!PyErr_Occurred()) {
+            PyErr_Format(PyExc_TypeError, "%s.name must be a str", what);
+        }
+    } else if (strlen(s) + 2 > PP_NAME_MAX) {
+        PyErr_Format(PyExc_ValueError, "%s.name is too long", what);
+    } else if (PyObject_GetBuffer(buf, view, PyBUF_WRITABLE) == 0) {
+        strcpy(name, s);
+        status = 0;
+    }
+    Py_DECREF(name_obj);
+    Py_DECREF(buf);
+    return status;
+}
+
+static PyObject* pool_apply(CalcoProcPool* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"func", "x", "out", "n", "offset", "out_offset", "chunk", NULL};
+    PyObject *func, *x, *out = Py_None;
+    Py_ssize_t n = -1, offset = 0, out_offset = 0, chunk = CALCO_DEFAULT_CHUNK;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$nnnn", kwlist, &func, &x, &out, &n, &offset, &out_offset,
+                                     &chunk)) {
+        return NULL;
+    }
+    if (self->procs == NULL || self->broken) {
+        PyErr_SetString(PyExc_RuntimeError, self->broken ? "the Pool lost a worker and must be recreated"
+                                                         : "the Pool is closed");
+        return NULL;
+    }
+    const calco_unary_entry* e = calco_lookup_unary(func);
+    if (e == NULL) {
+        return NULL;
+    }
+    Py_ssize_t id = 0;
+    while (calco_unary_entry_at(id) != e) {
+        id++;
+    }
+    if (out == Py_None) {
+        out = x;
+        if (out_offset == 0) {
+            out_offset = offset;
+        }
+    }
+    if (offset < 0 || out_offset < 0 || chunk < 1) {
+        PyErr_SetString(PyExc_ValueError, "offsets must be non-negative and chunk positive");
+        return NULL;
+    }
+
+    pp_request req;
+    memset(&req, 0, sizeof(req));
+    Py_buffer in_view, out_view;
+    if (shm_arg(x, "x", req.in_name, &in_view) < 0) {
+        return NULL;
+    }
+    if (shm_arg(out, "out", req.out_name, &out_view) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    Py_ssize_t in_len = in_view.len / (Py_ssize_t)sizeof(double) - offset;
+    Py_ssize_t out_len = out_view.len / (Py_ssize_t)sizeof(double) - out_offset;
+    if (n < 0) {
+        n = (in_len < out_len) ? in_len : out_len;
+    }
+    if (n < 0 || n > in_len || n > out_len) {
+        PyBuffer_Release(&in_view);
+        PyBuffer_Release(&out_view);
+        PyErr_SetString(PyExc_ValueError, "n elements from the offsets do not fit in the segments");
+        return NULL;
+    }
+    req.func = id;
+    req.n = n;
+    req.chunk = chunk;
+    req.in_offset = offset;
+    req.out_offset = out_offset;
+    const double* in = (const double*)in_view.buf + offset;
+    double* dst = (double*)out_view.buf + out_offset;
+
+    int lost = 0, err = 0;
+    int64_t ran = 0;
+    Py_BEGIN_ALLOW_THREADS
+    calco_mutex_lock(&self->lock);
+    req.job = ++self->job;
+    __atomic_store_n(&self->ctl->next, 0, __ATOMIC_RELAXED);
+    int sent = 0;
+    for (int i = 0; i < self->nproc; i++) {
+        if (write_full(self->to_fd[i], &req, sizeof(req)) < 0) {
+            lost = 1;
+            break;
+        }
+        sent++;
+    }
+    ran = run_chunks(self->ctl, e, in, dst, n, chunk); // The caller works through chunks as well
+    for (int i = 0; i < sent; i++) {
+        pp_reply reply;
+        if (read_full(self->from_fd[i], &reply, sizeof(reply)) < 0 || reply.job != req.job) {
+            lost = 1;
+        } else {
+            ran += reply.chunks;
+            if (reply.err != 0 && err == 0) {
+                err = reply.err;
+            }
+        }
+    }
+    calco_mutex_unlock(&self->lock);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+
+    if (lost) {
+        self->broken = 1;
+        PyErr_SetString(PyExc_RuntimeError, "a procpool worker exited; the Pool must be recreated");
+        return NULL;
+    }
+    // A worker that could not map a segment ran nothing; the others covered its share.
+    if (ran != (n + chunk - 1) / chunk) {
+        if (err > 0) {
+            errno = err;
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+        PyErr_SetString(PyExc_RuntimeError, "procpool job did not complete");
+        return NULL;
+    }
+    Py_INCREF(out);
+    return out;
+}
+
+static PyObject* pool_close(CalcoProcPool* self, PyObject* Py_UNUSED(ignored)) {
+    if (pool_close_impl(self) < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "a procpool worker did not exit cleanly");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+#else
+
+static PyObject* pool_apply(CalcoProcPool* self, PyObject* args, PyObject* kwargs) {
+    PyErr_SetString(PyExc_NotImplementedError, "calco.procpool requires POSIX shared memory");
+    return NULL;
+}
+
+static PyObject* pool_close(CalcoProcPool* self, PyObject* Py_UNUSED(ignored)) {
+    Py_RETURN_NONE;
+}
+
+#endif // !_WIN32
+
+static PyObject* pool_enter(CalcoProcPool* self, PyObject* Py_UNUSED(ignored)) {
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+static PyObject* pool_exit(CalcoProcPool* self, PyObject* args) {
+    PyObject* r = pool_close(self, NULL);
+    if (r == NULL) {
+        return NULL;
+    }
+    Py_DECREF(r);
+    Py_RETURN_FALSE;
+}
+
+static PyObject* pool_get_processes(CalcoProcPool* self, void* closure) {
+    return PyLong_FromLong(self->procs != NULL ? self->nproc : 0);
+}
+
+static PyMethodDef pool_methods[] = {
+    {"apply", (PyCFunction)(void(*)(void))pool_apply, METH_VARARGS | METH_KEYWORDS,
+     "apply(func, x, out=None, *, n=None, offset=0, out_offset=0, chunk=65536): Runs the unary calco function func "
+     "over n float64 elements of the SharedMemory x (from element offset) into out (in place when omitted), split "
+     "in chunks between the worker processes and the caller. Returns out."},
+    {"close", (PyCFunction)pool_close, METH_NOARGS, "close(): Stops the worker processes."},
+    {"__enter__", (PyCFunction)pool_enter, METH_NOARGS, NULL},
+    {"__exit__", (PyCFunction)pool_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef pool_getset[] = {
+    {"processes", (getter)pool_get_processes, NULL, "Number of running worker processes.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject CalcoProcPoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.procpool.Pool",
+    .tp_basicsize = sizeof(CalcoProcPool),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Pool(processes=None): Worker processes (one per CPU by default) that run unary calco kernels in place "
+              "on multiprocessing.shared_memory segments. Jobs are sent as fixed-size descriptors over pipes; "
+              "nothing is pickled.",
+    .tp_methods = pool_methods,
+    .tp_getset = pool_getset,
+    .tp_init = (initproc)pool_init,
+    .tp_dealloc = (destructor)pool_dealloc,
+    .tp_new = PyType_GenericNew,
+};
+
+// -----------------------------------------------------------------------------
+// Submodule Definition
+// -----------------------------------------------------------------------------
+
+static PyMethodDef CalcoProcPoolMethods[] = {
+#ifndef _WIN32
+    {"_serve", procpool_serve, METH_VARARGS, "_serve(control): Worker process main loop (used by Pool)."},
+#endif
+    {NULL, NULL, 0, NULL}
+};
+
+struct PyModuleDef calcoprocpoolmodule = {
+    PyModuleDef_HEAD_INIT,
+    "calco.procpool",
+    "Process-parallel calco kernels over multiprocessing.shared_memory, without pickling.",
+    -1,
+    CalcoProcPoolMethods
+};
+
+int calco_procpool_exec(PyObject* m) {
+    if (PyType_Ready(&CalcoProcPoolType) < 0) {
+        return -1;
+    }
+    Py_INCREF(&CalcoProcPoolType);
+    if (PyModule_AddObject(m, "Pool", (PyObject*)&CalcoProcPoolType) < 0) {
+        Py_DECREF(&CalcoProcPoolType);
+        return -1;
+    }
+    return 0;
+}
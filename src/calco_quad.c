@@ -0,0 +1,772 @@
+// calco_quad.c
+// Contains calco.quad: adaptive numerical integration by Gauss-Kronrod (G7K15, G10K21) and
+// tanh-sinh rules. Integrands are evaluated in batches: a calco kernel is applied in C, and a
+// Python callable receives one float64 array holding the nodes of every panel being refined,
+// across all integrals of a batch, so the callback count does not grow with the node count.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite (isfinite is folded away under -ffast-math)
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Gauss-Kronrod Rules (QUADPACK qk15 and qk21)
+// Abscissae exclude the centre and are listed from the outside in; gauss[] holds the Gauss
+// weight of the embedded rule at each abscissa, or 0 where the node is Kronrod-only.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    int m;                 // Abscissae per side; a panel uses 2m + 1 nodes
+    const double* x;
+    const double* kronrod;
+    const double* gauss;
+    double kronrod_centre;
+    double gauss_centre;
+} gk_rule;
+
+static const double gk15_x[7] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245};
+static const double gk15_k[7] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649};
+static const double gk15_g[7] = {
+    0.0, 0.129484966168869693270611432679082, 0.0, 0.279705391489276667901467771423780,
+    0.0, 0.381830050505118944950369775488975, 0.0};
+
+static const double gk21_x[10] = {
+    0.995657163025808080735527280689003, 0.973906528517171720077964012084452,
+    0.930157491355708226001207180059508, 0.865063366688984510732096688423493,
+    0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+    0.562757134668604683339000099272694, 0.433395394129247190799265943165784,
+    0.294392862701460198131126603103866, 0.148874338981631210884826001129720};
+static const double gk21_k[10] = {
+    0.011694638867371874278064396062192, 0.032558162307964727478818972459390,
+    0.054755896574351996031381300244580, 0.075039674810919952767043140916190,
+    0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+    0.123491976262065851077208980292224, 0.134709217311473325928054001771707,
+    0.142775938577060080797094273138717, 0.147739104901338491374841515972068};
+static const double gk21_g[10] = {
+    0.0, 0.066671344308688137593568809893332, 0.0, 0.149451349150580593145776339657697,
+    0.0, 0.219086362515982043995534934228163, 0.0, 0.269266719309996355091226921569469,
+    0.0, 0.295524224714752870173892994651338};
+
+static const gk_rule gk15 = {7, gk15_x, gk15_k, gk15_g, 0.209482141084727828012999174891714,
+                             0.417959183673469387755102040816327};
+static const gk_rule gk21 = {10, gk21_x, gk21_k, gk21_g, 0.149445554002916905664936468389821, 0.0};
+
+// -----------------------------------------------------------------------------
+// Interval Maps
+// Infinite ranges are integrated in a finite variable t: [a, inf) and (-inf, b] through
+// x = a + (1 - t) / t on (0, 1], and (-inf, inf) through x = t / (1 - t^2) on (-1, 1). The rules
+// never place a node on an open end of the t range.
+// -----------------------------------------------------------------------------
+
+enum { MAP_FINITE, MAP_UPPER, MAP_LOWER, MAP_BOTH };
+
+typedef struct {
+    int map;
+    double a, b;       // Integration limits with a <= b
+    double sign;       // -1 when the limits were given in decreasing order
+    double ta, tb;     // Range of the integration variable
+} quad_range;
+
+static void range_init(quad_range* r, double a, double b) {
+    r->sign = 1.0;
+    if (a > b) {
+        double t = a;
+        a = b;
+        b = t;
+        r->sign = -1.0;
+    }
+    r->a = a;
+    r->b = b;
+    int fa = calco_isfinite(a), fb = calco_isfinite(b);
+    if (fa && fb) {
+        r->map = MAP_FINITE;
+        r->ta = a;
+        r->tb = b;
+    } else if (fa) {
+        r->map = MAP_UPPER;
+        r->ta = 0.0;
+        r->tb = 1.0;
+    } else if (fb) {
+        r->map = MAP_LOWER;
+        r->ta = 0.0;
+        r->tb = 1.0;
+    } else {
+        r->map = MAP_BOTH;
+        r->ta = -1.0;
+        r->tb = 1.0;
+    }
+}
+
+// Returns x(t) and stores dx/dt in *jac.
+static inline double range_map(const quad_range* r, double t, double* jac) {
+    double s;
+    switch (r->map) {
+        case MAP_UPPER:
+            *jac = 1.0 / (t * t);
+            return r->a + (1.0 - t) / t;
+        case MAP_LOWER:
+            *jac = 1.0 / (t * t);
+            return r->b - (1.0 - t) / t;
+        case MAP_BOTH:
+            s = 1.0 / (1.0 - t * t);
+            *jac = (1.0 + t * t) * s * s;
+            return t * s;
+        default:
+            *jac = 1.0;
+            return t;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Batched Evaluation
+// Nodes are queued in x[] (with the Jacobian of the interval map in jac[]) and evaluated
+// together; fx[] then holds f(x) * jac.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject* func;            // Python integrand, or NULL when kernel is set
+    calco_unary_fn kernel;
+    int vectorized;            // Call func once with an array rather than once per node
+    double* x;
+    double* jac;
+    double* fx;
+    Py_ssize_t n;              // Queued nodes
+    Py_ssize_t cap;
+    Py_ssize_t neval;
+    Py_ssize_t ncalls;
+} quad_eval;
+
+static int eval_reserve(quad_eval* ev, Py_ssize_t extra) {
+    if (ev->n + extra <= ev->cap) {
+        return 0;
+    }
+    Py_ssize_t cap = (ev->cap > 0) ? ev->cap : 256;
+    while (cap < ev->n + extra) {
+        cap *= 2;
+    }
+    double* block = (double*)PyMem_Realloc(ev->x, 3 * cap * sizeof(double));
+    if (block == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    // Move the queued Jacobians to their new offset; fx holds nothing live between flushes.
+    memmove(block + cap, block + ev->cap, ev->n * sizeof(double));
+    ev->x = block;
+    ev->jac = block + cap;
+    ev->fx = block + 2 * cap;
+    ev->cap = cap;
+    return 0;
+}
+
+static inline void eval_push(quad_eval* ev, const quad_range* r, double t) {
+    ev->x[ev->n] = range_map(r, t, &ev->jac[ev->n]);
+    ev->n++;
+}
+
+static int eval_python(quad_eval* ev) {
+    Py_ssize_t n = ev->n;
+    if (!ev->vectorized) {
+        for (Py_ssize_t i = 0; i < n; i++) {
+            PyObject* res = PyObject_CallFunction(ev->func, "d", ev->x[i]);
+            if (res == NULL) {
+                return -1;
+            }
+            ev->fx[i] = PyFloat_AsDouble(res);
+            Py_DECREF(res);
+            if (PyErr_Occurred()) {
+                return -1;
+            }
+        }
+        ev->ncalls += n;
+        return 0;
+    }
+    Py_buffer view;
+    PyObject* nodes = calco_new_plain_array('d', n, &view);
+    if (nodes == NULL) {
+        return -1;
+    }
+    memcpy(view.buf, ev->x, n * sizeof(double));
+    PyBuffer_Release(&view);
+    PyObject* res = PyObject_CallOneArg(ev->func, nodes);
+    Py_DECREF(nodes);
+    if (res == NULL) {
+        return -1;
+    }
+    ev->ncalls++;
+    // A plain number is taken as a constant integrand.
+    if (PyFloat_Check(res) || PyLong_Check(res)) {
+        double v = PyFloat_AsDouble(res);
+        Py_DECREF(res);
+        if (PyErr_Occurred()) {
+            return -1;
+        }
+        for (Py_ssize_t i = 0; i < n; i++) {
+            ev->fx[i] = v;
+        }
+        return 0;
+    }
+    Py_ssize_t m;
+    double* values = calco_read_doubles(res, &m);
+    Py_DECREF(res);
+    if (values == NULL) {
+        return -1;
+    }
+    if (m != n) {
+        PyMem_Free(values);
+        PyErr_Format(PyExc_ValueError, "integrand returned %zd values for %zd nodes", m, n);
+        return -1;
+    }
+    memcpy(ev->fx, values, n * sizeof(double));
+    PyMem_Free(values);
+    return 0;
+}
+
+// Evaluates the queued nodes and empties the queue. Returns 0, or -1 with an exception set.
+static int eval_flush(quad_eval* ev) {
+    Py_ssize_t n = ev->n;
+    if (n == 0) {
+        return 0;
+    }
+    if (ev->kernel != NULL) {
+        calco_unary_fn f = ev->kernel;
+        Py_BEGIN_ALLOW_THREADS
+        for (Py_ssize_t i = 0; i < n; i++) {
+            ev->fx[i] = f(ev->x[i]);
+        }
+        Py_END_ALLOW_THREADS
+    } else if (eval_python(ev) < 0) {
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        ev->fx[i] *= ev->jac[i];
+    }
+    ev->neval += n;
+    ev->n = 0;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Adaptive Gauss-Kronrod
+// Each integral keeps its panels in a max-heap keyed by error estimate. Every round bisects
+// the worst panel of each unconverged integral, and the halves of all integrals are evaluated
+// in one batch. The error estimate is QUADPACK's: |K - G| scaled by the integrand's variation
+// and floored by the rounding level of the panel sum.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    double a, b;
+    double result;
+    double error;
+} quad_panel;
+
+typedef struct {
+    quad_range range;
+    quad_panel* heap;
+    Py_ssize_t size;
+    Py_ssize_t cap;
+    double result;
+    double error;
+    int state;          // QUAD_RUNNING, QUAD_CONVERGED or QUAD_STALLED
+} quad_item;
+
+enum { QUAD_RUNNING, QUAD_CONVERGED, QUAD_STALLED };
+
+static void heap_push(quad_item* it, quad_panel p) {
+    Py_ssize_t i = it->size++;
+    while (i > 0) {
+        Py_ssize_t parent = (i - 1) / 2;
+        if (it->heap[parent].error >= p.error) {
+            break;
+        }
+        it->heap[i] = it->heap[parent];
+        i = parent;
+    }
+    it->heap[i] = p;
+}
+
+static quad_panel heap_pop(quad_item* it) {
+    quad_panel top = it->heap[0];
+    quad_panel last = it->heap[--it->size];
+    Py_ssize_t i = 0, n = it->size;
+    for (;;) {
+        Py_ssize_t c = 2 * i + 1;
+        if (c >= n) {
+            break;
+        }
+        if (c + 1 < n && it->heap[c + 1].error > it->heap[c].error) {
+            c++;
+        }
+        if (it->heap[c].error <= last.error) {
+            break;
+        }
+        it->heap[i] = it->heap[c];
+        i = c;
+    }
+    if (n > 0) {
+        it->heap[i] = last;
+    }
+    return top;
+}
+
+static void gk_queue(quad_eval* ev, const gk_rule* rule, const quad_range* r, double a, double b) {
+    double c = 0.5 * (a + b), h = 0.5 * (b - a);
+    eval_push(ev, r, c);
+    for (int k = 0; k < rule->m; k++) {
+        eval_push(ev, r, c - h * rule->x[k]);
+        eval_push(ev, r, c + h * rule->x[k]);
+    }
+}
+
+// Applies the rule to the 2m + 1 values queued by gk_queue for the panel [a, b].
+static quad_panel gk_panel(const gk_rule* rule, const double* f, double a, double b) {
+    double h = 0.5 * (b - a), dh = fabs(h);
+    double fc = f[0];
+    double resk = rule->kronrod_centre * fc, resg = rule->gauss_centre * fc;
+    double resabs = fabs(resk);
+    for (int k = 0; k < rule->m; k++) {
+        double f1 = f[1 + 2 * k], f2 = f[2 + 2 * k];
+        resk += rule->kronrod[k] * (f1 + f2);
+        resg += rule->gauss[k] * (f1 + f2);
+        resabs += rule->kronrod[k] * (fabs(f1) + fabs(f2));
+    }
+    double mean = 0.5 * resk;
+    double resasc = rule->kronrod_centre * fabs(fc - mean);
+    for (int k = 0; k < rule->m; k++) {
+        resasc += rule->kronrod[k] * (fabs(f[1 + 2 * k] - mean) + fabs(f[2 + 2 * k] - mean));
+    }
+    resabs *= dh;
+    resasc *= dh;
+    double err = fabs((resk - resg) * h);
+    if (resasc != 0.0 && err != 0.0) {
+        double scale = pow(200.0 * err / resasc, 1.5);
+        err = resasc * ((scale < 1.0) ? scale : 1.0);
+    }
+    if (resabs > DBL_MIN / (50.0 * DBL_EPSILON)) {
+        double floor = 50.0 * DBL_EPSILON * resabs;
+        err = (err > floor) ? err : floor;
+    }
+    quad_panel p = {a, b, resk * h, err};
+    return p;
+}
+
+static int item_reserve(quad_item* it, Py_ssize_t extra) {
+    if (it->size + extra <= it->cap) {
+        return 0;
+    }
+    Py_ssize_t cap = (it->cap > 0) ? 2 * it->cap : 8;
+    quad_panel* heap = (quad_panel*)PyMem_Realloc(it->heap, cap * sizeof(quad_panel));
+    if (heap == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    it->heap = heap;
+    it->cap = cap;
+    return 0;
+}
+
+static int item_tolerance_met(const quad_item* it, double epsabs, double epsrel) {
+    double tol = epsrel * fabs(it->result);
+    return it->error <= ((tol > epsabs) ? tol : epsabs);
+}
+
+static int run_gk(quad_item* items, Py_ssize_t n, const gk_rule* rule, quad_eval* ev,
+                  double epsabs, double epsrel, Py_ssize_t limit) {
+    Py_ssize_t per_panel = 2 * rule->m + 1;
+    // Pending panels of the current round: owner and limits, in queue order.
+    Py_ssize_t* owner = (Py_ssize_t*)PyMem_Malloc((2 * n + 1) * sizeof(Py_ssize_t));
+    double* lim = (double*)PyMem_Malloc((4 * n + 1) * sizeof(double));
+    int status = -1;
+    if (owner == NULL || lim == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (int first = 1;; first = 0) {
+        Py_ssize_t np = 0;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            quad_item* it = &items[i];
+            if (it->state != QUAD_RUNNING) {
+                continue;
+            }
+            if (first) {
+                owner[np] = i;
+                lim[2 * np] = it->range.ta;
+                lim[2 * np + 1] = it->range.tb;
+                np++;
+                continue;
+            }
+            if (item_tolerance_met(it, epsabs, epsrel)) {
+                it->state = QUAD_CONVERGED;
+                continue;
+            }
+            double a = it->heap[0].a, b = it->heap[0].b, mid = 0.5 * (a + b);
+            if (it->size >= limit || !(a < mid && mid < b)) {
+                it->state = QUAD_STALLED;
+                continue;
+            }
+            quad_panel worst = heap_pop(it);
+            it->result -= worst.result;
+            it->error -= worst.error;
+            owner[np] = i;
+            lim[2 * np] = a;
+            lim[2 * np + 1] = mid;
+            np++;
+            owner[np] = i;
+            lim[2 * np] = mid;
+            lim[2 * np + 1] = b;
+            np++;
+        }
+        if (np == 0) {
+            break;
+        }
+        if (eval_reserve(ev, np * per_panel) < 0) {
+            goto done;
+        }
+        for (Py_ssize_t p = 0; p < np; p++) {
+            gk_queue(ev, rule, &items[owner[p]].range, lim[2 * p], lim[2 * p + 1]);
+        }
+        if (eval_flush(ev) < 0) {
+            goto done;
+        }
+        for (Py_ssize_t p = 0; p < np; p++) {
+            quad_item* it = &items[owner[p]];
+            quad_panel panel = gk_panel(rule, ev->fx + p * per_panel, lim[2 * p], lim[2 * p + 1]);
+            if (item_reserve(it, 1) < 0) {
+                goto done;
+            }
+            heap_push(it, panel);
+            it->result += panel.result;
+            it->error += panel.error;
+        }
+    }
+    // The running sums drift after many subtractions; report sums over the final panels.
+    for (Py_ssize_t i = 0; i < n; i++) {
+        quad_item* it = &items[i];
+        double result = 0.0, error = 0.0;
+        for (Py_ssize_t k = 0; k < it->size; k++) {
+            result += it->heap[k].result;
+            error += it->heap[k].error;
+        }
+        it->result = result;
+        it->error = error;
+    }
+    status = 0;
+done:
+    PyMem_Free(owner);
+    PyMem_Free(lim);
+    return status;
+}
+
+// -----------------------------------------------------------------------------
+// Tanh-Sinh
+// x = c + h * tanh(pi/2 sinh t) with weight h * pi/2 cosh t / cosh^2(pi/2 sinh t), sampled at
+// t = k * 2^-level. Node density grows double-exponentially towards the ends, which absorbs
+// integrable endpoint singularities. Each level adds the odd multiples of the new step, so no
+// node is evaluated twice. The distance to the nearer end is computed directly as
+// 1 - tanh(u) = 2 / (1 + e^(2u)), and a side stops once a node would round onto its end or its
+// weight underflows.
+// -----------------------------------------------------------------------------
+
+#define TS_TMAX 6.5
+#define HALF_PI 1.57079632679489661923
+#define TS_MIN_LEVEL 3
+
+static Py_ssize_t ts_queue_side(quad_eval* ev, const quad_range* r, double t0, double step, double* w) {
+    double h = 0.5 * (r->tb - r->ta);
+    Py_ssize_t count = 0;
+    for (int side = 0; side < 2; side++) {
+        double end = side ? r->tb : r->ta;
+        for (double t = t0; t <= TS_TMAX; t += step) {
+            double u = HALF_PI * sinh(t);
+            double d = 2.0 / (1.0 + exp(2.0 * u));
+            double weight = h * HALF_PI * cosh(t) * d * (2.0 - d);
+            double off = h * d;
+            if (weight < DBL_MIN || off <= DBL_EPSILON * fabs(end)) {
+                break;
+            }
+            double tx = side ? end - off : end + off;
+            double jac;
+            range_map(r, tx, &jac);
+            if (!calco_isfinite(weight * jac)) {
+                break;
+            }
+            if (w != NULL) {
+                w[ev->n] = weight;
+                eval_push(ev, r, tx);
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+// Queues the nodes of one level (with weights in w) and returns their count; with w NULL,
+// only counts them.
+static Py_ssize_t ts_queue_level(quad_eval* ev, const quad_range* r, int level, double* w) {
+    Py_ssize_t count = 0;
+    if (level == 0) {
+        if (w != NULL) {
+            w[ev->n] = 0.5 * (r->tb - r->ta) * HALF_PI;
+            eval_push(ev, r, 0.5 * (r->ta + r->tb));
+        }
+        return 1 + ts_queue_side(ev, r, 1.0, 1.0, w);
+    }
+    double step = ldexp(1.0, -level);
+    count += ts_queue_side(ev, r, step, 2.0 * step, w);
+    return count;
+}
+
+static int run_tanh_sinh(quad_item* items, Py_ssize_t n, quad_eval* ev, double epsabs, double epsrel,
+                         int max_level, int* levels) {
+    // Per item: weighted sum so far and the previous level's estimate; result holds the
+    // current estimate.
+    double* sum = (double*)PyMem_Calloc(2 * n + 1, sizeof(double));
+    Py_ssize_t* start = (Py_ssize_t*)PyMem_Malloc((n + 1) * sizeof(Py_ssize_t));
+    double* w = NULL;
+    Py_ssize_t wcap = 0;
+    int status = -1;
+    if (sum == NULL || start == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    double* prev = sum + n;
+    for (int level = 0; level <= max_level; level++) {
+        Py_ssize_t total = 0;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            if (items[i].state == QUAD_RUNNING) {
+                total += ts_queue_level(ev, &items[i].range, level, NULL);
+            }
+        }
+        if (total == 0) {
+            break;
+        }
+        *levels = level + 1;
+        if (eval_reserve(ev, total) < 0) {
+            goto done;
+        }
+        if (total > wcap) {
+            PyMem_Free(w);
+            wcap = ev->cap;
+            w = (double*)PyMem_Malloc(wcap * sizeof(double));
+            if (w == NULL) {
+                PyErr_NoMemory();
+                goto done;
+            }
+        }
+        for (Py_ssize_t i = 0; i < n; i++) {
+            start[i] = ev->n;
+            if (items[i].state == QUAD_RUNNING) {
+                ts_queue_level(ev, &items[i].range, level, w);
+            }
+        }
+        start[n] = ev->n;
+        if (eval_flush(ev) < 0) {
+            goto done;
+        }
+        double step = ldexp(1.0, -level);
+        for (Py_ssize_t i = 0; i < n; i++) {
+            quad_item* it = &items[i];
+            if (it->state != QUAD_RUNNING) {
+                continue;
+            }
+            for (Py_ssize_t k = start[i]; k < start[i + 1]; k++) {
+                sum[i] += w[k] * ev->fx[k];
+            }
+            prev[i] = it->result;
+            it->result = step * sum[i];
+            it->error = fabs(it->result - prev[i]);
+            if (level >= TS_MIN_LEVEL && item_tolerance_met(it, epsabs, epsrel)) {
+                it->state = QUAD_CONVERGED;
+            }
+        }
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (items[i].state == QUAD_RUNNING) {
+            items[i].state = QUAD_STALLED;
+        }
+    }
+    status = 0;
+done:
+    PyMem_Free(sum);
+    PyMem_Free(start);
+    PyMem_Free(w);
+    return status;
+}
+
+// -----------------------------------------------------------------------------
+// calco.quad
+// -----------------------------------------------------------------------------
+
+// Reads a limit as either one float (*n left unchanged, returns 0) or a float64 buffer or
+// sequence (*n set, returns 1). Returns -1 with an exception set on failure.
+static int read_limits(PyObject* obj, double* scalar, double** values, Py_ssize_t* n) {
+    if (PyFloat_Check(obj) || PyLong_Check(obj)) {
+        *scalar = PyFloat_AsDouble(obj);
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    *values = calco_read_doubles(obj, n);
+    return (*values == NULL) ? -1 : 1;
+}
+
+PyObject* calco_quad(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"f", "a", "b", "epsabs", "epsrel", "limit", "rule", "vectorized", "full_output", NULL};
+    PyObject *func, *a_obj, *b_obj, *limit_obj = Py_None;
+    double epsabs = 1.49e-8, epsrel = 1.49e-8;
+    const char* rule_name = "gk21";
+    int vectorized = 1, full_output = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|$ddOspp", kwlist, &func, &a_obj, &b_obj, &epsabs,
+                                     &epsrel, &limit_obj, &rule_name, &vectorized, &full_output)) {
+        return NULL;
+    }
+    const gk_rule* rule = NULL;
+    if (strcmp(rule_name, "gk21") == 0) {
+        rule = &gk21;
+    } else if (strcmp(rule_name, "gk15") == 0) {
+        rule = &gk15;
+    } else if (strcmp(rule_name, "tanh-sinh") != 0) {
+        PyErr_Format(PyExc_ValueError, "unknown rule '%s' (expected 'gk21', 'gk15' or 'tanh-sinh')", rule_name);
+        return NULL;
+    }
+    Py_ssize_t limit = (rule != NULL) ? 50 : 10;
+    if (limit_obj != Py_None) {
+        limit = PyLong_AsSsize_t(limit_obj);
+        if (limit == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (limit < 1 || (rule == NULL && limit > 30)) {
+            PyErr_SetString(PyExc_ValueError, "limit must be at least 1 (and at most 30 levels for tanh-sinh)");
+            return NULL;
+        }
+    }
+
+    quad_eval ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.vectorized = vectorized;
+    if (PyUnicode_Check(func) || PyCFunction_Check(func)) {
+        const calco_unary_entry* e = calco_lookup_unary(func);
+        if (e != NULL) {
+            ev.kernel = e->kernel;
+        } else if (PyUnicode_Check(func)) {
+            return NULL;
+        } else {
+            PyErr_Clear(); // Some other builtin, called like any Python integrand
+        }
+    }
+    if (ev.kernel == NULL) {
+        if (!PyCallable_Check(func)) {
+            PyErr_SetString(PyExc_TypeError, "f must be callable or the name of a unary calco function");
+            return NULL;
+        }
+        ev.func = func;
+    }
+
+    // Limits: scalars give one integral, buffers (or sequences) a batch, broadcasting scalars.
+    double a = 0.0, b = 0.0;
+    double *av = NULL, *bv = NULL;
+    Py_ssize_t na = 1, nb = 1;
+    int ka = read_limits(a_obj, &a, &av, &na);
+    int kb = (ka < 0) ? -1 : read_limits(b_obj, &b, &bv, &nb);
+    PyObject* result = NULL;
+    quad_item* items = NULL;
+    Py_ssize_t n = (na > nb) ? na : nb;
+    if (kb < 0) {
+        goto done;
+    }
+    if ((ka == 1 && kb == 1 && na != nb)) {
+        PyErr_SetString(PyExc_ValueError, "a and b must have the same length");
+        goto done;
+    }
+    items = (quad_item*)PyMem_Calloc(n > 0 ? n : 1, sizeof(quad_item));
+    if (items == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double ai = (ka == 1) ? av[i] : a, bi = (kb == 1) ? bv[i] : b;
+        range_init(&items[i].range, ai, bi);
+        if (calco_isnan(ai) || calco_isnan(bi)) {
+            items[i].result = NAN;
+            items[i].error = NAN;
+            items[i].state = QUAD_CONVERGED;
+        } else if (ai == bi) {
+            items[i].state = QUAD_CONVERGED;
+        }
+    }
+    int levels = 0;
+    int rc = (rule != NULL) ? run_gk(items, n, rule, &ev, epsabs, epsrel, limit)
+                            : run_tanh_sinh(items, n, &ev, epsabs, epsrel, (int)limit, &levels);
+    if (rc < 0) {
+        goto done;
+    }
+    Py_ssize_t stalled = 0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        items[i].result *= items[i].range.sign;
+        stalled += (items[i].state == QUAD_STALLED);
+    }
+    if (stalled > 0) {
+        int w = (n == 1 && ka == 0 && kb == 0)
+            ? PyErr_WarnEx(PyExc_RuntimeWarning,
+                           "quad: the requested tolerance was not reached (limit hit or roundoff); "
+                           "the error estimate may be large", 1)
+            : PyErr_WarnFormat(PyExc_RuntimeWarning, 1,
+                               "quad: %zd of %zd integrals did not reach the requested tolerance", stalled, n);
+        if (w < 0) {
+            goto done;
+        }
+    }
+
+    PyObject *value, *error;
+    if (ka == 0 && kb == 0) {
+        value = PyFloat_FromDouble(items[0].result);
+        error = PyFloat_FromDouble(items[0].error);
+    } else {
+        Py_buffer vview, eview;
+        value = calco_new_double_array(n, &vview);
+        error = (value == NULL) ? NULL : calco_new_double_array(n, &eview);
+        if (error != NULL) {
+            for (Py_ssize_t i = 0; i < n; i++) {
+                ((double*)vview.buf)[i] = items[i].result;
+                ((double*)eview.buf)[i] = items[i].error;
+            }
+            PyBuffer_Release(&vview);
+            PyBuffer_Release(&eview);
+        } else if (value != NULL) {
+            PyBuffer_Release(&vview);
+        }
+    }
+    if (value == NULL || error == NULL) {
+        Py_XDECREF(value);
+        Py_XDECREF(error);
+        goto done;
+    }
+    if (!full_output) {
+        result = Py_BuildValue("(NN)", value, error);
+        goto done;
+    }
+    // Refinement is reported as the total panel count (Gauss-Kronrod) or the levels reached.
+    Py_ssize_t refined = levels;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        refined += items[i].size;
+    }
+    result = Py_BuildValue("(NN{s:n,s:n,s:n,s:O})", value, error, "neval", ev.neval, "ncalls", ev.ncalls,
+                           (rule != NULL) ? "intervals" : "levels", refined, "converged",
+                           stalled ? Py_False : Py_True);
+done:
+    if (items != NULL) {
+        for (Py_ssize_t i = 0; i < n; i++) {
+            PyMem_Free(items[i].heap);
+        }
+        PyMem_Free(items);
+    }
+    PyMem_Free(ev.x);
+    PyMem_Free(av);
+    PyMem_Free(bv);
+    return result;
+}
@@ -0,0 +1,465 @@
+// calco_quantize.c
+// Contains quantize and dequantize: rounding float buffers to integer buffers with an explicit
+// rounding mode, a step and offset, and a clamp, all in one pass.
+//
+// q = clamp(round((x - offset) / step), lo, hi), saturated to the range of the integer type, with
+// round one of floor, ceil, trunc, half_away, half_even or stochastic. No mode touches the FPU
+// rounding state: round-half-even is (t + 2^52) - 2^52 (with the sign of t), which the default
+// rounding mode performs exactly for |t| < 2^52, and the other modes correct it with a compare.
+// The integer is then produced by a truncating conversion of a value that is already integral
+// and in range, so every loop vectorizes with the packed convert instructions. NaN becomes
+// clamp(0). Stochastic rounding rounds up with probability frac(t), using the uniform draws of
+// calco.random.Generator(seed) at the element's index, so the result does not depend on the
+// number of threads.
+//
+// -ffast-math would fold (t + c) - c to t and turn the division by step into a multiplication
+// by its reciprocal (which misplaces values that land exactly on a bucket edge), so this file
+// is compiled with the unsafe math optimizations turned off.
+
+#if defined(__clang__)
+#pragma float_control(precise, on)
+#elif defined(__GNUC__)
+#pragma GCC optimize("no-unsafe-math-optimizations", "no-trapping-math") // -fno-reciprocal-math alone keeps the hoisted 1/step
+#endif
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isnan (isnan is folded away under -ffast-math)
+
+#include <stdint.h>
+#include <string.h>
+
+#define QZ_BLOCK 512
+
+typedef enum { ROUND_FLOOR, ROUND_CEIL, ROUND_TRUNC, ROUND_HALF_AWAY, ROUND_HALF_EVEN, ROUND_STOCHASTIC } round_mode;
+
+static const char* const mode_names[] = {"floor", "ceil", "trunc", "half_away", "half_even", "stochastic", NULL};
+
+// -----------------------------------------------------------------------------
+// Integer Types
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    const char* name;
+    char code;      // array typecode / canonical buffer format
+    double min, max;
+} int_type;
+
+static const int_type int_types[] = {
+    {"int8", 'b', -128.0, 127.0},
+    {"int16", 'h', -32768.0, 32767.0},
+    {"int32", 'i', -2147483648.0, 2147483647.0},
+    {"int64", 'q', -9223372036854775808.0, 9223372036854775808.0}, // 2^63 saturates to INT64_MAX
+    {"uint8", 'B', 0.0, 255.0},
+    {"uint16", 'H', 0.0, 65535.0},
+    {"uint32", 'I', 0.0, 4294967295.0},
+    {NULL, 0, 0.0, 0.0}
+};
+
+static const int_type* find_int_type(const char* name) {
+    for (const int_type* t = int_types; t->name != NULL; t++) {
+        if (strcmp(t->name, name) == 0 || (name[0] == t->code && name[1] == 0)) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static const int_type* int_type_of(char code) {
+    for (const int_type* t = int_types; t->name != NULL; t++) {
+        if (t->code == code) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Rounding Kernels
+// -----------------------------------------------------------------------------
+
+// Nearest integer, ties to even, in the default rounding mode; |t| >= 2^52 is already integral.
+static inline double rint_even(double t) {
+    double s = copysign(0x1p52, t);
+    double r = (t + s) - s;
+    return (fabs(t) < 0x1p52) ? r : t;
+}
+
+static inline double floor_fast(double t) {
+    double r = rint_even(t);
+    return r - ((r > t) ? 1.0 : 0.0);
+}
+
+typedef struct {
+    round_mode mode;
+    double step, offset;
+    double lo, hi;        // Clamp in output units, already intersected with the type's range
+    double nan_value;     // clamp(0)
+    uint64_t seed;
+    const void* x;
+    int x_float32;
+    void* out;
+    char code;
+    Py_ssize_t n;
+} qz_task;
+
+// Rounds and clamps x[0, n) (element index first onwards) into r.
+static void round_block(const qz_task* t, const double* x, double* r, Py_ssize_t n, uint64_t first) {
+    double step = t->step, offset = t->offset, lo = t->lo, hi = t->hi;
+    switch (t->mode) {
+    case ROUND_FLOOR:
+        for (Py_ssize_t i = 0; i < n; i++) {
+            r[i] = floor_fast((x[i] - offset) / step);
+        }
+        break;
+    case ROUND_CEIL:
+        for (Py_ssize_t i = 0; i < n; i++) {
+            double v = (x[i] - offset) / step;
+            double e = rint_even(v);
+            r[i] = e + ((e < v) ? 1.0 : 0.0);
+        }
+        break;
+    case ROUND_TRUNC:
+        for (Py_ssize_t i = 0; i < n; i++) {
+            double v = (x[i] - offset) / step;
+            double e = rint_even(v);
+            r[i] = (fabs(e) > fabs(v)) ? e - copysign(1.0, v) : e;
+        }
+        break;
+    case ROUND_HALF_AWAY:
+        for (Py_ssize_t i = 0; i < n; i++) {
+            double v = (x[i] - offset) / step;
+            double e = rint_even(v);
+            r[i] = (fabs(v - e) == 0.5) ? v + copysign(0.5, v) : e;
+        }
+        break;
+    case ROUND_HALF_EVEN:
+        for (Py_ssize_t i = 0; i < n; i++) {
+            r[i] = rint_even((x[i] - offset) / step);
+        }
+        break;
+    case ROUND_STOCHASTIC:
+        calco_random_uniform(t->seed, 0, first, n, r);
+        for (Py_ssize_t i = 0; i < n; i++) {
+            double v = (x[i] - offset) / step;
+            double f = floor_fast(v);
+            r[i] = f + ((r[i] < v - f) ? 1.0 : 0.0);
+        }
+        break;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double v = (r[i] < lo) ? lo : r[i];
+        r[i] = (v > hi) ? hi : v;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) { // Rare: a compare-and-branch pass outside the vector loops
+        if (calco_isnan(x[i])) {
+            r[i] = t->nan_value;
+        }
+    }
+}
+
+// Stores integral, in-range doubles as the output type.
+static void store_ints(char code, const double* r, void* out, Py_ssize_t n) {
+    switch (code) {
+    case 'b': {
+        int8_t* o = (int8_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (int8_t)(int32_t)r[i];
+        }
+        break;
+    }
+    case 'h': {
+        int16_t* o = (int16_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (int16_t)(int32_t)r[i];
+        }
+        break;
+    }
+    case 'i': {
+        int32_t* o = (int32_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (int32_t)r[i];
+        }
+        break;
+    }
+    case 'B': {
+        uint8_t* o = (uint8_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (uint8_t)(int32_t)r[i];
+        }
+        break;
+    }
+    case 'H': {
+        uint16_t* o = (uint16_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (uint16_t)(int32_t)r[i];
+        }
+        break;
+    }
+    case 'I': {
+        uint32_t* o = (uint32_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (uint32_t)(int64_t)r[i];
+        }
+        break;
+    }
+    default: {
+        int64_t* o = (int64_t*)out;
+        for (Py_ssize_t i = 0; i < n; i++) {
+            o[i] = (r[i] >= 0x1p63) ? INT64_MAX : (int64_t)r[i];
+        }
+        break;
+    }
+    }
+}
+
+static void quantize_range(const qz_task* t, Py_ssize_t start, Py_ssize_t end) {
+    double xb[QZ_BLOCK], rb[QZ_BLOCK];
+    Py_ssize_t size = (t->code == 'b' || t->code == 'B') ? 1 : (t->code == 'h' || t->code == 'H') ? 2
+                    : (t->code == 'q') ? 8 : 4;
+    for (Py_ssize_t i = start; i < end; i += QZ_BLOCK) {
+        Py_ssize_t m = (end - i < QZ_BLOCK) ? end - i : QZ_BLOCK;
+        const double* x;
+        if (t->x_float32) {
+            const float* xf = (const float*)t->x + i;
+            for (Py_ssize_t j = 0; j < m; j++) {
+                xb[j] = xf[j];
+            }
+            x = xb;
+        } else {
+            x = (const double*)t->x + i;
+        }
+        round_block(t, x, rb, m, (uint64_t)i);
+        store_ints(t->code, rb, (char*)t->out + i * size, m);
+    }
+}
+
+static void quantize_chunk(void* ctx, Py_ssize_t chunk) {
+    const qz_task* t = (const qz_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    quantize_range(t, start, end);
+}
+
+// -----------------------------------------------------------------------------
+// Dequantization
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    double step, offset;
+    const void* q;
+    char code;
+    void* out;
+    int out_float32;
+    Py_ssize_t n;
+} dq_task;
+
+#define DQ_LOOP(T) \
+    do { \
+        const T* q = (const T*)t->q; \
+        if (t->out_float32) { \
+            float* o = (float*)t->out; \
+            for (Py_ssize_t i = start; i < end; i++) { \
+                o[i] = (float)((double)q[i] * step + offset); \
+            } \
+        } else { \
+            double* o = (double*)t->out; \
+            for (Py_ssize_t i = start; i < end; i++) { \
+                o[i] = (double)q[i] * step + offset; \
+            } \
+        } \
+    } while (0)
+
+static void dequantize_chunk(void* ctx, Py_ssize_t chunk) {
+    const dq_task* t = (const dq_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    double step = t->step, offset = t->offset;
+    switch (t->code) {
+    case 'b': DQ_LOOP(int8_t); break;
+    case 'h': DQ_LOOP(int16_t); break;
+    case 'i': DQ_LOOP(int32_t); break;
+    case 'q': DQ_LOOP(int64_t); break;
+    case 'B': DQ_LOOP(uint8_t); break;
+    case 'H': DQ_LOOP(uint16_t); break;
+    case 'I': DQ_LOOP(uint32_t); break;
+    default: DQ_LOOP(uint64_t); break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers
+// -----------------------------------------------------------------------------
+
+// Reads an optional integer bound; returns 0, or -1 with an exception set.
+static int read_bound(PyObject* obj, double* bound) {
+    if (obj == Py_None) {
+        return 0;
+    }
+    double v = PyFloat_AsDouble(obj);
+    if (v == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    *bound = v;
+    return 0;
+}
+
+PyObject* calco_quantize(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"x", "step", "offset", "lo", "hi", "mode", "dtype", "out", "seed", NULL};
+    PyObject *x, *lo_obj = Py_None, *hi_obj = Py_None, *out = Py_None, *out_obj;
+    const char *mode_name = "half_even", *dtype = NULL;
+    unsigned long long seed = 0;
+    qz_task t;
+    memset(&t, 0, sizeof(t));
+    t.step = 1.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|d$dOOszOK", kwlist, &x, &t.step, &t.offset, &lo_obj, &hi_obj,
+                                     &mode_name, &dtype, &out, &seed)) {
+        return NULL;
+    }
+    int mode = 0;
+    while (mode_names[mode] != NULL && strcmp(mode_names[mode], mode_name) != 0) {
+        mode++;
+    }
+    if (mode_names[mode] == NULL) {
+        PyErr_Format(PyExc_ValueError, "unknown rounding mode '%s' (expected floor, ceil, trunc, half_away, "
+                                       "half_even or stochastic)", mode_name);
+        return NULL;
+    }
+    if (!(t.step > 0.0) || !calco_isfinite(t.step) || !calco_isfinite(t.offset)) {
+        PyErr_SetString(PyExc_ValueError, "step must be finite and positive, and offset finite");
+        return NULL;
+    }
+    t.mode = (round_mode)mode;
+    t.seed = seed;
+    double lo = 0.0, hi = 0.0;
+    if (read_bound(lo_obj, &lo) < 0 || read_bound(hi_obj, &hi) < 0) {
+        return NULL;
+    }
+    if (lo_obj != Py_None && hi_obj != Py_None && lo > hi) {
+        PyErr_SetString(PyExc_ValueError, "lo must not exceed hi");
+        return NULL;
+    }
+
+    Py_buffer in_view, out_view;
+    const int_type* type = NULL;
+    int scalar = PyFloat_Check(x) || PyLong_Check(x);
+    double xv = 0.0;
+    if (scalar) {
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires a buffer argument");
+            return NULL;
+        }
+        xv = PyFloat_AsDouble(x);
+        if (xv == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    if (dtype != NULL && (type = find_int_type(dtype)) == NULL) {
+        PyErr_Format(PyExc_ValueError, "unsupported dtype '%s' (expected int8/16/32/64 or uint8/16/32)", dtype);
+        return NULL;
+    }
+    if (out != Py_None) {
+        int code = calco_get_typed_buffer(out, &out_view, 1, "bhiqBHI");
+        if (code < 0) {
+            return NULL;
+        }
+        if (type != NULL && type->code != code) {
+            PyBuffer_Release(&out_view);
+            PyErr_SetString(PyExc_ValueError, "dtype does not match the element type of out");
+            return NULL;
+        }
+        type = int_type_of((char)code);
+    } else if (type == NULL) {
+        type = int_type_of('q');
+    }
+    // Bounds in output units, inside the type's range; ceil/floor of fractional bounds.
+    t.lo = (lo_obj != Py_None && ceil(lo) > type->min) ? ceil(lo) : type->min;
+    t.hi = (hi_obj != Py_None && floor(hi) < type->max) ? floor(hi) : type->max;
+    t.nan_value = (0.0 < t.lo) ? t.lo : (0.0 > t.hi) ? t.hi : 0.0;
+    t.code = type->code;
+
+    if (scalar) {
+        double r;
+        round_block(&t, &xv, &r, 1, 0);
+        return (r >= 0x1p63) ? PyLong_FromLongLong(INT64_MAX) : PyLong_FromLongLong((long long)r);
+    }
+    int fmt = calco_get_typed_buffer(x, &in_view, 0, "df");
+    if (fmt < 0) {
+        if (out != Py_None) {
+            PyBuffer_Release(&out_view);
+        }
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / in_view.itemsize;
+    if (out == Py_None) {
+        if ((out_obj = calco_new_array(type->code, n, &out_view)) == NULL) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+    } else {
+        if (out_view.len / out_view.itemsize < n) {
+            PyBuffer_Release(&in_view);
+            PyBuffer_Release(&out_view);
+            PyErr_SetString(PyExc_ValueError, "out buffer is smaller than the input");
+            return NULL;
+        }
+        Py_INCREF(out);
+        out_obj = out;
+    }
+    t.x = in_view.buf;
+    t.x_float32 = (fmt == 'f');
+    t.out = out_view.buf;
+    t.n = n;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(quantize_chunk, &t, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+PyObject* calco_dequantize(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"q", "step", "offset", "out", NULL};
+    PyObject *q, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    dq_task t = {1.0, 0.0, NULL, 0, NULL, 0, 0};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|d$dO", kwlist, &q, &t.step, &t.offset, &out)) {
+        return NULL;
+    }
+    int code = calco_get_typed_buffer(q, &in_view, 0, "bhiqBHIQ");
+    if (code < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / in_view.itemsize;
+    if (out == Py_None) {
+        out_obj = calco_new_double_array(n, &out_view);
+        if (out_obj == NULL) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+    } else {
+        int fmt = calco_get_typed_buffer(out, &out_view, 1, "df");
+        if (fmt < 0) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+        if (out_view.len / out_view.itemsize < n) {
+            PyBuffer_Release(&in_view);
+            PyBuffer_Release(&out_view);
+            PyErr_SetString(PyExc_ValueError, "out buffer is smaller than the input");
+            return NULL;
+        }
+        t.out_float32 = (fmt == 'f');
+        Py_INCREF(out);
+        out_obj = out;
+    }
+    t.q = in_view.buf;
+    t.code = (char)code;
+    t.out = out_view.buf;
+    t.n = n;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(dequantize_chunk, &t, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
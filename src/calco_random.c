@@ -0,0 +1,562 @@
+// calco_random.c
+// Contains the counter-based random number generator (the calco.random submodule).
+//
+// Variates are produced by Philox4x32-10. Output element i of a generator with key k and
+// stream s is derived only from the counter (position + i, s, draw), never from a running
+// state, so any slice of the output can be computed independently. This gives cheap
+// jump-ahead, independent streams per thread, and output that is identical no matter how
+// many worker threads fill the buffer.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Philox4x32-10
+// -----------------------------------------------------------------------------
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+static inline void philox4x32(uint32_t c[4], uint32_t k0, uint32_t k1) {
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[0] = n0;
+        c[1] = (uint32_t)p1;
+        c[2] = n2;
+        c[3] = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+#define TO_UNIT(r) ((double)((r) >> 11) * (1.0 / 9007199254740992.0)) // [0, 1) with 53 bits
+
+// Per-element substream: successive 64-bit draws for element `index`.
+typedef struct {
+    uint32_t k0, k1;
+    uint32_t ctr[4];
+    uint32_t out[4];
+    int avail;
+} substream;
+
+static inline void substream_init(substream* s, uint32_t k0, uint32_t k1, uint64_t index, uint32_t stream) {
+    s->k0 = k0;
+    s->k1 = k1;
+    s->ctr[0] = (uint32_t)index;
+    s->ctr[1] = (uint32_t)(index >> 32);
+    s->ctr[2] = stream;
+    s->ctr[3] = 0;
+    s->avail = 0;
+}
+
+static inline uint64_t substream_next(substream* s) {
+    if (s->avail == 0) {
+        s->out[0] = s->ctr[0];
+        s->out[1] = s->ctr[1];
+        s->out[2] = s->ctr[2];
+        s->out[3] = s->ctr[3]++;
+        philox4x32(s->out, s->k0, s->k1);
+        s->avail = 2;
+    }
+    int i = 2 * (2 - s->avail--);
+    return (uint64_t)s->out[i] | ((uint64_t)s->out[i + 1] << 32);
+}
+
+static inline double substream_uniform(substream* s) {
+    return TO_UNIT(substream_next(s));
+}
+
+// -----------------------------------------------------------------------------
+// Ziggurat Tables (256 layers, Marsaglia & Tsang)
+// -----------------------------------------------------------------------------
+
+#define ZIG_R 3.6541528853610088
+#define ZIG_V 0.00492867323399
+
+static uint64_t zig_k[256];
+static double zig_w[256];
+static double zig_f[256];
+
+static void ziggurat_init(void) {
+    const double m = 4503599627370496.0; // 2^52
+    double dn = ZIG_R, tn = dn;
+    double q = ZIG_V / exp(-0.5 * dn * dn);
+    zig_k[0] = (uint64_t)((dn / q) * m);
+    zig_k[1] = 0;
+    zig_w[0] = q / m;
+    zig_w[255] = dn / m;
+    zig_f[0] = 1.0;
+    zig_f[255] = exp(-0.5 * dn * dn);
+    for (int i = 254; i >= 1; i--) {
+        dn = sqrt(-2.0 * log(ZIG_V / dn + exp(-0.5 * dn * dn)));
+        zig_k[i + 1] = (uint64_t)((dn / tn) * m);
+        tn = dn;
+        zig_f[i] = exp(-0.5 * dn * dn);
+        zig_w[i] = dn / m;
+    }
+}
+
+static double substream_normal(substream* s) {
+    for (;;) {
+        uint64_t r = substream_next(s);
+        int idx = (int)(r & 0xff);
+        r >>= 8;
+        int neg = (int)(r & 1);
+        uint64_t rabs = (r >> 1) & 0x000fffffffffffffULL;
+        double x = (double)rabs * zig_w[idx];
+        if (neg) {
+            x = -x;
+        }
+        if (rabs < zig_k[idx]) {
+            return x; // Inside the rectangle: ~99% of draws
+        }
+        if (idx == 0) {
+            // Tail beyond ZIG_R
+            for (;;) {
+                double xx = -log1p(-substream_uniform(s)) / ZIG_R;
+                double yy = -log1p(-substream_uniform(s));
+                if (yy + yy > xx * xx) {
+                    return neg ? -(ZIG_R + xx) : (ZIG_R + xx);
+                }
+            }
+        }
+        if ((zig_f[idx - 1] - zig_f[idx]) * substream_uniform(s) + zig_f[idx] < exp(-0.5 * x * x)) {
+            return x;
+        }
+    }
+}
+
+static double substream_gamma(substream* s, double shape) {
+    if (shape < 1.0) {
+        // Boost: Gamma(a) = Gamma(a + 1) * U^(1/a)
+        double g = substream_gamma(s, shape + 1.0);
+        return g * pow(substream_uniform(s), 1.0 / shape);
+    }
+    // Marsaglia & Tsang
+    double d = shape - 1.0 / 3.0;
+    double c = 1.0 / sqrt(9.0 * d);
+    for (;;) {
+        double x, v;
+        do {
+            x = substream_normal(s);
+            v = 1.0 + c * x;
+        } while (v <= 0.0);
+        v = v * v * v;
+        double u = substream_uniform(s);
+        double x2 = x * x;
+        if (u < 1.0 - 0.0331 * x2 * x2) {
+            return d * v;
+        }
+        if (log(u) < 0.5 * x2 + d * (1.0 - v + log(v))) {
+            return d * v;
+        }
+    }
+}
+
+static double substream_beta(substream* s, double a, double b) {
+    if (a <= 1.0 && b <= 1.0) {
+        // Johnk's algorithm, in log space when both powers underflow
+        for (;;) {
+            double u = substream_uniform(s);
+            double v = substream_uniform(s);
+            double x = pow(u, 1.0 / a);
+            double y = pow(v, 1.0 / b);
+            if (x + y <= 1.0) {
+                if (x + y > 0.0) {
+                    return x / (x + y);
+                }
+                double lx = log(u) / a, ly = log(v) / b;
+                double lm = (lx > ly) ? lx : ly;
+                lx -= lm;
+                ly -= lm;
+                return exp(lx - log(exp(lx) + exp(ly)));
+            }
+        }
+    }
+    double x = substream_gamma(s, a);
+    double y = substream_gamma(s, b);
+    return x / (x + y);
+}
+
+// -----------------------------------------------------------------------------
+// Bulk Generation
+// -----------------------------------------------------------------------------
+
+enum { DIST_UNIFORM, DIST_NORMAL, DIST_EXPONENTIAL, DIST_GAMMA, DIST_BETA };
+
+typedef struct {
+    int dist;
+    double p1, p2;
+    uint32_t k0, k1, stream;
+    uint64_t first;         // Counter of element 0
+    void* out;
+    int is_float32;
+    Py_ssize_t n;
+} gen_task;
+
+#define LANES 8
+
+// Uniform [0, 1) doubles for elements first .. first+n-1. Lanes are independent so the
+// Philox rounds vectorise (32x32->64 multiplies map to pmuludq / vpmuludq).
+static void uniform_block(uint32_t k0, uint32_t k1, uint32_t stream, uint64_t first, Py_ssize_t n, double* dst) {
+    Py_ssize_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+        for (int l = 0; l < LANES; l++) {
+            uint64_t idx = first + (uint64_t)(i + l);
+            c0[l] = (uint32_t)idx;
+            c1[l] = (uint32_t)(idx >> 32);
+            c2[l] = stream;
+            c3[l] = 0;
+        }
+        uint32_t a = k0, b = k1;
+        for (int round = 0; round < 10; round++) {
+            for (int l = 0; l < LANES; l++) {
+                uint64_t p0 = (uint64_t)PHILOX_M0 * c0[l];
+                uint64_t p1 = (uint64_t)PHILOX_M1 * c2[l];
+                uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[l] ^ a;
+                uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[l] ^ b;
+                c0[l] = n0;
+                c1[l] = (uint32_t)p1;
+                c2[l] = n2;
+                c3[l] = (uint32_t)p0;
+            }
+            a += PHILOX_W0;
+            b += PHILOX_W1;
+        }
+        for (int l = 0; l < LANES; l++) {
+            uint64_t r = (uint64_t)c0[l] | ((uint64_t)c1[l] << 32);
+            dst[i + l] = TO_UNIT(r);
+        }
+    }
+    for (; i < n; i++) {
+        substream s;
+        substream_init(&s, k0, k1, first + (uint64_t)i, stream);
+        dst[i] = substream_uniform(&s);
+    }
+}
+
+// Elements first .. first+n-1 of Generator(seed, stream).uniform(), for kernels elsewhere that
+// need reproducible noise (stochastic rounding).
+void calco_random_uniform(uint64_t seed, uint32_t stream, uint64_t first, Py_ssize_t n, double* dst) {
+    uniform_block((uint32_t)seed, (uint32_t)(seed >> 32), stream, first, n, dst);
+}
+
+static void generate(const gen_task* t, Py_ssize_t start, Py_ssize_t n, double* dst) {
+    uint64_t first = t->first + (uint64_t)start;
+    switch (t->dist) {
+    case DIST_UNIFORM: {
+        double scale = t->p2 - t->p1;
+        uniform_block(t->k0, t->k1, t->stream, first, n, dst);
+        for (Py_ssize_t i = 0; i < n; i++) {
+            dst[i] = t->p1 + scale * dst[i];
+        }
+        return;
+    }
+    case DIST_EXPONENTIAL:
+        uniform_block(t->k0, t->k1, t->stream, first, n, dst);
+        for (Py_ssize_t i = 0; i < n; i++) {
+            dst[i] = -t->p1 * log1p(-dst[i]);
+        }
+        return;
+    default:
+        break;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        substream s;
+        substream_init(&s, t->k0, t->k1, first + (uint64_t)i, t->stream);
+        switch (t->dist) {
+        case DIST_NORMAL:
+            dst[i] = t->p1 + t->p2 * substream_normal(&s);
+            break;
+        case DIST_GAMMA:
+            dst[i] = t->p2 * substream_gamma(&s, t->p1);
+            break;
+        default:
+            dst[i] = substream_beta(&s, t->p1, t->p2);
+            break;
+        }
+    }
+}
+
+static void gen_chunk(void* ctx, Py_ssize_t chunk) {
+    const gen_task* t = (const gen_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = start + CALCO_DEFAULT_CHUNK;
+    if (end > t->n) {
+        end = t->n;
+    }
+    if (!t->is_float32) {
+        generate(t, start, end - start, (double*)t->out + start);
+        return;
+    }
+    double tmp[512];
+    float* out = (float*)t->out;
+    for (Py_ssize_t i = start; i < end; i += 512) {
+        Py_ssize_t m = (end - i < 512) ? end - i : 512;
+        generate(t, i, m, tmp);
+        for (Py_ssize_t j = 0; j < m; j++) {
+            out[i + j] = (float)tmp[j];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// calco.random.Generator
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    uint64_t seed;
+    uint32_t stream;
+    uint64_t position; // Counter of the next element to be generated
+} CalcoGenerator;
+
+static int generator_init(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"seed", "stream", NULL};
+    unsigned long long seed = 0;
+    unsigned int stream = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|KI", kwlist, &seed, &stream)) {
+        return -1;
+    }
+    self->seed = seed;
+    self->stream = stream;
+    self->position = 0;
+    return 0;
+}
+
+static PyObject* generator_fill(CalcoGenerator* self, int dist, double p1, double p2,
+                                PyObject* size, PyObject* out, int parallel) {
+    Py_buffer view;
+    PyObject* out_obj;
+    int fmt;
+    gen_task task = {dist, p1, p2, (uint32_t)self->seed, (uint32_t)(self->seed >> 32), self->stream, self->position, NULL, 0, 0};
+
+    if (size == Py_None && out == Py_None) {
+        double value;
+        generate(&task, 0, 1, &value);
+        self->position++;
+        return Py_BuildValue("d", value);
+    }
+    if (out != Py_None) {
+        if ((fmt = calco_get_typed_buffer(out, &view, 1, "df")) < 0) {
+            return NULL;
+        }
+        Py_INCREF(out);
+        out_obj = out;
+    } else {
+        Py_ssize_t n = PyLong_AsSsize_t(size);
+        if (n < 0) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+            }
+            return NULL;
+        }
+        fmt = 'd';
+        if ((out_obj = calco_new_array('d', n, &view)) == NULL) {
+            return NULL;
+        }
+    }
+    task.out = view.buf;
+    task.is_float32 = (fmt == 'f');
+    task.n = view.len / view.itemsize;
+    Py_ssize_t nchunks = (task.n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    Py_BEGIN_ALLOW_THREADS
+    if (parallel) {
+        calco_pool_parallel_for(gen_chunk, &task, nchunks);
+    } else {
+        for (Py_ssize_t c = 0; c < nchunks; c++) {
+            gen_chunk(&task, c);
+        }
+    }
+    Py_END_ALLOW_THREADS
+    self->position += (uint64_t)task.n;
+    PyBuffer_Release(&view);
+    return out_obj;
+}
+
+static PyObject* generator_uniform(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"size", "low", "high", "out", "parallel", NULL};
+    PyObject *size = Py_None, *out = Py_None;
+    double low = 0.0, high = 1.0;
+    int parallel = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Odd$Op", kwlist, &size, &low, &high, &out, &parallel)) {
+        return NULL;
+    }
+    return generator_fill(self, DIST_UNIFORM, low, high, size, out, parallel);
+}
+
+static PyObject* generator_normal(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"size", "loc", "scale", "out", "parallel", NULL};
+    PyObject *size = Py_None, *out = Py_None;
+    double loc = 0.0, scale = 1.0;
+    int parallel = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Odd$Op", kwlist, &size, &loc, &scale, &out, &parallel)) {
+        return NULL;
+    }
+    return generator_fill(self, DIST_NORMAL, loc, scale, size, out, parallel);
+}
+
+static PyObject* generator_exponential(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"size", "scale", "out", "parallel", NULL};
+    PyObject *size = Py_None, *out = Py_None;
+    double scale = 1.0;
+    int parallel = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Od$Op", kwlist, &size, &scale, &out, &parallel)) {
+        return NULL;
+    }
+    return generator_fill(self, DIST_EXPONENTIAL, scale, 0.0, size, out, parallel);
+}
+
+static PyObject* generator_gamma(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"shape", "size", "scale", "out", "parallel", NULL};
+    PyObject *size = Py_None, *out = Py_None;
+    double shape, scale = 1.0;
+    int parallel = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "d|Od$Op", kwlist, &shape, &size, &scale, &out, &parallel)) {
+        return NULL;
+    }
+    if (!(shape > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "shape must be > 0");
+        return NULL;
+    }
+    return generator_fill(self, DIST_GAMMA, shape, scale, size, out, parallel);
+}
+
+static PyObject* generator_beta(CalcoGenerator* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "size", "out", "parallel", NULL};
+    PyObject *size = Py_None, *out = Py_None;
+    double a, b;
+    int parallel = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "dd|O$Op", kwlist, &a, &b, &size, &out, &parallel)) {
+        return NULL;
+    }
+    if (!(a > 0.0) || !(b > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "a and b must be > 0");
+        return NULL;
+    }
+    return generator_fill(self, DIST_BETA, a, b, size, out, parallel);
+}
+
+static PyObject* generator_jump(CalcoGenerator* self, PyObject* args) {
+    unsigned long long n;
+    if (!PyArg_ParseTuple(args, "K", &n)) {
+        return NULL;
+    }
+    self->position += n;
+    Py_RETURN_NONE;
+}
+
+static PyObject* generator_spawn(CalcoGenerator* self, PyObject* args) {
+    unsigned int stream;
+    if (!PyArg_ParseTuple(args, "I", &stream)) {
+        return NULL;
+    }
+    CalcoGenerator* g = PyObject_New(CalcoGenerator, Py_TYPE(self));
+    if (g == NULL) {
+        return NULL;
+    }
+    g->seed = self->seed;
+    g->stream = stream;
+    g->position = 0;
+    return (PyObject*)g;
+}
+
+static PyObject* generator_get_position(CalcoGenerator* self, void* closure) {
+    return PyLong_FromUnsignedLongLong(self->position);
+}
+
+static int generator_set_position(CalcoGenerator* self, PyObject* value, void* closure) {
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete position");
+        return -1;
+    }
+    unsigned long long pos = PyLong_AsUnsignedLongLong(value);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    self->position = pos;
+    return 0;
+}
+
+static PyObject* generator_get_seed(CalcoGenerator* self, void* closure) {
+    return PyLong_FromUnsignedLongLong(self->seed);
+}
+
+static PyObject* generator_get_stream(CalcoGenerator* self, void* closure) {
+    return PyLong_FromUnsignedLong(self->stream);
+}
+
+// workspace= shims (calco_workspace.c)
+CALCO_WORKSPACE_SHIM(generator_uniform)
+CALCO_WORKSPACE_SHIM(generator_normal)
+CALCO_WORKSPACE_SHIM(generator_exponential)
+CALCO_WORKSPACE_SHIM(generator_gamma)
+CALCO_WORKSPACE_SHIM(generator_beta)
+
+static PyMethodDef generator_methods[] = {
+    {"uniform", (PyCFunction)(void(*)(void))generator_uniform_ws, METH_VARARGS | METH_KEYWORDS,
+     "uniform(size=None, low=0.0, high=1.0, *, out=None, parallel=True): Uniform variates on [low, high)."},
+    {"normal", (PyCFunction)(void(*)(void))generator_normal_ws, METH_VARARGS | METH_KEYWORDS,
+     "normal(size=None, loc=0.0, scale=1.0, *, out=None, parallel=True): Normal variates (ziggurat)."},
+    {"exponential", (PyCFunction)(void(*)(void))generator_exponential_ws, METH_VARARGS | METH_KEYWORDS,
+     "exponential(size=None, scale=1.0, *, out=None, parallel=True): Exponential variates."},
+    {"gamma", (PyCFunction)(void(*)(void))generator_gamma_ws, METH_VARARGS | METH_KEYWORDS,
+     "gamma(shape, size=None, scale=1.0, *, out=None, parallel=True): Gamma variates (Marsaglia-Tsang)."},
+    {"beta", (PyCFunction)(void(*)(void))generator_beta_ws, METH_VARARGS | METH_KEYWORDS,
+     "beta(a, b, size=None, *, out=None, parallel=True): Beta variates."},
+    {"jump", (PyCFunction)generator_jump, METH_VARARGS, "jump(n): Skips the next n elements in O(1)."},
+    {"spawn", (PyCFunction)generator_spawn, METH_VARARGS, "spawn(stream): Returns an independent generator with the same seed on another stream."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef generator_getset[] = {
+    {"position", (getter)generator_get_position, (setter)generator_set_position, "Counter of the next element to be generated.", NULL},
+    {"seed", (getter)generator_get_seed, NULL, "64-bit Philox key.", NULL},
+    {"stream", (getter)generator_get_stream, NULL, "Stream id; different streams never overlap.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject CalcoGeneratorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.random.Generator",
+    .tp_basicsize = sizeof(CalcoGenerator),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Generator(seed=0, stream=0): Counter-based (Philox4x32-10) random generator. "
+              "Output depends only on (seed, stream, position), never on the number of threads.",
+    .tp_methods = generator_methods,
+    .tp_getset = generator_getset,
+    .tp_init = (initproc)generator_init,
+    .tp_new = PyType_GenericNew,
+};
+
+// -----------------------------------------------------------------------------
+// Submodule Definition
+// -----------------------------------------------------------------------------
+
+struct PyModuleDef calcorandommodule = {
+    PyModuleDef_HEAD_INIT,
+    "calco.random",
+    "Counter-based random number generation with uniform, normal, exponential, gamma and beta variates.",
+    -1,
+    NULL
+};
+
+int calco_random_exec(PyObject* m) {
+    ziggurat_init();
+    if (PyType_Ready(&CalcoGeneratorType) < 0) {
+        return -1;
+    }
+    Py_INCREF(&CalcoGeneratorType);
+    if (PyModule_AddObject(m, "Generator", (PyObject*)&CalcoGeneratorType) < 0) {
+        Py_DECREF(&CalcoGeneratorType);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,538 @@
+// calco_register.c
+// Contains calco.Register, a mutable double for chained in-place arithmetic, and
+// calco.RegisterFile, a small fixed-size array of doubles addressed by index.
+// Every operation updates the C double(s) in place and returns the object itself, so a chain
+// of steps allocates nothing until the result is read through .value or float().
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stddef.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Unary Kernels
+// Register methods reuse the buffer kernels, so sqrt_() behaves exactly like calco.square_root.
+// -----------------------------------------------------------------------------
+
+#define REGISTER_UNARY_LIST(X) \
+    X(sqrt_, square_root) \
+    X(cbrt_, cube_root) \
+    X(abs_, absolute_value) \
+    X(floor_, floor_val) \
+    X(ceil_, ceil_val) \
+    X(round_, round_val) \
+    X(trunc_, truncate_val) \
+    X(log_, natural_log) \
+    X(log10_, log_base10) \
+    X(log2_, log_base2) \
+    X(exp_, exponential) \
+    X(exp2_, exponential_base2) \
+    X(expm1_, exponential_minus_1) \
+    X(sin_, sine) \
+    X(cos_, cosine) \
+    X(tan_, tangent) \
+    X(asin_, arcsine) \
+    X(acos_, arccosine) \
+    X(atan_, arctangent) \
+    X(sinh_, hyperbolic_sine) \
+    X(cosh_, hyperbolic_cosine) \
+    X(tanh_, hyperbolic_tangent) \
+    X(asinh_, inverse_hyperbolic_sine) \
+    X(acosh_, inverse_hyperbolic_cosine) \
+    X(atanh_, inverse_hyperbolic_tangent) \
+    X(gamma_, gamma_function) \
+    X(lgamma_, log_gamma_function) \
+    X(erf_, error_function) \
+    X(erfc_, complementary_error_function) \
+    X(radians_, degrees_to_radians) \
+    X(degrees_, radians_to_degrees)
+
+#define UNARY_ENUM(method, kernel) UNARY_##method,
+enum { REGISTER_UNARY_LIST(UNARY_ENUM) UNARY_COUNT };
+
+#define UNARY_NAME(method, kernel) #kernel,
+static const char* const unary_names[UNARY_COUNT] = { REGISTER_UNARY_LIST(UNARY_NAME) };
+static calco_unary_fn unary_kernels[UNARY_COUNT];
+
+// Resolves the kernels behind the unary methods. Called once from PyInit_calco.
+int calco_register_init(void) {
+    for (int i = 0; i < UNARY_COUNT; i++) {
+        if ((unary_kernels[i] = calco_unary_kernel(unary_names[i])) == NULL) {
+            PyErr_Format(PyExc_SystemError, "missing element kernel %s", unary_names[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Operand Helpers
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    double v;
+} CalcoRegister;
+
+// Reads a float, int or Register operand. Returns 0, or -1 with an exception set.
+static inline int operand(PyObject* o, double* v) {
+    if (PyFloat_CheckExact(o)) {
+        *v = PyFloat_AS_DOUBLE(o);
+        return 0;
+    }
+    if (Py_TYPE(o) == &CalcoRegisterType) {
+        *v = ((CalcoRegister*)o)->v;
+        return 0;
+    }
+    *v = PyFloat_AsDouble(o);
+    return (*v == -1.0 && PyErr_Occurred()) ? -1 : 0;
+}
+
+static int check_nargs(const char* name, Py_ssize_t nargs, Py_ssize_t expected) {
+    if (nargs != expected) {
+        PyErr_Format(PyExc_TypeError, "%s() takes exactly %zd argument%s (%zd given)",
+                     name, expected, expected == 1 ? "" : "s", nargs);
+        return 0;
+    }
+    return 1;
+}
+
+static inline PyObject* return_self(PyObject* self) {
+    Py_INCREF(self);
+    return self;
+}
+
+// -----------------------------------------------------------------------------
+// calco.Register
+// -----------------------------------------------------------------------------
+
+#define REGISTER_BINARY(name, expr) \
+    static PyObject* register_##name(CalcoRegister* self, PyObject* const* args, Py_ssize_t nargs) { \
+        double x; \
+        if (!check_nargs(#name, nargs, 1) || operand(args[0], &x) < 0) { \
+            return NULL; \
+        } \
+        self->v = (expr); \
+        return return_self((PyObject*)self); \
+    }
+
+REGISTER_BINARY(set, x)
+REGISTER_BINARY(iadd, self->v + x)
+REGISTER_BINARY(isub, self->v - x)
+REGISTER_BINARY(imul, self->v * x)
+REGISTER_BINARY(idiv, self->v / x)
+REGISTER_BINARY(ipow, calco_fast_pow(self->v, x))
+REGISTER_BINARY(rsub, x - self->v)
+REGISTER_BINARY(rdiv, x / self->v)
+REGISTER_BINARY(imin, (x < self->v) ? x : self->v)
+REGISTER_BINARY(imax, (x > self->v) ? x : self->v)
+
+#define REGISTER_TERNARY(name, expr) \
+    static PyObject* register_##name(CalcoRegister* self, PyObject* const* args, Py_ssize_t nargs) { \
+        double a, b; \
+        if (!check_nargs(#name, nargs, 2) || operand(args[0], &a) < 0 || operand(args[1], &b) < 0) { \
+            return NULL; \
+        } \
+        self->v = (expr); \
+        return return_self((PyObject*)self); \
+    }
+
+REGISTER_TERNARY(fma, fma(self->v, a, b))
+REGISTER_TERNARY(iaddmul, fma(a, b, self->v))
+REGISTER_TERNARY(isubmul, fma(-a, b, self->v))
+
+#define REGISTER_UNARY_METHOD(method, kernel) \
+    static PyObject* register_##method(CalcoRegister* self, PyObject* unused) { \
+        self->v = unary_kernels[UNARY_##method](self->v); \
+        return return_self((PyObject*)self); \
+    }
+REGISTER_UNARY_LIST(REGISTER_UNARY_METHOD)
+
+static PyObject* register_neg_(CalcoRegister* self, PyObject* unused) {
+    self->v = -self->v;
+    return return_self((PyObject*)self);
+}
+
+static PyObject* register_square_(CalcoRegister* self, PyObject* unused) {
+    self->v = self->v * self->v;
+    return return_self((PyObject*)self);
+}
+
+static PyObject* register_recip_(CalcoRegister* self, PyObject* unused) {
+    self->v = 1.0 / self->v;
+    return return_self((PyObject*)self);
+}
+
+// apply_(func): any unary calco function (or its name).
+static PyObject* register_apply_(CalcoRegister* self, PyObject* func) {
+    const calco_unary_entry* e = calco_lookup_unary(func);
+    if (e == NULL) {
+        return NULL;
+    }
+    self->v = e->kernel(self->v);
+    return return_self((PyObject*)self);
+}
+
+static PyObject* register_copy(CalcoRegister* self, PyObject* unused) {
+    CalcoRegister* r = PyObject_New(CalcoRegister, Py_TYPE(self));
+    if (r != NULL) {
+        r->v = self->v;
+    }
+    return (PyObject*)r;
+}
+
+static PyObject* register_vectorcall(PyObject* type, PyObject* const* args, size_t nargsf, PyObject* kwnames) {
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    Py_ssize_t nkw = (kwnames != NULL) ? PyTuple_GET_SIZE(kwnames) : 0;
+    double v = 0.0;
+    if (nargs + nkw > 1) {
+        PyErr_Format(PyExc_TypeError, "Register() takes at most 1 argument (%zd given)", nargs + nkw);
+        return NULL;
+    }
+    if (nkw == 1 && PyUnicode_CompareWithASCIIString(PyTuple_GET_ITEM(kwnames, 0), "value") != 0) {
+        PyErr_Format(PyExc_TypeError, "Register() got an unexpected keyword argument '%U'",
+                     PyTuple_GET_ITEM(kwnames, 0));
+        return NULL;
+    }
+    if (nargs + nkw == 1 && operand(args[0], &v) < 0) {
+        return NULL;
+    }
+    CalcoRegister* r = (CalcoRegister*)((PyTypeObject*)type)->tp_alloc((PyTypeObject*)type, 0);
+    if (r != NULL) {
+        r->v = v;
+    }
+    return (PyObject*)r;
+}
+
+static PyObject* register_new(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"value", NULL};
+    PyObject* value = NULL;
+    double v = 0.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &value)) {
+        return NULL;
+    }
+    if (value != NULL && operand(value, &v) < 0) {
+        return NULL;
+    }
+    CalcoRegister* r = (CalcoRegister*)type->tp_alloc(type, 0);
+    if (r != NULL) {
+        r->v = v;
+    }
+    return (PyObject*)r;
+}
+
+static PyObject* register_get_value(CalcoRegister* self, void* closure) {
+    return PyFloat_FromDouble(self->v);
+}
+
+static int register_set_value(CalcoRegister* self, PyObject* value, void* closure) {
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete value");
+        return -1;
+    }
+    return operand(value, &self->v);
+}
+
+static PyObject* register_repr(CalcoRegister* self) {
+    PyObject* f = PyFloat_FromDouble(self->v);
+    if (f == NULL) {
+        return NULL;
+    }
+    PyObject* r = PyUnicode_FromFormat("Register(%R)", f);
+    Py_DECREF(f);
+    return r;
+}
+
+static PyObject* register_float(CalcoRegister* self) {
+    return PyFloat_FromDouble(self->v);
+}
+
+// In-place operators (r += x, ...) update the register and return it; the non-in-place forms
+// are deliberately not defined, since they would have to allocate.
+#define REGISTER_INPLACE(name, expr) \
+    static PyObject* register_inplace_##name(PyObject* self, PyObject* other) { \
+        double x; \
+        if (Py_TYPE(self) != &CalcoRegisterType) { \
+            Py_RETURN_NOTIMPLEMENTED; \
+        } \
+        if (operand(other, &x) < 0) { \
+            PyErr_Clear(); \
+            Py_RETURN_NOTIMPLEMENTED; \
+        } \
+        double v = ((CalcoRegister*)self)->v; \
+        ((CalcoRegister*)self)->v = (expr); \
+        return return_self(self); \
+    }
+
+REGISTER_INPLACE(add, v + x)
+REGISTER_INPLACE(sub, v - x)
+REGISTER_INPLACE(mul, v * x)
+REGISTER_INPLACE(div, v / x)
+
+static PyObject* register_inplace_pow(PyObject* self, PyObject* other, PyObject* mod) {
+    double x;
+    if (Py_TYPE(self) != &CalcoRegisterType || mod != Py_None) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (operand(other, &x) < 0) {
+        PyErr_Clear();
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    ((CalcoRegister*)self)->v = calco_fast_pow(((CalcoRegister*)self)->v, x);
+    return return_self(self);
+}
+
+static PyNumberMethods register_as_number = {
+    .nb_float = (unaryfunc)register_float,
+    .nb_inplace_add = register_inplace_add,
+    .nb_inplace_subtract = register_inplace_sub,
+    .nb_inplace_multiply = register_inplace_mul,
+    .nb_inplace_true_divide = register_inplace_div,
+    .nb_inplace_power = register_inplace_pow,
+};
+
+#define FASTCALL(fn) (PyCFunction)(void(*)(void))(fn), METH_FASTCALL
+#define UNARY_DEF(method, kernel) \
+    {#method, (PyCFunction)register_##method, METH_NOARGS, "Replaces the value with calco." #kernel "(value)."},
+
+static PyMethodDef register_methods[] = {
+    {"set", FASTCALL(register_set), "set(x): value = x."},
+    {"iadd", FASTCALL(register_iadd), "iadd(x): value += x."},
+    {"isub", FASTCALL(register_isub), "isub(x): value -= x."},
+    {"imul", FASTCALL(register_imul), "imul(x): value *= x."},
+    {"idiv", FASTCALL(register_idiv), "idiv(x): value /= x."},
+    {"ipow", FASTCALL(register_ipow), "ipow(x): value = value ** x."},
+    {"rsub", FASTCALL(register_rsub), "rsub(x): value = x - value."},
+    {"rdiv", FASTCALL(register_rdiv), "rdiv(x): value = x / value."},
+    {"imin", FASTCALL(register_imin), "imin(x): value = min(value, x)."},
+    {"imax", FASTCALL(register_imax), "imax(x): value = max(value, x)."},
+    {"fma", FASTCALL(register_fma), "fma(a, b): value = value * a + b (one rounding)."},
+    {"iaddmul", FASTCALL(register_iaddmul), "iaddmul(a, b): value += a * b (one rounding)."},
+    {"isubmul", FASTCALL(register_isubmul), "isubmul(a, b): value -= a * b (one rounding)."},
+    REGISTER_UNARY_LIST(UNARY_DEF)
+    {"neg_", (PyCFunction)register_neg_, METH_NOARGS, "value = -value."},
+    {"square_", (PyCFunction)register_square_, METH_NOARGS, "value = value * value."},
+    {"recip_", (PyCFunction)register_recip_, METH_NOARGS, "value = 1 / value."},
+    {"apply_", (PyCFunction)register_apply_, METH_O, "apply_(func): Replaces the value with func(value) for any unary calco function."},
+    {"copy", (PyCFunction)register_copy, METH_NOARGS, "Returns a new Register with the same value."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef register_getset[] = {
+    {"value", (getter)register_get_value, (setter)register_set_value, "The current value (a new float on every read).", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+PyTypeObject CalcoRegisterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.Register",
+    .tp_basicsize = sizeof(CalcoRegister),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Register(value=0.0): A mutable double. Operands may be floats, ints or Registers; every method "
+              "updates the value in place and returns the register, so calls chain without allocating.",
+    .tp_methods = register_methods,
+    .tp_getset = register_getset,
+    .tp_as_number = &register_as_number,
+    .tp_repr = (reprfunc)register_repr,
+    .tp_new = register_new,
+#if PY_VERSION_HEX >= 0x03090000
+    .tp_vectorcall = register_vectorcall,
+#endif
+};
+
+// -----------------------------------------------------------------------------
+// calco.RegisterFile
+// Three-address operations on numbered registers: add(d, a, b) sets r[d] = r[a] + r[b].
+// Negative indices count from the end, as for lists.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_VAR_HEAD
+    double r[1];
+} CalcoRegisterFile;
+
+static inline int reg_index(CalcoRegisterFile* self, PyObject* o, Py_ssize_t* i) {
+    Py_ssize_t n = Py_SIZE(self);
+    Py_ssize_t k = PyLong_AsSsize_t(o);
+    if (k == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (k < 0) {
+        k += n;
+    }
+    if (k < 0 || k >= n) {
+        PyErr_SetString(PyExc_IndexError, "register index out of range");
+        return -1;
+    }
+    *i = k;
+    return 0;
+}
+
+// Resolves nargs register indices into idx[]. Returns 0, or -1 with an exception set.
+static int reg_indices(CalcoRegisterFile* self, const char* name, PyObject* const* args, Py_ssize_t nargs,
+                       Py_ssize_t expected, Py_ssize_t* idx) {
+    if (!check_nargs(name, nargs, expected)) {
+        return -1;
+    }
+    for (Py_ssize_t k = 0; k < expected; k++) {
+        if (reg_index(self, args[k], &idx[k]) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#define FILE_BINARY(name, expr) \
+    static PyObject* regfile_##name(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) { \
+        Py_ssize_t i[3]; \
+        if (reg_indices(self, #name, args, nargs, 3, i) < 0) { \
+            return NULL; \
+        } \
+        double a = self->r[i[1]], b = self->r[i[2]]; \
+        self->r[i[0]] = (expr); \
+        return return_self((PyObject*)self); \
+    }
+
+FILE_BINARY(add, a + b)
+FILE_BINARY(sub, a - b)
+FILE_BINARY(mul, a * b)
+FILE_BINARY(div, a / b)
+FILE_BINARY(pow, calco_fast_pow(a, b))
+FILE_BINARY(min, (a < b) ? a : b)
+FILE_BINARY(max, (a > b) ? a : b)
+
+static PyObject* regfile_fma(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t i[4];
+    if (reg_indices(self, "fma", args, nargs, 4, i) < 0) {
+        return NULL;
+    }
+    self->r[i[0]] = fma(self->r[i[1]], self->r[i[2]], self->r[i[3]]);
+    return return_self((PyObject*)self);
+}
+
+static PyObject* regfile_copy_reg(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t i[2];
+    if (reg_indices(self, "mov", args, nargs, 2, i) < 0) {
+        return NULL;
+    }
+    self->r[i[0]] = self->r[i[1]];
+    return return_self((PyObject*)self);
+}
+
+static PyObject* regfile_neg(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t i[2];
+    if (reg_indices(self, "neg", args, nargs, 2, i) < 0) {
+        return NULL;
+    }
+    self->r[i[0]] = -self->r[i[1]];
+    return return_self((PyObject*)self);
+}
+
+static PyObject* regfile_load(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t i;
+    if (!check_nargs("load", nargs, 2) || reg_index(self, args[0], &i) < 0 || operand(args[1], &self->r[i]) < 0) {
+        return NULL;
+    }
+    return return_self((PyObject*)self);
+}
+
+// unary(d, func, a): r[d] = func(r[a]) for any unary calco function (or its name).
+static PyObject* regfile_unary(CalcoRegisterFile* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t d, a;
+    if (!check_nargs("unary", nargs, 3) || reg_index(self, args[0], &d) < 0 || reg_index(self, args[2], &a) < 0) {
+        return NULL;
+    }
+    const calco_unary_entry* e = calco_lookup_unary(args[1]);
+    if (e == NULL) {
+        return NULL;
+    }
+    self->r[d] = e->kernel(self->r[a]);
+    return return_self((PyObject*)self);
+}
+
+static PyObject* regfile_tolist(CalcoRegisterFile* self, PyObject* unused) {
+    Py_ssize_t n = Py_SIZE(self);
+    PyObject* list = PyList_New(n);
+    for (Py_ssize_t k = 0; list != NULL && k < n; k++) {
+        PyObject* v = PyFloat_FromDouble(self->r[k]);
+        if (v == NULL) {
+            Py_CLEAR(list);
+            break;
+        }
+        PyList_SET_ITEM(list, k, v);
+    }
+    return list;
+}
+
+static PyObject* regfile_new(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"size", NULL};
+    Py_ssize_t n;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", kwlist, &n)) {
+        return NULL;
+    }
+    if (n < 1) {
+        PyErr_SetString(PyExc_ValueError, "size must be >= 1");
+        return NULL;
+    }
+    return type->tp_alloc(type, n); // Zero-filled
+}
+
+static Py_ssize_t regfile_length(CalcoRegisterFile* self) {
+    return Py_SIZE(self);
+}
+
+static PyObject* regfile_item(CalcoRegisterFile* self, Py_ssize_t i) {
+    if (i < 0 || i >= Py_SIZE(self)) {
+        PyErr_SetString(PyExc_IndexError, "register index out of range");
+        return NULL;
+    }
+    return PyFloat_FromDouble(self->r[i]);
+}
+
+static int regfile_ass_item(CalcoRegisterFile* self, Py_ssize_t i, PyObject* value) {
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "registers cannot be deleted");
+        return -1;
+    }
+    if (i < 0 || i >= Py_SIZE(self)) {
+        PyErr_SetString(PyExc_IndexError, "register index out of range");
+        return -1;
+    }
+    return operand(value, &self->r[i]);
+}
+
+static PySequenceMethods regfile_as_sequence = {
+    .sq_length = (lenfunc)regfile_length,
+    .sq_item = (ssizeargfunc)regfile_item,
+    .sq_ass_item = (ssizeobjargproc)regfile_ass_item,
+};
+
+static PyMethodDef regfile_methods[] = {
+    {"load", FASTCALL(regfile_load), "load(d, x): r[d] = x."},
+    {"mov", FASTCALL(regfile_copy_reg), "mov(d, a): r[d] = r[a]."},
+    {"add", FASTCALL(regfile_add), "add(d, a, b): r[d] = r[a] + r[b]."},
+    {"sub", FASTCALL(regfile_sub), "sub(d, a, b): r[d] = r[a] - r[b]."},
+    {"mul", FASTCALL(regfile_mul), "mul(d, a, b): r[d] = r[a] * r[b]."},
+    {"div", FASTCALL(regfile_div), "div(d, a, b): r[d] = r[a] / r[b]."},
+    {"pow", FASTCALL(regfile_pow), "pow(d, a, b): r[d] = r[a] ** r[b]."},
+    {"min", FASTCALL(regfile_min), "min(d, a, b): r[d] = min(r[a], r[b])."},
+    {"max", FASTCALL(regfile_max), "max(d, a, b): r[d] = max(r[a], r[b])."},
+    {"fma", FASTCALL(regfile_fma), "fma(d, a, b, c): r[d] = r[a] * r[b] + r[c] (one rounding)."},
+    {"neg", FASTCALL(regfile_neg), "neg(d, a): r[d] = -r[a]."},
+    {"unary", FASTCALL(regfile_unary), "unary(d, func, a): r[d] = func(r[a]) for any unary calco function."},
+    {"tolist", (PyCFunction)regfile_tolist, METH_NOARGS, "Returns the register values as a list."},
+    {NULL, NULL, 0, NULL}
+};
+
+PyTypeObject CalcoRegisterFileType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.RegisterFile",
+    .tp_basicsize = offsetof(CalcoRegisterFile, r),
+    .tp_itemsize = sizeof(double),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "RegisterFile(size): A fixed number of zero-initialised doubles for multi-variable formulas. "
+              "Operations address registers by index, update them in place and return the file.",
+    .tp_methods = regfile_methods,
+    .tp_as_sequence = &regfile_as_sequence,
+    .tp_new = regfile_new,
+};
@@ -0,0 +1,566 @@
+// calco_roots.c
+// Contains calco.find_roots: many independent scalar equations f(x) = target solved together by
+// Brent's method, safeguarded Newton or bisection. Every equation keeps its own state, and each
+// iteration evaluates f once at the next point of every unconverged equation: a calco kernel runs
+// in C over the worker threads, and a Python callable receives one float64 array of points per
+// iteration, so the callback count does not grow with the number of equations. A bracket around
+// a pole (tan on [1, 2]) shrinks just as one around a root does, so a converged point whose
+// residual exceeds both end values is reported as a singularity instead.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite (isfinite is folded away under -ffast-math)
+
+#include <float.h>
+#include <string.h>
+
+#define ROOT_CHUNK 4096 // Equations per pool task (calco kernels)
+
+// Status codes
+#define ROOT_CONVERGED 0
+#define ROOT_MAXITER 1        // Best estimate so far is returned
+#define ROOT_NOT_BRACKETED 2  // f(lo) and f(hi) have the same sign (Brent, bisection)
+#define ROOT_BREAKDOWN 3      // f was not finite, or a Newton step could not be taken
+#define ROOT_SINGULAR 4       // Converged onto a pole or jump: |f| there exceeds |f(lo)| and |f(hi)|
+
+typedef enum { ROOT_BRENT, ROOT_NEWTON, ROOT_BISECT } root_method;
+
+// Per-equation state. Brent (after SciPy's brentq): xpre, xcur and xblk with their values, and
+// the previous and current steps. Bisection and Newton keep their bracket in [xpre, xblk] with
+// f(xpre) in fpre; xcur is the midpoint (bisection) or the iterate (Newton, bracketed only when
+// f(lo) and f(hi) differ in sign); bisection also keeps f(xblk) in fblk. fbound is the larger
+// of |f(lo)| and |f(hi)|.
+typedef struct {
+    double xpre, xcur, xblk, fpre, fcur, fblk, spre, scur, fbound;
+    int bracketed;
+} root_lane;
+
+typedef struct {
+    root_method method;
+    PyObject* func;            // Python f, or NULL when kernel is set
+    PyObject* fprime;          // Python f' (Newton), or NULL to use the kernel's derivative
+    calco_unary_fn kernel;
+    calco_dual_fn dual;        // Kernel value and derivative (Newton)
+    Py_ssize_t n;
+    const double* in[4];       // lo, hi, target, x0 (x0 may be NULL)
+    Py_ssize_t step[4];        // 1 for a buffer, 0 for a broadcast scalar
+    double xtol, rtol;
+    Py_ssize_t maxiter;
+    double* roots;
+    long long* iters;
+    unsigned char* status;
+    Py_ssize_t* nfev;          // One per chunk
+    int nomem;
+} root_task;
+
+#define IN(T, k, i) ((T)->in[k][(i) * (T)->step[k]])
+
+// -----------------------------------------------------------------------------
+// Evaluation
+// -----------------------------------------------------------------------------
+
+// Calls a vectorized Python function on k points and stores its k values.
+static int root_call(PyObject* fn, const char* name, const double* x, double* out, Py_ssize_t k) {
+    Py_buffer view;
+    PyObject* points = calco_new_plain_array('d', k, &view);
+    if (points == NULL) {
+        return -1;
+    }
+    memcpy(view.buf, x, k * sizeof(double));
+    PyBuffer_Release(&view);
+    PyObject* res = PyObject_CallOneArg(fn, points);
+    Py_DECREF(points);
+    if (res == NULL) {
+        return -1;
+    }
+    Py_ssize_t m;
+    double* values = calco_read_doubles(res, &m);
+    Py_DECREF(res);
+    if (values == NULL) {
+        return -1;
+    }
+    if (m != k) {
+        PyMem_Free(values);
+        PyErr_Format(PyExc_ValueError, "%s returned %zd values for %zd points", name, m, k);
+        return -1;
+    }
+    memcpy(out, values, k * sizeof(double));
+    PyMem_Free(values);
+    return 0;
+}
+
+// f(x[i]) - target for the k equations listed in idx, into fx (and f' into dfx when not NULL).
+// Returns 0, or -1 with an exception set (Python callables only).
+static int root_eval(const root_task* T, const Py_ssize_t* idx, const double* x, double* fx, double* dfx,
+                     Py_ssize_t k) {
+    if (k == 0) {
+        return 0;
+    }
+    if (T->kernel != NULL && dfx != NULL && T->fprime == NULL) {
+        double r[3];
+        for (Py_ssize_t i = 0; i < k; i++) {
+            T->dual(x[i], 1, r);
+            fx[i] = r[0];
+            dfx[i] = r[1];
+        }
+    } else if (T->kernel != NULL) {
+        calco_unary_fn f = T->kernel;
+        for (Py_ssize_t i = 0; i < k; i++) {
+            fx[i] = f(x[i]);
+        }
+    } else if (root_call(T->func, "f", x, fx, k) < 0) {
+        return -1;
+    }
+    if (dfx != NULL && T->fprime != NULL && root_call(T->fprime, "fprime", x, dfx, k) < 0) {
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < k; i++) {
+        fx[i] -= IN(T, 2, idx[i]);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Iteration
+// Each round first advances every active equation to its next point (or finishes it), then
+// evaluates all the new points at once and stores the values.
+// -----------------------------------------------------------------------------
+
+static inline double root_delta(const root_task* T, double x) {
+    return 0.5 * (T->xtol + T->rtol * fabs(x));
+}
+
+static void root_finish(root_task* T, Py_ssize_t i, double x, int status) {
+    T->roots[i] = x;
+    T->status[i] = (unsigned char)status;
+}
+
+// Status of an equation that converged with residual f.
+static inline int root_converged(const root_lane* L, double f) {
+    return (fabs(f) > L->fbound) ? ROOT_SINGULAR : ROOT_CONVERGED;
+}
+
+// Chooses the next Brent point of equation i. Returns 1 when the equation needs f there, or 0
+// when it is finished.
+static int brent_next(root_task* T, root_lane* L, Py_ssize_t i) {
+    if (L->fpre != 0.0 && L->fcur != 0.0 && (signbit(L->fpre) != signbit(L->fcur))) {
+        L->xblk = L->xpre;
+        L->fblk = L->fpre;
+        L->spre = L->scur = L->xcur - L->xpre;
+    }
+    if (fabs(L->fblk) < fabs(L->fcur)) {
+        L->xpre = L->xcur;
+        L->xcur = L->xblk;
+        L->xblk = L->xpre;
+        L->fpre = L->fcur;
+        L->fcur = L->fblk;
+        L->fblk = L->fpre;
+    }
+    double delta = root_delta(T, L->xcur);
+    double sbis = 0.5 * (L->xblk - L->xcur);
+    if (L->fcur == 0.0 || fabs(sbis) < delta) {
+        root_finish(T, i, L->xcur, root_converged(L, L->fcur));
+        return 0;
+    }
+    if (T->iters[i] >= T->maxiter) {
+        root_finish(T, i, L->xcur, ROOT_MAXITER);
+        return 0;
+    }
+    if (fabs(L->spre) > delta && fabs(L->fcur) < fabs(L->fpre)) {
+        double stry;
+        if (L->xpre == L->xblk) {
+            stry = -L->fcur * (L->xcur - L->xpre) / (L->fcur - L->fpre); // Secant
+        } else {
+            double dpre = (L->fpre - L->fcur) / (L->xpre - L->xcur); // Inverse quadratic
+            double dblk = (L->fblk - L->fcur) / (L->xblk - L->xcur);
+            stry = -L->fcur * (L->fblk * dblk - L->fpre * dpre) / (dblk * dpre * (L->fblk - L->fpre));
+        }
+        double lim = 3.0 * fabs(sbis) - delta;
+        if (2.0 * fabs(stry) < ((fabs(L->spre) < lim) ? fabs(L->spre) : lim)) {
+            L->spre = L->scur;
+            L->scur = stry;
+        } else {
+            L->spre = L->scur = sbis;
+        }
+    } else {
+        L->spre = L->scur = sbis;
+    }
+    L->xpre = L->xcur;
+    L->fpre = L->fcur;
+    L->xcur += (fabs(L->scur) > delta) ? L->scur : ((sbis > 0.0) ? delta : -delta);
+    return 1;
+}
+
+static int bisect_next(root_task* T, root_lane* L, Py_ssize_t i) {
+    L->xcur = L->xpre + 0.5 * (L->xblk - L->xpre);
+    if (fabs(0.5 * (L->xblk - L->xpre)) < root_delta(T, L->xcur)) {
+        double f = (fabs(L->fpre) < fabs(L->fblk)) ? L->fpre : L->fblk;
+        root_finish(T, i, L->xcur, root_converged(L, f));
+        return 0;
+    }
+    if (T->iters[i] >= T->maxiter) {
+        root_finish(T, i, L->xcur, ROOT_MAXITER);
+        return 0;
+    }
+    return 1;
+}
+
+static void bisect_update(root_task* T, root_lane* L, Py_ssize_t i, double fx) {
+    if (fx == 0.0) {
+        root_finish(T, i, L->xcur, ROOT_CONVERGED);
+    } else if (signbit(fx) == signbit(L->fpre)) {
+        L->xpre = L->xcur;
+        L->fpre = fx;
+    } else {
+        L->xblk = L->xcur;
+        L->fblk = fx;
+    }
+}
+
+// Newton step from xcur, falling back to bisection whenever the step leaves the bracket.
+// Returns 1 while the equation goes on, 0 once finished.
+static int newton_update(root_task* T, root_lane* L, Py_ssize_t i, double fx, double dfx) {
+    double x = L->xcur;
+    if (fx == 0.0) {
+        root_finish(T, i, x, ROOT_CONVERGED);
+        return 0;
+    }
+    if (L->bracketed) {
+        if (signbit(fx) == signbit(L->fpre)) {
+            L->xpre = x;
+            L->fpre = fx;
+        } else {
+            L->xblk = x;
+        }
+    }
+    double xn = x - fx / dfx;
+    if (calco_isfinite(xn) && fabs(xn - x) < root_delta(T, xn)) {
+        root_finish(T, i, xn, root_converged(L, fx));
+        return 0;
+    }
+    if (L->bracketed) {
+        double lo = (L->xpre < L->xblk) ? L->xpre : L->xblk, hi = (L->xpre < L->xblk) ? L->xblk : L->xpre;
+        if (!(calco_isfinite(xn) && xn > lo && xn < hi)) {
+            xn = lo + 0.5 * (hi - lo);
+        }
+    } else if (!calco_isfinite(xn)) {
+        root_finish(T, i, NAN, ROOT_BREAKDOWN);
+        return 0;
+    }
+    if (fabs(xn - x) < root_delta(T, xn)) {
+        root_finish(T, i, xn, root_converged(L, fx));
+        return 0;
+    }
+    L->xcur = xn;
+    if (T->iters[i] >= T->maxiter) {
+        root_finish(T, i, xn, ROOT_MAXITER);
+        return 0;
+    }
+    return 1;
+}
+
+// Solves equations [lo, lo + c). Returns 0, or -1 with an exception set (Python callables) or
+// on allocation failure (task nomem set).
+static int root_range(root_task* T, Py_ssize_t lo, Py_ssize_t c, Py_ssize_t* nfev) {
+    root_lane* lanes = (root_lane*)PyMem_RawMalloc((c > 0 ? c : 1) * sizeof(root_lane));
+    double* x = (double*)PyMem_RawMalloc((c > 0 ? 6 * c : 1) * sizeof(double));
+    Py_ssize_t* idx = (Py_ssize_t*)PyMem_RawMalloc((c > 0 ? 4 * c : 1) * sizeof(Py_ssize_t));
+    int rc = -1;
+    if (lanes == NULL || x == NULL || idx == NULL) {
+        T->nomem = 1;
+        goto done;
+    }
+    double* fx = x + 2 * c;
+    double* dfx = x + 4 * c;
+    Py_ssize_t* act = idx + 2 * c;
+    int newton = (T->method == ROOT_NEWTON);
+
+    // f at both ends of every bracket, in one evaluation.
+    for (Py_ssize_t j = 0; j < c; j++) {
+        x[j] = IN(T, 0, lo + j);
+        x[c + j] = IN(T, 1, lo + j);
+        idx[j] = idx[c + j] = lo + j;
+    }
+    if (root_eval(T, idx, x, fx, NULL, 2 * c) < 0) {
+        goto done;
+    }
+    *nfev += 2 * c;
+    Py_ssize_t na = 0;
+    for (Py_ssize_t j = 0; j < c; j++) {
+        Py_ssize_t i = lo + j;
+        root_lane* L = &lanes[j];
+        double flo = fx[j], fhi = fx[c + j];
+        T->iters[i] = 0;
+        memset(L, 0, sizeof(*L));
+        L->xpre = x[j];
+        L->xcur = x[c + j];
+        L->fpre = flo;
+        L->fcur = fhi;
+        L->fbound = (fabs(flo) > fabs(fhi)) ? fabs(flo) : fabs(fhi);
+        if (!calco_isfinite(flo) || !calco_isfinite(fhi)) {
+            root_finish(T, i, NAN, ROOT_BREAKDOWN);
+            continue;
+        }
+        if (flo == 0.0 || fhi == 0.0) {
+            root_finish(T, i, (flo == 0.0) ? x[j] : x[c + j], ROOT_CONVERGED);
+            continue;
+        }
+        L->bracketed = (signbit(flo) != signbit(fhi));
+        if (!L->bracketed && !newton) {
+            root_finish(T, i, NAN, ROOT_NOT_BRACKETED);
+            continue;
+        }
+        if (T->method == ROOT_BISECT) {
+            L->xblk = x[c + j]; // xpre and fpre already hold lo and f(lo)
+            L->fblk = fhi;
+        } else if (newton) {
+            L->xblk = x[c + j];
+            L->xcur = (T->in[3] != NULL) ? IN(T, 3, i) : x[j] + 0.5 * (x[c + j] - x[j]);
+        }
+        act[na++] = j;
+    }
+
+    while (na > 0) {
+        // Next point of every active equation.
+        Py_ssize_t k = 0;
+        for (Py_ssize_t q = 0; q < na; q++) {
+            Py_ssize_t j = act[q];
+            root_lane* L = &lanes[j];
+            int more = (T->method == ROOT_BRENT) ? brent_next(T, L, lo + j)
+                     : (T->method == ROOT_BISECT) ? bisect_next(T, L, lo + j) : 1;
+            if (more) {
+                act[k] = j;
+                idx[k] = lo + j;
+                x[k] = L->xcur;
+                k++;
+            }
+        }
+        na = k;
+        if (root_eval(T, idx, x, fx, newton ? dfx : NULL, na) < 0) {
+            goto done;
+        }
+        *nfev += na;
+        k = 0;
+        for (Py_ssize_t q = 0; q < na; q++) {
+            Py_ssize_t j = act[q], i = lo + j;
+            root_lane* L = &lanes[j];
+            T->iters[i]++;
+            if (!calco_isfinite(fx[q]) || (newton && !calco_isfinite(dfx[q]))) {
+                root_finish(T, i, NAN, ROOT_BREAKDOWN);
+                continue;
+            }
+            if (T->method == ROOT_BRENT) {
+                L->fcur = fx[q];
+            } else if (T->method == ROOT_BISECT) {
+                bisect_update(T, L, i, fx[q]);
+                if (fx[q] == 0.0) {
+                    continue;
+                }
+            } else if (!newton_update(T, L, i, fx[q], dfx[q])) {
+                continue;
+            }
+            act[k++] = j;
+        }
+        na = k;
+    }
+    rc = 0;
+done:
+    PyMem_RawFree(lanes);
+    PyMem_RawFree(x);
+    PyMem_RawFree(idx);
+    return rc;
+}
+
+static void root_chunk(void* ctx, Py_ssize_t chunk) {
+    root_task* T = (root_task*)ctx;
+    Py_ssize_t lo = chunk * ROOT_CHUNK;
+    Py_ssize_t c = (T->n - lo < ROOT_CHUNK) ? T->n - lo : ROOT_CHUNK;
+    root_range(T, lo, c, &T->nfev[chunk]);
+}
+
+// -----------------------------------------------------------------------------
+// calco.find_roots
+// -----------------------------------------------------------------------------
+
+PyObject* calco_find_roots(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"f", "lo", "hi", "method", "target", "fprime", "x0", "xtol", "rtol", "maxiter", "out",
+                             "full_output", NULL};
+    PyObject *func, *ins[4], *fprime = Py_None, *out = Py_None;
+    const char* method = "brent";
+    int full_output = 0;
+    root_task task;
+    memset(&task, 0, sizeof(task));
+    ins[2] = NULL;
+    ins[3] = Py_None;
+    task.xtol = 2e-12;
+    task.rtol = 4.0 * DBL_EPSILON;
+    task.maxiter = 100;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|$sOOOddnOp", kwlist, &func, &ins[0], &ins[1], &method,
+                                     &ins[2], &fprime, &ins[3], &task.xtol, &task.rtol, &task.maxiter, &out,
+                                     &full_output)) {
+        return NULL;
+    }
+    if (strcmp(method, "brent") == 0) {
+        task.method = ROOT_BRENT;
+    } else if (strcmp(method, "newton") == 0) {
+        task.method = ROOT_NEWTON;
+    } else if (strcmp(method, "bisect") == 0) {
+        task.method = ROOT_BISECT;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown method '%s' (expected 'brent', 'newton' or 'bisect')", method);
+        return NULL;
+    }
+    if (!(task.xtol >= 0.0) || !(task.rtol >= 4.0 * DBL_EPSILON) || task.maxiter < 1) {
+        PyErr_SetString(PyExc_ValueError, "xtol must be >= 0, rtol at least 4 * eps, and maxiter positive");
+        return NULL;
+    }
+    if (PyUnicode_Check(func) || PyCFunction_Check(func)) {
+        const calco_unary_entry* e = calco_lookup_unary(func);
+        if (e != NULL) {
+            task.kernel = e->kernel;
+            task.dual = calco_dual_kernel(e->name);
+        } else if (PyUnicode_Check(func)) {
+            return NULL;
+        } else {
+            PyErr_Clear(); // Some other builtin, called like any Python function
+        }
+    }
+    if (task.kernel == NULL) {
+        if (!PyCallable_Check(func)) {
+            PyErr_SetString(PyExc_TypeError, "f must be callable or the name of a unary calco function");
+            return NULL;
+        }
+        task.func = func;
+    }
+    if (task.method == ROOT_NEWTON) {
+        if (fprime != Py_None) {
+            if (!PyCallable_Check(fprime)) {
+                PyErr_SetString(PyExc_TypeError, "fprime must be callable");
+                return NULL;
+            }
+            task.fprime = fprime;
+        } else if (task.kernel == NULL || task.dual == NULL) {
+            PyErr_SetString(PyExc_ValueError, "method 'newton' needs fprime unless f is a differentiable calco function");
+            return NULL;
+        }
+    }
+
+    // Operands: lo, hi, target and x0 are floats or float64 buffers of one common length.
+    Py_buffer views[4], roots_view, iters_view, status_view;
+    double scalars[4] = {0.0, 0.0, 0.0, 0.0};
+    double scalar_root;
+    long long scalar_iters;
+    unsigned char scalar_status;
+    int is_view[4] = {0, 0, 0, 0}, have_out = 0;
+    PyObject *roots = NULL, *iters = NULL, *status = NULL, *result = NULL;
+    Py_ssize_t n = -1;
+    for (int k = 0; k < 4; k++) {
+        if (ins[k] == NULL || ins[k] == Py_None) {
+            task.in[k] = (k == 2) ? &scalars[k] : NULL;
+            continue;
+        }
+        if (PyFloat_Check(ins[k]) || PyLong_Check(ins[k])) {
+            scalars[k] = PyFloat_AsDouble(ins[k]);
+            if (PyErr_Occurred()) {
+                goto done;
+            }
+            task.in[k] = &scalars[k];
+            continue;
+        }
+        if (calco_get_double_buffer(ins[k], &views[k], 0) < 0) {
+            goto done;
+        }
+        is_view[k] = 1;
+        Py_ssize_t len = views[k].len / (Py_ssize_t)sizeof(double);
+        if (n >= 0 && len != n) {
+            PyErr_SetString(PyExc_ValueError, "lo, hi, target and x0 buffers must have the same length");
+            goto done;
+        }
+        n = len;
+        task.in[k] = (const double*)views[k].buf;
+        task.step[k] = 1;
+    }
+    int scalar_mode = (n < 0);
+    if (scalar_mode) {
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires at least one buffer operand");
+            goto done;
+        }
+        n = 1;
+        task.roots = &scalar_root;
+        task.iters = &scalar_iters;
+        task.status = &scalar_status;
+    } else {
+        if (calco_get_out_buffer(out, n, &roots_view, &roots) < 0) {
+            goto done;
+        }
+        have_out = 1;
+        task.roots = (double*)roots_view.buf;
+        if ((iters = calco_new_array('q', n, &iters_view)) == NULL) {
+            goto done;
+        }
+        task.iters = (long long*)iters_view.buf;
+        PyBuffer_Release(&iters_view);
+        if ((status = calco_new_array('B', n, &status_view)) == NULL) {
+            goto done;
+        }
+        task.status = (unsigned char*)status_view.buf;
+        PyBuffer_Release(&status_view);
+    }
+    task.n = n;
+
+    int python = (task.func != NULL || task.fprime != NULL);
+    Py_ssize_t nchunks = python ? 1 : (n + ROOT_CHUNK - 1) / ROOT_CHUNK;
+    task.nfev = (Py_ssize_t*)PyMem_Calloc(nchunks > 0 ? nchunks : 1, sizeof(Py_ssize_t));
+    if (task.nfev == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    int rc = 0;
+    if (python) {
+        // Python callables need the GIL for every evaluation, so all equations iterate as one range.
+        rc = root_range(&task, 0, n, &task.nfev[0]);
+    } else {
+        Py_BEGIN_ALLOW_THREADS
+        calco_pool_parallel_for(root_chunk, &task, nchunks);
+        Py_END_ALLOW_THREADS
+    }
+    Py_ssize_t nfev = 0;
+    for (Py_ssize_t c = 0; c < nchunks; c++) {
+        nfev += task.nfev[c];
+    }
+    PyMem_Free(task.nfev);
+    if (task.nomem) {
+        PyErr_NoMemory();
+    }
+    if (rc < 0 || task.nomem) {
+        goto done;
+    }
+    Py_ssize_t failed = 0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        failed += (task.status[i] != ROOT_CONVERGED);
+    }
+    if (scalar_mode) {
+        result = Py_BuildValue("(dLi)", scalar_root, scalar_iters, (int)scalar_status);
+    } else {
+        result = PyTuple_Pack(3, roots, iters, status);
+    }
+    if (result != NULL && full_output) {
+        PyObject* info = Py_BuildValue("{s:n,s:n}", "nfev", nfev, "failed", failed);
+        PyObject* pair = (info == NULL) ? NULL : PyTuple_Pack(2, result, info);
+        Py_XDECREF(info);
+        Py_SETREF(result, pair);
+    }
+done:
+    for (int k = 0; k < 4; k++) {
+        if (is_view[k]) {
+            PyBuffer_Release(&views[k]);
+        }
+    }
+    if (have_out) {
+        PyBuffer_Release(&roots_view);
+    }
+    Py_XDECREF(roots);
+    Py_XDECREF(iters);
+    Py_XDECREF(status);
+    return result;
+}
@@ -0,0 +1,669 @@
+// calco_scan.c
+// Contains prefix scans (cumsum, cumprod) and rolling-window statistics over float64 buffers,
+// including the calco.RollingStats type that carries window state across chunks.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isnan, calco_isfinite (folded away under -ffast-math)
+
+#include <stdint.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Prefix Scans
+// The input is cut into fixed blocks of CALCO_DEFAULT_CHUNK elements. Within a block the
+// scan runs from zero and the running offset of all previous blocks is added on output, so
+// rounding error grows with the block size rather than n. A parallel run scans the blocks
+// concurrently from zero (which also yields their totals) and then adds the offsets in a
+// second pass; every element sees the same operations in the same order as in a serial run,
+// so the bits do not depend on the number of threads.
+// -----------------------------------------------------------------------------
+
+enum { SCAN_SUM, SCAN_PROD };
+
+typedef struct {
+    int op;
+    const double* in;
+    double* out;
+    Py_ssize_t n;
+    double* totals;  // Per-block totals (pass 1), then per-block offsets (pass 2)
+} scan_task;
+
+static inline void block_range(const scan_task* t, Py_ssize_t block, Py_ssize_t* start, Py_ssize_t* end) {
+    *start = block * CALCO_DEFAULT_CHUNK;
+    *end = *start + CALCO_DEFAULT_CHUNK;
+    if (*end > t->n) {
+        *end = t->n;
+    }
+}
+
+// Scans one block starting from `offset`; returns the block total. This sequential loop is the
+// only place partial sums and products are formed, so -ffast-math cannot order them differently
+// for serial and parallel runs.
+static double scan_block(const scan_task* t, Py_ssize_t block, double offset) {
+    Py_ssize_t start, end;
+    block_range(t, block, &start, &end);
+    double acc;
+    if (t->op == SCAN_SUM) {
+        acc = 0.0;
+        for (Py_ssize_t i = start; i < end; i++) {
+            acc += t->in[i];
+            t->out[i] = offset + acc;
+        }
+    } else {
+        acc = 1.0;
+        for (Py_ssize_t i = start; i < end; i++) {
+            acc *= t->in[i];
+            t->out[i] = offset * acc;
+        }
+    }
+    return acc;
+}
+
+// Pass 1: the block scanned from zero (out holds the in-block partials), recording its total.
+static void scan_total_chunk(void* ctx, Py_ssize_t block) {
+    const scan_task* t = (const scan_task*)ctx;
+    t->totals[block] = scan_block(t, block, (t->op == SCAN_SUM) ? 0.0 : 1.0);
+}
+
+// Pass 2: out = offset + partial (offset * partial), the same final step as scan_block.
+static void scan_offset_chunk(void* ctx, Py_ssize_t block) {
+    const scan_task* t = (const scan_task*)ctx;
+    Py_ssize_t start, end;
+    block_range(t, block, &start, &end);
+    double offset = t->totals[block];
+    if (t->op == SCAN_SUM) {
+        for (Py_ssize_t i = start; i < end; i++) {
+            t->out[i] = offset + t->out[i];
+        }
+    } else {
+        for (Py_ssize_t i = start; i < end; i++) {
+            t->out[i] = offset * t->out[i];
+        }
+    }
+}
+
+// Runs a scan seeded with `initial`. Called without the GIL.
+static void scan_run(scan_task* t, double initial) {
+    Py_ssize_t nblocks = (t->n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    double offset = initial;
+    if (nblocks <= 1 || t->totals == NULL) {
+        for (Py_ssize_t b = 0; b < nblocks; b++) {
+            double total = scan_block(t, b, offset);
+            offset = (t->op == SCAN_SUM) ? offset + total : offset * total;
+        }
+        return;
+    }
+    calco_pool_parallel_for(scan_total_chunk, t, nblocks);
+    for (Py_ssize_t b = 0; b < nblocks; b++) {
+        double total = t->totals[b];
+        t->totals[b] = offset;
+        offset = (t->op == SCAN_SUM) ? offset + total : offset * total;
+    }
+    calco_pool_parallel_for(scan_offset_chunk, t, nblocks);
+}
+
+static PyObject* scan_common(PyObject* args, PyObject* kwargs, int op) {
+    static char* kwlist[] = {"buf", "out", "initial", NULL};
+    PyObject *buf, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    double initial = (op == SCAN_SUM) ? 0.0 : 1.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$d", kwlist, &buf, &out, &initial)) {
+        return NULL;
+    }
+    if (calco_get_double_buffer(buf, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    scan_task task = {op, (const double*)in_view.buf, (double*)out_view.buf, n, NULL};
+    Py_ssize_t nblocks = (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    if (nblocks > 1 && calco_pool_size() > 1) {
+        task.totals = (double*)PyMem_Malloc(nblocks * sizeof(double)); // NULL falls back to serial
+    }
+    Py_BEGIN_ALLOW_THREADS
+    scan_run(&task, initial);
+    Py_END_ALLOW_THREADS
+    PyMem_Free(task.totals);
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+PyObject* calco_cumsum(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return scan_common(args, kwargs, SCAN_SUM);
+}
+
+PyObject* calco_cumprod(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return scan_common(args, kwargs, SCAN_PROD);
+}
+
+// -----------------------------------------------------------------------------
+// Rolling Window State
+// Sum, mean and variance are updated in O(1) per sample with a sliding Welford step. Every
+// time the window has been fully replaced, they are recomputed exactly from the ring buffer
+// (two-pass), which bounds the drift of the incremental updates to one window's worth at an
+// amortized O(1) cost; unlike Kahan-style compensation this survives -ffast-math. Non-finite
+// samples are only counted (NaN, +inf, -inf), since one would poison the running sums for good;
+// while any is in the window the moments come from the counts, and the sums are recomputed
+// exactly as soon as the last one leaves.
+// Minimum and maximum use monotonic deques, so each sample is pushed and popped at most once.
+// NaN never enters the deques (it compares false both ways); the index of the last one is kept
+// instead, and the minimum and maximum are NaN while it is in the window.
+// -----------------------------------------------------------------------------
+
+enum { STAT_SUM, STAT_MEAN, STAT_VAR, STAT_STD, STAT_MIN, STAT_MAX };
+
+#define TRACK_MOMENTS 1
+#define TRACK_MIN 2
+#define TRACK_MAX 4
+#define TRACK_ALL (TRACK_MOMENTS | TRACK_MIN | TRACK_MAX)
+
+typedef struct {
+    int64_t index;
+    double value;
+} deque_item;
+
+typedef struct {
+    deque_item* items; // Ring of capacity `window`
+    Py_ssize_t head;
+    Py_ssize_t len;
+} mono_deque;
+
+typedef struct {
+    Py_ssize_t window;
+    Py_ssize_t min_periods;
+    int ddof;
+    int track;
+    double* ring;          // Last `window` samples, slot = index % window
+    int64_t count;         // Samples seen since the last reset
+    Py_ssize_t filled;     // Samples currently in the window
+    Py_ssize_t replaced;   // Replacements since the last exact recomputation
+    Py_ssize_t nans;       // Non-finite samples in the window, left out of sum, mean and m2
+    Py_ssize_t pinfs;
+    Py_ssize_t ninfs;
+    int64_t last_nan;      // Index of the last NaN (min and max), -1 for none
+    double sum;
+    double mean;
+    double m2;
+    mono_deque minq;
+    mono_deque maxq;
+} rolling_state;
+
+// Allocates the buffers of a rolling state. Returns 0, or -1 with MemoryError set.
+static int rolling_alloc(rolling_state* s, Py_ssize_t window, Py_ssize_t min_periods, int ddof, int track) {
+    memset(s, 0, sizeof(*s));
+    s->window = window;
+    s->min_periods = min_periods;
+    s->ddof = ddof;
+    s->track = track;
+    s->last_nan = -1;
+    s->ring = (double*)PyMem_Malloc(window * sizeof(double));
+    if (track & TRACK_MIN) {
+        s->minq.items = (deque_item*)PyMem_Malloc(window * sizeof(deque_item));
+    }
+    if (track & TRACK_MAX) {
+        s->maxq.items = (deque_item*)PyMem_Malloc(window * sizeof(deque_item));
+    }
+    if (s->ring == NULL || ((track & TRACK_MIN) && s->minq.items == NULL) ||
+        ((track & TRACK_MAX) && s->maxq.items == NULL)) {
+        PyMem_Free(s->ring);
+        PyMem_Free(s->minq.items);
+        PyMem_Free(s->maxq.items);
+        s->ring = NULL;
+        s->minq.items = s->maxq.items = NULL;
+        PyErr_NoMemory();
+        return -1;
+    }
+    return 0;
+}
+
+static void rolling_free(rolling_state* s) {
+    PyMem_Free(s->ring);
+    PyMem_Free(s->minq.items);
+    PyMem_Free(s->maxq.items);
+    s->ring = NULL;
+    s->minq.items = s->maxq.items = NULL;
+}
+
+static void rolling_reset(rolling_state* s) {
+    s->count = 0;
+    s->filled = 0;
+    s->replaced = 0;
+    s->nans = s->pinfs = s->ninfs = 0;
+    s->last_nan = -1;
+    s->sum = s->mean = s->m2 = 0.0;
+    s->minq.head = s->minq.len = 0;
+    s->maxq.head = s->maxq.len = 0;
+}
+
+// Drops entries that left the window, then pushes (index, x) after removing the entries it
+// dominates (>= x for the minimum deque, <= x for the maximum deque).
+static inline void deque_push(mono_deque* q, Py_ssize_t cap, int64_t index, double x, int64_t oldest, int is_max) {
+    while (q->len > 0 && q->items[q->head].index < oldest) {
+        q->head = (q->head + 1 == cap) ? 0 : q->head + 1;
+        q->len--;
+    }
+    while (q->len > 0) {
+        Py_ssize_t back = q->head + q->len - 1;
+        if (back >= cap) {
+            back -= cap;
+        }
+        double v = q->items[back].value;
+        if (is_max ? (v > x) : (v < x)) {
+            break;
+        }
+        q->len--;
+    }
+    Py_ssize_t slot = q->head + q->len;
+    if (slot >= cap) {
+        slot -= cap;
+    }
+    q->items[slot].index = index;
+    q->items[slot].value = x;
+    q->len++;
+}
+
+static void rolling_resync(rolling_state* s) {
+    double sum = 0.0, m2 = 0.0;
+    for (Py_ssize_t i = 0; i < s->filled; i++) {
+        sum += s->ring[i];
+    }
+    double mean = sum / (double)s->filled;
+    for (Py_ssize_t i = 0; i < s->filled; i++) {
+        double d = s->ring[i] - mean;
+        m2 += d * d;
+    }
+    s->sum = sum;
+    s->mean = mean;
+    s->m2 = m2;
+    s->replaced = 0;
+}
+
+// Adds by (+1 or -1) to the count of x's kind and returns 1 if x is not finite.
+static inline int count_nonfinite(rolling_state* s, double x, Py_ssize_t by) {
+    if (calco_isfinite(x)) {
+        return 0;
+    }
+    if (calco_isnan(x)) {
+        s->nans += by;
+    } else if (signbit(x)) {
+        s->ninfs += by;
+    } else {
+        s->pinfs += by;
+    }
+    return 1;
+}
+
+static inline void rolling_push(rolling_state* s, double x) {
+    Py_ssize_t w = s->window;
+    Py_ssize_t slot = (Py_ssize_t)(s->count % w);
+    int resync = 0;
+    if (s->track & TRACK_MOMENTS) {
+        int had = (s->nans + s->pinfs + s->ninfs) > 0;
+        if (s->filled == w) {
+            count_nonfinite(s, s->ring[slot], -1);
+        }
+        int has = count_nonfinite(s, x, 1) || (s->nans + s->pinfs + s->ninfs) > 0;
+        if (had || has) {
+            // The running sums are stale while a non-finite sample is in the window
+            s->filled += (s->filled < w);
+            resync = !has;
+        } else if (s->filled < w) {
+            s->filled++;
+            double d = x - s->mean;
+            s->sum += x;
+            s->mean += d / (double)s->filled;
+            s->m2 += d * (x - s->mean);
+        } else {
+            double old = s->ring[slot];
+            double d = x - old;
+            double old_mean = s->mean;
+            s->sum += d;
+            s->mean += d / (double)w;
+            s->m2 += d * (x - s->mean + old - old_mean);
+            if (s->m2 < 0.0) {
+                s->m2 = 0.0;
+            }
+        }
+    } else if (s->filled < w) {
+        s->filled++;
+    }
+    s->ring[slot] = x;
+    int64_t oldest = s->count - w + 1;
+    if ((s->track & (TRACK_MIN | TRACK_MAX)) && calco_isnan(x)) {
+        s->last_nan = s->count;
+    } else {
+        if (s->track & TRACK_MIN) {
+            deque_push(&s->minq, w, s->count, x, oldest, 0);
+        }
+        if (s->track & TRACK_MAX) {
+            deque_push(&s->maxq, w, s->count, x, oldest, 1);
+        }
+    }
+    s->count++;
+    if (resync || ((s->track & TRACK_MOMENTS) && s->filled == w && ++s->replaced >= w)) {
+        rolling_resync(s);
+    }
+}
+
+// Current value of a statistic over the window, or NaN below min_periods.
+static inline double rolling_value(const rolling_state* s, int stat) {
+    if (s->filled < s->min_periods || s->filled == 0) {
+        return NAN;
+    }
+    int nonfinite = (s->nans + s->pinfs + s->ninfs) > 0;
+    switch (stat) {
+    case STAT_SUM:
+    case STAT_MEAN:
+        if (nonfinite) {
+            return (s->nans > 0 || (s->pinfs > 0 && s->ninfs > 0)) ? NAN : (s->pinfs > 0) ? INFINITY : -INFINITY;
+        }
+        return (stat == STAT_SUM) ? s->sum : s->mean;
+    case STAT_VAR:
+    case STAT_STD: {
+        if (s->filled <= s->ddof || nonfinite) {
+            return NAN;
+        }
+        double var = s->m2 / (double)(s->filled - s->ddof);
+        return (stat == STAT_VAR) ? var : sqrt(var);
+    }
+    case STAT_MIN:
+    default:
+        if (s->last_nan >= s->count - s->filled) {
+            return NAN;
+        }
+        return (stat == STAT_MIN) ? s->minq.items[s->minq.head].value : s->maxq.items[s->maxq.head].value;
+    }
+}
+
+// Pushes n samples, writing the statistic after each one to out (if not NULL).
+static void rolling_feed(rolling_state* s, const double* in, double* out, Py_ssize_t n, int stat) {
+    if (out == NULL) {
+        for (Py_ssize_t i = 0; i < n; i++) {
+            rolling_push(s, in[i]);
+        }
+        return;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        rolling_push(s, in[i]);
+        out[i] = rolling_value(s, stat);
+    }
+}
+
+static int stat_track(int stat) {
+    switch (stat) {
+    case STAT_MIN:
+        return TRACK_MIN;
+    case STAT_MAX:
+        return TRACK_MAX;
+    default:
+        return TRACK_MOMENTS;
+    }
+}
+
+static int parse_stat(PyObject* obj) {
+    static const char* names[] = {"sum", "mean", "var", "std", "min", "max", NULL};
+    const char* name = PyUnicode_Check(obj) ? PyUnicode_AsUTF8(obj) : NULL;
+    if (name != NULL) {
+        for (int i = 0; names[i] != NULL; i++) {
+            if (strcmp(names[i], name) == 0) {
+                return i;
+            }
+        }
+    }
+    if (!PyErr_Occurred()) {
+        PyErr_Format(PyExc_ValueError, "stat must be one of 'sum', 'mean', 'var', 'std', 'min', 'max', not %R", obj);
+    }
+    return -1;
+}
+
+// Validates window/min_periods/ddof; min_periods < 0 means "equal to window".
+static int check_window(Py_ssize_t window, Py_ssize_t* min_periods, int ddof) {
+    if (window < 1) {
+        PyErr_SetString(PyExc_ValueError, "window must be >= 1");
+        return -1;
+    }
+    if (*min_periods < 0) {
+        *min_periods = window;
+    }
+    if (*min_periods > window) {
+        PyErr_SetString(PyExc_ValueError, "min_periods must not exceed window");
+        return -1;
+    }
+    if (ddof < 0) {
+        PyErr_SetString(PyExc_ValueError, "ddof must be >= 0");
+        return -1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Rolling Buffer Functions
+// -----------------------------------------------------------------------------
+
+static PyObject* rolling_common(PyObject* args, PyObject* kwargs, int stat) {
+    static char* kwlist[] = {"buf", "window", "out", "min_periods", "ddof", NULL};
+    PyObject *buf, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    Py_ssize_t window, min_periods = -1;
+    int ddof = 1;
+    rolling_state state;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "On|O$ni", kwlist, &buf, &window, &out, &min_periods, &ddof)) {
+        return NULL;
+    }
+    if (check_window(window, &min_periods, ddof) < 0) {
+        return NULL;
+    }
+    if (calco_get_double_buffer(buf, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    if (window > n) {
+        window = (n > 0) ? n : 1; // The window never fills; min_periods still applies
+    }
+    if (rolling_alloc(&state, window, min_periods, ddof, stat_track(stat)) < 0) {
+        PyBuffer_Release(&in_view);
+        PyBuffer_Release(&out_view);
+        Py_DECREF(out_obj);
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    rolling_feed(&state, (const double*)in_view.buf, (double*)out_view.buf, n, stat);
+    Py_END_ALLOW_THREADS
+    rolling_free(&state);
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+PyObject* calco_rolling_sum(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_SUM);
+}
+
+PyObject* calco_rolling_mean(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_MEAN);
+}
+
+PyObject* calco_rolling_var(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_VAR);
+}
+
+PyObject* calco_rolling_std(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_STD);
+}
+
+PyObject* calco_rolling_min(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_MIN);
+}
+
+PyObject* calco_rolling_max(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return rolling_common(args, kwargs, STAT_MAX);
+}
+
+// -----------------------------------------------------------------------------
+// calco.RollingStats
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    PyObject_HEAD
+    rolling_state state;
+    int busy; // Set while update() runs without the GIL
+} CalcoRollingStats;
+
+static int rollingstats_init(CalcoRollingStats* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"window", "min_periods", "ddof", NULL};
+    Py_ssize_t window, min_periods = -1;
+    int ddof = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|$ni", kwlist, &window, &min_periods, &ddof)) {
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "RollingStats is being updated");
+        return -1;
+    }
+    if (check_window(window, &min_periods, ddof) < 0) {
+        return -1;
+    }
+    rolling_free(&self->state);
+    return rolling_alloc(&self->state, window, min_periods, ddof, TRACK_ALL);
+}
+
+static void rollingstats_dealloc(CalcoRollingStats* self) {
+    rolling_free(&self->state);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int rollingstats_ready(CalcoRollingStats* self) {
+    if (self->state.ring == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "RollingStats is not initialized");
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "RollingStats is being updated in another thread");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* rollingstats_update(CalcoRollingStats* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"buf", "stat", "out", NULL};
+    PyObject *buf, *stat_obj = Py_None, *out = Py_None, *out_obj = Py_None;
+    Py_buffer in_view, out_view;
+    int stat = STAT_MEAN;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$O", kwlist, &buf, &stat_obj, &out)) {
+        return NULL;
+    }
+    if (rollingstats_ready(self) < 0) {
+        return NULL;
+    }
+    if (stat_obj != Py_None && (stat = parse_stat(stat_obj)) < 0) {
+        return NULL;
+    }
+    if (stat_obj == Py_None && out != Py_None) {
+        PyErr_SetString(PyExc_TypeError, "out requires stat");
+        return NULL;
+    }
+    if (calco_get_double_buffer(buf, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    double* dst = NULL;
+    if (stat_obj != Py_None) {
+        if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+        dst = (double*)out_view.buf;
+    } else {
+        Py_INCREF(out_obj);
+    }
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    rolling_feed(&self->state, (const double*)in_view.buf, dst, n, stat);
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+    PyBuffer_Release(&in_view);
+    if (dst != NULL) {
+        PyBuffer_Release(&out_view);
+    }
+    return out_obj;
+}
+
+static PyObject* rollingstats_push(CalcoRollingStats* self, PyObject* args) {
+    double x;
+    if (!PyArg_ParseTuple(args, "d", &x)) {
+        return NULL;
+    }
+    if (rollingstats_ready(self) < 0) {
+        return NULL;
+    }
+    rolling_push(&self->state, x);
+    Py_RETURN_NONE;
+}
+
+static PyObject* rollingstats_reset(CalcoRollingStats* self, PyObject* args) {
+    if (rollingstats_ready(self) < 0) {
+        return NULL;
+    }
+    rolling_reset(&self->state);
+    Py_RETURN_NONE;
+}
+
+static PyObject* rollingstats_get_stat(CalcoRollingStats* self, void* closure) {
+    if (rollingstats_ready(self) < 0) {
+        return NULL;
+    }
+    return Py_BuildValue("d", rolling_value(&self->state, (int)(intptr_t)closure));
+}
+
+static PyObject* rollingstats_get_window(CalcoRollingStats* self, void* closure) {
+    return PyLong_FromSsize_t(self->state.window);
+}
+
+static PyObject* rollingstats_get_count(CalcoRollingStats* self, void* closure) {
+    return PyLong_FromLongLong(self->state.count);
+}
+
+CALCO_WORKSPACE_SHIM(rollingstats_update) // workspace= (calco_workspace.c)
+
+static PyMethodDef rollingstats_methods[] = {
+    {"update", (PyCFunction)(void(*)(void))rollingstats_update_ws, METH_VARARGS | METH_KEYWORDS,
+     "update(buf, stat=None, *, out=None): Feeds a float64 buffer. With stat ('sum', 'mean', 'var', 'std', "
+     "'min' or 'max') returns that statistic after every sample, continuing the window from earlier calls."},
+    {"push", (PyCFunction)rollingstats_push, METH_VARARGS, "push(x): Feeds a single sample."},
+    {"reset", (PyCFunction)rollingstats_reset, METH_NOARGS, "Empties the window."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef rollingstats_getset[] = {
+    {"sum", (getter)rollingstats_get_stat, NULL, "Sum of the current window.", (void*)(intptr_t)STAT_SUM},
+    {"mean", (getter)rollingstats_get_stat, NULL, "Mean of the current window.", (void*)(intptr_t)STAT_MEAN},
+    {"var", (getter)rollingstats_get_stat, NULL, "Variance of the current window (with ddof).", (void*)(intptr_t)STAT_VAR},
+    {"std", (getter)rollingstats_get_stat, NULL, "Standard deviation of the current window (with ddof).", (void*)(intptr_t)STAT_STD},
+    {"min", (getter)rollingstats_get_stat, NULL, "Minimum of the current window.", (void*)(intptr_t)STAT_MIN},
+    {"max", (getter)rollingstats_get_stat, NULL, "Maximum of the current window.", (void*)(intptr_t)STAT_MAX},
+    {"window", (getter)rollingstats_get_window, NULL, "Window length.", NULL},
+    {"count", (getter)rollingstats_get_count, NULL, "Samples fed since construction or reset().", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+PyTypeObject CalcoRollingStatsType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.RollingStats",
+    .tp_basicsize = sizeof(CalcoRollingStats),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "RollingStats(window, *, min_periods=window, ddof=1): Sliding-window sum, mean, variance, "
+              "minimum and maximum over an unbounded stream fed in chunks, in O(1) amortized time per sample.",
+    .tp_methods = rollingstats_methods,
+    .tp_getset = rollingstats_getset,
+    .tp_init = (initproc)rollingstats_init,
+    .tp_dealloc = (destructor)rollingstats_dealloc,
+    .tp_new = PyType_GenericNew,
+};
@@ -0,0 +1,109 @@
+// calco_sincos.h
+// Sine and cosine of an angle in degrees from one shared reduction. Degrees reduce exactly:
+// with q = round(x / 90), r = x - 90 q is exact, so multiples of 90 degrees give exact zeros
+// and ones, and only the conversion of |r| <= 45 to radians rounds. Radians reduce by pi/2 in
+// three parts (Cody-Waite) up to CALCO_RAD_MEDIUM; larger arguments need the Payne-Hanek
+// reduction in calco_trig_reduce.c. The polynomials are the fdlibm kernels for |x| <= pi/4
+// (about one unit in the last place). Everything is straight-line arithmetic with selects, so
+// loops over points can vectorize.
+
+#ifndef CALCO_SINCOS_H
+#define CALCO_SINCOS_H
+
+#include "calco_eft.h" // calco_same_bits
+
+#include <math.h>
+
+#define CALCO_DEG_TO_RAD 0.017453292519943295769 // pi / 180
+#define CALCO_RAD_TO_DEG 57.295779513082320877   // 180 / pi
+#define CALCO_COS_30 0.86602540378443864676      // sqrt(3) / 2
+#define CALCO_TAN_30 0.57735026918962576451      // 1 / sqrt(3)
+#define CALCO_TAN_60 1.7320508075688772935       // sqrt(3)
+
+// sin(x) and cos(x) for |x| <= pi/4.
+static inline void calco_sincos_kernel(double x, double* s, double* c) {
+    double z = x * x;
+    double ps = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06 +
+                z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)));
+    double pc = 4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05 +
+                z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11))));
+    *s = x + x * z * (-1.66666666666666324348e-01 + z * ps);
+    *c = (1.0 - 0.5 * z) + z * z * pc;
+}
+
+// Nearest integer to t as an int, |t| < 2^31. Rounding by conversion vectorizes on every x86-64
+// level, where nearbyint and floor do not before SSE4.1.
+static inline int calco_round_int(double t) {
+    return (int)(t + copysign(0.5, t));
+}
+
+// sin(x) and cos(x) from the quadrant q and sr = sin r, cr = cos r.
+static inline void calco_sincos_select(int q, double sr, double cr, double* s, double* c) {
+    int m = q & 3;
+    int odd = m & 1;
+    double sgn_s = (m >= 2) ? -1.0 : 1.0;
+    double sgn_c = (m == 1 || m == 2) ? -1.0 : 1.0;
+    *s = sgn_s * (odd ? cr : sr);
+    *c = sgn_c * (odd ? sr : cr);
+}
+
+// sin(x) and cos(x) from the quadrant q and the reduced argument r, |r| <= pi/4.
+static inline void calco_sincos_quadrant(int q, double r, double* s, double* c) {
+    double sr, cr;
+    calco_sincos_kernel(r, &sr, &cr);
+    calco_sincos_select(q, sr, cr, s, c);
+}
+
+// Reduces x (degrees, |x| < CALCO_DEG_MEDIUM) to r = x - 90 q, |r| <= 45, and returns q. The
+// quotient is taken in two steps (first by 90 * 2^26) so it fits an int; both remainders are exact,
+// and 2^26 is a multiple of four, so the quadrant comes from the second step alone.
+static inline int calco_reduce_deg90(double x, double* r) {
+    const double coarse = 90.0 * 67108864.0; // 90 * 2^26
+    double tc = x * (1.0 / coarse);
+    tc = (tc < 2147483647.0) ? tc : 2147483647.0;
+    tc = (tc > -2147483647.0) ? tc : -2147483647.0;
+    double r1 = x - coarse * (double)(int)tc;
+    int q = calco_round_int(r1 * (1.0 / 90.0));
+    *r = r1 - 90.0 * (double)q;
+    return q;
+}
+
+// sin(x) and cos(x) for x in degrees, |x| < CALCO_DEG_MEDIUM. A remainder of +-30 (x an odd
+// multiple of 30) takes the correctly rounded values, so sind(30) and cosd(60) are exactly 1/2.
+// The remainder is matched by bit pattern so a NaN cannot match under -ffast-math.
+static inline void calco_sincos_deg(double x, double* s, double* c) {
+    double r, sr, cr;
+    int q = calco_reduce_deg90(x, &r);
+    calco_sincos_kernel(r * CALCO_DEG_TO_RAD, &sr, &cr);
+    int sixth = calco_same_bits(fabs(r), 30.0);
+    sr = sixth ? copysign(0.5, r) : sr;
+    cr = sixth ? CALCO_COS_30 : cr;
+    calco_sincos_select(q, sr, cr, s, c);
+}
+
+// Largest |x| in radians that calco_sincos_rad reduces accurately (2^20 * pi/2, as in fdlibm):
+// the quotient then has at most 20 bits, so its products with the 33-bit parts of pi/2 are exact.
+#define CALCO_RAD_MEDIUM 1647099.3291652855
+// Largest |x| in degrees that calco_sincos_deg reduces (90 * 2^57).
+#define CALCO_DEG_MEDIUM 1.2970366926827028e19
+
+// Reduces x (radians, |x| < CALCO_RAD_MEDIUM) to r = x - q pi/2 with pi/2 split into three
+// 33-bit parts and a tail (fdlibm's pio2_1, pio2_2, pio2_3 and pio2_3t). Returns q. The caller
+// must be compiled without reassociation (see calco_trig_reduce.c), or the parts get merged.
+static inline int calco_reduce_pio2_medium(double x, double* r) {
+    int q = calco_round_int(x * 0.63661977236758134308); // 2 / pi
+    double fq = (double)q;
+    double r1 = x - fq * 1.57079632673412561417e+00;
+    double r2 = r1 - fq * 6.07710050630396597660e-11;
+    *r = (r2 - fq * 2.02226624871116645580e-21) - fq * 8.47842766036889956997e-32;
+    return q;
+}
+
+// sin(x) and cos(x) for x in radians, |x| < CALCO_RAD_MEDIUM.
+static inline void calco_sincos_rad(double x, double* s, double* c) {
+    double r;
+    int q = calco_reduce_pio2_medium(x, &r);
+    calco_sincos_quadrant(q, r, s, c);
+}
+
+#endif // CALCO_SINCOS_H
@@ -0,0 +1,1020 @@
+// calco_stats.c
+// Contains the calco.stats submodule: mergeable central moments, the t-digest quantile sketch
+// and fixed-bin histograms over float64 buffers.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Central Moments
+// A buffer is cut into fixed blocks of STATS_BLOCK elements. Each block is summarised with a
+// shifted two-pass (the second pass hits L1), blocks are combined left to right with the
+// Chan/Pebay merge inside each pool chunk, and chunk results are merged in chunk order.
+// The split never depends on the thread count, so neither do the results.
+// -----------------------------------------------------------------------------
+
+#define STATS_BLOCK 4096
+
+typedef struct {
+    double n;
+    double mean;
+    double m2; // Sums of powers of deviations from the mean
+    double m3;
+    double m4;
+    double min;
+    double max;
+} moments_t;
+
+static const moments_t moments_empty = {0.0, 0.0, 0.0, 0.0, 0.0, NAN, NAN};
+
+// Combines two partial results (Pebay 2008, eqs. 3.1-3.3).
+static moments_t moments_merge(const moments_t* a, const moments_t* b) {
+    if (a->n == 0.0) {
+        return *b;
+    }
+    if (b->n == 0.0) {
+        return *a;
+    }
+    moments_t r;
+    double na = a->n, nb = b->n, n = na + nb;
+    double delta = b->mean - a->mean;
+    double dn = delta / n;
+    double dn2 = dn * dn;
+    double term = delta * dn * na * nb;
+    r.n = n;
+    r.mean = a->mean + nb * dn;
+    r.m2 = a->m2 + b->m2 + term;
+    r.m3 = a->m3 + b->m3 + term * dn * (na - nb) + 3.0 * dn * (na * b->m2 - nb * a->m2);
+    r.m4 = a->m4 + b->m4 + term * dn2 * (na * na - na * nb + nb * nb) +
+           6.0 * dn2 * (na * na * b->m2 + nb * nb * a->m2) + 4.0 * dn * (na * b->m3 - nb * a->m3);
+    r.min = (b->min < a->min) ? b->min : a->min;
+    r.max = (b->max > a->max) ? b->max : a->max;
+    return r;
+}
+
+static moments_t moments_block(const double* x, Py_ssize_t n) {
+    moments_t r;
+    double sum = 0.0, lo = x[0], hi = x[0];
+    for (Py_ssize_t i = 0; i < n; i++) {
+        sum += x[i];
+        lo = (x[i] < lo) ? x[i] : lo;
+        hi = (x[i] > hi) ? x[i] : hi;
+    }
+    double mean = sum / (double)n;
+    double s2 = 0.0, s3 = 0.0, s4 = 0.0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        double d = x[i] - mean;
+        double d2 = d * d;
+        s2 += d2;
+        s3 += d2 * d;
+        s4 += d2 * d2;
+    }
+    r.n = (double)n;
+    r.mean = mean;
+    r.m2 = s2;
+    r.m3 = s3;
+    r.m4 = s4;
+    r.min = lo;
+    r.max = hi;
+    return r;
+}
+
+typedef struct {
+    const double* in;
+    Py_ssize_t n;
+    moments_t* results; // One per pool chunk
+} moments_task;
+
+static void moments_chunk(void* ctx, Py_ssize_t chunk) {
+    const moments_task* t = (const moments_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = start + CALCO_DEFAULT_CHUNK;
+    if (end > t->n) {
+        end = t->n;
+    }
+    moments_t acc = moments_empty;
+    for (Py_ssize_t i = start; i < end; i += STATS_BLOCK) {
+        Py_ssize_t len = (end - i < STATS_BLOCK) ? end - i : STATS_BLOCK;
+        moments_t block = moments_block(t->in + i, len);
+        acc = moments_merge(&acc, &block);
+    }
+    t->results[chunk] = acc;
+}
+
+// -----------------------------------------------------------------------------
+// calco.stats.Moments
+// -----------------------------------------------------------------------------
+
+#define MOMENTS_MAGIC "CMO1"
+
+typedef struct {
+    PyObject_HEAD
+    moments_t m;
+    int ddof;
+    int busy; // Set while update() runs without the GIL
+} CalcoMoments;
+
+static PyTypeObject CalcoMomentsType;
+
+static int moments_init(CalcoMoments* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"ddof", NULL};
+    int ddof = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|$i", kwlist, &ddof)) {
+        return -1;
+    }
+    if (ddof < 0) {
+        PyErr_SetString(PyExc_ValueError, "ddof must be >= 0");
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Moments is being updated in another thread");
+        return -1;
+    }
+    self->m = moments_empty;
+    self->ddof = ddof;
+    return 0;
+}
+
+static CalcoMoments* moments_new(int ddof) {
+    CalcoMoments* self = PyObject_New(CalcoMoments, &CalcoMomentsType);
+    if (self != NULL) {
+        self->m = moments_empty;
+        self->ddof = ddof;
+        self->busy = 0;
+    }
+    return self;
+}
+
+static int moments_check(CalcoMoments* self) {
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Moments is being updated in another thread");
+        return -1;
+    }
+    return 0;
+}
+
+// Folds a float64 buffer into self. Returns 0, or -1 with an exception set.
+static int moments_feed(CalcoMoments* self, PyObject* buf) {
+    Py_buffer view;
+    if (moments_check(self) < 0 || calco_get_double_buffer(buf, &view, 0) < 0) {
+        return -1;
+    }
+    moments_task task = {(const double*)view.buf, view.len / (Py_ssize_t)sizeof(double), NULL};
+    Py_ssize_t nchunks = (task.n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    if (nchunks == 0) {
+        PyBuffer_Release(&view);
+        return 0;
+    }
+    task.results = (moments_t*)PyMem_Malloc(nchunks * sizeof(moments_t));
+    if (task.results == NULL) {
+        PyBuffer_Release(&view);
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(moments_chunk, &task, nchunks);
+    for (Py_ssize_t c = 0; c < nchunks; c++) {
+        self->m = moments_merge(&self->m, &task.results[c]);
+    }
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+    PyMem_Free(task.results);
+    PyBuffer_Release(&view);
+    return 0;
+}
+
+static PyObject* moments_update(CalcoMoments* self, PyObject* args) {
+    PyObject* buf;
+    if (!PyArg_ParseTuple(args, "O", &buf)) {
+        return NULL;
+    }
+    if (moments_feed(self, buf) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* moments_push(CalcoMoments* self, PyObject* args) {
+    double x;
+    if (!PyArg_ParseTuple(args, "d", &x)) {
+        return NULL;
+    }
+    if (moments_check(self) < 0) {
+        return NULL;
+    }
+    moments_t one = {1.0, x, 0.0, 0.0, 0.0, x, x};
+    self->m = moments_merge(&self->m, &one);
+    Py_RETURN_NONE;
+}
+
+static PyObject* moments_merge_method(CalcoMoments* self, PyObject* args) {
+    CalcoMoments* other;
+    if (!PyArg_ParseTuple(args, "O!", &CalcoMomentsType, &other)) {
+        return NULL;
+    }
+    if (moments_check(self) < 0 || moments_check(other) < 0) {
+        return NULL;
+    }
+    self->m = moments_merge(&self->m, &other->m);
+    Py_RETURN_NONE;
+}
+
+static PyObject* moments_to_bytes(CalcoMoments* self, PyObject* args) {
+    if (moments_check(self) < 0) {
+        return NULL;
+    }
+    char raw[4 + sizeof(moments_t) + sizeof(double)];
+    double ddof = (double)self->ddof;
+    memcpy(raw, MOMENTS_MAGIC, 4);
+    memcpy(raw + 4, &self->m, sizeof(moments_t));
+    memcpy(raw + 4 + sizeof(moments_t), &ddof, sizeof(double));
+    return PyBytes_FromStringAndSize(raw, sizeof(raw));
+}
+
+static PyObject* moments_from_bytes(PyObject* cls, PyObject* args) {
+    Py_buffer data;
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    const char* raw = (const char*)data.buf;
+    if (data.len != 4 + (Py_ssize_t)(sizeof(moments_t) + sizeof(double)) || memcmp(raw, MOMENTS_MAGIC, 4) != 0) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "not a serialized calco.stats.Moments");
+        return NULL;
+    }
+    double ddof;
+    memcpy(&ddof, raw + 4 + sizeof(moments_t), sizeof(double));
+    CalcoMoments* self = moments_new((int)ddof);
+    if (self != NULL) {
+        memcpy(&self->m, raw + 4, sizeof(moments_t));
+    }
+    PyBuffer_Release(&data);
+    return (PyObject*)self;
+}
+
+static PyObject* moments_reduce(CalcoMoments* self, PyObject* args) {
+    PyObject* raw = moments_to_bytes(self, NULL);
+    if (raw == NULL) {
+        return NULL;
+    }
+    PyObject* ctor = PyObject_GetAttrString((PyObject*)&CalcoMomentsType, "from_bytes");
+    if (ctor == NULL) {
+        Py_DECREF(raw);
+        return NULL;
+    }
+    return Py_BuildValue("(N(N))", ctor, raw);
+}
+
+enum { MOM_MEAN, MOM_SUM, MOM_VAR, MOM_STD, MOM_SKEW, MOM_KURT, MOM_MIN, MOM_MAX };
+
+static PyObject* moments_get(CalcoMoments* self, void* closure) {
+    const moments_t* m = &self->m;
+    double r;
+    switch ((int)(intptr_t)closure) {
+    case MOM_MEAN:
+        r = (m->n > 0.0) ? m->mean : NAN;
+        break;
+    case MOM_SUM:
+        r = m->mean * m->n;
+        break;
+    case MOM_VAR:
+    case MOM_STD:
+        r = (m->n > self->ddof) ? m->m2 / (m->n - self->ddof) : NAN;
+        if ((int)(intptr_t)closure == MOM_STD) {
+            r = sqrt(r);
+        }
+        break;
+    case MOM_SKEW:
+        r = (m->m2 > 0.0) ? sqrt(m->n) * m->m3 / (m->m2 * sqrt(m->m2)) : NAN;
+        break;
+    case MOM_KURT:
+        r = (m->m2 > 0.0) ? m->n * m->m4 / (m->m2 * m->m2) - 3.0 : NAN;
+        break;
+    case MOM_MIN:
+        r = m->min;
+        break;
+    default:
+        r = m->max;
+        break;
+    }
+    return Py_BuildValue("d", r);
+}
+
+static PyObject* moments_get_count(CalcoMoments* self, void* closure) {
+    return PyLong_FromLongLong((long long)self->m.n);
+}
+
+static PyObject* moments_get_ddof(CalcoMoments* self, void* closure) {
+    return PyLong_FromLong(self->ddof);
+}
+
+static int moments_set_ddof(CalcoMoments* self, PyObject* value, void* closure) {
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete ddof");
+        return -1;
+    }
+    long ddof = PyLong_AsLong(value);
+    if (ddof == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (ddof < 0 || ddof > INT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "ddof must be >= 0");
+        return -1;
+    }
+    self->ddof = (int)ddof;
+    return 0;
+}
+
+static PyMethodDef moments_methods[] = {
+    {"update", (PyCFunction)moments_update, METH_VARARGS, "update(buf): Adds every element of a float64 buffer."},
+    {"push", (PyCFunction)moments_push, METH_VARARGS, "push(x): Adds a single value."},
+    {"merge", (PyCFunction)moments_merge_method, METH_VARARGS, "merge(other): Adds the values summarised by another Moments."},
+    {"to_bytes", (PyCFunction)moments_to_bytes, METH_NOARGS, "Serializes the state (native byte order) for merging in another process."},
+    {"from_bytes", (PyCFunction)moments_from_bytes, METH_VARARGS | METH_CLASS, "from_bytes(data): Restores a Moments serialized with to_bytes()."},
+    {"__reduce__", (PyCFunction)moments_reduce, METH_NOARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef moments_getset[] = {
+    {"count", (getter)moments_get_count, NULL, "Number of values.", NULL},
+    {"mean", (getter)moments_get, NULL, "Arithmetic mean.", (void*)(intptr_t)MOM_MEAN},
+    {"sum", (getter)moments_get, NULL, "Sum of the values.", (void*)(intptr_t)MOM_SUM},
+    {"var", (getter)moments_get, NULL, "Variance with ddof degrees of freedom removed.", (void*)(intptr_t)MOM_VAR},
+    {"std", (getter)moments_get, NULL, "Standard deviation with ddof degrees of freedom removed.", (void*)(intptr_t)MOM_STD},
+    {"skewness", (getter)moments_get, NULL, "Sample skewness g1 (biased).", (void*)(intptr_t)MOM_SKEW},
+    {"kurtosis", (getter)moments_get, NULL, "Excess kurtosis g2 (biased).", (void*)(intptr_t)MOM_KURT},
+    {"min", (getter)moments_get, NULL, "Smallest value.", (void*)(intptr_t)MOM_MIN},
+    {"max", (getter)moments_get, NULL, "Largest value.", (void*)(intptr_t)MOM_MAX},
+    {"ddof", (getter)moments_get_ddof, (setter)moments_set_ddof, "Delta degrees of freedom used by var and std.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject CalcoMomentsType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.stats.Moments",
+    .tp_basicsize = sizeof(CalcoMoments),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Moments(*, ddof=1): Mergeable count, mean, variance, skewness, kurtosis, min and max. "
+              "Results depend only on the order of update() calls, not on the number of threads.",
+    .tp_methods = moments_methods,
+    .tp_getset = moments_getset,
+    .tp_init = (initproc)moments_init,
+    .tp_new = PyType_GenericNew,
+};
+
+static PyObject* stats_moments(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"buf", "ddof", NULL};
+    PyObject* buf;
+    int ddof = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$i", kwlist, &buf, &ddof)) {
+        return NULL;
+    }
+    if (ddof < 0) {
+        PyErr_SetString(PyExc_ValueError, "ddof must be >= 0");
+        return NULL;
+    }
+    CalcoMoments* m = moments_new(ddof);
+    if (m == NULL) {
+        return NULL;
+    }
+    if (moments_feed(m, buf) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    return (PyObject*)m;
+}
+
+// -----------------------------------------------------------------------------
+// calco.stats.TDigest
+// Merging t-digest (Dunning & Ertl) with the k1 (arcsine) scale function: incoming values are
+// buffered, and when the buffer fills it is sorted together with the centroids and merged
+// greedily so that no centroid spans more than one unit of k. Memory is fixed by the
+// compression; accuracy is best in the tails. Merging feeds another digest's centroids
+// through the same buffer, so digests built in different processes combine freely.
+// -----------------------------------------------------------------------------
+
+#define TDIGEST_MAGIC "CTD1"
+
+typedef struct {
+    double mean;
+    double weight;
+} centroid;
+
+typedef struct {
+    PyObject_HEAD
+    double compression;
+    centroid* c;       // Merged centroids, sorted by mean
+    Py_ssize_t nc;
+    centroid* buf;     // Unmerged values; also the scratch space of compress()
+    Py_ssize_t nb;
+    Py_ssize_t cap_c;
+    Py_ssize_t cap_b;
+    double total;      // Total weight, including the buffer
+    double min;
+    double max;
+    int busy;          // Set while update() runs without the GIL
+} CalcoTDigest;
+
+static PyTypeObject CalcoTDigestType;
+
+static int centroid_cmp(const void* a, const void* b) {
+    double x = ((const centroid*)a)->mean, y = ((const centroid*)b)->mean;
+    return (x > y) - (x < y);
+}
+
+static inline double k1(double q, double norm) {
+    return norm * asin(2.0 * q - 1.0);
+}
+
+// Inverse of k1, saturating at q = 1 once k passes the top of the scale.
+static inline double k1_inv(double k, double norm) {
+    return (k >= norm * (M_PI / 2.0)) ? 1.0 : (sin(k / norm) + 1.0) * 0.5;
+}
+
+// Merges the buffer into the centroids. Safe without the GIL.
+static void tdigest_compress(CalcoTDigest* t) {
+    if (t->nb == 0) {
+        return;
+    }
+    // Centroids join the buffered values (the buffer has room for cap_c extra entries).
+    memcpy(t->buf + t->nb, t->c, t->nc * sizeof(centroid));
+    Py_ssize_t n = t->nb + t->nc;
+    qsort(t->buf, n, sizeof(centroid), centroid_cmp);
+    double norm = t->compression / (2.0 * M_PI);
+    double total = t->total;
+    double so_far = 0.0;
+    double q_limit = k1_inv(k1(0.0, norm) + 1.0, norm) * total;
+    centroid cur = t->buf[0];
+    Py_ssize_t out = 0;
+    for (Py_ssize_t i = 1; i < n; i++) {
+        const centroid* next = &t->buf[i];
+        if (so_far + cur.weight + next->weight <= q_limit) {
+            cur.weight += next->weight;
+            cur.mean += (next->mean - cur.mean) * next->weight / cur.weight;
+        } else {
+            so_far += cur.weight;
+            t->c[out++] = cur;
+            q_limit = k1_inv(k1(so_far / total, norm) + 1.0, norm) * total;
+            cur = *next;
+        }
+    }
+    t->c[out++] = cur;
+    t->nc = out;
+    t->nb = 0;
+}
+
+static inline void tdigest_add(CalcoTDigest* t, double x, double w) {
+    if (t->nb == t->cap_b) {
+        tdigest_compress(t);
+    }
+    t->buf[t->nb].mean = x;
+    t->buf[t->nb].weight = w;
+    t->nb++;
+    if (t->total == 0.0) {
+        t->min = t->max = x;
+    } else {
+        t->min = (x < t->min) ? x : t->min;
+        t->max = (x > t->max) ? x : t->max;
+    }
+    t->total += w;
+}
+
+// Allocates storage for the given compression. Returns 0, or -1 with an exception set.
+static int tdigest_alloc(CalcoTDigest* t, double compression) {
+    if (!(compression >= 10.0 && compression <= 100000.0)) {
+        PyErr_SetString(PyExc_ValueError, "compression must be between 10 and 100000");
+        return -1;
+    }
+    Py_ssize_t cap_c = (Py_ssize_t)(2.0 * compression) + 8;
+    Py_ssize_t cap_b = (Py_ssize_t)(5.0 * compression) + 8;
+    centroid* c = (centroid*)PyMem_Malloc(cap_c * sizeof(centroid));
+    centroid* b = (centroid*)PyMem_Malloc((cap_b + cap_c) * sizeof(centroid));
+    if (c == NULL || b == NULL) {
+        PyMem_Free(c);
+        PyMem_Free(b);
+        PyErr_NoMemory();
+        return -1;
+    }
+    PyMem_Free(t->c);
+    PyMem_Free(t->buf);
+    t->compression = compression;
+    t->c = c;
+    t->buf = b;
+    t->cap_c = cap_c;
+    t->cap_b = cap_b;
+    t->nc = t->nb = 0;
+    t->total = 0.0;
+    t->min = t->max = NAN;
+    return 0;
+}
+
+static int tdigest_init(CalcoTDigest* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"compression", NULL};
+    double compression = 100.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|d", kwlist, &compression)) {
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "TDigest is being updated in another thread");
+        return -1;
+    }
+    return tdigest_alloc(self, compression);
+}
+
+static void tdigest_dealloc(CalcoTDigest* self) {
+    PyMem_Free(self->c);
+    PyMem_Free(self->buf);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int tdigest_check(CalcoTDigest* self) {
+    if (self->c == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "TDigest is not initialized");
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "TDigest is being updated in another thread");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* tdigest_update(CalcoTDigest* self, PyObject* args) {
+    PyObject* obj;
+    Py_buffer view;
+    if (!PyArg_ParseTuple(args, "O", &obj)) {
+        return NULL;
+    }
+    if (tdigest_check(self) < 0 || calco_get_double_buffer(obj, &view, 0) < 0) {
+        return NULL;
+    }
+    const double* x = (const double*)view.buf;
+    Py_ssize_t n = view.len / (Py_ssize_t)sizeof(double);
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < n; i++) {
+        tdigest_add(self, x[i], 1.0);
+    }
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
+static PyObject* tdigest_push(CalcoTDigest* self, PyObject* args) {
+    double x, w = 1.0;
+    if (!PyArg_ParseTuple(args, "d|d", &x, &w)) {
+        return NULL;
+    }
+    if (!(w > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "weight must be > 0");
+        return NULL;
+    }
+    if (tdigest_check(self) < 0) {
+        return NULL;
+    }
+    tdigest_add(self, x, w);
+    Py_RETURN_NONE;
+}
+
+static PyObject* tdigest_merge(CalcoTDigest* self, PyObject* args) {
+    CalcoTDigest* other;
+    if (!PyArg_ParseTuple(args, "O!", &CalcoTDigestType, &other)) {
+        return NULL;
+    }
+    if (tdigest_check(self) < 0 || tdigest_check(other) < 0) {
+        return NULL;
+    }
+    if (other->total == 0.0) {
+        Py_RETURN_NONE;
+    }
+    tdigest_compress(other);
+    // Copy first: merging a digest into itself must not read centroids it is rewriting.
+    Py_ssize_t n = other->nc;
+    centroid* src = (centroid*)PyMem_Malloc(n * sizeof(centroid));
+    if (src == NULL) {
+        return PyErr_NoMemory();
+    }
+    memcpy(src, other->c, n * sizeof(centroid));
+    double lo = other->min, hi = other->max;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        tdigest_add(self, src[i].mean, src[i].weight);
+    }
+    PyMem_Free(src);
+    self->min = (lo < self->min) ? lo : self->min;
+    self->max = (hi > self->max) ? hi : self->max;
+    Py_RETURN_NONE;
+}
+
+static double tdigest_quantile_value(CalcoTDigest* t, double q) {
+    tdigest_compress(t);
+    const centroid* c = t->c;
+    Py_ssize_t n = t->nc;
+    if (n == 0) {
+        return NAN;
+    }
+    if (n == 1 || q <= 0.0) {
+        return (q <= 0.0) ? t->min : (q >= 1.0 ? t->max : c[0].mean);
+    }
+    if (q >= 1.0) {
+        return t->max;
+    }
+    double index = q * t->total;
+    // Below the first centroid's centre: interpolate from the minimum.
+    if (index < c[0].weight * 0.5) {
+        return t->min + (c[0].mean - t->min) * index / (c[0].weight * 0.5);
+    }
+    double so_far = c[0].weight * 0.5;
+    for (Py_ssize_t i = 0; i + 1 < n; i++) {
+        double dw = (c[i].weight + c[i + 1].weight) * 0.5;
+        if (so_far + dw > index) {
+            double z = (index - so_far) / dw;
+            return c[i].mean + (c[i + 1].mean - c[i].mean) * z;
+        }
+        so_far += dw;
+    }
+    // Above the last centroid's centre: interpolate towards the maximum.
+    double last_half = c[n - 1].weight * 0.5;
+    double z = (index - so_far) / last_half;
+    return c[n - 1].mean + (t->max - c[n - 1].mean) * (z > 1.0 ? 1.0 : z);
+}
+
+static double tdigest_cdf_value(CalcoTDigest* t, double x) {
+    tdigest_compress(t);
+    const centroid* c = t->c;
+    Py_ssize_t n = t->nc;
+    if (n == 0) {
+        return NAN;
+    }
+    if (x < t->min) {
+        return 0.0;
+    }
+    if (x >= t->max) {
+        return 1.0;
+    }
+    if (x < c[0].mean) {
+        double span = c[0].mean - t->min;
+        return (span > 0.0) ? c[0].weight * 0.5 * (x - t->min) / span / t->total : 0.0;
+    }
+    double so_far = c[0].weight * 0.5;
+    for (Py_ssize_t i = 0; i + 1 < n; i++) {
+        double dw = (c[i].weight + c[i + 1].weight) * 0.5;
+        if (x < c[i + 1].mean) {
+            double span = c[i + 1].mean - c[i].mean;
+            return (so_far + ((span > 0.0) ? dw * (x - c[i].mean) / span : 0.0)) / t->total;
+        }
+        so_far += dw;
+    }
+    double span = t->max - c[n - 1].mean;
+    double r = (so_far + ((span > 0.0) ? c[n - 1].weight * 0.5 * (x - c[n - 1].mean) / span : 0.0)) / t->total;
+    return (r > 1.0) ? 1.0 : r;
+}
+
+// Applies f to a float or to every element of an iterable of floats (returning a list).
+static PyObject* tdigest_map(CalcoTDigest* self, PyObject* arg, double (*f)(CalcoTDigest*, double)) {
+    if (tdigest_check(self) < 0) {
+        return NULL;
+    }
+    if (PyFloat_Check(arg) || PyLong_Check(arg)) {
+        double v = PyFloat_AsDouble(arg);
+        if (v == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        return Py_BuildValue("d", f(self, v));
+    }
+    PyObject* seq = PySequence_Fast(arg, "expected a float or an iterable of floats");
+    if (seq == NULL) {
+        return NULL;
+    }
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    PyObject* result = PyList_New(n);
+    for (Py_ssize_t i = 0; result != NULL && i < n; i++) {
+        double v = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, i));
+        PyObject* item = (v == -1.0 && PyErr_Occurred()) ? NULL : PyFloat_FromDouble(f(self, v));
+        if (item == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject* tdigest_quantile(CalcoTDigest* self, PyObject* arg) {
+    return tdigest_map(self, arg, tdigest_quantile_value);
+}
+
+static PyObject* tdigest_cdf(CalcoTDigest* self, PyObject* arg) {
+    return tdigest_map(self, arg, tdigest_cdf_value);
+}
+
+// Layout: magic, compression, total, min, max, centroid count, then (mean, weight) pairs,
+// all as native doubles.
+static PyObject* tdigest_to_bytes(CalcoTDigest* self, PyObject* args) {
+    if (tdigest_check(self) < 0) {
+        return NULL;
+    }
+    tdigest_compress(self);
+    Py_ssize_t size = 4 + 5 * sizeof(double) + self->nc * sizeof(centroid);
+    PyObject* out = PyBytes_FromStringAndSize(NULL, size);
+    if (out == NULL) {
+        return NULL;
+    }
+    char* p = PyBytes_AS_STRING(out);
+    double header[5] = {self->compression, self->total, self->min, self->max, (double)self->nc};
+    memcpy(p, TDIGEST_MAGIC, 4);
+    memcpy(p + 4, header, sizeof(header));
+    memcpy(p + 4 + sizeof(header), self->c, self->nc * sizeof(centroid));
+    return out;
+}
+
+static PyObject* tdigest_from_bytes(PyObject* cls, PyObject* args) {
+    Py_buffer data;
+    double header[5];
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    const char* raw = (const char*)data.buf;
+    Py_ssize_t nc = -1;
+    if (data.len >= 4 + (Py_ssize_t)sizeof(header) && memcmp(raw, TDIGEST_MAGIC, 4) == 0) {
+        memcpy(header, raw + 4, sizeof(header));
+        nc = (Py_ssize_t)header[4];
+        if (data.len != 4 + (Py_ssize_t)(sizeof(header) + nc * sizeof(centroid))) {
+            nc = -1;
+        }
+    }
+    if (nc < 0) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "not a serialized calco.stats.TDigest");
+        return NULL;
+    }
+    CalcoTDigest* t = (CalcoTDigest*)PyType_GenericNew(&CalcoTDigestType, NULL, NULL);
+    if (t == NULL || tdigest_alloc(t, header[0]) < 0) {
+        Py_XDECREF(t);
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    if (nc > t->cap_c) {
+        Py_DECREF(t);
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "not a serialized calco.stats.TDigest");
+        return NULL;
+    }
+    memcpy(t->c, raw + 4 + sizeof(header), nc * sizeof(centroid));
+    t->nc = nc;
+    t->total = header[1];
+    t->min = header[2];
+    t->max = header[3];
+    PyBuffer_Release(&data);
+    return (PyObject*)t;
+}
+
+static PyObject* tdigest_reduce(CalcoTDigest* self, PyObject* args) {
+    PyObject* raw = tdigest_to_bytes(self, NULL);
+    if (raw == NULL) {
+        return NULL;
+    }
+    PyObject* ctor = PyObject_GetAttrString((PyObject*)&CalcoTDigestType, "from_bytes");
+    if (ctor == NULL) {
+        Py_DECREF(raw);
+        return NULL;
+    }
+    return Py_BuildValue("(N(N))", ctor, raw);
+}
+
+static PyObject* tdigest_get_count(CalcoTDigest* self, void* closure) {
+    return Py_BuildValue("d", self->total);
+}
+
+static PyObject* tdigest_get_min(CalcoTDigest* self, void* closure) {
+    return Py_BuildValue("d", self->min);
+}
+
+static PyObject* tdigest_get_max(CalcoTDigest* self, void* closure) {
+    return Py_BuildValue("d", self->max);
+}
+
+static PyObject* tdigest_get_compression(CalcoTDigest* self, void* closure) {
+    return Py_BuildValue("d", self->compression);
+}
+
+static PyObject* tdigest_get_centroids(CalcoTDigest* self, void* closure) {
+    if (tdigest_check(self) < 0) {
+        return NULL;
+    }
+    tdigest_compress(self);
+    return PyLong_FromSsize_t(self->nc);
+}
+
+static PyMethodDef tdigest_methods[] = {
+    {"update", (PyCFunction)tdigest_update, METH_VARARGS, "update(buf): Adds every element of a float64 buffer."},
+    {"push", (PyCFunction)tdigest_push, METH_VARARGS, "push(x, weight=1.0): Adds a single (weighted) value."},
+    {"merge", (PyCFunction)tdigest_merge, METH_VARARGS, "merge(other): Adds the values summarised by another TDigest."},
+    {"quantile", (PyCFunction)tdigest_quantile, METH_O, "quantile(q): Estimated q-quantile (0 <= q <= 1); q may be an iterable, giving a list."},
+    {"cdf", (PyCFunction)tdigest_cdf, METH_O, "cdf(x): Estimated fraction of values <= x; x may be an iterable, giving a list."},
+    {"to_bytes", (PyCFunction)tdigest_to_bytes, METH_NOARGS, "Serializes the digest (native byte order) for merging in another process."},
+    {"from_bytes", (PyCFunction)tdigest_from_bytes, METH_VARARGS | METH_CLASS, "from_bytes(data): Restores a TDigest serialized with to_bytes()."},
+    {"__reduce__", (PyCFunction)tdigest_reduce, METH_NOARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef tdigest_getset[] = {
+    {"count", (getter)tdigest_get_count, NULL, "Total weight added.", NULL},
+    {"min", (getter)tdigest_get_min, NULL, "Smallest value added.", NULL},
+    {"max", (getter)tdigest_get_max, NULL, "Largest value added.", NULL},
+    {"compression", (getter)tdigest_get_compression, NULL, "Compression parameter (about the number of centroids kept).", NULL},
+    {"centroids", (getter)tdigest_get_centroids, NULL, "Number of centroids after merging the buffer.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject CalcoTDigestType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.stats.TDigest",
+    .tp_basicsize = sizeof(CalcoTDigest),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "TDigest(compression=100): Mergeable quantile sketch in fixed memory, most accurate in the tails.",
+    .tp_methods = tdigest_methods,
+    .tp_getset = tdigest_getset,
+    .tp_init = (initproc)tdigest_init,
+    .tp_dealloc = (destructor)tdigest_dealloc,
+    .tp_new = PyType_GenericNew,
+};
+
+// -----------------------------------------------------------------------------
+// Histograms
+// Bin indices are computed without branches: the scaled position is clamped to [-1, bins + 1]
+// and shifted by one, so slot 0 collects underflow and slot bins + 1 overflow; the upper edge
+// itself belongs to the last bin. Each pool part counts into its own row and the rows are
+// summed afterwards (integer counts, so the result never depends on the split).
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    const double* in;
+    Py_ssize_t n;
+    Py_ssize_t bins;
+    Py_ssize_t part_size;
+    double low;
+    double high;
+    double scale;
+    int64_t* counts; // nparts rows of bins + 2
+} hist_task;
+
+static void hist_chunk(void* ctx, Py_ssize_t part) {
+    const hist_task* t = (const hist_task*)ctx;
+    Py_ssize_t start = part * t->part_size;
+    Py_ssize_t end = start + t->part_size;
+    if (end > t->n) {
+        end = t->n;
+    }
+    int64_t* row = t->counts + part * (t->bins + 2);
+    double top = (double)t->bins + 1.0;
+    for (Py_ssize_t i = start; i < end; i++) {
+        double x = t->in[i];
+        double pos = (x - t->low) * t->scale;
+        pos = (pos < -1.0) ? -1.0 : pos;
+        pos = (pos > top) ? top : pos;
+        Py_ssize_t idx = (Py_ssize_t)(pos + 1.0) - (x == t->high);
+        idx = (idx > t->bins + 1) ? t->bins + 1 : idx;
+        idx = (idx < 0) ? 0 : idx; // NaN converts to an arbitrary integer
+        row[idx]++;
+    }
+}
+
+static PyObject* stats_histogram(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"buf", "bins", "low", "high", "out", NULL};
+    PyObject *buf, *low_obj = Py_None, *high_obj = Py_None, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    Py_ssize_t bins = 10;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|nOO$O", kwlist, &buf, &bins, &low_obj, &high_obj, &out)) {
+        return NULL;
+    }
+    if (bins < 1) {
+        PyErr_SetString(PyExc_ValueError, "bins must be >= 1");
+        return NULL;
+    }
+    if (calco_get_double_buffer(buf, &in_view, 0) < 0) {
+        return NULL;
+    }
+    hist_task task = {(const double*)in_view.buf, in_view.len / (Py_ssize_t)sizeof(double), bins, 0, 0.0, 0.0, 0.0, NULL};
+    // A missing edge defaults to the data's minimum or maximum.
+    if (low_obj == Py_None || high_obj == Py_None) {
+        double lo = 0.0, hi = 1.0;
+        if (task.n > 0) {
+            lo = hi = task.in[0];
+            for (Py_ssize_t i = 1; i < task.n; i++) {
+                lo = (task.in[i] < lo) ? task.in[i] : lo;
+                hi = (task.in[i] > hi) ? task.in[i] : hi;
+            }
+        }
+        task.low = lo;
+        task.high = hi;
+    }
+    if ((low_obj != Py_None && (task.low = PyFloat_AsDouble(low_obj)) == -1.0 && PyErr_Occurred()) ||
+        (high_obj != Py_None && (task.high = PyFloat_AsDouble(high_obj)) == -1.0 && PyErr_Occurred())) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    if (task.low == task.high) {
+        task.low -= 0.5;
+        task.high += 0.5;
+    }
+    if (!(task.low < task.high)) {
+        PyBuffer_Release(&in_view);
+        PyErr_SetString(PyExc_ValueError, "low must be smaller than high");
+        return NULL;
+    }
+    task.scale = (double)bins / (task.high - task.low);
+
+    if (out == Py_None) {
+        out_obj = calco_new_array('q', bins, &out_view);
+        if (out_obj == NULL) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+        memset(out_view.buf, 0, bins * sizeof(int64_t));
+    } else {
+        if (calco_get_typed_buffer(out, &out_view, 1, "q") < 0) {
+            PyBuffer_Release(&in_view);
+            return NULL;
+        }
+        if (out_view.len / (Py_ssize_t)sizeof(int64_t) != bins) {
+            PyBuffer_Release(&in_view);
+            PyBuffer_Release(&out_view);
+            PyErr_SetString(PyExc_ValueError, "out must hold exactly `bins` int64 counts");
+            return NULL;
+        }
+        Py_INCREF(out);
+        out_obj = out;
+    }
+
+    Py_ssize_t nparts = (task.n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK;
+    Py_ssize_t threads = calco_pool_size();
+    nparts = (nparts > threads) ? threads : nparts;
+    nparts = (nparts < 1) ? 1 : nparts;
+    task.part_size = (task.n + nparts - 1) / nparts;
+    task.counts = (int64_t*)PyMem_Calloc(nparts * (bins + 2), sizeof(int64_t));
+    if (task.counts == NULL) {
+        PyBuffer_Release(&in_view);
+        PyBuffer_Release(&out_view);
+        Py_DECREF(out_obj);
+        return PyErr_NoMemory();
+    }
+    int64_t* dst = (int64_t*)out_view.buf;
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(hist_chunk, &task, nparts);
+    for (Py_ssize_t p = 0; p < nparts; p++) {
+        const int64_t* row = task.counts + p * (bins + 2) + 1;
+        for (Py_ssize_t b = 0; b < bins; b++) {
+            dst[b] += row[b];
+        }
+    }
+    Py_END_ALLOW_THREADS
+    PyMem_Free(task.counts);
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+// -----------------------------------------------------------------------------
+// Submodule Definition
+// -----------------------------------------------------------------------------
+
+CALCO_WORKSPACE_SHIM(stats_histogram) // workspace= (calco_workspace.c)
+
+static PyMethodDef CalcoStatsMethods[] = {
+    {"moments", (PyCFunction)(void(*)(void))stats_moments, METH_VARARGS | METH_KEYWORDS,
+     "moments(buf, *, ddof=1): Returns a Moments summarising a float64 buffer in a single parallel pass."},
+    {"histogram", (PyCFunction)(void(*)(void))stats_histogram_ws, METH_VARARGS | METH_KEYWORDS,
+     "histogram(buf, bins=10, low=None, high=None, *, out=None): Counts values in equal-width bins over [low, high] "
+     "(data range by default) into an int64 array; values outside are ignored. With out, counts are added to it."},
+    {NULL, NULL, 0, NULL}
+};
+
+struct PyModuleDef calcostatsmodule = {
+    PyModuleDef_HEAD_INIT,
+    "calco.stats",
+    "Descriptive statistics: mergeable moments, t-digest quantiles and histograms.",
+    -1,
+    CalcoStatsMethods
+};
+
+int calco_stats_exec(PyObject* m) {
+    PyTypeObject* types[] = {&CalcoMomentsType, &CalcoTDigestType};
+    const char* names[] = {"Moments", "TDigest"};
+    for (int i = 0; i < 2; i++) {
+        if (PyType_Ready(types[i]) < 0) {
+            return -1;
+        }
+        Py_INCREF(types[i]);
+        if (PyModule_AddObject(m, names[i], (PyObject*)types[i]) < 0) {
+            Py_DECREF(types[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
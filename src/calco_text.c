@@ -0,0 +1,842 @@
+// calco_text.c
+// Contains fast text <-> float64 conversion over buffers: calco.parse_floats (Eisel-Lemire
+// with a correctly rounded fallback; empty fields are rejected) and calco.format_floats (Grisu2 digits verified to be
+// the shortest round-trip string, printed exactly the way repr() prints floats).
+//
+// Both paths work on integers and bit patterns only, so they are unaffected by -ffast-math.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stdint.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// 64x64 -> 128-bit Multiplication
+// -----------------------------------------------------------------------------
+
+static inline uint64_t mul128(uint64_t a, uint64_t b, uint64_t* lo) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *lo = (uint64_t)p;
+    return (uint64_t)(p >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    *lo = (mid << 32) | (uint32_t)p0;
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+static inline int clz64(uint64_t x) {
+    int n = 0;
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+
+// -----------------------------------------------------------------------------
+// Powers of Ten
+// pow10_128[i] holds the top 128 bits (truncated, top bit set) of 10^(i + POW10_MIN).
+// The table is computed once at import with a small bignum instead of being shipped.
+// -----------------------------------------------------------------------------
+
+#define POW10_MIN (-348)
+#define POW10_MAX 347
+#define BIG_LIMBS 40
+
+static uint64_t pow10_hi[POW10_MAX - POW10_MIN + 1];
+static uint64_t pow10_lo[POW10_MAX - POW10_MIN + 1];
+
+typedef struct {
+    uint32_t limb[BIG_LIMBS]; // Little-endian
+    int len;
+} bignum;
+
+static int big_bitlen(const bignum* b) {
+    int top = b->len - 1;
+    uint32_t v = b->limb[top];
+    int bits = 0;
+    while (v) {
+        v >>= 1;
+        bits++;
+    }
+    return top * 32 + bits;
+}
+
+static void big_top128(const bignum* b, uint64_t* hi, uint64_t* lo) {
+    int len = big_bitlen(b);
+    *hi = *lo = 0;
+    for (int i = 0; i < 128; i++) {
+        int bit = len - 1 - i;
+        uint64_t v = (bit >= 0) ? (b->limb[bit / 32] >> (bit % 32)) & 1 : 0;
+        if (i < 64) {
+            *hi |= v << (63 - i);
+        } else {
+            *lo |= v << (127 - i);
+        }
+    }
+}
+
+void calco_text_init(void) {
+    bignum b;
+    // Non-negative powers: 5^k exactly (10^k has the same mantissa as 5^k)
+    memset(&b, 0, sizeof(b));
+    b.limb[0] = 1;
+    b.len = 1;
+    for (int k = 0; k <= POW10_MAX; k++) {
+        big_top128(&b, &pow10_hi[k - POW10_MIN], &pow10_lo[k - POW10_MIN]);
+        uint64_t carry = 0;
+        for (int i = 0; i < b.len; i++) {
+            uint64_t v = (uint64_t)b.limb[i] * 5 + carry;
+            b.limb[i] = (uint32_t)v;
+            carry = v >> 32;
+        }
+        if (carry) {
+            b.limb[b.len++] = (uint32_t)carry;
+        }
+    }
+    // Negative powers: floor(2^1248 / 5^m), which keeps far more than 128 significant bits
+    memset(&b, 0, sizeof(b));
+    b.len = BIG_LIMBS;
+    b.limb[BIG_LIMBS - 1] = 1;
+    for (int m = 1; m <= -POW10_MIN; m++) {
+        uint64_t rem = 0;
+        for (int i = b.len - 1; i >= 0; i--) {
+            uint64_t cur = (rem << 32) | b.limb[i];
+            b.limb[i] = (uint32_t)(cur / 5);
+            rem = cur % 5;
+        }
+        while (b.len > 1 && b.limb[b.len - 1] == 0) {
+            b.len--;
+        }
+        big_top128(&b, &pow10_hi[-m - POW10_MIN], &pow10_lo[-m - POW10_MIN]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Parsing
+// -----------------------------------------------------------------------------
+
+static inline double bits_to_double(uint64_t bits) {
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+static inline uint64_t double_to_bits(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+// Eisel-Lemire: converts man * 10^exp10 to the nearest double. Returns 0 when the result
+// cannot be decided from 128 bits (halfway cases, subnormals, overflow) so the caller can
+// fall back to a correctly rounded conversion.
+static int eisel_lemire(uint64_t man, int exp10, int neg, double* out) {
+    if (man == 0) {
+        // From the bit pattern: -ffast-math implies -fno-signed-zeros, which folds neg ? -0.0 : 0.0
+        *out = bits_to_double(neg ? 0x8000000000000000ULL : 0);
+        return 1;
+    }
+    if (exp10 < POW10_MIN || exp10 > POW10_MAX) {
+        return 0;
+    }
+    int clz = clz64(man);
+    man <<= clz;
+    uint64_t ret_exp2 = (uint64_t)(((217706 * exp10) >> 16) + 64 + 1023) - (uint64_t)clz;
+    uint64_t x_lo;
+    uint64_t x_hi = mul128(man, pow10_hi[exp10 - POW10_MIN], &x_lo);
+    if ((x_hi & 0x1FF) == 0x1FF && x_lo + man < man) {
+        // Wider approximation using the low 64 bits of the power
+        uint64_t y_lo;
+        uint64_t y_hi = mul128(man, pow10_lo[exp10 - POW10_MIN], &y_lo);
+        uint64_t merged_hi = x_hi, merged_lo = x_lo + y_hi;
+        if (merged_lo < x_lo) {
+            merged_hi++;
+        }
+        if ((merged_hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 && y_lo + man < man) {
+            return 0;
+        }
+        x_hi = merged_hi;
+        x_lo = merged_lo;
+    }
+    uint64_t msb = x_hi >> 63;
+    uint64_t ret_man = x_hi >> (msb + 9);
+    ret_exp2 -= 1 ^ msb;
+    if (x_lo == 0 && (x_hi & 0x1FF) == 0 && (ret_man & 3) == 1) {
+        return 0; // Exactly halfway: ambiguous
+    }
+    ret_man += ret_man & 1;
+    ret_man >>= 1;
+    if (ret_man >> 53) {
+        ret_man >>= 1;
+        ret_exp2 += 1;
+    }
+    if (ret_exp2 - 1 >= 0x7FF - 1) {
+        return 0; // Subnormal or overflow
+    }
+    uint64_t bits = (ret_exp2 << 52) | (ret_man & 0x000FFFFFFFFFFFFFULL);
+    if (neg) {
+        bits |= 0x8000000000000000ULL;
+    }
+    *out = bits_to_double(bits);
+    return 1;
+}
+
+static inline int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+static int match_word(const char* p, const char* end, const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(end - p) != n) {
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (lower(p[i]) != word[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Parses one token [p, end). Returns 0 on success, -1 (with an exception set) otherwise.
+static int parse_token(const char* p, const char* end, double* out) {
+    const char* s = p;
+    int neg = 0;
+    if (s < end && (*s == '+' || *s == '-')) {
+        neg = (*s == '-');
+        s++;
+    }
+    uint64_t man = 0;
+    int digits = 0, exp10 = 0, any = 0;
+    while (s < end && *s == '0') {
+        s++;
+        any = 1;
+    }
+    while (s < end && is_digit(*s)) {
+        if (digits < 19) {
+            man = man * 10 + (uint64_t)(*s - '0');
+        } else {
+            exp10++;
+        }
+        digits++;
+        s++;
+        any = 1;
+    }
+    int truncated = digits > 19;
+    if (s < end && *s == '.') {
+        s++;
+        if (digits == 0) {
+            while (s < end && *s == '0') {
+                exp10--;
+                s++;
+                any = 1;
+            }
+        }
+        while (s < end && is_digit(*s)) {
+            if (digits < 19) {
+                man = man * 10 + (uint64_t)(*s - '0');
+                exp10--;
+            } else if (*s != '0') {
+                truncated = 1;
+            }
+            digits++;
+            s++;
+            any = 1;
+        }
+    }
+    if (any && s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        int eneg = 0, ev = 0, edigits = 0;
+        if (e < end && (*e == '+' || *e == '-')) {
+            eneg = (*e == '-');
+            e++;
+        }
+        while (e < end && is_digit(*e)) {
+            if (ev < 100000) {
+                ev = ev * 10 + (*e - '0');
+            }
+            e++;
+            edigits++;
+        }
+        if (edigits > 0) {
+            exp10 += eneg ? -ev : ev;
+            s = e;
+        }
+    }
+    if (any && s == end && !truncated && eisel_lemire(man, exp10, neg, out)) {
+        return 0;
+    }
+    if (!any) {
+        const char* w = (p < end && (*p == '+' || *p == '-')) ? p + 1 : p;
+        if (match_word(w, end, "nan")) {
+            *out = bits_to_double(neg ? 0xFFF8000000000000ULL : 0x7FF8000000000000ULL);
+            return 0;
+        }
+        if (match_word(w, end, "inf") || match_word(w, end, "infinity")) {
+            *out = neg ? -INFINITY : INFINITY;
+            return 0;
+        }
+    }
+    // Correctly rounded fallback (long mantissas, halfway cases, subnormals, overflow)
+    char small[64];
+    Py_ssize_t n = end - p;
+    char* tmp = (n < (Py_ssize_t)sizeof(small)) ? small : (char*)PyMem_Malloc((size_t)n + 1);
+    if (tmp == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memcpy(tmp, p, (size_t)n);
+    tmp[n] = 0;
+    char* stop;
+    double v = PyOS_string_to_double(tmp, &stop, NULL);
+    int ok = !(v == -1.0 && PyErr_Occurred()) && stop == tmp + n && n > 0;
+    if (!ok) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_ValueError, "could not convert '%s' to float", tmp);
+    }
+    if (tmp != small) {
+        PyMem_Free(tmp);
+    }
+    *out = v;
+    return ok ? 0 : -1;
+}
+
+static inline int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int only_space(const char* p, const char* end) {
+    while (p < end && is_space(*p)) {
+        p++;
+    }
+    return p == end;
+}
+
+PyObject* calco_parse_floats(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"data", "sep", "out", "partial", NULL};
+    PyObject *data, *out = Py_None;
+    Py_buffer sep = {NULL, NULL};
+    int partial = 0;
+    Py_buffer in;
+    char sep_char = ',';
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|y*$Op", kwlist, &data, &sep, &out, &partial)) {
+        return NULL;
+    }
+    if (sep.obj != NULL) {
+        if (sep.len != 1) {
+            PyBuffer_Release(&sep);
+            PyErr_SetString(PyExc_ValueError, "sep must be a single byte");
+            return NULL;
+        }
+        sep_char = ((const char*)sep.buf)[0];
+        PyBuffer_Release(&sep);
+    }
+    if (PyObject_GetBuffer(data, &in, PyBUF_C_CONTIGUOUS) < 0) {
+        return NULL;
+    }
+    const char* p = (const char*)in.buf;
+    const char* end = p + in.len;
+
+    // Destination: the caller's float64 buffer, or a growable scratch array
+    Py_buffer out_view;
+    int have_out = 0;
+    double* dst = NULL;
+    Py_ssize_t cap = 0, count = 0;
+    if (out != Py_None) {
+        if (calco_get_double_buffer(out, &out_view, 1) < 0) {
+            PyBuffer_Release(&in);
+            return NULL;
+        }
+        have_out = 1;
+        dst = (double*)out_view.buf;
+        cap = out_view.len / (Py_ssize_t)sizeof(double);
+    } else {
+        cap = in.len / 4 + 16;
+        dst = (double*)PyMem_Malloc((size_t)cap * sizeof(double));
+        if (dst == NULL) {
+            PyBuffer_Release(&in);
+            return PyErr_NoMemory();
+        }
+    }
+
+    // Values are separated by sep or whitespace, and sep must sit between two values on one line:
+    // a sep at the start of a line, after another sep, or before a line break followed by more
+    // data closes an empty field, which is an error rather than a value to skip. One sep after
+    // the last value is a terminator (b'1\n2\n' with sep=b'\n').
+    enum { LINE_START, AFTER_VALUE, AFTER_SEP } state = LINE_START;
+    const char* consumed = p;
+    PyObject* result = NULL;
+    for (;;) {
+        while (p < end && *p != sep_char && is_space(*p)) {
+            if (*p == '\n') {
+                if (state == AFTER_SEP && !only_space(p, end)) {
+                    goto empty_field;
+                }
+                state = LINE_START;
+            }
+            p++;
+        }
+        if (p >= end) {
+            consumed = end;
+            break;
+        }
+        if (*p == sep_char) {
+            if (state != AFTER_VALUE) {
+                goto empty_field;
+            }
+            state = AFTER_SEP;
+            consumed = ++p;
+            continue;
+        }
+        const char* tok = p;
+        while (p < end && *p != sep_char && !is_space(*p)) {
+            p++;
+        }
+        if (p == end && partial) {
+            break; // The last token may continue in the next chunk
+        }
+        if (count == cap) {
+            if (have_out) {
+                PyErr_SetString(PyExc_ValueError, "out buffer is too small for the parsed values");
+                goto done;
+            }
+            cap *= 2;
+            double* grown = (double*)PyMem_Realloc(dst, (size_t)cap * sizeof(double));
+            if (grown == NULL) {
+                PyErr_NoMemory();
+                goto done;
+            }
+            dst = grown;
+        }
+        if (parse_token(tok, p, &dst[count]) < 0) {
+            goto done;
+        }
+        count++;
+        consumed = p;
+        state = AFTER_VALUE;
+    }
+
+    if (have_out) {
+        result = PyLong_FromSsize_t(count);
+    } else {
+        Py_buffer view;
+        result = calco_new_double_array(count, &view);
+        if (result != NULL) {
+            memcpy(view.buf, dst, (size_t)count * sizeof(double));
+            PyBuffer_Release(&view);
+        }
+    }
+    if (result != NULL && partial) {
+        PyObject* pair = Py_BuildValue("(Nn)", result, (Py_ssize_t)(consumed - (const char*)in.buf));
+        result = pair;
+    }
+    goto done;
+
+empty_field:
+    PyErr_Format(PyExc_ValueError, "empty field at byte %zd", (Py_ssize_t)(p - (const char*)in.buf));
+done:
+    if (have_out) {
+        PyBuffer_Release(&out_view);
+    } else {
+        PyMem_Free(dst);
+    }
+    PyBuffer_Release(&in);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Formatting (Grisu2)
+// Grisu2 produces the shortest digit string in the vast majority of cases and always one
+// that round-trips; shortest_digits() below closes the remaining gap.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t f;
+    int e;
+} diyfp;
+
+static inline diyfp diy_mul(diyfp a, diyfp b) {
+    uint64_t lo;
+    uint64_t hi = mul128(a.f, b.f, &lo);
+    diyfp r = {hi + (lo >> 63), a.e + b.e + 64}; // Round to nearest
+    return r;
+}
+
+static inline diyfp diy_normalize(diyfp x) {
+    int s = clz64(x.f);
+    x.f <<= s;
+    x.e -= s;
+    return x;
+}
+
+// Cached power c = 10^k (normalised, rounded) such that the product lands in [-60, -32].
+static diyfp cached_power(int e, int* k) {
+    double dk = (-61 - e) * 0.30102999566398114;
+    int kk = (int)dk;
+    if (dk - kk > 0.0) {
+        kk++;
+    }
+    if (kk < POW10_MIN) {
+        kk = POW10_MIN;
+    }
+    *k = kk;
+    uint64_t hi = pow10_hi[kk - POW10_MIN], lo = pow10_lo[kk - POW10_MIN];
+    diyfp c = {hi, ((217706 * kk) >> 16) - 63};
+    if ((lo >> 63) && c.f != UINT64_MAX) {
+        c.f++;
+    }
+    return c;
+}
+
+static const uint64_t pow10_u64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static void grisu_round(char* buf, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int count_digits32(uint32_t n) {
+    int d = 1;
+    while (n >= 10) {
+        n /= 10;
+        d++;
+    }
+    return d;
+}
+
+static int digit_gen(diyfp w, diyfp mp, uint64_t delta, char* buf, int* k) {
+    diyfp one = {1ULL << -mp.e, mp.e};
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = count_digits32(p1);
+    int len = 0;
+    while (kappa > 0) {
+        uint32_t div = (uint32_t)pow10_u64[kappa - 1];
+        uint32_t d = p1 / div;
+        p1 %= div;
+        kappa--;
+        if (d || len) {
+            buf[len++] = (char)('0' + d);
+        }
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buf, len, delta, rest, pow10_u64[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d || len) {
+            buf[len++] = (char)('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int index = -kappa;
+            grisu_round(buf, len, delta, p2, one.f, wp_w * (index < 20 ? pow10_u64[index] : 0));
+            return len;
+        }
+    }
+}
+
+// Shortest digits of a finite positive double: value = digits * 10^k. Returns the digit count.
+static int grisu2(double value, char* buf, int* k) {
+    uint64_t bits = double_to_bits(value);
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t sig = bits & 0x000FFFFFFFFFFFFFULL;
+    diyfp v;
+    if (biased != 0) {
+        v.f = sig | 0x0010000000000000ULL;
+        v.e = biased - 1075;
+    } else {
+        v.f = sig;
+        v.e = -1074;
+    }
+    // Boundaries m+ and m-, both with m+'s exponent
+    diyfp pl = {(v.f << 1) + 1, v.e - 1};
+    while (!(pl.f & (0x0010000000000000ULL << 1))) {
+        pl.f <<= 1;
+        pl.e--;
+    }
+    pl.f <<= 64 - 52 - 2;
+    pl.e -= 64 - 52 - 2;
+    diyfp mi = (v.f == 0x0010000000000000ULL) ? (diyfp){(v.f << 2) - 1, v.e - 2} : (diyfp){(v.f << 1) - 1, v.e - 1};
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    int mk;
+    diyfp c = cached_power(pl.e, &mk);
+    diyfp w = diy_mul(diy_normalize(v), c);
+    diyfp wp = diy_mul(pl, c);
+    diyfp wm = diy_mul(mi, c);
+    wm.f++;
+    wp.f--;
+    *k = -mk;
+    return digit_gen(w, wp, wp.f - wm.f, buf, k);
+}
+
+// Returns 1 if man * 10^k converts back to exactly `bits`, 0 if not, -1 if undecidable here.
+static int roundtrips(uint64_t man, int k, uint64_t bits) {
+    double y;
+    if (!eisel_lemire(man, k, 0, &y)) {
+        return -1;
+    }
+    return double_to_bits(y) == bits;
+}
+
+// Compares (n / 2) * 10^q with the finite positive double with bits `bits`, where n is odd
+// (a midpoint between two decimal candidates). Returns -1/1 if the midpoint is below/above x
+// and 0 when the 64-bit approximation of 10^q is too coarse to tell.
+static int compare_midpoint(uint64_t n, int q, uint64_t bits) {
+    if (q < POW10_MIN || q > POW10_MAX) {
+        return 0;
+    }
+    // midpoint ~= n * hi(10^q) * 2^(e10 + 64), underestimated by < 2^-62 relative
+    int e10 = ((217706 * q) >> 16) - 127;
+    uint64_t pl;
+    uint64_t ph = mul128(n, pow10_hi[q - POW10_MIN], &pl);
+    int s = clz64(ph | 1);
+    uint64_t t = (s == 0) ? ph : (ph << s) | (pl >> (64 - s));
+    int ev = e10 + 64 + 64 - s - 1; // The 1/2 of n / 2
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t xm = (bits & 0x000FFFFFFFFFFFFFULL) | (biased ? 0x0010000000000000ULL : 0);
+    int ex = (biased ? biased : 1) - 1075;
+    int sx = clz64(xm);
+    xm <<= sx;
+    ex -= sx;
+    if (ev > ex) {
+        return 1;
+    }
+    if (ev < ex) {
+        return (ev == ex - 1 && t > UINT64_MAX - 64) ? 0 : -1;
+    }
+    if (t > xm + 16) {
+        return 1;
+    }
+    if (t + 16 < xm) {
+        return -1;
+    }
+    return 0;
+}
+
+// Shortest, closest digits of a finite positive double (repr semantics): Grisu2, then a check
+// that no shorter string round-trips and that the result is the only round-tripping string of
+// its length (hence the closest one). Returns the digit count, or -1 when the caller must use
+// the exact (slow) conversion instead.
+static int shortest_digits(double x, char* digits, int* k) {
+    uint64_t bits = double_to_bits(x);
+    char buf[24];
+    int len = grisu2(x, buf, k);
+    uint64_t man = 0;
+    for (int i = 0; i < len; i++) {
+        man = man * 10 + (uint64_t)(buf[i] - '0');
+    }
+    while (man >= 10) {
+        int lo = roundtrips(man / 10, *k + 1, bits);
+        int hi = roundtrips(man / 10 + 1, *k + 1, bits);
+        if (lo < 0 || hi < 0 || (lo && hi)) {
+            return -1;
+        }
+        if (!lo && !hi) {
+            break;
+        }
+        man = lo ? man / 10 : man / 10 + 1;
+        *k += 1;
+    }
+    // Among strings of this length, repr picks the one closest to x
+    for (int step = 0; step < 3; step++) {
+        int below = roundtrips(man - 1, *k, bits);
+        int above = roundtrips(man + 1, *k, bits);
+        if (below < 0 || above < 0) {
+            return -1;
+        }
+        int cmp;
+        if (below) {
+            if ((cmp = compare_midpoint(2 * man - 1, *k, bits)) == 0) {
+                return -1;
+            }
+            if (cmp > 0) {
+                man--;
+                continue;
+            }
+        }
+        if (above) {
+            if ((cmp = compare_midpoint(2 * man + 1, *k, bits)) == 0) {
+                return -1;
+            }
+            if (cmp < 0) {
+                man++;
+                continue;
+            }
+        }
+        break;
+    }
+    while (man % 10 == 0) {
+        man /= 10;
+        *k += 1;
+    }
+    len = 0;
+    for (uint64_t m = man; m > 0; m /= 10) {
+        buf[len++] = (char)('0' + m % 10);
+    }
+    for (int i = 0; i < len; i++) {
+        digits[i] = buf[len - 1 - i];
+    }
+    return len;
+}
+
+// Writes x the way repr(x) does. Returns the number of bytes written (at most 25), or -1 if x
+// needs the exact conversion.
+static int format_double(double x, char* out) {
+    uint64_t bits = double_to_bits(x);
+    char* o = out;
+    if ((bits & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL) {
+        if (bits & 0x000FFFFFFFFFFFFFULL) {
+            memcpy(o, "nan", 3);
+            return 3;
+        }
+        if (bits >> 63) {
+            *o++ = '-';
+        }
+        memcpy(o, "inf", 3);
+        return (int)(o - out) + 3;
+    }
+    if (bits >> 63) {
+        *o++ = '-';
+        bits &= ~0x8000000000000000ULL;
+    }
+    if (bits == 0) {
+        memcpy(o, "0.0", 3);
+        return (int)(o - out) + 3;
+    }
+    char digits[24];
+    int k;
+    int len = shortest_digits(bits_to_double(bits), digits, &k);
+    if (len < 0) {
+        return -1;
+    }
+    int point = len + k; // Position of the decimal point relative to the first digit
+    if (point - 1 < -4 || point - 1 >= 16) {
+        *o++ = digits[0];
+        if (len > 1) {
+            *o++ = '.';
+            memcpy(o, digits + 1, (size_t)(len - 1));
+            o += len - 1;
+        }
+        int e = point - 1;
+        *o++ = 'e';
+        *o++ = (e < 0) ? '-' : '+';
+        if (e < 0) {
+            e = -e;
+        }
+        if (e >= 100) {
+            *o++ = (char)('0' + e / 100);
+        }
+        *o++ = (char)('0' + (e / 10) % 10);
+        *o++ = (char)('0' + e % 10);
+    } else if (point >= len) {
+        memcpy(o, digits, (size_t)len);
+        o += len;
+        memset(o, '0', (size_t)(point - len));
+        o += point - len;
+        *o++ = '.';
+        *o++ = '0';
+    } else if (point > 0) {
+        memcpy(o, digits, (size_t)point);
+        o += point;
+        *o++ = '.';
+        memcpy(o, digits + point, (size_t)(len - point));
+        o += len - point;
+    } else {
+        *o++ = '0';
+        *o++ = '.';
+        memset(o, '0', (size_t)(-point));
+        o += -point;
+        memcpy(o, digits, (size_t)len);
+        o += len;
+    }
+    return (int)(o - out);
+}
+
+PyObject* calco_format_floats(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"buf", "sep", NULL};
+    PyObject* buf;
+    Py_buffer sep = {NULL, NULL};
+    Py_buffer in;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|y*", kwlist, &buf, &sep)) {
+        return NULL;
+    }
+    const char* sep_bytes = ",";
+    Py_ssize_t sep_len = 1;
+    if (sep.obj != NULL) {
+        sep_bytes = (const char*)sep.buf;
+        sep_len = sep.len;
+    }
+    if (calco_get_double_buffer(buf, &in, 0) < 0) {
+        if (sep.obj != NULL) PyBuffer_Release(&sep);
+        return NULL;
+    }
+    Py_ssize_t n = in.len / (Py_ssize_t)sizeof(double);
+    PyObject* result = PyBytes_FromStringAndSize(NULL, n * (25 + sep_len));
+    if (result != NULL) {
+        char* o = PyBytes_AS_STRING(result);
+        const double* x = (const double*)in.buf;
+        int failed = 0;
+        Py_BEGIN_ALLOW_THREADS
+        for (Py_ssize_t i = 0; i < n; i++) {
+            if (i > 0) {
+                memcpy(o, sep_bytes, (size_t)sep_len);
+                o += sep_len;
+            }
+            int w = format_double(x[i], o);
+            if (w < 0) {
+                // Rare: let CPython's exact dtoa decide (needs the GIL)
+                Py_BLOCK_THREADS
+                char* r = PyOS_double_to_string(x[i], 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+                Py_UNBLOCK_THREADS
+                if (r == NULL) {
+                    failed = 1;
+                    break;
+                }
+                w = (int)strlen(r);
+                memcpy(o, r, (size_t)w);
+                PyMem_Free(r);
+            }
+            o += w;
+        }
+        Py_END_ALLOW_THREADS
+        if (failed) {
+            Py_CLEAR(result);
+        } else {
+            _PyBytes_Resize(&result, o - PyBytes_AS_STRING(result));
+        }
+    }
+    PyBuffer_Release(&in);
+    if (sep.obj != NULL) {
+        PyBuffer_Release(&sep);
+    }
+    return result;
+}
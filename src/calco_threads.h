@@ -0,0 +1,52 @@
+// calco_threads.h
+// Minimal portable threading primitives (mutex, condition variable, thread)
+// used by the native worker pool. Wraps pthreads on POSIX and the Win32 API on Windows.
+
+#ifndef CALCO_THREADS_H
+#define CALCO_THREADS_H
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef CRITICAL_SECTION calco_mutex_t;
+typedef CONDITION_VARIABLE calco_cond_t;
+typedef HANDLE calco_thread_t;
+
+#define calco_mutex_init(m)     InitializeCriticalSection(m)
+#define calco_mutex_lock(m)     EnterCriticalSection(m)
+#define calco_mutex_unlock(m)   LeaveCriticalSection(m)
+#define calco_cond_init(c)      InitializeConditionVariable(c)
+#define calco_cond_wait(c, m)   SleepConditionVariableCS((c), (m), INFINITE)
+#define calco_cond_signal(c)    WakeConditionVariable(c)
+#define calco_cond_broadcast(c) WakeAllConditionVariable(c)
+
+static inline int calco_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t calco_mutex_t;
+typedef pthread_cond_t calco_cond_t;
+typedef pthread_t calco_thread_t;
+
+#define calco_mutex_init(m)     pthread_mutex_init((m), NULL)
+#define calco_mutex_lock(m)     pthread_mutex_lock(m)
+#define calco_mutex_unlock(m)   pthread_mutex_unlock(m)
+#define calco_cond_init(c)      pthread_cond_init((c), NULL)
+#define calco_cond_wait(c, m)   pthread_cond_wait((c), (m))
+#define calco_cond_signal(c)    pthread_cond_signal(c)
+#define calco_cond_broadcast(c) pthread_cond_broadcast(c)
+
+static inline int calco_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+#endif // _WIN32
+
+#endif // CALCO_THREADS_H
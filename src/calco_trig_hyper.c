@@ -31,11 +31,11 @@ PyObject* calco_tangent(PyObject* self, PyObject* args) {
     if (!PyArg_ParseTuple(args, "d", &angle_rad)) {
         return NULL;
     }
-    double cos_val = cos(angle_rad);
-    if (fabs(cos_val) < DBL_EPSILON) { // Check for values very close to zero
+    double tan_val = tan(angle_rad);
+    if (fabs(tan_val) > 1.0 / DBL_EPSILON) { // Cosine very close to zero (pole)
         return Py_BuildValue("d", NAN);
     }
-    return Py_BuildValue("d", tan(angle_rad));
+    return Py_BuildValue("d", tan_val);
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,468 @@
+// calco_trig_reduce.c
+// Contains degree-native trigonometry (sind, cosd, tand, asind, acosd, atan2d) and the buffer
+// kernels behind calco.apply for sine, cosine and tangent in radians.
+//
+// Degrees reduce exactly (calco_sincos.h), so sind(180) is 0, sind(30) is 1/2 and tand(45) is 1.
+// Radians reduce by Cody-Waite up to CALCO_RAD_MEDIUM, and beyond that by Payne-Hanek: the
+// product of x with enough bits of 2/pi, taken modulo 4 in fixed point, gives the quadrant and
+// the remainder to full precision for any finite double. Block kernels run the vectorizable medium path over
+// the whole block and then redo the (rare) elements beyond its range one at a time.
+//
+// -ffast-math would fold x - q a - q b into x - q (a + b) and undo the split of pi/2, so this
+// file is compiled without reassociation. Its loops are element-wise and still vectorize.
+
+#if defined(__clang__)
+#pragma clang fp reassociate(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("no-associative-math")
+#endif
+
+#include "calco.h" // Include the main header for prototypes and definitions
+#include "calco_eft.h" // calco_isfinite, calco_isnan, calco_same_bits
+#include "calco_dd.h" // Double-double remainder for calco_rem_pio2_large_dd
+#include "calco_sincos.h"
+
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+
+#define RAD_TO_DEG_LO -1.9878495670576283e-15 // 180/pi - CALCO_RAD_TO_DEG
+#define PIO2_HI 1.5707963267948966
+#define PIO2_LO 6.123233995736766e-17
+
+// -----------------------------------------------------------------------------
+// Payne-Hanek Reduction
+// -----------------------------------------------------------------------------
+
+// Bits of 2/pi, most significant first: word w >= 1 holds bits 64 (w - 1) + 1 .. 64 w, where bit
+// k has weight 2^-k. Word 0 stands for the (zero) bits at k <= 0.
+static const uint64_t two_over_pi[22] = {
+    0x0000000000000000ULL,
+    0xA2F9836E4E441529ULL, 0xFC2757D1F534DDC0ULL, 0xDB6295993C439041ULL,
+    0xFE5163ABDEBBC561ULL, 0xB7246E3A424DD2E0ULL, 0x06492EEA09D1921CULL,
+    0xFE1DEB1CB129A73EULL, 0xE88235F52EBB4484ULL, 0xE99C7026B45F7E41ULL,
+    0x3991D639835339F4ULL, 0x9C845F8BBDF9283BULL, 0x1FF897FFDE05980FULL,
+    0xEF2F118B5A0A6D1FULL, 0x6D367ECF27CB09B7ULL, 0x4F463F669E5FEA2DULL,
+    0x7527BAC7EBE5F17BULL, 0x3D0739F78A5292EAULL, 0x6BFB5FB11F8D5D08ULL,
+    0x56033046FC7B6BABULL, 0xF0CFBC209AF4361DULL, 0xA9E391615EE61B08ULL,
+};
+
+static inline uint64_t mul128(uint64_t a, uint64_t b, uint64_t* lo) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *lo = (uint64_t)p;
+    return (uint64_t)(p >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    *lo = (mid << 32) | (uint32_t)p0;
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+// The 64 bits of 2/pi starting at bit k (k > -64).
+static inline uint64_t two_over_pi_bits(int k) {
+    int idx = k + 63;
+    int w = idx >> 6, sh = idx & 63;
+    return sh ? (two_over_pi[w] << sh) | (two_over_pi[w + 1] >> (64 - sh)) : two_over_pi[w];
+}
+
+// x 2/pi mod 4 for |x| >= 2^20, as the quadrant q (returned) and the fraction of a quarter turn
+// in f[0..2] (fixed point, f[0] most significant, weight 2^-64 per unit of f[0]). The fraction
+// is rounded to the nearest quadrant: when it is >= 1/2, q is incremented, f holds 1 - fraction
+// and *sign is -1. With x = m 2^e (m a 53-bit integer), bits of 2/pi above 2^-(e-1) contribute
+// whole multiples of 4 and are skipped; the next 192 bits give the fraction with at least 120
+// bits to spare after the worst cancellation a double can produce (about 61 bits).
+static int rem_pio2_fraction(uint64_t bits, uint64_t f[3], double* sign) {
+    int e = (int)((bits >> 52) & 0x7FF) - 1075;
+    uint64_t m = (bits & 0x000FFFFFFFFFFFFFULL) | 0x0010000000000000ULL;
+    uint64_t c0 = two_over_pi_bits(e - 1), c1 = two_over_pi_bits(e + 63), c2 = two_over_pi_bits(e + 127);
+
+    // Low 192 bits of m * (c0:c1:c2): x * 2/pi mod 4 in units of 2^-190.
+    uint64_t p2_lo, p1_lo;
+    uint64_t p2_hi = mul128(m, c2, &p2_lo);
+    uint64_t p1_hi = mul128(m, c1, &p1_lo);
+    uint64_t r2 = p2_lo;
+    uint64_t r1 = p2_hi + p1_lo;
+    uint64_t r0 = p1_hi + m * c0 + (r1 < p1_lo);
+    int q = (int)(r0 >> 62);
+    f[0] = (r0 << 2) | (r1 >> 62);
+    f[1] = (r1 << 2) | (r2 >> 62);
+    f[2] = r2 << 2;
+    *sign = 1.0;
+    if (f[0] >> 63) { // Fraction >= 1/2: round to the next quadrant and negate
+        q++;
+        f[0] = ~f[0];
+        f[1] = ~f[1];
+        f[2] = ~f[2] + 1;
+        if (f[2] == 0 && ++f[1] == 0) {
+            f[0]++;
+        }
+        *sign = -1.0;
+    }
+    return q;
+}
+
+// Reduces any double to r = x - q pi/2, |r| <= pi/4, and returns q (only q mod 4 matters).
+int calco_rem_pio2_large(double x, double* r) {
+    if (!calco_isfinite(x)) {
+        *r = x - x;
+        return 0;
+    }
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    if (((bits >> 52) & 0x7FF) < 1043) { // |x| < 2^20: the medium reduction is exact enough
+        return calco_reduce_pio2_medium(x, r);
+    }
+    uint64_t f[3];
+    double sign;
+    int q = rem_pio2_fraction(bits, f, &sign);
+    // Fraction of a quarter turn as a double-double, then times pi/2.
+    double hi = (double)f[0];
+    double lo = (double)(int64_t)(f[0] - (uint64_t)hi) + (double)f[1] * 0x1p-64;
+    hi *= 0x1p-64;
+    lo *= 0x1p-64;
+    double y = hi * PIO2_HI + (hi * PIO2_LO + lo * PIO2_HI);
+    if (bits >> 63) {
+        *r = -sign * y;
+        return -q;
+    }
+    *r = sign * y;
+    return q;
+}
+
+static inline int clz64(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+    while (!(v >> 63)) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// As calco_rem_pio2_large for finite |x| >= 2^20, with the remainder as a double-double
+// (*hi + *lo, about 2^-104 relative) for the double-double sine and cosine in calco_dd.c. The
+// fraction is normalized before rounding, so cancellation near a multiple of pi/2 costs no
+// relative accuracy.
+int calco_rem_pio2_large_dd(double x, double* hi, double* lo) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint64_t f[3];
+    double sign;
+    int q = rem_pio2_fraction(bits, f, &sign);
+    int shift = 0;
+    while (f[0] == 0 && shift < 192) {
+        f[0] = f[1];
+        f[1] = f[2];
+        f[2] = 0;
+        shift += 64;
+    }
+    calco_dd r = calco_dd_make(0.0, 0.0);
+    if (f[0] != 0) {
+        int s = clz64(f[0]);
+        if (s) {
+            f[0] = (f[0] << s) | (f[1] >> (64 - s));
+            f[1] = (f[1] << s) | (f[2] >> (64 - s));
+            shift += s;
+        }
+        // Top 53 bits exactly, then the next 64 rounded once: 117 bits of the fraction.
+        double top = (double)(f[0] >> 11) * 0x1p-53;
+        double next = (double)(((f[0] & 0x7FF) << 53) | (f[1] >> 11)) * 0x1p-117;
+        r = calco_dd_mul(calco_dd_norm(top, next), calco_dd_make(PIO2_HI, PIO2_LO));
+        r = calco_dd_make(ldexp(r.hi, -shift) * sign, ldexp(r.lo, -shift) * sign);
+    }
+    if (bits >> 63) {
+        r = calco_dd_neg(r);
+        q = -q;
+    }
+    *hi = r.hi;
+    *lo = r.lo;
+    return q;
+}
+
+// -----------------------------------------------------------------------------
+// Element Kernels
+// The *_medium forms are straight-line code for the vectorized pass; the others are complete.
+// -----------------------------------------------------------------------------
+
+static inline double to_degrees(double r) {
+    return r * CALCO_RAD_TO_DEG + r * RAD_TO_DEG_LO;
+}
+
+static inline double sind_medium(double x) {
+    double s, c;
+    calco_sincos_deg(x, &s, &c);
+    return s;
+}
+
+static inline double cosd_medium(double x) {
+    double s, c;
+    calco_sincos_deg(x, &s, &c);
+    return c;
+}
+
+// tan from the exact degree remainder: +-45 give +-1 exactly, +-30 give the correctly rounded
+// tan 30 or tan 60, and odd multiples of 90 (the poles) give NaN, like calco.tangent. NaN and
+// infinite x are caught by bit tests, since -ffast-math comparisons do not see NaN.
+static inline double tand_medium(double x) {
+    double r;
+    int odd = calco_reduce_deg90(x, &r) & 1;
+    double sr, cr;
+    calco_sincos_kernel(r * CALCO_DEG_TO_RAD, &sr, &cr);
+    double sgn = odd ? -1.0 : 1.0;
+    double t = sgn * (odd ? cr : sr) / (odd ? sr : cr);
+    double exact = odd ? CALCO_TAN_60 : CALCO_TAN_30;
+    t = calco_same_bits(fabs(r), 30.0) ? ((r > 0.0) ? sgn * exact : -sgn * exact) : t;
+    t = calco_same_bits(fabs(r), 45.0) ? ((r > 0.0) ? sgn : -sgn) : t;
+    double pole = odd ? r : 1.0;
+    return (pole == 0.0 || !calco_isfinite(x)) ? NAN : t;
+}
+
+static inline double sine_medium(double x) {
+    double s, c;
+    calco_sincos_rad(x, &s, &c);
+    return s;
+}
+
+static inline double cosine_medium(double x) {
+    double s, c;
+    calco_sincos_rad(x, &s, &c);
+    return c;
+}
+
+// Poles: NaN where |cos x| < DBL_EPSILON, as in calco.tangent; there |tan x| > 1 / DBL_EPSILON.
+static inline double tangent_from(int q, double r) {
+    double sr, cr;
+    calco_sincos_kernel(r, &sr, &cr);
+    double t = (q & 1) ? -cr / sr : sr / cr;
+    return (fabs(t) > 1.0 / DBL_EPSILON) ? NAN : t;
+}
+
+static inline double tangent_medium(double x) {
+    double r;
+    int q = calco_reduce_pio2_medium(x, &r);
+    return tangent_from(q, r);
+}
+
+// Arguments beyond the medium ranges: degrees reduce exactly by fmod, radians by Payne-Hanek.
+static double sind_large(double x) { return sind_medium(fmod(x, 360.0)); }
+static double cosd_large(double x) { return cosd_medium(fmod(x, 360.0)); }
+static double tand_large(double x) { return tand_medium(fmod(x, 360.0)); }
+
+static double sine_large(double x) {
+    double r, s, c;
+    int q = calco_rem_pio2_large(x, &r);
+    calco_sincos_quadrant(q, r, &s, &c);
+    return s;
+}
+
+static double cosine_large(double x) {
+    double r, s, c;
+    int q = calco_rem_pio2_large(x, &r);
+    calco_sincos_quadrant(q, r, &s, &c);
+    return c;
+}
+
+static double tangent_large(double x) {
+    double r;
+    int q = calco_rem_pio2_large(x, &r);
+    return tangent_from(q, r);
+}
+
+// Inverses return degrees; the values at +-1/2 are exact (30, 60, 120 degrees). All tests are
+// by bit pattern, since -ffast-math lets NaN match x == 0.5 and fail both range tests.
+static inline double asind_one(double x) {
+    double d = to_degrees(asin(x));
+    d = calco_same_bits(x, 0.5) ? 30.0 : calco_same_bits(x, -0.5) ? -30.0 : d;
+    return (calco_isnan(x) || x < -1.0 || x > 1.0) ? NAN : d;
+}
+
+static inline double acosd_one(double x) {
+    double d = to_degrees(acos(x));
+    d = calco_same_bits(x, 0.5) ? 60.0 : calco_same_bits(x, -0.5) ? 120.0 : d;
+    return (calco_isnan(x) || x < -1.0 || x > 1.0) ? NAN : d;
+}
+
+static inline double atan2d_one(double y, double x) {
+    return to_degrees(atan2(y, x));
+}
+
+#define TRIG_KERNELS(name, limit) \
+    double calco_##name##_kernel(double x) { \
+        return (fabs(x) < (limit)) ? name##_medium(x) : name##_large(x); \
+    } \
+    void calco_##name##_block(const double* in, double* out, Py_ssize_t n) { \
+        for (Py_ssize_t i = 0; i < n; i++) { \
+            out[i] = name##_medium(in[i]); \
+        } \
+        for (Py_ssize_t i = 0; i < n; i++) { \
+            if (!(fabs(in[i]) < (limit))) { \
+                out[i] = name##_large(in[i]); \
+            } \
+        } \
+    }
+
+TRIG_KERNELS(sind, CALCO_DEG_MEDIUM)
+TRIG_KERNELS(cosd, CALCO_DEG_MEDIUM)
+TRIG_KERNELS(tand, CALCO_DEG_MEDIUM)
+TRIG_KERNELS(sine, CALCO_RAD_MEDIUM)
+TRIG_KERNELS(cosine, CALCO_RAD_MEDIUM)
+TRIG_KERNELS(tangent, CALCO_RAD_MEDIUM)
+
+double calco_asind_kernel(double x) { return asind_one(x); }
+double calco_acosd_kernel(double x) { return acosd_one(x); }
+
+void calco_asind_block(const double* in, double* out, Py_ssize_t n) {
+    for (Py_ssize_t i = 0; i < n; i++) {
+        out[i] = asind_one(in[i]);
+    }
+}
+
+void calco_acosd_block(const double* in, double* out, Py_ssize_t n) {
+    for (Py_ssize_t i = 0; i < n; i++) {
+        out[i] = acosd_one(in[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Python Wrappers: a float gives a float, a float64 buffer an array (or fills out=)
+// -----------------------------------------------------------------------------
+
+static PyObject* trig_unary(PyObject* args, PyObject* kwargs, calco_unary_fn kernel, calco_block_fn block) {
+    static char* kwlist[] = {"x", "out", NULL};
+    PyObject *x, *out = Py_None, *out_obj;
+    Py_buffer in_view, out_view;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O", kwlist, &x, &out)) {
+        return NULL;
+    }
+    if (PyFloat_Check(x) || PyLong_Check(x)) {
+        double v = PyFloat_AsDouble(x);
+        if (v == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires a buffer argument");
+            return NULL;
+        }
+        return PyFloat_FromDouble(kernel(v));
+    }
+    if (calco_get_double_buffer(x, &in_view, 0) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = in_view.len / (Py_ssize_t)sizeof(double);
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        PyBuffer_Release(&in_view);
+        return NULL;
+    }
+    calco_unary_task task = {kernel, (const double*)in_view.buf, (double*)out_view.buf, n, CALCO_DEFAULT_CHUNK,
+                             block};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(calco_unary_chunk, &task, (n + task.chunk_size - 1) / task.chunk_size);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&in_view);
+    PyBuffer_Release(&out_view);
+    return out_obj;
+}
+
+#define TRIG_WRAPPER(name) \
+    PyObject* calco_##name(PyObject* self, PyObject* args, PyObject* kwargs) { \
+        return trig_unary(args, kwargs, calco_##name##_kernel, calco_##name##_block); \
+    }
+
+TRIG_WRAPPER(sind)
+TRIG_WRAPPER(cosd)
+TRIG_WRAPPER(tand)
+TRIG_WRAPPER(asind)
+TRIG_WRAPPER(acosd)
+
+typedef struct {
+    const double* y;
+    const double* x;
+    Py_ssize_t ystep, xstep;   // 1 for a buffer, 0 for a broadcast scalar
+    double* out;
+    Py_ssize_t n;
+} atan2d_task;
+
+static void atan2d_chunk(void* ctx, Py_ssize_t chunk) {
+    const atan2d_task* t = (const atan2d_task*)ctx;
+    Py_ssize_t start = chunk * CALCO_DEFAULT_CHUNK;
+    Py_ssize_t end = (start + CALCO_DEFAULT_CHUNK < t->n) ? start + CALCO_DEFAULT_CHUNK : t->n;
+    const double* y = t->y;
+    const double* x = t->x;
+    double* out = t->out;
+    if (t->ystep && t->xstep) {
+        for (Py_ssize_t i = start; i < end; i++) {
+            out[i] = atan2d_one(y[i], x[i]);
+        }
+    } else {
+        for (Py_ssize_t i = start; i < end; i++) {
+            out[i] = atan2d_one(y[i * t->ystep], x[i * t->xstep]);
+        }
+    }
+}
+
+PyObject* calco_atan2d(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"y", "x", "out", NULL};
+    PyObject *ins[2], *out = Py_None, *out_obj = NULL, *result = NULL;
+    Py_buffer views[2], out_view;
+    double scalars[2];
+    const double* ptr[2];
+    Py_ssize_t step[2] = {0, 0};
+    int is_view[2] = {0, 0};
+    Py_ssize_t n = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$O", kwlist, &ins[0], &ins[1], &out)) {
+        return NULL;
+    }
+    for (int k = 0; k < 2; k++) {
+        if (PyFloat_Check(ins[k]) || PyLong_Check(ins[k])) {
+            scalars[k] = PyFloat_AsDouble(ins[k]);
+            if (scalars[k] == -1.0 && PyErr_Occurred()) {
+                goto done;
+            }
+            ptr[k] = &scalars[k];
+            continue;
+        }
+        if (calco_get_double_buffer(ins[k], &views[k], 0) < 0) {
+            goto done;
+        }
+        is_view[k] = 1;
+        Py_ssize_t len = views[k].len / (Py_ssize_t)sizeof(double);
+        if (n >= 0 && len != n) {
+            PyErr_SetString(PyExc_ValueError, "y and x buffers must have the same length");
+            goto done;
+        }
+        n = len;
+        ptr[k] = (const double*)views[k].buf;
+        step[k] = 1;
+    }
+    if (n < 0) {
+        if (out != Py_None) {
+            PyErr_SetString(PyExc_TypeError, "out= requires at least one buffer argument");
+            goto done;
+        }
+        result = PyFloat_FromDouble(atan2d_one(scalars[0], scalars[1]));
+        goto done;
+    }
+    if (calco_get_out_buffer(out, n, &out_view, &out_obj) < 0) {
+        goto done;
+    }
+    atan2d_task task = {ptr[0], ptr[1], step[0], step[1], (double*)out_view.buf, n};
+    Py_BEGIN_ALLOW_THREADS
+    calco_pool_parallel_for(atan2d_chunk, &task, (n + CALCO_DEFAULT_CHUNK - 1) / CALCO_DEFAULT_CHUNK);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&out_view);
+    result = out_obj;
+done:
+    for (int k = 0; k < 2; k++) {
+        if (is_view[k]) {
+            PyBuffer_Release(&views[k]);
+        }
+    }
+    return result;
+}
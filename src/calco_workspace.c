@@ -0,0 +1,594 @@
+// calco_workspace.c
+// Contains calco.Workspace: a pool of aligned output buffers that batch functions draw their
+// results from when called with workspace=, so repeated calls on same-shaped data stop paying
+// for malloc/free and first-touch page faults.
+//
+// A result is handed back as a memoryview over a pooled block. The block returns to the pool when
+// the last view of it goes away: on ws.release(view), at the end of a `with view:` or `with ws:`
+// block, or when the view is garbage collected. Releasing a view that something else (a numpy
+// array, another memoryview) still exports only drops that view, so pooled memory is never handed
+// out twice while it can still be reached.
+//
+// Blocks are kept in free lists keyed by their size in bytes (rounded up to the alignment); the
+// element type only sets the view's format, so an int64 and a float64 result of the same length
+// share a block. All pool state is touched with the GIL held.
+//
+// The shims generated by CALCO_WORKSPACE_SHIM (calco.h) take workspace= out of the keywords and
+// make the workspace current for the duration of the call in a thread-specific slot, which
+// calco_new_array consults. Nested calls (from Python callbacks) without workspace= see none.
+
+#include "calco.h" // Include the main header for prototypes and definitions
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define WS_HUGE_PAGE ((size_t)2 << 20)
+#endif
+
+#define WS_MAX_DEPTH 32
+
+// -----------------------------------------------------------------------------
+// Blocks and Free Lists
+// -----------------------------------------------------------------------------
+
+typedef struct ws_block {
+    struct ws_block* next;
+    void* data;
+    size_t size;        // Pool key: requested bytes rounded up to the alignment
+    size_t mapped;      // Length of the mapping when allocated with mmap, else 0
+} ws_block;
+
+typedef struct {
+    size_t size;
+    ws_block* free;
+} ws_bin;
+
+typedef struct {
+    PyObject_HEAD
+    size_t alignment;
+    int huge_pages;
+    Py_ssize_t max_cached;          // Bytes kept in the free lists at most, -1 for no limit
+    ws_bin* bins;
+    Py_ssize_t nbins, bins_cap;
+    unsigned long long hits, misses;
+    Py_ssize_t buffers_in_use;
+    Py_ssize_t bytes_in_use, bytes_cached;
+    Py_ssize_t peak_bytes_in_use, peak_bytes;   // peak_bytes: in use + cached
+    PyObject* scope;                // Weak references to views handed out inside `with ws:`
+    Py_ssize_t marks[WS_MAX_DEPTH]; // Length of scope at each enclosing __enter__
+    int depth;
+} CalcoWorkspace;
+
+// Exporter behind each handed-out memoryview; owns one block while alive.
+typedef struct {
+    PyObject_HEAD
+    CalcoWorkspace* ws;
+    ws_block* block;
+    Py_ssize_t n, itemsize;
+    char format[2];
+} CalcoWorkspaceBuffer;
+
+static Py_tss_t current_key = Py_tss_NEEDS_INIT;
+static PyObject* workspace_str;
+
+static ws_block* block_alloc(const CalcoWorkspace* ws, size_t size) {
+    ws_block* b = (ws_block*)PyMem_RawMalloc(sizeof(ws_block));
+    if (b == NULL) {
+        return NULL;
+    }
+    b->next = NULL;
+    b->size = size;
+    b->mapped = 0;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (ws->huge_pages && size >= WS_HUGE_PAGE) {
+        size_t len = (size + WS_HUGE_PAGE - 1) & ~(WS_HUGE_PAGE - 1);
+        void* p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, len, MADV_HUGEPAGE); // A hint: without transparent huge pages this is a plain mapping
+            b->data = p;
+            b->mapped = len;
+            return b;
+        }
+    }
+#endif
+#ifdef _WIN32
+    b->data = _aligned_malloc(size, ws->alignment);
+#else
+    if (posix_memalign(&b->data, ws->alignment, size) != 0) {
+        b->data = NULL;
+    }
+#endif
+    if (b->data == NULL) {
+        PyMem_RawFree(b);
+        return NULL;
+    }
+    return b;
+}
+
+static void block_free(ws_block* b) {
+#if defined(__linux__)
+    if (b->mapped) {
+        munmap(b->data, b->mapped);
+        PyMem_RawFree(b);
+        return;
+    }
+#endif
+#ifdef _WIN32
+    _aligned_free(b->data);
+#else
+    free(b->data);
+#endif
+    PyMem_RawFree(b);
+}
+
+static ws_bin* find_bin(CalcoWorkspace* ws, size_t size, int create) {
+    for (Py_ssize_t i = 0; i < ws->nbins; i++) {
+        if (ws->bins[i].size == size) {
+            return &ws->bins[i];
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+    if (ws->nbins == ws->bins_cap) {
+        Py_ssize_t cap = ws->bins_cap ? 2 * ws->bins_cap : 8;
+        ws_bin* bins = (ws_bin*)PyMem_Realloc(ws->bins, cap * sizeof(ws_bin));
+        if (bins == NULL) {
+            return (ws_bin*)PyErr_NoMemory();
+        }
+        ws->bins = bins;
+        ws->bins_cap = cap;
+    }
+    ws_bin* bin = &ws->bins[ws->nbins++];
+    bin->size = size;
+    bin->free = NULL;
+    return bin;
+}
+
+// Returns the number of bytes freed.
+static Py_ssize_t free_cached(CalcoWorkspace* ws) {
+    Py_ssize_t freed = 0;
+    for (Py_ssize_t i = 0; i < ws->nbins; i++) {
+        while (ws->bins[i].free != NULL) {
+            ws_block* b = ws->bins[i].free;
+            ws->bins[i].free = b->next;
+            freed += (Py_ssize_t)b->size;
+            block_free(b);
+        }
+    }
+    ws->bytes_cached = 0;
+    return freed;
+}
+
+// -----------------------------------------------------------------------------
+// calco.WorkspaceBuffer (internal exporter)
+// -----------------------------------------------------------------------------
+
+static int wsbuf_getbuffer(CalcoWorkspaceBuffer* self, Py_buffer* view, int flags) {
+    view->obj = (PyObject*)self;
+    Py_INCREF(self);
+    view->buf = self->block->data;
+    view->len = self->n * self->itemsize;
+    view->readonly = 0;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &self->n : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &self->itemsize : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static void wsbuf_dealloc(CalcoWorkspaceBuffer* self) {
+    CalcoWorkspace* ws = self->ws;
+    ws_block* b = self->block;
+    ws->buffers_in_use--;
+    ws->bytes_in_use -= (Py_ssize_t)b->size;
+    ws_bin* bin = find_bin(ws, b->size, 0);
+    if (bin != NULL && (ws->max_cached < 0 || ws->bytes_cached + (Py_ssize_t)b->size <= ws->max_cached)) {
+        b->next = bin->free;
+        bin->free = b;
+        ws->bytes_cached += (Py_ssize_t)b->size;
+    } else {
+        block_free(b);
+    }
+    Py_DECREF(ws);
+    PyObject_Free(self);
+}
+
+static PyBufferProcs wsbuf_as_buffer = {
+    .bf_getbuffer = (getbufferproc)wsbuf_getbuffer,
+};
+
+static PyTypeObject CalcoWorkspaceBufferType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.WorkspaceBuffer",
+    .tp_basicsize = sizeof(CalcoWorkspaceBuffer),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "A block of calco.Workspace memory; batch results are memoryviews over one.",
+    .tp_dealloc = (destructor)wsbuf_dealloc,
+    .tp_as_buffer = &wsbuf_as_buffer,
+};
+
+// -----------------------------------------------------------------------------
+// Allocation Hooks
+// -----------------------------------------------------------------------------
+
+PyObject* calco_workspace_current(void) {
+    return (PyObject*)PyThread_tss_get(&current_key);
+}
+
+PyObject* calco_workspace_array(PyObject* obj, char typecode, Py_ssize_t n, Py_buffer* view) {
+    CalcoWorkspace* ws = (CalcoWorkspace*)obj;
+    Py_ssize_t itemsize = calco_itemsize(typecode);
+    if (n < 0 || n > (PY_SSIZE_T_MAX - (Py_ssize_t)ws->alignment) / itemsize) {
+        return PyErr_NoMemory();
+    }
+    size_t size = ((size_t)(n * itemsize) + ws->alignment - 1) & ~(ws->alignment - 1);
+    if (size == 0) {
+        size = ws->alignment;
+    }
+    ws_bin* bin = find_bin(ws, size, 1);
+    if (bin == NULL) {
+        return NULL;
+    }
+    CalcoWorkspaceBuffer* buf = PyObject_New(CalcoWorkspaceBuffer, &CalcoWorkspaceBufferType);
+    if (buf == NULL) {
+        return NULL;
+    }
+    ws_block* b = bin->free;
+    if (b != NULL) {
+        bin->free = b->next;
+        ws->bytes_cached -= (Py_ssize_t)size;
+        ws->hits++;
+    } else {
+        if ((b = block_alloc(ws, size)) == NULL) {
+            PyObject_Free(buf);
+            return PyErr_NoMemory();
+        }
+        ws->misses++;
+    }
+    buf->ws = ws;
+    Py_INCREF(ws);
+    buf->block = b;
+    buf->n = n;
+    buf->itemsize = itemsize;
+    buf->format[0] = typecode;
+    buf->format[1] = 0;
+    ws->buffers_in_use++;
+    ws->bytes_in_use += (Py_ssize_t)size;
+    if (ws->bytes_in_use > ws->peak_bytes_in_use) {
+        ws->peak_bytes_in_use = ws->bytes_in_use;
+    }
+    if (ws->bytes_in_use + ws->bytes_cached > ws->peak_bytes) {
+        ws->peak_bytes = ws->bytes_in_use + ws->bytes_cached;
+    }
+
+    PyObject* mv = PyMemoryView_FromObject((PyObject*)buf);
+    if (mv != NULL && ws->depth > 0) {
+        PyObject* ref = PyWeakref_NewRef(mv, NULL);
+        if (ref == NULL || PyList_Append(ws->scope, ref) < 0) {
+            Py_CLEAR(mv);
+        }
+        Py_XDECREF(ref);
+    }
+    if (mv != NULL && PyObject_GetBuffer((PyObject*)buf, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) < 0) {
+        Py_CLEAR(mv);
+    }
+    Py_DECREF(buf);
+    return mv;
+}
+
+// Takes workspace= out of kwargs. Returns 0 with *ws set (NULL when absent or None) and *kw
+// a new reference to the remaining keywords (or NULL), or -1 with an exception set.
+static int split_kwargs(PyObject* kwargs, PyObject** ws, PyObject** kw) {
+    *ws = NULL;
+    *kw = NULL;
+    if (kwargs == NULL) {
+        return 0;
+    }
+    PyObject* value = PyDict_GetItemWithError(kwargs, workspace_str);
+    if (value == NULL) {
+        if (PyErr_Occurred()) {
+            return -1;
+        }
+        Py_INCREF(kwargs);
+        *kw = kwargs;
+        return 0;
+    }
+    if (value != Py_None && !PyObject_TypeCheck(value, &CalcoWorkspaceType)) {
+        PyErr_Format(PyExc_TypeError, "workspace must be a calco.Workspace or None, not %.200s",
+                     Py_TYPE(value)->tp_name);
+        return -1;
+    }
+    // The caller's dict may be reused (f(**kw)), so the keyword is removed from a copy.
+    PyObject* copy = PyDict_Copy(kwargs);
+    if (copy == NULL || PyDict_DelItem(copy, workspace_str) < 0) {
+        Py_XDECREF(copy);
+        return -1;
+    }
+    *ws = (value == Py_None) ? NULL : value;
+    *kw = copy;
+    return 0;
+}
+
+PyObject* calco_workspace_call(PyCFunctionWithKeywords fn, PyObject* self, PyObject* args, PyObject* kwargs) {
+    PyObject* prev = calco_workspace_current();
+    if (kwargs == NULL && prev == NULL) {
+        return fn(self, args, NULL);
+    }
+    PyObject *ws, *kw;
+    if (split_kwargs(kwargs, &ws, &kw) < 0) {
+        return NULL;
+    }
+    Py_XINCREF(ws);
+    PyThread_tss_set(&current_key, ws);
+    PyObject* result = fn(self, args, kw);
+    PyThread_tss_set(&current_key, prev);
+    Py_XDECREF(ws);
+    Py_XDECREF(kw);
+    return result;
+}
+
+PyObject* calco_workspace_fastcall(calco_fastcall_fn fn, PyObject* self, PyObject* const* args, Py_ssize_t nargs,
+                                   PyObject* kwnames) {
+    PyObject* prev = calco_workspace_current();
+    Py_ssize_t nkw = (kwnames != NULL) ? PyTuple_GET_SIZE(kwnames) : 0;
+    Py_ssize_t at = -1;
+    for (Py_ssize_t i = 0; i < nkw; i++) {
+        PyObject* name = PyTuple_GET_ITEM(kwnames, i);
+        if (name == workspace_str || PyUnicode_Compare(name, workspace_str) == 0) {
+            at = i;
+            break;
+        }
+    }
+    if (at < 0 && prev == NULL) {
+        return fn(self, args, nargs, kwnames);
+    }
+    PyObject* ws = NULL;
+    PyObject* names = kwnames;
+    PyObject* small[16];
+    PyObject** stack = (PyObject**)args;
+    if (at >= 0) {
+        ws = args[nargs + at];
+        if (ws == Py_None) {
+            ws = NULL;
+        } else if (!PyObject_TypeCheck(ws, &CalcoWorkspaceType)) {
+            PyErr_Format(PyExc_TypeError, "workspace must be a calco.Workspace or None, not %.200s",
+                         Py_TYPE(ws)->tp_name);
+            return NULL;
+        }
+        // Keyword values follow the positionals in the same order as kwnames.
+        Py_ssize_t total = nargs + nkw - 1;
+        stack = (total <= 16) ? small : (PyObject**)PyMem_Malloc(total * sizeof(PyObject*));
+        names = PyTuple_New(nkw - 1);
+        if (stack == NULL || names == NULL) {
+            if (stack != small) {
+                PyMem_Free(stack);
+            }
+            Py_XDECREF(names);
+            return PyErr_NoMemory();
+        }
+        for (Py_ssize_t i = 0, j = 0; i < nargs + nkw; i++) {
+            if (i != nargs + at) {
+                stack[j++] = args[i];
+            }
+        }
+        for (Py_ssize_t i = 0, j = 0; i < nkw; i++) {
+            if (i != at) {
+                PyObject* name = PyTuple_GET_ITEM(kwnames, i);
+                Py_INCREF(name);
+                PyTuple_SET_ITEM(names, j++, name);
+            }
+        }
+        if (nkw == 1) {
+            Py_CLEAR(names);
+        }
+    }
+    Py_XINCREF(ws);
+    PyThread_tss_set(&current_key, ws);
+    PyObject* result = fn(self, stack, nargs, names);
+    PyThread_tss_set(&current_key, prev);
+    Py_XDECREF(ws);
+    if (at >= 0) {
+        Py_XDECREF(names);
+        if (stack != small) {
+            PyMem_Free(stack);
+        }
+    }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// calco.Workspace
+// -----------------------------------------------------------------------------
+
+static int workspace_init(CalcoWorkspace* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"alignment", "huge_pages", "max_cached_bytes", NULL};
+    Py_ssize_t alignment = 64;
+    int huge_pages = 0;
+    PyObject* max_cached = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|$npO", kwlist, &alignment, &huge_pages, &max_cached)) {
+        return -1;
+    }
+    if (alignment < (Py_ssize_t)sizeof(void*) || alignment > ((Py_ssize_t)1 << 21) || (alignment & (alignment - 1))) {
+        PyErr_SetString(PyExc_ValueError, "alignment must be a power of two between the pointer size and 2 MiB");
+        return -1;
+    }
+    Py_ssize_t limit = -1;
+    if (max_cached != Py_None && ((limit = PyLong_AsSsize_t(max_cached)) < 0)) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_ValueError, "max_cached_bytes must be non-negative");
+        }
+        return -1;
+    }
+    if (self->buffers_in_use > 0) {
+        PyErr_SetString(PyExc_RuntimeError, "cannot reinitialize a workspace with buffers in use");
+        return -1;
+    }
+    free_cached(self);
+    self->alignment = (size_t)alignment;
+    self->huge_pages = huge_pages;
+    self->max_cached = limit;
+    return 0;
+}
+
+static void workspace_dealloc(CalcoWorkspace* self) {
+    // Handed-out buffers hold a reference, so only cached blocks remain here.
+    free_cached(self);
+    PyMem_Free(self->bins);
+    Py_XDECREF(self->scope);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Releases one memoryview (or each one in a tuple or list). Views of other memory are an error;
+// views already released are skipped.
+static int release_one(CalcoWorkspace* self, PyObject* obj) {
+    if (PyTuple_Check(obj) || PyList_Check(obj)) {
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(obj); i++) {
+            if (release_one(self, PySequence_Fast_GET_ITEM(obj, i)) < 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+    if (!PyMemoryView_Check(obj)) {
+        PyErr_Format(PyExc_TypeError, "expected a memoryview returned with this workspace, not %.200s",
+                     Py_TYPE(obj)->tp_name);
+        return -1;
+    }
+    PyObject* base = PyObject_GetAttrString(obj, "obj");
+    if (base == NULL) {
+        if (PyErr_ExceptionMatches(PyExc_ValueError)) { // Already released
+            PyErr_Clear();
+            return 0;
+        }
+        return -1;
+    }
+    int ours = Py_TYPE(base) == &CalcoWorkspaceBufferType && ((CalcoWorkspaceBuffer*)base)->ws == self;
+    Py_DECREF(base);
+    if (!ours) {
+        PyErr_SetString(PyExc_ValueError, "memoryview does not belong to this workspace");
+        return -1;
+    }
+    PyObject* r = PyObject_CallMethod(obj, "release", NULL);
+    Py_XDECREF(r);
+    return (r == NULL) ? -1 : 0;
+}
+
+static PyObject* workspace_release(CalcoWorkspace* self, PyObject* args) {
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(args); i++) {
+        if (release_one(self, PyTuple_GET_ITEM(args, i)) < 0) {
+            return NULL;
+        }
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* workspace_clear(CalcoWorkspace* self, PyObject* Py_UNUSED(ignored)) {
+    return PyLong_FromSsize_t(free_cached(self));
+}
+
+static PyObject* workspace_stats(CalcoWorkspace* self, PyObject* Py_UNUSED(ignored)) {
+    return Py_BuildValue("{sKsKsnsnsnsnsn}",
+                         "hits", self->hits,
+                         "misses", self->misses,
+                         "buffers_in_use", self->buffers_in_use,
+                         "bytes_in_use", self->bytes_in_use,
+                         "bytes_cached", self->bytes_cached,
+                         "peak_bytes_in_use", self->peak_bytes_in_use,
+                         "peak_bytes", self->peak_bytes);
+}
+
+static PyObject* workspace_enter(CalcoWorkspace* self, PyObject* Py_UNUSED(ignored)) {
+    if (self->depth == WS_MAX_DEPTH) {
+        PyErr_SetString(PyExc_RuntimeError, "workspace scopes nested too deeply");
+        return NULL;
+    }
+    if (self->scope == NULL && (self->scope = PyList_New(0)) == NULL) {
+        return NULL;
+    }
+    self->marks[self->depth++] = PyList_GET_SIZE(self->scope);
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+// Releases the views handed out since the matching __enter__. A view still exported elsewhere
+// stays valid; its block returns to the pool when that export goes away.
+static PyObject* workspace_exit(CalcoWorkspace* self, PyObject* args) {
+    if (self->depth == 0) {
+        Py_RETURN_NONE;
+    }
+    Py_ssize_t mark = self->marks[--self->depth];
+    PyObject* exc_type, *exc_value, *exc_tb;
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    for (Py_ssize_t i = PyList_GET_SIZE(self->scope) - 1; i >= mark; i--) {
+        PyObject* view;
+#if PY_VERSION_HEX >= 0x030D0000
+        if (PyWeakref_GetRef(PyList_GET_ITEM(self->scope, i), &view) < 0) {
+            PyErr_Clear();
+        }
+#else
+        view = PyWeakref_GetObject(PyList_GET_ITEM(self->scope, i));
+        view = (view == Py_None) ? NULL : view;
+        Py_XINCREF(view);
+#endif
+        if (view != NULL) {
+            PyObject* r = PyObject_CallMethod(view, "release", NULL);
+            if (r == NULL) {
+                PyErr_Clear();
+            }
+            Py_XDECREF(r);
+            Py_DECREF(view);
+        }
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+    if (PyList_SetSlice(self->scope, mark, PyList_GET_SIZE(self->scope), NULL) < 0) {
+        return NULL;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyMethodDef workspace_methods[] = {
+    {"release", (PyCFunction)workspace_release, METH_VARARGS,
+     "release(*views): Returns the memory behind result views (or tuples of them) to the pool. A view also "
+     "exported elsewhere is only detached; its block comes back when the last export goes away."},
+    {"clear", (PyCFunction)workspace_clear, METH_NOARGS,
+     "clear(): Frees the cached (idle) buffers and returns the number of bytes freed."},
+    {"stats", (PyCFunction)workspace_stats, METH_NOARGS,
+     "stats(): Returns a dict with hits, misses, buffers_in_use, bytes_in_use, bytes_cached, "
+     "peak_bytes_in_use and peak_bytes (in use + cached)."},
+    {"__enter__", (PyCFunction)workspace_enter, METH_NOARGS, NULL},
+    {"__exit__", (PyCFunction)workspace_exit, METH_VARARGS,
+     "Releases the result views handed out inside the with block."},
+    {NULL, NULL, 0, NULL}
+};
+
+PyTypeObject CalcoWorkspaceType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "calco.Workspace",
+    .tp_basicsize = sizeof(CalcoWorkspace),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Workspace(*, alignment=64, huge_pages=False, max_cached_bytes=None): Pool of aligned output "
+              "buffers. Batch functions called with workspace=ws return memoryviews into pooled memory "
+              "instead of new arrays; release them with ws.release(view), `with view:` or `with ws:`. "
+              "huge_pages backs buffers of 2 MiB or more with transparent huge pages (Linux).",
+    .tp_methods = workspace_methods,
+    .tp_init = (initproc)workspace_init,
+    .tp_dealloc = (destructor)workspace_dealloc,
+    .tp_new = PyType_GenericNew,
+};
+
+int calco_workspace_init(void) {
+    if (PyThread_tss_create(&current_key) != 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if ((workspace_str = PyUnicode_InternFromString("workspace")) == NULL) {
+        return -1;
+    }
+    return PyType_Ready(&CalcoWorkspaceBufferType);
+}
@@ -0,0 +1,63 @@
+import array
+import math
+import unittest
+
+import calco
+
+NAN = math.nan
+
+
+def all_nan(values):
+    return all(math.isnan(v) for v in values)
+
+
+class ActivationNaN(unittest.TestCase):
+    def test_unary_nan(self):
+        for f in [calco.sigmoid, calco.softplus, calco.silu, calco.gelu, calco.logit, calco.log1p]:
+            self.assertTrue(math.isnan(f(NAN)), f)
+            for code in 'df':
+                out = f(array.array(code, [NAN, 0.5, NAN]))
+                self.assertTrue(math.isnan(out[0]) and math.isnan(out[2]), (f, code))
+                self.assertFalse(math.isnan(out[1]), (f, code))
+
+    def test_logaddexp_nan_either_order(self):
+        for f in [calco.logaddexp, calco.logaddexp2]:
+            self.assertTrue(math.isnan(f(1.0, NAN)), f)
+            self.assertTrue(math.isnan(f(NAN, 1.0)), f)
+            self.assertTrue(math.isnan(f(NAN, NAN)), f)
+            for code in 'df':
+                a = array.array(code, [1.0, NAN])
+                b = array.array(code, [NAN, 1.0])
+                self.assertTrue(all_nan(f(a, b)), (f, code))
+                self.assertTrue(all_nan(f(b, a)), (f, code))
+                self.assertTrue(all_nan(f(a, NAN)), (f, code))
+                self.assertTrue(all_nan(f(NAN, b)), (f, code))
+
+    def test_logaddexp_special_values(self):
+        self.assertEqual(calco.logaddexp(math.inf, math.inf), math.inf)
+        self.assertEqual(calco.logaddexp(-math.inf, -math.inf), -math.inf)
+        self.assertEqual(calco.logaddexp(0.0, 0.0), math.log(2.0))
+        self.assertEqual(calco.logaddexp2(3.0, 3.0), 4.0)
+
+    def test_rows_with_nan(self):
+        x = array.array('d', [1.0, NAN, 2.0])
+        self.assertTrue(math.isnan(calco.logsumexp(x)))
+        self.assertTrue(all_nan(calco.softmax(x)))
+
+
+class SigmoidFloat32(unittest.TestCase):
+    def test_symmetry_point_is_exact(self):
+        for code in 'df':
+            out = calco.sigmoid(array.array(code, [0.0, -0.0] * 20))
+            self.assertTrue(all(v == 0.5 for v in out), code)
+
+    def test_float32_close_to_double(self):
+        xs = [i / 16.0 for i in range(-400, 401)]
+        f32 = calco.sigmoid(array.array('f', xs))
+        for x, got in zip(xs, f32):
+            want = array.array('f', [1.0 / (1.0 + math.exp(-x))])[0]
+            self.assertLessEqual(abs(got - want), 2 ** -22 * want, x)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,54 @@
+import array
+import math
+import unittest
+
+import calco
+
+
+class DegreeTrigSpecialValues(unittest.TestCase):
+    def test_nan_and_inf(self):
+        for f in [calco.sind, calco.cosd, calco.tand]:
+            for x in [math.nan, math.inf, -math.inf]:
+                self.assertTrue(math.isnan(f(x)), (f, x))
+            out = f(array.array('d', [math.nan, math.inf, -math.inf, 0.0]))
+            self.assertTrue(all(math.isnan(v) for v in out[:3]), f)
+        for f in [calco.asind, calco.acosd]:
+            for x in [math.nan, math.inf, 2.0, -1.5]:
+                self.assertTrue(math.isnan(f(x)), (f, x))
+            out = f(array.array('d', [math.nan, 0.5]))
+            self.assertTrue(math.isnan(out[0]), f)
+
+    def test_exact_special_angles(self):
+        half = {30: 0.5, 150: 0.5, 210: -0.5, 330: -0.5, -30: -0.5, 390: 0.5, 750: 0.5}
+        for x, v in half.items():
+            self.assertEqual(calco.sind(x), v, x)
+        for x, v in {60: 0.5, 120: -0.5, 240: -0.5, 300: 0.5, -60: 0.5, 420: 0.5}.items():
+            self.assertEqual(calco.cosd(x), v, x)
+        for x in [0, 90, 180, 270, 360]:
+            self.assertEqual(abs(calco.sind(x)), [0.0, 1.0][x // 90 % 2], x)
+        r3 = math.sqrt(3.0)
+        self.assertEqual(calco.cosd(30), r3 / 2)
+        self.assertEqual(calco.sind(60), r3 / 2)
+        self.assertEqual(calco.tand(45), 1.0)
+        self.assertEqual(calco.tand(-45), -1.0)
+        self.assertEqual(calco.tand(30), 0.5773502691896257)  # Correctly rounded 1 / sqrt(3)
+        self.assertEqual(calco.tand(60), r3)
+        self.assertEqual(calco.tand(-60), -r3)
+        self.assertEqual(calco.tand(120), -r3)
+        self.assertEqual(calco.tand(210), 0.5773502691896257)
+        self.assertTrue(math.isnan(calco.tand(90)))
+        self.assertEqual(calco.asind(0.5), 30.0)
+        self.assertEqual(calco.acosd(0.5), 60.0)
+        self.assertEqual(calco.acosd(-0.5), 120.0)
+
+    def test_buffers_match_scalars(self):
+        xs = array.array('d', [k * 15.0 for k in range(-48, 49)])
+        for f in [calco.sind, calco.cosd, calco.tand]:
+            out = f(xs)
+            for x, v in zip(xs, out):
+                w = f(x)
+                self.assertTrue(v == w or (math.isnan(v) and math.isnan(w)), (f, x))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,26 @@
+import array
+import math
+import unittest
+
+import calco
+
+
+class DoubleDoubleTrigLargeArguments(unittest.TestCase):
+    def test_large_finite_arguments(self):
+        xs = [1e22, 2.0 ** 60, 1e300, -1e300, 1.7e308, 2.0 ** 50, 6381956970095103 * 2.0 ** 797]
+        s_hi, s_lo = calco.dd_sin(array.array('d', xs))
+        c_hi, c_lo = calco.dd_cos(array.array('d', xs))
+        for i, x in enumerate(xs):
+            for hi, lo, ref in [(s_hi[i], s_lo[i], math.sin(x)), (c_hi[i], c_lo[i], math.cos(x))]:
+                self.assertTrue(math.isfinite(hi) and math.isfinite(lo), x)
+                self.assertLessEqual(abs(hi - ref), 1e-14 * abs(ref), x)
+                self.assertLessEqual(abs(lo), math.ulp(hi), x)
+
+    def test_non_finite_arguments(self):
+        for f in [calco.dd_sin, calco.dd_cos]:
+            hi, lo = f(array.array('d', [math.inf, -math.inf, math.nan]))
+            self.assertTrue(all(math.isnan(v) for v in hi), f)
+
+
+if __name__ == '__main__':
+    unittest.main()
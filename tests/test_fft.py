@@ -0,0 +1,28 @@
+import unittest
+from array import array
+
+import calco
+
+
+class FftEmptyInput(unittest.TestCase):
+    def test_empty_returns_empty(self):
+        for fn in [calco.fft, calco.ifft, calco.rfft]:
+            for fmt in ['d', 'f']:
+                res = fn(array(fmt))
+                self.assertEqual(len(res), 0, fn.__name__)
+                self.assertEqual(memoryview(res).format, fmt, fn.__name__)
+
+    def test_empty_with_cols_and_out(self):
+        self.assertEqual(len(calco.fft(array('d'), 4)), 0)
+        self.assertEqual(len(calco.rfft(array('d'), 4)), 0)
+        out = array('d', [1.0, 2.0])
+        self.assertIs(calco.fft(array('d'), out=out), out)
+        self.assertEqual(list(out), [1.0, 2.0])
+
+    def test_single_point(self):
+        self.assertEqual(list(calco.fft(array('d', [3.0, -1.0]))), [3.0, -1.0])
+        self.assertEqual(list(calco.rfft(array('d', [2.5]))), [2.5, 0.0])
+
+
+if __name__ == '__main__':
+    unittest.main()
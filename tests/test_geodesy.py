@@ -0,0 +1,44 @@
+import array
+import math
+import unittest
+
+import calco
+
+NAN = math.nan
+
+
+class GeodesyNaN(unittest.TestCase):
+    def test_scalar_nan_in_any_position(self):
+        for f in [calco.haversine, calco.bearing, calco.vincenty]:
+            for degrees, v in [(True, 10.0), (False, 0.2)]:
+                for k in range(4):
+                    args = [NAN if j == k else v * (j + 1) for j in range(4)]
+                    self.assertTrue(math.isnan(f(*args, degrees=degrees)), (f, degrees, k))
+
+    def test_buffer_nan_rows(self):
+        lat1 = array.array('d', [NAN, 10.0, 0.0])
+        lon1 = array.array('d', [0.0, NAN, 0.0])
+        lat2 = array.array('d', [0.0, 0.0, 0.0])
+        lon2 = array.array('d', [0.0, 0.0, 90.0])
+        for f in [calco.haversine, calco.bearing, calco.vincenty]:
+            out = f(lat1, lon1, lat2, lon2)
+            self.assertTrue(math.isnan(out[0]) and math.isnan(out[1]), f)
+            self.assertFalse(math.isnan(out[2]), f)
+
+    def test_antipodal_haversine(self):
+        self.assertAlmostEqual(calco.haversine(0.0, 0.0, 0.0, 180.0), math.pi * 6371008.8, places=6)
+
+    def test_vincenty_pole_to_pole(self):
+        half_meridian = 20003931.4586  # WGS 84
+        self.assertAlmostEqual(calco.vincenty(90.0, 0.0, -90.0, 0.0), half_meridian, places=3)
+        self.assertAlmostEqual(calco.vincenty(-90.0, 30.0, 90.0, 0.0), half_meridian, places=3)
+        self.assertAlmostEqual(calco.vincenty(math.pi / 2, 0.0, -math.pi / 2, 0.0, degrees=False),
+                               half_meridian, places=3)
+
+    def test_vincenty_coincident(self):
+        self.assertEqual(calco.vincenty(90.0, 0.0, 90.0, 45.0), 0.0)
+        self.assertEqual(calco.vincenty(12.5, 30.0, 12.5, 30.0), 0.0)
+
+
+if __name__ == '__main__':
+    unittest.main()
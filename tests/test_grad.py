@@ -0,0 +1,54 @@
+import math
+import unittest
+
+import calco
+
+
+def hessian_fd(f, a, b, h=1e-4):
+    faa = (f(a + h, b) - 2.0 * f(a, b) + f(a - h, b)) / (h * h)
+    fbb = (f(a, b + h) - 2.0 * f(a, b) + f(a, b - h)) / (h * h)
+    fab = (f(a + h, b + h) - f(a + h, b - h) - f(a - h, b + h) + f(a - h, b - h)) / (4.0 * h * h)
+    return faa, fab, fbb
+
+
+class BinaryHessian(unittest.TestCase):
+    CASES = [
+        ('add', lambda a, b: a + b, 1.3, -0.7),
+        ('subtract', lambda a, b: a - b, 1.3, -0.7),
+        ('multiply', lambda a, b: a * b, 1.3, -0.7),
+        ('divide', lambda a, b: a / b, 1.3, -0.7),
+        ('power', math.pow, 1.7, 2.3),
+        ('hypotenuse', math.hypot, 1.2, -0.9),
+        ('arctangent2', math.atan2, 0.8, -1.1),
+        ('log_custom_base', math.log, 3.5, 2.5),
+    ]
+
+    def test_matches_finite_differences(self):
+        for name, f, a, b in self.CASES:
+            r = getattr(calco.grad, name)(a, b, order=2)
+            self.assertEqual(len(r), 6, name)
+            self.assertEqual(r[:3], getattr(calco.grad, name)(a, b), name)
+            for got, want in zip(r[3:], hessian_fd(f, a, b)):
+                self.assertAlmostEqual(got, want, delta=1e-5 * max(1.0, abs(want)), msg=name)
+
+    def test_default_order_is_gradient(self):
+        self.assertEqual(calco.grad.multiply(2.0, 3.0), (6.0, 3.0, 2.0))
+        self.assertEqual(calco.grad.multiply(2.0, 3.0, order=2), (6.0, 3.0, 2.0, 0.0, 1.0, 0.0))
+
+    def test_fused_multiply_add(self):
+        self.assertEqual(calco.grad.fused_multiply_add(2.0, 3.0, 1.0, order=2),
+                         (7.0, 3.0, 2.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0))
+
+    def test_piecewise_linear_has_zero_hessian(self):
+        for name in ['float_modulo', 'positive_difference', 'copy_sign_double']:
+            self.assertEqual(getattr(calco.grad, name)(5.5, 2.0, order=2)[3:], (0.0, 0.0, 0.0), name)
+
+    def test_bad_order(self):
+        with self.assertRaises(ValueError):
+            calco.grad.add(1.0, 2.0, order=3)
+        with self.assertRaises(ValueError):
+            calco.grad.fused_multiply_add(1.0, 2.0, 3.0, order=0)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,38 @@
+import array
+import math
+import unittest
+
+import calco
+
+XP = [0.0, 1.0, 2.0, 3.0]
+FP = [0.0, 1.0, 4.0, 9.0]
+
+
+class InterpolationNaN(unittest.TestCase):
+    def test_interp_nan_query(self):
+        self.assertTrue(math.isnan(calco.interp(math.nan, XP, FP)))
+        out = calco.interp(array.array('d', [0.5, math.nan, 3.0, 5.0, -1.0]), XP, FP)
+        self.assertEqual(out[0], 0.5)
+        self.assertTrue(math.isnan(out[1]))
+        self.assertEqual(list(out[2:]), [9.0, 9.0, 0.0])
+
+    def test_interpolators_nan_query(self):
+        for cls in [calco.PchipInterpolator, calco.CubicSpline]:
+            f = cls(XP, FP)
+            self.assertTrue(math.isnan(f(math.nan)), cls)
+            out = f(array.array('d', [math.nan, 1.0, 3.0, math.nan]))
+            self.assertTrue(math.isnan(out[0]) and math.isnan(out[3]), cls)
+            self.assertEqual(list(out[1:3]), [1.0, 9.0], cls)
+
+    def test_non_finite_knots_rejected(self):
+        for bad in [[0.0, math.nan, 2.0, 3.0], [math.nan, 1.0, 2.0, 3.0], [0.0, 1.0, 2.0, math.inf],
+                    [-math.inf, 1.0, 2.0, 3.0]]:
+            with self.assertRaises(ValueError):
+                calco.interp(1.5, bad, FP)
+            for cls in [calco.PchipInterpolator, calco.CubicSpline]:
+                with self.assertRaises(ValueError):
+                    cls(bad, FP)
+
+
+if __name__ == '__main__':
+    unittest.main()
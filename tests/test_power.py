@@ -0,0 +1,53 @@
+import array
+import math
+import random
+import struct
+import unittest
+
+import calco
+
+
+class PowerSpecialValues(unittest.TestCase):
+    def test_nan_exponent(self):
+        for x in [2.0, -8.0, 0.5, 0.0, -1.0, math.inf]:
+            self.assertTrue(math.isnan(calco.power(x, math.nan)), x)
+        self.assertEqual(calco.power(1.0, math.nan), 1.0)  # As pow()
+
+    def test_infinite_exponent(self):
+        for x in [2.0, 0.5, -3.0, -0.25]:
+            self.assertEqual(calco.power(x, math.inf), math.pow(x, math.inf), x)
+            self.assertEqual(calco.power(x, -math.inf), math.pow(x, -math.inf), x)
+
+    def test_fast_paths(self):
+        for y in [2.0, 0.5, 3.0, -1.0, 1.0]:
+            self.assertEqual(calco.power(2.0, y), math.pow(2.0, y))
+
+    def test_zero_and_infinite_bases(self):
+        def bits(v):
+            return struct.pack('<d', v)
+        for x in [0.0, -0.0, math.inf, -math.inf]:
+            for y in [0.5, -0.5, 1.5, 1 / 3, 2 / 3, 0.25, 0.75, -1.25, 2.0, 3.0, -1.0, -2.0, -3.0, 4.0]:
+                try:
+                    want = math.pow(x, y)
+                except (ValueError, ZeroDivisionError):
+                    want = math.copysign(math.inf, x) if y == -1.0 or y == -3.0 else math.inf
+                got = calco.power(x, y)
+                self.assertEqual(bits(got), bits(want), (x, y, got, want))
+                self.assertEqual(bits(calco.power_by(y)(x)), bits(want), (x, y))
+
+    def test_negative_integer_exponents_match_pow(self):
+        rng = random.Random(3)
+        xs = [rng.uniform(0.01, 100.0) for _ in range(2000)] + [3.0, -0.75, 1e200, 1e-200, 5e-324, -7.0]
+        for y in [-2.0, -3.0, -4.0, -7.0, -8.0]:
+            buf = calco.power_by(y)(array.array('d', xs))
+            for x, got in zip(xs, buf):
+                try:
+                    want = math.pow(x, y)
+                except OverflowError:
+                    want = math.copysign(math.inf, x) if y % 2 else math.inf
+                self.assertEqual(got, want, (x, y))
+                self.assertEqual(calco.power(x, y), want, (x, y))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,39 @@
+import math
+import unittest
+from array import array
+
+import calco
+
+SINGULAR = 4
+
+
+class FindRootsSingularity(unittest.TestCase):
+    def test_pole_is_not_a_root(self):
+        for method in ['brent', 'bisect', 'newton']:
+            root, _, status = calco.find_roots('tangent', 1.0, 2.0, method=method)
+            self.assertEqual(status, SINGULAR, method)
+            self.assertAlmostEqual(root, math.pi / 2, places=6, msg=method)
+
+    def test_python_callable(self):
+        _, _, status = calco.find_roots(lambda x: array('d', [1.0 / (t - 0.3) for t in x]), 0.0, 1.0)
+        self.assertEqual(status, SINGULAR)
+
+    def test_roots_still_converge(self):
+        for method in ['brent', 'bisect', 'newton']:
+            root, _, status = calco.find_roots('tangent', 2.0, 4.0, method=method)
+            self.assertEqual(status, 0, method)
+            self.assertAlmostEqual(root, math.pi, places=10, msg=method)
+        (roots, _, status), info = calco.find_roots('sine', array('d', [3.0, 1.0]), array('d', [4.0, 2.0]),
+                                                    target=array('d', [0.0, 5.0]), full_output=True)
+        self.assertEqual(list(status), [0, 2])
+        self.assertAlmostEqual(roots[0], math.pi, places=10)
+        self.assertEqual(info['failed'], 1)
+
+    def test_steep_root(self):
+        root, _, status = calco.find_roots(lambda x: array('d', [1e10 * (t - 1.5) for t in x]), 1.0, 2.0)
+        self.assertEqual(status, 0)
+        self.assertAlmostEqual(root, 1.5, places=10)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,100 @@
+import array
+import math
+import random
+import statistics
+import unittest
+
+import calco
+
+
+class ScanThreadInvariance(unittest.TestCase):
+    def setUp(self):
+        self.threads = calco.get_num_threads()
+
+    def tearDown(self):
+        calco.set_num_threads(self.threads)
+
+    def results_per_pool_size(self, func, x, **kwargs):
+        results = []
+        for threads in [1, 2, 4, 8]:
+            calco.set_num_threads(threads)
+            results.append(func(x, **kwargs).tobytes())
+        return results
+
+    def test_cumsum_same_bits_for_any_pool_size(self):
+        rng = random.Random(7)
+        x = array.array('d', [rng.uniform(-1.0, 1.0) * 10 ** rng.randint(-3, 3) for _ in range(200_000)])
+        for kwargs in [{}, {'initial': 12.5}]:
+            results = self.results_per_pool_size(calco.cumsum, x, **kwargs)
+            self.assertTrue(all(r == results[0] for r in results), kwargs)
+
+    def test_cumprod_same_bits_for_any_pool_size(self):
+        rng = random.Random(11)
+        x = array.array('d', [rng.uniform(0.999, 1.001) for _ in range(200_000)])
+        results = self.results_per_pool_size(calco.cumprod, x)
+        self.assertTrue(all(r == results[0] for r in results))
+
+    def test_cumsum_in_place(self):
+        x = array.array('d', [1.0] * 150_000)
+        calco.set_num_threads(4)
+        calco.cumsum(x, x)
+        self.assertEqual(x[-1], 150_000.0)
+        self.assertEqual(x[70_000], 70_001.0)
+
+
+def same(a, b):
+    return (math.isnan(a) and math.isnan(b)) or a == b or abs(a - b) <= 1e-9 * max(1.0, abs(b))
+
+
+class RollingNonFinite(unittest.TestCase):
+    def check_moments(self, data, w):
+        x = array.array('d', data)
+        sums, means, vars_ = calco.rolling_sum(x, w), calco.rolling_mean(x, w), calco.rolling_var(x, w)
+        for i in range(w - 1, len(data)):
+            win = data[i - w + 1:i + 1]
+            want_sum = sum(win)
+            want_var = statistics.variance(win) if all(map(math.isfinite, win)) else math.nan
+            self.assertTrue(same(sums[i], want_sum), (i, sums[i], want_sum))
+            self.assertTrue(same(means[i], want_sum / w), (i, means[i]))
+            self.assertTrue(same(vars_[i], want_var), (i, vars_[i], want_var))
+
+    def test_nan_leaves_the_window(self):
+        data = [float(i % 7) for i in range(300)]
+        data[120] = math.nan
+        self.check_moments(data, 50)
+
+    def test_infinities_leave_the_window(self):
+        data = [1.0, math.inf, 1.0, 1.0, 1.0, -math.inf, 2.0, 3.0, math.inf, -math.inf, 5.0, 5.0, 6.0]
+        self.check_moments(data, 2)
+        self.check_moments(data, 3)
+        self.assertEqual(calco.rolling_var(array.array('d', [math.inf, 1.0, 1.0]), 2)[2], 0.0)
+
+    def test_nan_while_filling(self):
+        data = [math.nan, 1.0, 2.0, 3.0, 4.0]
+        out = calco.rolling_sum(array.array('d', data), 3, min_periods=1)
+        self.assertTrue(all(math.isnan(v) for v in out[:3]))
+        self.assertEqual(list(out[3:]), [6.0, 9.0])
+
+    def test_min_max_nan_anywhere_in_window(self):
+        data = [1.0, 2.0, math.nan, 4.0, 3.0, math.nan, math.nan, 0.5, 7.0, -math.inf, 2.0]
+        x = array.array('d', data)
+        for w in [1, 2, 3, 5]:
+            for fn, ref in [(calco.rolling_max, max), (calco.rolling_min, min)]:
+                out = fn(x, w)
+                for i in range(w - 1, len(data)):
+                    win = data[i - w + 1:i + 1]
+                    want = math.nan if any(map(math.isnan, win)) else ref(win)
+                    self.assertTrue(same(out[i], want), (fn.__name__, w, i, out[i], want))
+
+    def test_rolling_stats_min_max_across_chunks(self):
+        stats = calco.RollingStats(2)
+        stats.update(array.array('d', [2.0, math.nan]))
+        self.assertTrue(math.isnan(stats.max) and math.isnan(stats.min))
+        stats.update(array.array('d', [4.0]))
+        self.assertTrue(math.isnan(stats.max))
+        stats.update(array.array('d', [3.0]))
+        self.assertEqual((stats.min, stats.max), (3.0, 4.0))
+
+
+if __name__ == '__main__':
+    unittest.main()
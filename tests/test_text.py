@@ -0,0 +1,52 @@
+import math
+import unittest
+from array import array
+
+import calco
+
+
+class ParseFloatsFields(unittest.TestCase):
+    def test_values(self):
+        self.assertEqual(list(calco.parse_floats(b'1,2.5, -3\n4,5e1,6\n\n')), [1.0, 2.5, -3.0, 4.0, 50.0, 6.0])
+        self.assertEqual(list(calco.parse_floats(b'1 2\t3')), [1.0, 2.0, 3.0])
+        self.assertEqual(list(calco.parse_floats(b'1;2;3', b';')), [1.0, 2.0, 3.0])
+
+    def test_signed_zeros(self):
+        values = calco.parse_floats(b'1.0,-0.0,0.0,2.0,-0e5,0e-3')
+        self.assertEqual(list(values), [1.0, 0.0, 0.0, 2.0, 0.0, 0.0])
+        self.assertEqual([math.copysign(1.0, v) for v in values], [1.0, -1.0, 1.0, 1.0, -1.0, 1.0])
+        self.assertEqual(math.copysign(1.0, calco.parse_floats(b'0.0')[0]), 1.0)
+        self.assertEqual(math.copysign(1.0, calco.parse_floats(b'-0.0')[0]), -1.0)
+        self.assertEqual(math.copysign(1.0, calco.parse_floats(b'-nan')[0]), -1.0)
+
+    def test_empty_field_is_an_error(self):
+        for data in [b'1,,3', b',1,2', b'1,2,,', b'1,2,\n3,4', b'1,2\n,3', b'1, ,3']:
+            with self.assertRaises(ValueError, msg=data):
+                calco.parse_floats(data)
+        with self.assertRaises(ValueError):
+            calco.parse_floats(b'1\t\t3', b'\t')
+        for data in [b'1\n\n2\n', b'1\n2\n\n']:
+            with self.assertRaises(ValueError, msg=data):
+                calco.parse_floats(data, sep=b'\n')
+
+    def test_trailing_separator(self):
+        self.assertEqual(list(calco.parse_floats(b'1\n2\n', sep=b'\n')), [1.0, 2.0])
+        self.assertEqual(list(calco.parse_floats(b'1\r\n2\r\n', sep=b'\n')), [1.0, 2.0])
+        for data in [b'1,2,', b'1,2,\n', b'1,2\n3,4,\n']:
+            self.assertEqual(list(calco.parse_floats(data))[:2], [1.0, 2.0], data)
+
+    def test_partial_chunks(self):
+        text = b'1.5,2.25,3\n4,5,6\n'
+        for cut in range(1, len(text)):
+            parsed, used = calco.parse_floats(text[:cut], partial=True)
+            rest = calco.parse_floats(text[used:])
+            self.assertEqual(list(parsed) + list(rest), [1.5, 2.25, 3.0, 4.0, 5.0, 6.0], cut)
+
+    def test_out_buffer(self):
+        out = array('d', [0.0] * 4)
+        self.assertEqual(calco.parse_floats(b'7,8,9', out=out), 3)
+        self.assertEqual(list(out[:3]), [7.0, 8.0, 9.0])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,44 @@
+import unittest
+from array import array
+
+import calco
+
+
+class WorkspaceShims(unittest.TestCase):
+    """Only calls that produce an output buffer take workspace=."""
+
+    def setUp(self):
+        self.ws = calco.Workspace()
+        self.x = array('d', [0.5, 1.0, 1.5, 2.0])
+
+    def assert_pooled(self, result):
+        self.assertIsInstance(result, memoryview)
+        self.ws.release(result)
+
+    def test_buffer_functions_return_pooled_views(self):
+        x, ws = self.x, self.ws
+        self.assert_pooled(calco.apply('sine', x, workspace=ws))
+        self.assert_pooled(calco.submit('sine', x, workspace=ws).result())
+        self.assert_pooled(calco.parse_floats(b'1,2,3', workspace=ws))
+        self.assert_pooled(calco.cumsum(x, workspace=ws))
+        self.assert_pooled(calco.rolling_max(x, 2, workspace=ws))
+        self.assert_pooled(calco.sind(x, workspace=ws))
+        self.assert_pooled(calco.sigmoid(x, workspace=ws))
+        self.assert_pooled(calco.fft(x, workspace=ws))
+        self.assert_pooled(calco.haversine(x, x, x, x, workspace=ws))
+        self.assert_pooled(calco.find_roots('sine', array('d', [3.0]), 4.0, workspace=ws)[0])
+        self.assert_pooled(calco.quad('sine', array('d', [0.0]), 1.0, workspace=ws)[0])
+
+    def test_callable_objects(self):
+        x, ws = self.x, self.ws
+        self.assert_pooled(calco.power_by(2.0)(x, workspace=ws))
+        self.assert_pooled(calco.grad.apply('sine', x, workspace=ws)[0])
+
+    def test_factories_reject_workspace(self):
+        # power_by builds a callable and writes no buffer, so workspace= would be ignored.
+        with self.assertRaises(TypeError):
+            calco.power_by(2.0, workspace=self.ws)
+
+
+if __name__ == '__main__':
+    unittest.main()